@@ -1,72 +1,160 @@
 #include "AD9959.h"
-#include "delay.h"
+#include <string.h>
 															
-uint8_t FR1_DATA[3] = {0xD0,0x00,0x00};//VCO gain control[23]=1ϵͳʱӸ255Mhz; PLL[22:18]=10100,20Ƶ,20*25M=500MHZ; Charge pump control = 75uA 
+uint8_t FR1_DATA[3] = {0xD0,0x00,0x00};//VCO gain control[23]=1系统时钟高于255Mhz; PLL[22:18]=10100,20倍频,20*25M=500MHZ; Charge pump control = 75uA 
 
 
-uint8_t FR2_DATA[2] = {0x00,0x00};	// ˫ɨ裬ʼֵɨִֵӽֵɨʼֵ
-//uint8_t FR2_DATA[2] = {0x80,0x00};// ɨ裬ʼֵɨִֵʼֵɨֵԴ
+uint8_t FR2_DATA[2] = {0x00,0x00};	// 双方向扫描，即从起始值扫到结束值后，又从结束值扫到起始值
+//uint8_t FR2_DATA[2] = {0x80,0x00};// 单方向扫描，即从起始值扫到结束值后，又从起始值扫到结束值，以此类推
 
 
-double ACC_FRE_FACTOR = 8.589934592;	//Ƶ8.589934592=(2^32)/500000000 500M=25M*20(Ƶɱ)
+double ACC_FRE_FACTOR = 8.589934592;	//频率因子8.589934592=(2^32)/500000000 其中500M=25M*20(倍频数可编程),仅为兼容保留,驱动内用AD9959_HzToFtw
 
-uint8_t CFR_DATA[3] = {0x00,0x03,0x02};//default Value = 0x000302	   //ܼͨĴ
+uint8_t CFR_DATA[3] = {0x00,0x03,0x02};//default Value = 0x000302	   //通道功能寄存器
+
+//各寄存器的字节数,地址0x00~0x18
+const uint8_t AD9959_RegLen[AD9959_REG_NUM] = {1,3,2,3,4,2,3,2,4,4, 4,4,4,4,4,4,4,4,4,4,4,4,4,4,4};
+
+AD9959_Shadow_t AD9959_Shadow;	//影子寄存器
+
+AD9959_Clock_t AD9959_Clock = {AD9959_REF_CLK, AD9959_PLL_MUL, AD9959_SYSCLK, 0, 0};	//时钟配置,AD9959_ClockConfig中计算倒数
+AD9959_PhaseCal_t AD9959_PhaseCal;	//多相输出校准表,由用户按实测填写
 
 																	
 																
 																	
 /************************************************************
-**  void AD9959_Init(void)  
-**  ʼAD9959ҪõIO,Ĵ
-** ڲ 
-** ڲ 
-** ˵ 
+** 函数名称 ：void AD9959_Init(void)  
+** 函数功能 ：初始化控制AD9959需要用到的IO口,及寄存器
+** 入口参数 ：无
+** 出口参数 ：无
+** 函数说明 ：无
 **************************************************************/
 void AD9959_Init(void)  
 { 
 	GPIO_InitTypeDef  GPIO_InitStructure;       
-//	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB|RCC_APB2Periph_GPIOA|RCC_APB2Periph_GPIOC, ENABLE);	 //ʹPB,PE˿ʱ
-  __HAL_RCC_GPIOB_CLK_ENABLE(); // GPIOBʱ
-	__HAL_RCC_GPIOC_CLK_ENABLE(); // GPIOCʱ
-		__HAL_RCC_GPIOF_CLK_ENABLE(); // GPIOFʱ
+	AD9959_DelayInit();	//IO_Update、复位用DWT精确延时
+  __HAL_RCC_GPIOB_CLK_ENABLE(); //开启 GPIOB时钟
+	__HAL_RCC_GPIOC_CLK_ENABLE(); //开启 GPIOC时钟
+	__HAL_RCC_GPIOF_CLK_ENABLE(); //开启 GPIOF时钟
 	
+	GPIO_InitStructure.Pin = GPIO_PIN_6|GPIO_PIN_7;//初始化管脚PF6.7 CS,PS0
+	GPIO_InitStructure.Mode = GPIO_MODE_OUTPUT_PP; 		 //推挽输出
+	GPIO_InitStructure.Pull = GPIO_NOPULL;
+	GPIO_InitStructure.Speed = GPIO_SPEED_FREQ_VERY_HIGH ;		 //IO口速度为最高
+	HAL_GPIO_Init(GPIOF, &GPIO_InitStructure);					 //根据设定参数初始化GPIOF
 	
-	GPIO_InitStructure.Pin = GPIO_PIN_6|GPIO_PIN_8|GPIO_PIN_7;//ʼܽPF6.7.8
-	GPIO_InitStructure.Mode = GPIO_MODE_OUTPUT_PP; 		 //
-	GPIO_InitStructure.Speed = GPIO_SPEED_FREQ_VERY_HIGH ;		 //IOٶΪ50MHz
-	HAL_GPIO_Init(GPIOF, &GPIO_InitStructure);					 //趨ʼGPIOF
+	GPIO_InitStructure.Pin =GPIO_PIN_0|GPIO_PIN_2|GPIO_PIN_12|GPIO_PIN_13;//初始化管脚PB0.2.12.13 UPDATE,PS1,PWR,Reset
+	HAL_GPIO_Init(GPIOB, &GPIO_InitStructure);					 //根据设定参数初始化GPIOB
 	
-	GPIO_InitStructure.Pin =GPIO_PIN_2|GPIO_PIN_3|GPIO_PIN_4|GPIO_PIN_5|GPIO_PIN_12|GPIO_PIN_13;//ʼܽPB12,13,2,3,4,5    
-	GPIO_InitStructure.Mode = GPIO_MODE_OUTPUT_PP; 		 //
-	GPIO_InitStructure.Speed = GPIO_SPEED_FREQ_VERY_HIGH;		 //IOٶΪ50MHz
-	HAL_GPIO_Init(GPIOB, &GPIO_InitStructure);					 //趨ʼGPIOB
+	GPIO_InitStructure.Pin = GPIO_PIN_10;//初始化管脚PB10 PS2
+	GPIO_InitStructure.Speed = GPIO_SPEED_FREQ_LOW;		 //IO口速度为2MHz
+	HAL_GPIO_Init(GPIOB, &GPIO_InitStructure);					 //根据设定参数初始化GPIOB
 	
-	GPIO_InitStructure.Pin = GPIO_PIN_0|GPIO_PIN_1|GPIO_PIN_10;//ʼܽPB0.1.10			
-	GPIO_InitStructure.Mode = GPIO_MODE_OUTPUT_PP; 		 //
-	GPIO_InitStructure.Speed = GPIO_SPEED_FREQ_LOW;		 //IOٶΪ2MHz
-	HAL_GPIO_Init(GPIOB, &GPIO_InitStructure);					 //趨ʼGPIOB
+	GPIO_InitStructure.Pin = GPIO_PIN_0;	//初始化管脚PC0 PS3
+	HAL_GPIO_Init(GPIOC, &GPIO_InitStructure);					 //根据设定参数初始化GPIOC
 	
-	GPIO_InitStructure.Pin = GPIO_PIN_0;	//ʼܽPC0			 
-	GPIO_InitStructure.Mode = GPIO_MODE_OUTPUT_PP; 		 //
-	GPIO_InitStructure.Speed = GPIO_SPEED_FREQ_LOW;		 //IOٶΪ2MHz
-	HAL_GPIO_Init(GPIOC, &GPIO_InitStructure);					 //趨ʼGPIOC
+	AD9959_Bus.Init();  //SCLK、SDIO0~3由选中的通信方式初始化
 		
-	Intserve();  //IOڵƽ״̬ʼ
-    IntReset();  //AD9959λ  
+	Intserve();  //IO口电平状态初始化
+    IntReset();  //AD9959复位  
 	
-	//ʼܼĴ
-  AD9959_WriteData(FR1_ADD,3,FR1_DATA);//дܼĴ1
+	//初始化功能寄存器
+	AD9959_ClockConfig(AD9959_REF_CLK, AD9959_PLL_MUL);//写功能寄存器1,计算频率换算参数
   AD9959_WriteData(FR2_ADD,2,FR2_DATA);//
 } 
 
-//ʱ
+static uint32_t cpuCyclesPerUs = 0;	//每微秒的CPU周期数
+static uint32_t updateCycles = 0;		//IO_UPDATE高电平保持的CPU周期数
+
+/************************************************************
+** 函数名称 ：static uint32_t ad9959_sysclk_now(void)
+** 函数功能 ：芯片此刻实际的系统时钟,按已写入芯片的FR1(影子寄存器Reg)算
+** 函数说明 ：复位后PLL旁路,系统时钟就是参考时钟;AD9959_Clock.SysClk是目标值,FR1更新前不能用
+**************************************************************/
+static uint32_t ad9959_sysclk_now(void)
+{
+	uint8_t mul = (AD9959_Shadow.Reg[0][FR1_ADD] >> 18) & 0x1F;
+
+	return (mul >= 4 && mul <= 20) ? AD9959_Clock.RefClk * mul : AD9959_Clock.RefClk;
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_DelayInit(void)
+** 函数功能 ：打开DWT周期计数器,按当前CPU主频和芯片此刻的系统时钟计算延时参数
+** 函数说明 ：AD9959_Init、IntReset、AD9959_ClockSettle中已调用,修改CPU主频后要再调用一次
+**************************************************************/
+void AD9959_DelayInit(void)
+{
+	uint32_t sysclk = ad9959_sysclk_now();
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	cpuCyclesPerUs = SystemCoreClock / 1000000;
+	//SYNC_CLK = SYSCLK/4,向上取整到CPU周期
+	updateCycles = (uint32_t)(((uint64_t)AD9959_UPDATE_SYNC_CLKS * 4 * SystemCoreClock + sysclk - 1) / sysclk);
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_DelayCycles(uint32_t cycles)
+** 函数功能 ：按DWT周期计数器忙等,精度为几个CPU周期
+**************************************************************/
+void AD9959_DelayCycles(uint32_t cycles)
+{
+	uint32_t start = DWT->CYCCNT;
+
+	while(DWT->CYCCNT - start < cycles);
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_TimingStart(AD9959_Timing_t *t, uint32_t now)
+** 函数功能 ：清零切换时刻统计,now为第一次切换时的DWT计数
+**************************************************************/
+void AD9959_TimingStart(AD9959_Timing_t *t, uint32_t now)
+{
+	memset(t, 0, sizeof(AD9959_Timing_t));
+	t->LastStamp = now;
+	t->JitterMin = INT32_MAX;
+	t->JitterMax = INT32_MIN;
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_TimingStamp(AD9959_Timing_t *t, uint32_t now, uint64_t stepQ16)
+** 函数功能 ：记录一次切换的时刻,与累计的理想时刻比较
+** 入口参数 ：now:			这次切换时的DWT计数
+							stepQ16:	与上次切换的理想间隔,CPU周期,16.16定点
+** 函数说明 ：实际时间按DWT差值累计,计数器回绕不影响
+**************************************************************/
+void AD9959_TimingStamp(AD9959_Timing_t *t, uint32_t now, uint64_t stepQ16)
+{
+	int64_t err;
+
+	t->Elapsed += (uint32_t)(now - t->LastStamp);
+	t->LastStamp = now;
+	t->Ideal += stepQ16;
+	err = (int64_t)(t->Elapsed - ((t->Ideal + 0x8000) >> 16));
+	if(err < t->JitterMin)
+	{
+		t->JitterMin = (int32_t)err;
+	}
+	if(err > t->JitterMax)
+	{
+		t->JitterMax = (int32_t)err;
+	}
+	t->JitterAbsSum += (err < 0) ? -err : err;
+}
+
+/************************************************************
+** 函数名称 ：void delay1 (uint32_t length)
+** 函数功能 ：延时length微秒
+**************************************************************/
 void delay1 (uint32_t length)
 {
-    delay_us(2000);
+	AD9959_DelayCycles(length * cpuCyclesPerUs);
 }
 /************************************************************
-**  void Intserve(void)		   
-**  IOڵƽ״̬ʼ
+** 函数名称 ：void Intserve(void)		   
+** 函数功能 ：IO口电平状态初始化
 **************************************************************/
 void Intserve(void)		   
 {   
@@ -85,93 +173,733 @@ void Intserve(void)
 }
 
 /************************************************************
-**  void IntReset(void)		   
-**  AD9959λ
+** 函数名称 ：uint8_t IntReset(void)		   
+** 函数功能 ：AD9959复位
+** 出口参数 ：0:成功 1:四线通信方式切换四线模式失败
+** 函数说明 ：复位脉冲1us(手册要求至少1个SYSCLK周期),复位后等待30us再通信;
+							复位后PLL旁路,IO_UPDATE脉宽改按参考时钟算,FR1写入后由AD9959_ClockSettle恢复
 **************************************************************/
-void IntReset(void)	  
+uint8_t IntReset(void)	  
 {
   Reset = 0;
-	delay1(1);
 	Reset = 1;
-	delay1(30);
+	delay1(1);
 	Reset = 0;
+	delay1(30);
+	AD9959_ShadowReset();	//芯片寄存器回到默认值
+	AD9959_DelayInit();
+	return AD9959_Bus.Setup();		//复位后回到单线模式,四线通信方式在这里重新切换
 }
 
 /************************************************************
-**  void IO_Update(void)  
-**   AD9959
+** 函数名称 void IO_Update(void)  
+** 函数功能 ： AD9959更新数据
+** 函数说明 ： IO_UPDATE高电平保持AD9959_UPDATE_SYNC_CLKS个SYNC_CLK周期,
+							在SYNC_CLK上升沿把缓冲寄存器的数据送到工作寄存器
 **************************************************************/
 void IO_Update(void)  
 {
-	UPDATE = 0;
-	delay1(2);
+	AD9959_BusWait();		//DMA方式下等待数据发完
 	UPDATE = 1;
-	delay1(4);
+	AD9959_DelayCycles(updateCycles);
 	UPDATE = 0;
+	AD9959_Shadow.Pending = 0;
 }
 
 /************************************************************
-**  void AD9959_WriteData(u8 RegisterAddress, u8 NumberofRegisters, u8 *RegisterData)
-**  ʹģSPIAD9959д
-** ڲ RegisterAddress: Ĵַ
-						NumberofRegisters: Ҫдֽ
-						*RegisterData: ʼַ
-** ڲ 
-** ˵ 
+** 函数名称 ：void AD9959_ShadowReset(void)
+** 函数功能 ：影子寄存器恢复为芯片复位后的默认值
+** 函数说明 ：IntReset中已调用
 **************************************************************/
-void AD9959_WriteData(uint8_t RegisterAddress, uint8_t NumberofRegisters, uint8_t *RegisterData)
+void AD9959_ShadowReset(void)
 {
-	uint8_t	ControlValue = 0;
-	uint8_t	ValueToWrite = 0;
-	uint8_t	RegisterIndex = 0;
-	uint8_t	i = 0;
+	uint8_t ch;
 
-	ControlValue = RegisterAddress;
-//дַ
-	SCLK = 0;
-	CS = 0;	 
-	for(i=0; i<8; i++)
+	memset(&AD9959_Shadow, 0, sizeof(AD9959_Shadow));
+	AD9959_Shadow.CSR = 0xF0;
+	for(ch=0; ch<4; ch++)
 	{
-		SCLK = 0;
-		if(0x80 == (ControlValue & 0x80))
-		SDIO0= 1;	  
-		else
-		SDIO0= 0;	  
-		SCLK = 1;
-		ControlValue <<= 1;
+		AD9959_Shadow.Reg[ch][CFR_ADD] = 0x000302;
+		AD9959_Shadow.Stage[ch][CFR_ADD] = 0x000302;
 	}
-	SCLK = 0;
-//д
-	for (RegisterIndex=0; RegisterIndex<NumberofRegisters; RegisterIndex++)
+}
+
+/************************************************************
+** 函数名称 ：void ad9959_track(uint8_t *frame, uint16_t len)
+** 函数功能 ：按寄存器长度解析一帧中的每条写指令,补上CSR的串行模式位,
+							并把写入的值记入影子寄存器(通道寄存器记到CSR选中的每个通道)
+**************************************************************/
+static void ad9959_track(uint8_t *frame, uint16_t len)
+{
+	uint8_t addr, n, ch;
+	uint32_t value;
+
+	while(len > 0)
 	{
-		ValueToWrite = RegisterData[RegisterIndex];
-		for (i=0; i<8; i++)
+		addr = frame[0] & 0x7F;
+		n = (addr < AD9959_REG_NUM) ? AD9959_RegLen[addr] : len;
+		if(n + 1 > len)
+		{
+			return;
+		}
+		if(addr == CSR_ADD)
+		{
+			frame[1] = (frame[1] & ~0x06) | AD9959_Bus.CsrMode;
+		}
+		for(value = 0, ch = 1; ch <= n; ch++)
 		{
-			SCLK = 0;
-			if(0x80 == (ValueToWrite & 0x80))
-			SDIO0= 1;	  
-			else
-			SDIO0= 0;	  
-			SCLK = 1;
-			ValueToWrite <<= 1;
+			value = (value << 8) | frame[ch];
 		}
-		SCLK = 0;		
-	}	
-  CS = 1;
+		if(addr == CSR_ADD)
+		{
+			AD9959_Shadow.CSR = (uint8_t)value & 0xF0;
+		}
+		else if(addr < CFR_ADD)
+		{
+			AD9959_Shadow.Reg[0][addr] = value;
+			AD9959_Shadow.Stage[0][addr] = value;
+			AD9959_Shadow.Pending = 1;
+		}
+		else if(addr < AD9959_REG_NUM)
+		{
+			AD9959_Shadow.Pending = 1;
+			for(ch=0; ch<4; ch++)
+			{
+				if(AD9959_Shadow.CSR & (0x10 << ch))
+				{
+					AD9959_Shadow.Reg[ch][addr] = value;
+					AD9959_Shadow.Stage[ch][addr] = value;
+				}
+			}
+		}
+		frame += n + 1;
+		len -= n + 1;
+	}
+}
+
+/************************************************************
+** 函数名称 ：uint8_t *ad9959_put(uint8_t *p, uint8_t addr, uint32_t value)
+** 函数功能 ：在帧中放一条写指令,数据高字节在前
+** 出口参数 ：下一条指令的位置
+**************************************************************/
+static uint8_t *ad9959_put(uint8_t *p, uint8_t addr, uint32_t value)
+{
+	uint8_t n = AD9959_RegLen[addr];
+
+	*p++ = addr;
+	while(n--)
+	{
+		*p++ = (uint8_t)(value >> (8 * n));
+	}
+	return p;
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_WriteData(u8 RegisterAddress, u8 NumberofRegisters, u8 *RegisterData)
+** 函数功能 ：通过选中的通信方式(AD9959_BUS)向AD9959写数据
+** 入口参数 ：RegisterAddress: 寄存器地址
+						NumberofRegisters: 要写入的字节数
+						*RegisterData: 数据起始地址
+** 出口参数 ：0:成功 1:外设报错,没有发出
+** 函数说明 ：写CSR时自动补上通信方式的串行模式位,写入的值记入影子寄存器;
+							DMA方式下返回时可能还在发送
+**************************************************************/
+uint8_t AD9959_WriteData(uint8_t RegisterAddress, uint8_t NumberofRegisters, uint8_t *RegisterData)
+{
+	uint8_t *buf = AD9959_BusAlloc();
+
+	buf[0] = RegisterAddress;
+	memcpy(&buf[1], RegisterData, NumberofRegisters);
+	ad9959_track(buf, NumberofRegisters + 1);
+	return AD9959_BusSend(NumberofRegisters + 1);
 } 
 
 /************************************************************
-**  void Write_CFTW0(uint32_t fre)
-**  дCFTW0ͨƵתּĴ
-** ڲ  Freq:	дƵʣΧ0~200 000 000 Hz
-** ڲ 
-** ˵ 
+** 函数名称 ：void AD9959_Stage(uint8_t Channel, uint8_t addr, uint32_t value)
+** 函数功能 ：暂存一个寄存器的新值,AD9959_Flush/AD9959_Commit时才写入芯片
+** 入口参数 ：Channel:  通道CH0~CH3的组合,FR1/FR2等公共寄存器忽略
+							addr:			寄存器地址 FR1_ADD~0x18,不能是CSR_ADD
+							value:		寄存器值,按寄存器长度取低位
+**************************************************************/
+void AD9959_Stage(uint8_t Channel, uint8_t addr, uint32_t value)
+{
+	uint8_t ch;
+
+	if(addr == CSR_ADD || addr >= AD9959_REG_NUM)
+	{
+		return;
+	}
+	if(AD9959_RegLen[addr] < 4)
+	{
+		value &= (1UL << (8 * AD9959_RegLen[addr])) - 1;
+	}
+	if(addr < CFR_ADD)
+	{
+		AD9959_Shadow.Stage[0][addr] = value;
+		return;
+	}
+	for(ch=0; ch<4; ch++)
+	{
+		if(Channel & (0x10 << ch))
+		{
+			AD9959_Shadow.Stage[ch][addr] = value;
+		}
+	}
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_Stage_Fre(uint8_t Channel, uint32_t Freq)
+** 函数功能 ：暂存通道频率,单位Hz
+**************************************************************/
+void AD9959_Stage_Fre(uint8_t Channel, uint32_t Freq)
+{
+	AD9959_Stage(Channel, CFTW0_ADD, AD9959_HzToFtw(Freq));
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_Stage_Amp(uint8_t Channel, uint16_t Ampli)
+** 函数功能 ：暂存通道幅度0~1023,同时打开幅度乘法器(与Write_ACR相同)
+**************************************************************/
+void AD9959_Stage_Amp(uint8_t Channel, uint16_t Ampli)
+{
+	AD9959_Stage(Channel, ACR_ADD, Ampli | 0x1000);
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_Stage_Phase(uint8_t Channel, uint16_t Phase)
+** 函数功能 ：暂存通道相位0~16383
+**************************************************************/
+void AD9959_Stage_Phase(uint8_t Channel, uint16_t Phase)
+{
+	AD9959_Stage(Channel, CPOW0_ADD, Phase & 0x3FFF);
+}
+
+/************************************************************
+** 函数名称 ：uint16_t AD9959_Flush(void)
+** 函数功能 ：把与芯片不同的暂存值写入芯片,不产生IO_Update
+** 出口参数 ：写入的字节数,0表示没有变化
+** 函数说明 ：每个通道寄存器按值分组,写相同值的通道用一次CSR同时选中只写一遍;
+							再按通道组合归并,每种组合只写一次CSR,当前已选中的组合最先写;
+							所有指令拼成一帧连续发送,超过AD9959_BUS_BUF_LEN时分成几帧
+**************************************************************/
+uint16_t AD9959_Flush(void)
+{
+	uint8_t grp[4][AD9959_REG_NUM];		//每个通道每个寄存器所在的通道组合,0为不用写
+	uint16_t masks = 0;								//用到的通道组合,bit m 表示组合m
+	uint8_t *buf = AD9959_BusAlloc();
+	uint8_t *p = buf;
+	uint16_t total = 0;
+	uint8_t ch, j, addr, m, k, csr, first;
+	uint32_t value;
+
+	memset(grp, 0, sizeof(grp));
+	for(addr=CFR_ADD; addr<AD9959_REG_NUM; addr++)
+	{
+		for(ch=0; ch<4; ch++)
+		{
+			value = AD9959_Shadow.Stage[ch][addr];
+			if(grp[ch][addr] || value == AD9959_Shadow.Reg[ch][addr])
+			{
+				continue;
+			}
+			for(m=0, j=ch; j<4; j++)
+			{
+				if(!grp[j][addr] && AD9959_Shadow.Stage[j][addr] == value && AD9959_Shadow.Reg[j][addr] != value)
+				{
+					m |= 1 << j;
+				}
+			}
+			for(j=ch; j<4; j++)
+			{
+				if(m & (1 << j))
+				{
+					grp[j][addr] = m;
+				}
+			}
+			masks |= 1 << m;
+		}
+	}
+
+	//公共寄存器不需要选通道
+	for(addr=FR1_ADD; addr<CFR_ADD; addr++)
+	{
+		if(AD9959_Shadow.Stage[0][addr] != AD9959_Shadow.Reg[0][addr])
+		{
+			p = ad9959_put(p, addr, AD9959_Shadow.Stage[0][addr]);
+		}
+	}
+
+	first = csr = AD9959_Shadow.CSR >> 4;
+	for(k=0; k<16; k++)
+	{
+		//当前已选中的组合最先写,省一次CSR
+		m = (k == 0) ? first : (k == first) ? 0 : k;
+		if(!(masks & (1 << m)) || m == 0)
+		{
+			continue;
+		}
+		for(ch=0; !(m & (1 << ch)); ch++);
+		for(addr=CFR_ADD; addr<AD9959_REG_NUM; addr++)
+		{
+			if(grp[ch][addr] != m)
+			{
+				continue;
+			}
+			//CSR + 寄存器最多1+1+1+4字节,放不下就先发出去
+			if(p - buf + 7 > AD9959_BUS_BUF_LEN)
+			{
+				ad9959_track(buf, p - buf);
+				AD9959_BusSend(p - buf);
+				total += p - buf;
+				p = buf = AD9959_BusAlloc();
+			}
+			if(m != csr)
+			{
+				p = ad9959_put(p, CSR_ADD, m << 4);
+				csr = m;
+			}
+			p = ad9959_put(p, addr, AD9959_Shadow.Stage[ch][addr]);
+		}
+	}
+
+	if(p != buf)
+	{
+		ad9959_track(buf, p - buf);
+		AD9959_BusSend(p - buf);
+		total += p - buf;
+	}
+	return total;
+}
+
+/************************************************************
+** 函数名称 ：uint16_t AD9959_Commit(void)
+** 函数功能 ：写入所有暂存值并产生一次IO_Update,各通道的新值同时生效
+** 出口参数 ：写入的字节数
+** 示例     ：AD9959_Stage_Fre(CH0|CH1|CH2|CH3, 1000000);
+							AD9959_Stage_Phase(CH1, 4096);
+							AD9959_Stage_Amp(CH0|CH1, 1023);
+							AD9959_Commit();	//一帧数据、一次IO_Update
+**************************************************************/
+uint16_t AD9959_Commit(void)
+{
+	uint16_t n = AD9959_Flush();
+
+	IO_Update();
+	return n;
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_ClockConfig(uint32_t RefClk, uint8_t PllMul)
+** 函数功能 ：设置参考时钟和PLL倍频,写FR1并更新,预先计算频率换算用的倒数
+** 入口参数 ：RefClk:	参考时钟,单位Hz
+							PllMul:	PLL倍频4~20,其他值为不用PLL(系统时钟=参考时钟)
+** 函数说明 ：系统时钟高于255MHz时自动置VCO增益位;
+							写FR1的这次IO_UPDATE按芯片原来的系统时钟定脉宽,之后等待PLL锁定(约1ms)
+**************************************************************/
+void AD9959_ClockConfig(uint32_t RefClk, uint8_t PllMul)
+{
+	uint32_t fr1 = AD9959_Shadow.Stage[0][FR1_ADD] & ~0xFC0000UL;
+
+	if(PllMul < 4 || PllMul > 20)
+	{
+		PllMul = 1;
+	}
+	AD9959_Clock.RefClk = RefClk;
+	AD9959_Clock.PllMul = PllMul;
+	AD9959_Clock.SysClk = RefClk * PllMul;
+	//2^64/SYSCLK,Hz换算:f*Recip在64位内(f<SYSCLK)
+	AD9959_Clock.FtwRecip = (UINT64_MAX / AD9959_Clock.SysClk) + ((UINT64_MAX % AD9959_Clock.SysClk) * 2 + 2 >= AD9959_Clock.SysClk);
+	//2^64/(SYSCLK*1000),mHz换算中不足1Hz的部分用
+	AD9959_Clock.FtwRecipMilli = AD9959_Clock.FtwRecip / 1000;
+
+	if(PllMul > 1)
+	{
+		fr1 |= (uint32_t)PllMul << 18;
+	}
+	if(AD9959_Clock.SysClk > 255000000)
+	{
+		fr1 |= 1UL << 23;
+	}
+	FR1_DATA[0] = (uint8_t)(fr1 >> 16);
+	FR1_DATA[1] = (uint8_t)(fr1 >> 8);
+	FR1_DATA[2] = (uint8_t)fr1;
+	ACC_FRE_FACTOR = 4294967296.0 / AD9959_Clock.SysClk;
+
+	AD9959_Stage(0, FR1_ADD, fr1);
+	AD9959_Commit();
+	AD9959_ClockSettle();
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_ClockSettle(void)
+** 函数功能 ：FR1写入芯片后按新的系统时钟重算IO_UPDATE脉宽,开了PLL时等待锁定
+** 函数说明 ：AD9959_ClockConfig、AD9959_VerifyRestore中已调用;
+							锁定前输出频率不准,这段时间不要再写寄存器
+**************************************************************/
+void AD9959_ClockSettle(void)
+{
+	AD9959_DelayInit();
+	if(ad9959_sysclk_now() != AD9959_Clock.RefClk)
+	{
+		delay1(AD9959_PLL_LOCK_US);
+	}
+}
+
+/************************************************************
+** 函数名称 ：uint32_t AD9959_HzToFtw(uint32_t Freq)
+** 函数功能 ：频率(Hz)换算为频率控制字,四舍五入,结果精确
+** 函数说明 ：乘倒数得到估计值,再用整数余数校正一次,不用除法和浮点
+**************************************************************/
+uint32_t AD9959_HzToFtw(uint32_t Freq)
+{
+	uint64_t sys = AD9959_Clock.SysClk;
+	uint64_t ftw;
+	int64_t r;
+
+	if(Freq >= sys)
+	{
+		Freq %= sys;		//控制字按2^32回绕,结果相同
+	}
+	ftw = ((uint64_t)Freq * AD9959_Clock.FtwRecip + 0x80000000UL) >> 32;
+	r = (int64_t)(((uint64_t)Freq << 32) - ftw * sys);	//f*2^32 - ftw*SYSCLK
+
+	if(2 * r >= (int64_t)sys)
+	{
+		ftw++;
+	}
+	else if(2 * r < -(int64_t)sys)
+	{
+		ftw--;
+	}
+	return (uint32_t)ftw;
+}
+
+/************************************************************
+** 函数名称 ：uint32_t AD9959_MilliHzToFtw(uint64_t Freq)
+** 函数功能 ：频率(mHz)换算为频率控制字,四舍五入,结果精确
+** 函数说明 ：整数Hz和不足1Hz的部分分别乘倒数,再用余数校正;
+							余数按2^64取模计算,真实余数很小,取模不影响结果
+**************************************************************/
+uint32_t AD9959_MilliHzToFtw(uint64_t Freq)
+{
+	uint64_t d = (uint64_t)AD9959_Clock.SysClk * 1000;
+	uint64_t hz, ftw;
+	uint32_t milli;
+	int64_t r;
+
+	if(Freq >= d)
+	{
+		Freq %= d;
+	}
+	hz = Freq / 1000;
+	milli = (uint32_t)(Freq - hz * 1000);
+	ftw = (hz * AD9959_Clock.FtwRecip + milli * AD9959_Clock.FtwRecipMilli + 0x80000000UL) >> 32;
+	r = (int64_t)((Freq << 32) - ftw * d);
+
+	if(2 * r >= (int64_t)d)
+	{
+		ftw++;
+	}
+	else if(2 * r < -(int64_t)d)
+	{
+		ftw--;
+	}
+	return (uint32_t)ftw;
+}
+
+/************************************************************
+** 函数名称 ：uint64_t AD9959_FtwToMilliHz(uint32_t Ftw)
+** 函数功能 ：频率控制字对应的实际输出频率,单位mHz,四舍五入
+**************************************************************/
+uint64_t AD9959_FtwToMilliHz(uint32_t Ftw)
+{
+	uint64_t a = (uint64_t)Ftw * AD9959_Clock.SysClk;		//f*2^32
+
+	return (a >> 32) * 1000 + (((a & 0xFFFFFFFFUL) * 1000 + 0x80000000UL) >> 32);
+}
+
+/************************************************************
+** 函数名称 ：uint16_t AD9959_MilliDegToPow(int32_t Phase)
+** 函数功能 ：相位(千分之一度,可为负数)换算为相位控制字0~16383,四舍五入
+** 函数说明 ：16384/360000 = 256/5625
+**************************************************************/
+uint16_t AD9959_MilliDegToPow(int32_t Phase)
+{
+	Phase %= 360000;
+	if(Phase < 0)
+	{
+		Phase += 360000;
+	}
+	return (uint16_t)((((uint32_t)Phase * 512 + 5625) / 11250) & 0x3FFF);
+}
+
+/************************************************************
+** 函数名称 ：uint16_t AD9959_PermilleToAsf(uint16_t Ampli)
+** 函数功能 ：幅度(满幅的千分比0~1000)换算为幅度比例因子0~1023,四舍五入
+**************************************************************/
+uint16_t AD9959_PermilleToAsf(uint16_t Ampli)
+{
+	if(Ampli > 1000)
+	{
+		Ampli = 1000;
+	}
+	return (uint16_t)(((uint32_t)Ampli * 2046 + 1000) / 2000);
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_Stage_FreMilli(uint8_t Channel, uint64_t Freq)
+** 函数功能 ：暂存通道频率,单位mHz
+**************************************************************/
+void AD9959_Stage_FreMilli(uint8_t Channel, uint64_t Freq)
+{
+	AD9959_Stage(Channel, CFTW0_ADD, AD9959_MilliHzToFtw(Freq));
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_Stage_PhaseMilli(uint8_t Channel, int32_t Phase)
+** 函数功能 ：暂存通道相位,单位千分之一度
+**************************************************************/
+void AD9959_Stage_PhaseMilli(uint8_t Channel, int32_t Phase)
+{
+	AD9959_Stage(Channel, CPOW0_ADD, AD9959_MilliDegToPow(Phase));
+}
+
+/************************************************************
+** 函数名称 ：uint16_t AD9959_GroupSet(uint8_t Channel, const AD9959_ChSet_t *set, uint8_t Sync)
+** 函数功能 ：一次设置多个通道的频率、相位、幅度,在同一个IO_Update生效
+** 入口参数 ：Channel:  通道CH0~CH3的组合
+							set:			set[0]~set[3]对应CH0~CH3,只用Channel中选中的通道
+							Sync:			1:同时清零这些通道的相位累加器,各通道从各自的相位字开始,相位关系确定
+** 出口参数 ：写入的字节数
+** 函数说明 ：Sync时先置位CFR自动清相位累加器位,提交后再清除该位并再更新一次,
+							两次IO_Update都同时清零组内通道,相位关系不受影响
+**************************************************************/
+uint16_t AD9959_GroupSet(uint8_t Channel, const AD9959_ChSet_t *set, uint8_t Sync)
+{
+	uint16_t n;
+	uint8_t ch, mask;
+
+	for(ch=0; ch<4; ch++)
+	{
+		mask = 0x10 << ch;
+		if(!(Channel & mask))
+		{
+			continue;
+		}
+		AD9959_Stage(mask, CFTW0_ADD, AD9959_MilliHzToFtw(set[ch].Freq));
+		AD9959_Stage(mask, CPOW0_ADD, AD9959_MilliDegToPow(set[ch].Phase));
+		if(set[ch].Asf <= 1023)
+		{
+			AD9959_Stage(mask, ACR_ADD, set[ch].Asf | 0x1000);
+		}
+		if(Sync)
+		{
+			AD9959_Stage(mask, CFR_ADD, AD9959_Shadow.Stage[ch][CFR_ADD] | CFR_AUTOCLR_PHASE);
+		}
+	}
+	n = AD9959_Commit();
+	if(Sync)
+	{
+		for(ch=0; ch<4; ch++)
+		{
+			if(Channel & (0x10 << ch))
+			{
+				AD9959_Stage(0x10 << ch, CFR_ADD, AD9959_Shadow.Stage[ch][CFR_ADD] & ~CFR_AUTOCLR_PHASE);
+			}
+		}
+		n += AD9959_Commit();
+	}
+	return n;
+}
+
+/************************************************************
+** 函数名称 ：uint16_t ad9959_phase_group(uint8_t Channel, uint64_t Freq, const int32_t *Phase, uint16_t Asf, const int16_t *Trim)
+** 函数功能 ：按校准表修正各通道的相位和幅度,用AD9959_GroupSet同步输出
+**************************************************************/
+static uint16_t ad9959_phase_group(uint8_t Channel, uint64_t Freq, const int32_t *Phase, uint16_t Asf, const int16_t *Trim)
+{
+	AD9959_ChSet_t set[4];
+	int64_t skew, gain;
+	uint8_t ch;
+
+	for(ch=0; ch<4; ch++)
+	{
+		if(!(Channel & (0x10 << ch)))
+		{
+			continue;
+		}
+		//延迟补偿:mHz*ps*360/10^12 = 千分之一度,四舍五入
+		skew = (int64_t)Freq * AD9959_PhaseCal.Delay[ch] * 360;
+		skew = (skew + ((skew < 0) ? -500000000000LL : 500000000000LL)) / 1000000000000LL;
+		set[ch].Freq = Freq;
+		set[ch].Phase = (Phase[ch] % 360000) + (AD9959_PhaseCal.Phase[ch] % 360000) + (int32_t)(skew % 360000);
+		set[ch].Asf = 0xFFFF;
+		if(Asf <= 1023)
+		{
+			gain = (int64_t)Asf * (1000 + AD9959_PhaseCal.Gain[ch]) * (1000 + ((Trim != NULL) ? Trim[ch] : 0));
+			gain = (gain + 500000) / 1000000;
+			set[ch].Asf = (uint16_t)((gain < 0) ? 0 : (gain > 1023) ? 1023 : gain);
+		}
+	}
+	return AD9959_GroupSet(Channel, set, 1);
+}
+
+/************************************************************
+** 函数名称 ：uint16_t AD9959_MultiPhase(uint8_t Channel, uint64_t Freq, int32_t Phase0, uint16_t Asf, const int16_t *Trim)
+** 函数功能 ：Channel中的N个通道输出同一频率,相位依次相差360°/N(CH0在前),同一次IO_Update生效
+** 入口参数 ：Channel:  通道CH0~CH3的组合,如CH0|CH1|CH2为三相
+							Freq:			频率,mHz
+							Phase0:		第一个通道的相位,千分之一度
+							Asf:			幅度比例因子0~1023,大于1023不修改幅度
+							Trim:			各通道幅度微调,千分比,Trim[0]~Trim[3]对应CH0~CH3,NULL为不调
+** 出口参数 ：写入的字节数
+** 函数说明 ：相位累加器同时清零,第一个周期起相位关系就是确定的;再叠加AD9959_PhaseCal中的校准
+**************************************************************/
+uint16_t AD9959_MultiPhase(uint8_t Channel, uint64_t Freq, int32_t Phase0, uint16_t Asf, const int16_t *Trim)
+{
+	int32_t phase[4];
+	uint8_t ch, n = 0, k = 0;
+
+	for(ch=0; ch<4; ch++)
+	{
+		if(Channel & (0x10 << ch))
+		{
+			n++;
+		}
+	}
+	if(n == 0)
+	{
+		return 0;
+	}
+	for(ch=0; ch<4; ch++)
+	{
+		phase[ch] = 0;
+		if(Channel & (0x10 << ch))
+		{
+			phase[ch] = (Phase0 % 360000) + (int32_t)(360000 / n * k++);
+		}
+	}
+	return ad9959_phase_group(Channel, Freq, phase, Asf, Trim);
+}
+
+/************************************************************
+** 函数名称 ：uint16_t AD9959_IQ(uint8_t ChI, uint8_t ChQ, uint64_t Freq, uint16_t Asf)
+** 函数功能 ：正交输出:ChI为cos,ChQ为sin(滞后90°),同一次IO_Update生效
+** 入口参数 ：ChI、ChQ:	各一个通道CH0~CH3,不能相同
+							Freq:			频率,mHz
+							Asf:			幅度比例因子0~1023,大于1023不修改幅度
+** 出口参数 ：写入的字节数,参数错误时为0
+** 函数说明 ：校准同AD9959_MultiPhase,I/Q的幅度不平衡用AD9959_PhaseCal.Gain补偿
+**************************************************************/
+uint16_t AD9959_IQ(uint8_t ChI, uint8_t ChQ, uint64_t Freq, uint16_t Asf)
+{
+	int32_t phase[4] = {0, 0, 0, 0};
+	uint8_t ch;
+
+	ChI &= 0xF0;
+	ChQ &= 0xF0;
+	if(ChI == 0 || ChQ == 0 || (ChI & ChQ) || (ChI & (ChI - 1)) || (ChQ & (ChQ - 1)))
+	{
+		return 0;
+	}
+	for(ch=0; ch<4; ch++)
+	{
+		if(ChI & (0x10 << ch))
+		{
+			phase[ch] = 90000;
+		}
+	}
+	return ad9959_phase_group(ChI | ChQ, Freq, phase, Asf, NULL);
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_Select(uint8_t Channel)
+** 函数功能 ：CSR没有选中Channel时写一次CSR
+**************************************************************/
+void AD9959_Select(uint8_t Channel)
+{
+	uint8_t CHANNEL[1];
+
+	if((AD9959_Shadow.CSR & 0xF0) != (Channel & 0xF0))
+	{
+		CHANNEL[0] = Channel;
+		AD9959_WriteData(CSR_ADD,1,CHANNEL);
+	}
+}
+
+/************************************************************
+** 函数名称 ：uint8_t AD9959_ReadReg(uint8_t Channel, uint8_t addr, uint32_t *value)
+** 函数功能 ：读回芯片寄存器(缓冲寄存器)的值
+** 入口参数 ：Channel:  通道寄存器读Channel中编号最小的通道,需要时先写CSR;公共寄存器忽略
+							addr:			寄存器地址 CSR_ADD~0x18
+							value:		读回的值
+** 出口参数 ：0:成功 1:参数错误或通信方式不支持读
+** 函数说明 ：与定时器中断里的播放共用总线时要在关中断时调用
+**************************************************************/
+uint8_t AD9959_ReadReg(uint8_t Channel, uint8_t addr, uint32_t *value)
+{
+	uint8_t buf[4];
+	uint8_t i, n;
+
+	if(AD9959_Bus.Read == NULL || addr >= AD9959_REG_NUM || value == NULL)
+	{
+		return 1;
+	}
+	if(addr >= CFR_ADD)
+	{
+		for(i=0; i<4 && !(Channel & (0x10 << i)); i++);
+		if(i == 4)
+		{
+			return 1;
+		}
+		AD9959_Select(0x10 << i);
+	}
+	AD9959_BusWait();
+	n = AD9959_RegLen[addr];
+	AD9959_Bus.Read(addr | 0x80, buf, n);
+	for(*value = 0, i = 0; i < n; i++)
+	{
+		*value = (*value << 8) | buf[i];
+	}
+	return 0;
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_ProfilePins(uint8_t Channel, uint8_t Level)
+** 函数功能 ：设置Channel中各通道的Profile引脚,Level[7:4]为对应的电平
+**************************************************************/
+void AD9959_ProfilePins(uint8_t Channel, uint8_t Level)
+{
+	if(Channel & CH0)
+	{
+		PS0 = (Level & CH0) ? 1 : 0;
+	}
+	if(Channel & CH1)
+	{
+		PS1 = (Level & CH1) ? 1 : 0;
+	}
+	if(Channel & CH2)
+	{
+		PS2 = (Level & CH2) ? 1 : 0;
+	}
+	if(Channel & CH3)
+	{
+		PS3 = (Level & CH3) ? 1 : 0;
+	}
+}
+
+/************************************************************
+** 函数名称 ：void Write_CFTW0(uint32_t fre)
+** 函数功能 ：写CFTW0通道频率转换字寄存器
+** 入口参数 ： Freq:	写入频率，范围0~200 000 000 Hz
+** 出口参数 ：无
+** 函数说明 ：无
 **************************************************************/
 void Write_CFTW0(uint32_t fre)
 {
-		uint8_t CFTW0_DATA[4] ={0x00,0x00,0x00,0x00};	//м
+		uint8_t CFTW0_DATA[4] ={0x00,0x00,0x00,0x00};	//中间变量
 	  uint32_t Temp;            
-	  Temp=(uint32_t)fre*ACC_FRE_FACTOR;	 
+	  Temp=AD9959_HzToFtw(fre);	 
 	  CFTW0_DATA[3]=(uint8_t)Temp;
 	  CFTW0_DATA[2]=(uint8_t)(Temp>>8);
 	  CFTW0_DATA[1]=(uint8_t)(Temp>>16);
@@ -180,11 +908,11 @@ void Write_CFTW0(uint32_t fre)
 }
 
 /************************************************************
-**  void Write_ACR(uint16_t Ampli)
-**  дACRͨתּĴ
-** ڲ Ampli:    ,Χ0~1023ֵ0~1023Ӧ0~500mVpp
-** ڲ 
-** ˵ 
+** 函数名称 ：void Write_ACR(uint16_t Ampli)
+** 函数功能 ：写ACR通道幅度转换字寄存器
+** 入口参数 ：Ampli:    输出幅度,范围0~1023，控制值0~1023对应输出幅度0~500mVpp左右
+** 出口参数 ：无
+** 函数说明 ：无
 **************************************************************/
 void Write_ACR(uint16_t Ampli)
 { 
@@ -192,17 +920,17 @@ void Write_ACR(uint16_t Ampli)
 	uint8_t ACR_DATA[3] = {0x00,0x00,0x00};//default Value = 0x--0000 Rest = 18.91/Iout 
   A_temp=Ampli|0x1000;
 	
-	ACR_DATA[1] = (uint8_t)(A_temp>>8); //λ
-	ACR_DATA[2] = (uint8_t)A_temp;  //λ
-  AD9959_WriteData(ACR_ADD,3,ACR_DATA); //ACR address 0x06.CHn趨
+	ACR_DATA[1] = (uint8_t)(A_temp>>8); //高位数据
+	ACR_DATA[2] = (uint8_t)A_temp;  //低位数据
+  AD9959_WriteData(ACR_ADD,3,ACR_DATA); //ACR address 0x06.CHn设定幅度
 }
 
 /************************************************************
-**  void Write_CPOW0(uint16_t Phase)
-**  дCPOW0ͨλתּĴ
-** ڲ Phase:		λ,Χ0~16383(ӦǶȣ0~360)
-** ڲ 
-** ˵ 
+** 函数名称 ：void Write_CPOW0(uint16_t Phase)
+** 函数功能 ：写CPOW0通道相位转换字寄存器
+** 入口参数 ：Phase:		输出相位,范围：0~16383(对应角度：0°~360°)
+** 出口参数 ：无
+** 函数说明 ：无
 **************************************************************/
 void Write_CPOW0(uint16_t Phase)
 {
@@ -210,37 +938,37 @@ void Write_CPOW0(uint16_t Phase)
 	CPOW0_data[1]=(uint8_t)Phase;
 	CPOW0_data[0]=(uint8_t)(Phase>>8);
 
-	AD9959_WriteData(CPOW0_ADD,2,CPOW0_data);//CPOW0 address 0x05.CHn趨λ
+	AD9959_WriteData(CPOW0_ADD,2,CPOW0_data);//CPOW0 address 0x05.CHn设定相位
 }
 
 /************************************************************
-**  void Write_LSRR(uint8_t rsrr,uint8_t fsrr)
-**  дLSRRɨбʼĴ
-** ڲ 	rsrr:	б,Χ0~255
-							fsrr:	½б,Χ0~255
-** ڲ 
-** ˵ 
+** 函数名称 ：void Write_LSRR(uint8_t rsrr,uint8_t fsrr)
+** 函数功能 ：写LSRR线性扫描斜率寄存器
+** 入口参数 ：	rsrr:	上升斜率,范围：0~255
+							fsrr:	下降斜率,范围：0~255
+** 出口参数 ：无
+** 函数说明 ：无
 **************************************************************/
 void Write_LSRR(uint8_t rsrr,uint8_t fsrr)
 {
 	uint8_t LSRR_data[2]={0x00,0x00};
 
 	LSRR_data[1]=rsrr;	
-	LSRR_data[0]=fsrr;//8λ½б
+	LSRR_data[0]=fsrr;//高8位下降斜率
 
 	AD9959_WriteData(LSRR_ADD,2,LSRR_data);
 }
 
 /************************************************************
-**  void Write_RDW(uint32_t r_delta)
-**  дRDWĴ
-** ڲ r_delta:,0-4294967295
-** ڲ 
-** ˵ 
+** 函数名称 ：void Write_RDW(uint32_t r_delta)
+** 函数功能 ：写RDW上升增量寄存器
+** 入口参数 ：r_delta:上升增量,0-4294967295
+** 出口参数 ：无
+** 函数说明 ：无
 **************************************************************/
 void Write_RDW(uint32_t r_delta)
 {
-		uint8_t RDW_data[4] ={0x00,0x00,0x00,0x00};	//м          
+		uint8_t RDW_data[4] ={0x00,0x00,0x00,0x00};	//中间变量          
  
 	  RDW_data[3]=(uint8_t)r_delta;
 	  RDW_data[2]=(uint8_t)(r_delta>>8);
@@ -250,15 +978,15 @@ void Write_RDW(uint32_t r_delta)
 }
 
 /************************************************************
-**  void Write_FDW(uint32_t f_delta)
-**  дFDW½Ĵ
-** ڲ f_delta:½,0-4294967295
-** ڲ 
-** ˵ 
+** 函数名称 ：void Write_FDW(uint32_t f_delta)
+** 函数功能 ：写FDW下降增量寄存器
+** 入口参数 ：f_delta:下降增量,0-4294967295
+** 出口参数 ：无
+** 函数说明 ：无
 **************************************************************/
 void Write_FDW(uint32_t f_delta)
 {
-		uint8_t FDW_data[4] ={0x00,0x00,0x00,0x00};	//м          
+		uint8_t FDW_data[4] ={0x00,0x00,0x00,0x00};	//中间变量          
  
 	  FDW_data[3]=(uint8_t)f_delta;
 	  FDW_data[2]=(uint8_t)(f_delta>>8);
@@ -268,19 +996,19 @@ void Write_FDW(uint32_t f_delta)
 }
 
 /************************************************************
-**  void Write_Profile_Fre(uint8_t profile,uint32_t data)
-**  дProfileĴ
-** ڲ profile:	profile(0~14)
-							data:	дƵʣΧ0~200 000 000 Hz
-** ڲ 
-** ˵ 
+** 函数名称 ：void Write_Profile_Fre(uint8_t profile,uint32_t data)
+** 函数功能 ：写Profile寄存器
+** 入口参数 ：profile:	profile号(0~14)
+							data:	写入频率，范围0~200 000 000 Hz
+** 出口参数 ：无
+** 函数说明 ：无
 **************************************************************/
 void Write_Profile_Fre(uint8_t profile,uint32_t data)
 {
 		uint8_t profileAddr;
-		uint8_t Profile_data[4] ={0x00,0x00,0x00,0x00};	//м
+		uint8_t Profile_data[4] ={0x00,0x00,0x00,0x00};	//中间变量
 	  uint32_t Temp;            
-	  Temp=(uint32_t)data*ACC_FRE_FACTOR;	   //ƵӷΪĸֽ  4.294967296=(2^32)/500000000
+	  Temp=AD9959_HzToFtw(data);	   //将输入频率因子分为四个字节
 	  Profile_data[3]=(uint8_t)Temp;
 	  Profile_data[2]=(uint8_t)(Temp>>8);
 	  Profile_data[1]=(uint8_t)(Temp>>16);
@@ -290,117 +1018,111 @@ void Write_Profile_Fre(uint8_t profile,uint32_t data)
 		AD9959_WriteData(profileAddr,4,Profile_data);
 }
 /************************************************************
-**  void Write_Profile_Ampli(uint8_t profile,uint16_t data)
-**  дProfileĴ
-** ڲ profile:	profile(0~14)
-							data:	 д,Χ0~1023
-** ڲ 
-** ˵ 
+** 函数名称 ：void Write_Profile_Ampli(uint8_t profile,uint16_t data)
+** 函数功能 ：写Profile寄存器
+** 入口参数 ：profile:	profile号(0~14)
+							data:	 写入幅度,范围0~1023，
+** 出口参数 ：无
+** 函数说明 ：无
 **************************************************************/
 void Write_Profile_Ampli(uint8_t profile,uint16_t data)
 {
 		uint8_t profileAddr;
-		uint8_t Profile_data[4] ={0x00,0x00,0x00,0x00};	//м
+		uint8_t Profile_data[4] ={0x00,0x00,0x00,0x00};	//中间变量
 
-		//ΪȵʱΪ[31:22]λ
+		//为幅度调制时幅度数据为[31:22]位
 	  Profile_data[1]=(uint8_t)(data<<6);//[23:22]
 	  Profile_data[0]=(uint8_t)(data>>2);//[31:24]
 		
 		profileAddr = PROFILE_ADDR_BASE + profile;
 		
-		AD9959_WriteData(profileAddr,4,Profile_data);//д32λ
+		AD9959_WriteData(profileAddr,4,Profile_data);//写入32位数据
 }
 /************************************************************
-**  void Write_Profile_Phase(uint8_t profile,uint16_t data)
-**  дProfileĴ
-** ڲ profile:	profile(0~14)
-							data:	 дλ,Χ0~16383
-** ڲ 
-** ˵ 
+** 函数名称 ：void Write_Profile_Phase(uint8_t profile,uint16_t data)
+** 函数功能 ：写Profile寄存器
+** 入口参数 ：profile:	profile号(0~14)
+							data:	 写入相位,范围：0~16383
+** 出口参数 ：无
+** 函数说明 ：无
 **************************************************************/
 void Write_Profile_Phase(uint8_t profile,uint16_t data)
 {
 		uint8_t profileAddr;
-		uint8_t Profile_data[4] ={0x00,0x00,0x00,0x00};	//м
+		uint8_t Profile_data[4] ={0x00,0x00,0x00,0x00};	//中间变量
 
-		//ΪλʱλΪ[31:18]λ
+		//为相位调制时相位数据为[31:18]位
 	  Profile_data[1]=(uint8_t)(data<<2);//[23:18]
 	  Profile_data[0]=(uint8_t)(data>>6);//[31:24]
 		
 		profileAddr = PROFILE_ADDR_BASE + profile;
 		
-		AD9959_WriteData(profileAddr,4,Profile_data);//д32λ
+		AD9959_WriteData(profileAddr,4,Profile_data);//写入32位数据
 }
 
 
 
 /************************************************************
-**  void AD9959_Set_Fre(uint8_t Channel,uint32_t Freq)
-**  ͨƵ
-** ڲ Channel:  ͨ  CH0-CH3
-						 Freq:     ƵʣΧ0~200 000 000 Hz
-** ڲ 
-** ˵ 
+** 函数名称 ：void AD9959_Set_Fre(uint8_t Channel,uint32_t Freq)
+** 函数功能 ：设置通道的输出频率
+** 入口参数 ：Channel:  输出通道  CH0-CH3
+						 Freq:     输出频率，范围0~200 000 000 Hz
+** 出口参数 ：无
+** 函数说明 ：无
 **************************************************************/
 void AD9959_Set_Fre(uint8_t Channel,uint32_t Freq)
 {	 
-		uint8_t CHANNEL[1] = {0x00};
-		
-		CHANNEL[0]=Channel;
-		AD9959_WriteData(CSR_ADD,1,CHANNEL);//ƼĴдCHnͨѡCHn
-    Write_CFTW0(Freq);//CHn趨Ƶ																																			 
+	AD9959_Stage_Fre(Channel, Freq);
+	AD9959_Flush();					//值没有变化时不写
+	AD9959_Select(Channel);	//保持原来的行为:返回时CSR选中CHn
 } 
 
 /************************************************************
-**  void AD9959_Set_Amp(uint8_t Channel, uint16_t Ampli)
-**  ͨ
-** ڲ Channel:  ͨ CH0-CH3
-							Ampli:    ,Χ0~1023ֵ0~1023Ӧ0~500mVpp
-** ڲ 
-** ˵ 
+** 函数名称 ：void AD9959_Set_Amp(uint8_t Channel, uint16_t Ampli)
+** 函数功能 ：设置通道的输出幅度
+** 入口参数 ：Channel:  输出通道 CH0-CH3
+							Ampli:    输出幅度,范围0~1023，控制值0~1023对应输出幅度0~500mVpp左右
+** 出口参数 ：无
+** 函数说明 ：无
 **************************************************************/
 void AD9959_Set_Amp(uint8_t Channel, uint16_t Ampli)
 { 
-	uint8_t CHANNEL[1] = {0x00};
-
-	CHANNEL[0]=Channel;
-	AD9959_WriteData(CSR_ADD,1,CHANNEL); //ƼĴдCHnͨѡCHn
-	Write_ACR(Ampli);							//	CHn趨
+	AD9959_Stage_Amp(Channel, Ampli);
+	AD9959_Flush();
+	AD9959_Select(Channel);
 }
 
 /************************************************************
-**  void AD9959_Set_Phase(uint8_t Channel,uint16_t Phase)
-**  ͨλ
-** ڲ Channel:  ͨ CH0-CH3
-							Phase:		λ,Χ0~16383(ӦǶȣ0~360)
-** ڲ 
-** ˵ 
+** 函数名称 ：void AD9959_Set_Phase(uint8_t Channel,uint16_t Phase)
+** 函数功能 ：设置通道的输出相位
+** 入口参数 ：Channel:  输出通道 CH0-CH3
+							Phase:		输出相位,范围：0~16383(对应角度：0°~360°)
+** 出口参数 ：无
+** 函数说明 ：无
 **************************************************************/
 void AD9959_Set_Phase(uint8_t Channel,uint16_t Phase)
 {
-	uint8_t CHANNEL[1] = {0x00};
-	CHANNEL[0]=Channel;
-
-	AD9959_WriteData(CSR_ADD,1,CHANNEL); //ƼĴдCHnͨѡCHn
-	Write_CPOW0(Phase);//CHn趨λ
+	AD9959_Stage_Phase(Channel, Phase);
+	AD9959_Flush();
+	AD9959_Select(Channel);
 }
 
 /************************************************************
-**  void AD9959_Modulation_Init(uint8_t Channel,uint8_t Modulation,uint8_t Sweep_en,uint8_t Nlevel)
-**  øͨĵģʽ
-** ڲ  Channel:  	ͨ CH0-CH3
-							Modulation:	ģʽDISABLE_ModASKFSKPSK
-							Sweep_en:		ɨģʽ SWEEP_ENABLEáSWEEP_DISABLEãʱNlevelֻLEVEL_MOD_2
-							Nlevel		Ƶƽѡ LEVEL_MOD_24816
-** ڲ 
-** ˵ 罫ƵƽΪ2ƽʱӦP0-P3ϵĸߵ͵ƽֱCH0-CH3ͨ(ӦͨĻ)
-							罫ƵƽΪ4ƽʱӦP0P1P2,P3ϵĸߵ͵ƽֱCH0-CH1ͨ(ӦͨĻ)
-							AD9959ֻP0-P3,4ڵƿƵţ4ƽʱֻ2ͨͬʱΪ
-							8ƽ16ƽʱֻ1ͨͬʱΪʵüƽӦ
+** 函数名称 ：void AD9959_Modulation_Init(uint8_t Channel,uint8_t Modulation,uint8_t Sweep_en,uint8_t Nlevel)
+** 函数功能 ：设置各个通道的调制模式。
+** 入口参数 ： Channel:  	输出通道 CH0-CH3
+							Modulation:	调制模式DISABLE_Mod，ASK，FSK，PSK
+							Sweep_en:		线性扫描模式 SWEEP_ENABLE启用、SWEEP_DISABLE不启用；启用时Nlevel只能是LEVEL_MOD_2
+							Nlevel：		调制电平选择 LEVEL_MOD_2、4、8、16
+** 出口参数 ：无
+** 函数说明 ：如将调制电平设置为2电平调制时，对应的P0-P3引脚上的高低电平分别控制CH0-CH3通道(如果对应通道开启的话)
+							如将调制电平设置为4电平调制时，对应的P0，P1和P2,P3引脚上的高低电平分别控制CH0-CH1通道(如果对应通道开启的话)
+							由于AD9959只有P0-P3,4个用于调制控制的引脚，因此输出在4电平调制时，只能有2个通道同时设置为调制输出；
+							8电平和16电平调制时，只能有1个通道同时设置为调制输出。请适当设置几电平调制以满足应用需求。
 
-**ע⣡ó4ƽʱֻͨѡCH0-1
-							ó8,16ƽʱֻͨѡCH0
-							δͨݣ巽οAD9959оƬֲ22-23ҳFR1[14:12]ΪӦֵ
+**注意！！！：设置成4电平调制时，输出通道只能选择CH0-1
+							设置成8,16电平调制时，输出通道只能选择CH0
+							本函数未做任意通道兼容，具体方法请参考AD9959芯片手册22-23页，操作FR1[14:12]为对应值。
 **************************************************************/
 void AD9959_Modulation_Init(uint8_t Channel,uint8_t Modulation,uint8_t Sweep_en,uint8_t Nlevel)
 {
@@ -409,7 +1131,7 @@ void AD9959_Modulation_Init(uint8_t Channel,uint8_t Modulation,uint8_t Sweep_en,
 	uint8_t FR1_data[3];
 	uint8_t FR2_data[2];
 	uint8_t CFR_data[3];
-	for(i=0;i<3;i++)//Ĭֵ
+	for(i=0;i<3;i++)//设置默认值
 	{
 		FR1_data[i]=FR1_DATA[i];
 		CFR_data[i]=CFR_DATA[i];
@@ -418,30 +1140,30 @@ void AD9959_Modulation_Init(uint8_t Channel,uint8_t Modulation,uint8_t Sweep_en,
 	FR2_data[1]=FR2_DATA[1];
 		
 	CHANNEL[0]=Channel;
-	AD9959_WriteData(CSR_ADD,1,CHANNEL); //ƼĴдCHnͨѡCHnþCHn
+	AD9959_WriteData(CSR_ADD,1,CHANNEL); //控制寄存器写入CHn通道，选择CHn；以下设置均针对CHn
 	
 	FR1_data[1]=Nlevel;
 	CFR_data[0]=Modulation;
 	CFR_data[1]|=Sweep_en;
 	CFR_data[2]=0x00;
 
-	if(Channel!=0)//ͨʹ
+	if(Channel!=0)//有通道被使能
 	{
-		AD9959_WriteData(FR1_ADD,3,FR1_data);//дܼĴ1
-		AD9959_WriteData(FR2_ADD,2,FR2_data);//дܼĴ1
-		AD9959_WriteData(CFR_ADD,3,CFR_data);//дܼͨĴ
+		AD9959_WriteData(FR1_ADD,3,FR1_data);//写功能寄存器1
+		AD9959_WriteData(FR2_ADD,2,FR2_data);//写功能寄存器1
+		AD9959_WriteData(CFR_ADD,3,CFR_data);//写通道功能寄存器
 	}
 }
 
 
 /************************************************************
-**  void AD9959_SetFSK(uint8_t Channel, uint32_t *data,uint16_t Phase)
-**  FSKƵĲ
-** ڲ Channel:  ͨ CH0-CH3
-							*data:	Ƶݵʼַ
-							Phase:	λ,Χ0~16383(ӦǶȣ0~360)
-** ڲ 
-** ˵ FSKʱźŷĬΪ
+** 函数名称 ：void AD9959_SetFSK(uint8_t Channel, uint32_t *data,uint16_t Phase)
+** 函数功能 ：设置FSK调制的参数
+** 入口参数 ：Channel:  输出通道 CH0-CH3
+							*data:	调整频率数据的起始地址
+							Phase:	输出相位,范围：0~16383(对应角度：0°~360°)
+** 出口参数 ：无
+** 函数说明 ：FSK时信号幅度默认为最大
 **************************************************************/
 void AD9959_SetFSK(uint8_t Channel, uint32_t *data,uint16_t Phase)
 {
@@ -449,8 +1171,8 @@ void AD9959_SetFSK(uint8_t Channel, uint32_t *data,uint16_t Phase)
 	uint8_t CHANNEL[1]={0x00};	
 	
 	CHANNEL[0]=Channel;
-	AD9959_WriteData(CSR_ADD,1,CHANNEL); //ƼĴдCHnͨѡCHnþCHn
-	Write_CPOW0(Phase);//λ
+	AD9959_WriteData(CSR_ADD,1,CHANNEL); //控制寄存器写入CHn通道，选择CHn；以下设置均针对CHn
+	Write_CPOW0(Phase);//设置相位
 	
 	Write_CFTW0(data[0]);
 	for(i=0;i<15;i++)
@@ -458,14 +1180,14 @@ void AD9959_SetFSK(uint8_t Channel, uint32_t *data,uint16_t Phase)
 }
 
 /************************************************************
-**  void AD9959_SetASK(uint8_t Channel, uint32_t *data,uint32_t fre,uint16_t Phase)
-**  ASKƵĲ
-** ڲ Channel:  ͨ CH0-CH3
-							*data: ݵʼַ
-							Freq:		ƵʣΧ0~200 000 000 Hz
-							Phase:	λ,Χ0~16383(ӦǶȣ0~360)
-** ڲ 
-** ˵ 
+** 函数名称 ：void AD9959_SetASK(uint8_t Channel, uint32_t *data,uint32_t fre,uint16_t Phase)
+** 函数功能 ：设置ASK调制的参数
+** 入口参数 ：Channel:  输出通道 CH0-CH3
+							*data: 调整幅度数据的起始地址
+							Freq:		输出频率，范围0~200 000 000 Hz
+							Phase:	输出相位,范围：0~16383(对应角度：0°~360°)
+** 出口参数 ：无
+** 函数说明 ：无
 **************************************************************/
 void AD9959_SetASK(uint8_t Channel, uint16_t *data,uint32_t fre,uint16_t Phase)
 {
@@ -473,9 +1195,9 @@ void AD9959_SetASK(uint8_t Channel, uint16_t *data,uint32_t fre,uint16_t Phase)
 	uint8_t CHANNEL[1]={0x00};	
 	
 	CHANNEL[0]=Channel;
-	AD9959_WriteData(CSR_ADD,1,CHANNEL); //ƼĴдCHnͨѡCHnþCHn
-	Write_CFTW0(fre);//Ƶ
-	Write_CPOW0(Phase);//λ
+	AD9959_WriteData(CSR_ADD,1,CHANNEL); //控制寄存器写入CHn通道，选择CHn；以下设置均针对CHn
+	Write_CFTW0(fre);//设置频率
+	Write_CPOW0(Phase);//设置相位
 	
 	Write_ACR(data[0]);
 	for(i=0;i<15;i++)
@@ -483,13 +1205,13 @@ void AD9959_SetASK(uint8_t Channel, uint16_t *data,uint32_t fre,uint16_t Phase)
 }
 
 /************************************************************
-**  void AD9959_SetPSK(uint8_t Channel, uint16_t *data,uint32_t fre,uint16_t Phase)
-**  PSKƵĲ
-** ڲ Channel:  ͨ CH0-CH3
-							*data:	λݵʼַ
-							Freq:		ƵʣΧ0~200 000 000 Hz
-** ڲ 
-** ˵ 
+** 函数名称 ：void AD9959_SetPSK(uint8_t Channel, uint16_t *data,uint32_t fre,uint16_t Phase)
+** 函数功能 ：设置PSK调制的参数
+** 入口参数 ：Channel:  输出通道 CH0-CH3
+							*data:	调整相位数据的起始地址
+							Freq:		输出频率，范围0~200 000 000 Hz
+** 出口参数 ：无
+** 函数说明 ：无
 **************************************************************/
 void AD9959_SetPSK(uint8_t Channel, uint16_t *data,uint32_t Freq)
 {
@@ -497,7 +1219,7 @@ void AD9959_SetPSK(uint8_t Channel, uint16_t *data,uint32_t Freq)
 	uint8_t CHANNEL[1]={0x00};	
 	
 	CHANNEL[0]=Channel;
-	AD9959_WriteData(CSR_ADD,1,CHANNEL); //ƼĴдCHnͨѡCHnþCHn
+	AD9959_WriteData(CSR_ADD,1,CHANNEL); //控制寄存器写入CHn通道，选择CHn；以下设置均针对CHn
 	Write_CFTW0(Freq);
 	
 	Write_CPOW0(data[0]);
@@ -506,21 +1228,21 @@ void AD9959_SetPSK(uint8_t Channel, uint16_t *data,uint32_t Freq)
 }
 
 /************************************************************
-**  void AD9959_SetFre_Sweep(uint8_t Channel, uint32_t s_data,uint32_t e_data,uint8_t fsrr,uint8_t rsrr,uint32_t r_delta,uint32_t f_delta,uint16_t Phase)
-**  ɨƵĲ
-** ڲ Channel:  ͨ CH0-CH3
-							s_data:	ʼƵʣΧ0~200 000 000 Hz
-							e_data:	ƵʣΧ0~200 000 000 Hz
-							r_delta:Ƶ,0~200 000 000Hz
-							f_delta:½Ƶ,0~200 000 000Hz
+** 函数名称 ：void AD9959_SetFre_Sweep(uint8_t Channel, uint32_t s_data,uint32_t e_data,uint8_t fsrr,uint8_t rsrr,uint32_t r_delta,uint32_t f_delta,uint16_t Phase)
+** 函数功能 ：设置线性扫频的参数
+** 入口参数 ：Channel:  输出通道 CH0-CH3
+							s_data:	起始频率，范围0~200 000 000 Hz
+							e_data:	结束频率，范围0~200 000 000 Hz
+							r_delta:上升步长频率,0~200 000 000Hz
+							f_delta:下降步长频率,0~200 000 000Hz
 
-							rsrr:		б,Χ1~255ϵͳʱΪ500MhzʱһԼΪ8ns
-							fsrr:		½б,Χ1~255
-							Ampli:	,Χ0~1023ֵ0~1023Ӧ0~500mVpp
-							Phase:	λ,Χ0~16383(ӦǶȣ0~360)
-** ڲ 
-** ˵ ƵƵͣʱ dT = Xsrr*8 λnsɨ=(ʼ-)/
-							ɨƵʱ=ɨƵ*dT
+							rsrr:		上升斜率,范围：1~255，系统时钟为500Mhz时一个控制字约为8ns
+							fsrr:		下降斜率,范围：1~255
+							Ampli:	输出幅度,范围0~1023，控制值0~1023对应输出幅度0~500mVpp左右
+							Phase:	输出相位,范围：0~16383(对应角度：0°~360°)
+** 出口参数 ：无
+** 函数说明 ：频点与频点间停留时间 dT = Xsrr*8 单位ns，扫描点数=(起始-结束)/步长
+							扫频总时间=总扫描频点数*dT
 **************************************************************/
 void AD9959_SetFre_Sweep(uint8_t Channel, uint32_t s_data,uint32_t e_data,uint32_t r_delta,uint32_t f_delta,uint8_t rsrr,uint8_t fsrr,uint16_t Ampli,uint16_t Phase)
 {
@@ -528,41 +1250,41 @@ void AD9959_SetFre_Sweep(uint8_t Channel, uint32_t s_data,uint32_t e_data,uint32
 	uint32_t Fer_data=0;            
 	
 	CHANNEL[0]=Channel;
-	AD9959_WriteData(CSR_ADD,1,CHANNEL); //ƼĴдCHnͨѡCHnþCHn
+	AD9959_WriteData(CSR_ADD,1,CHANNEL); //控制寄存器写入CHn通道，选择CHn；以下设置均针对CHn
 	
-	Write_CPOW0(Phase);//λ
-	Write_ACR(Ampli); //
+	Write_CPOW0(Phase);//设置相位
+	Write_ACR(Ampli); //幅度设置
 	
-	Write_LSRR(rsrr,fsrr);//б
+	Write_LSRR(rsrr,fsrr);//斜率
 	
-	Fer_data=(uint32_t)r_delta*ACC_FRE_FACTOR;	 //Ƶתɿ
-	Write_RDW(Fer_data);//
+	Fer_data=AD9959_HzToFtw(r_delta);	 //频率转换成控制字
+	Write_RDW(Fer_data);//上升步长
 	
-	Fer_data=(uint32_t)f_delta*ACC_FRE_FACTOR;
-	Write_FDW(Fer_data);//½
+	Fer_data=AD9959_HzToFtw(f_delta);
+	Write_FDW(Fer_data);//下降步长
 	
-	Write_CFTW0(s_data);//ʼƵ
-	Write_Profile_Fre(0, e_data);//Ƶ
+	Write_CFTW0(s_data);//起始频率
+	Write_Profile_Fre(0, e_data);//结束频率
 }
 
 /************************************************************
-**  void AD9959_SetAmp_Sweep(uint8_t Channel, uint32_t s_Ampli,uint16_t e_Ampli,uint32_t r_delta,uint32_t f_delta,uint8_t rsrr,uint8_t fsrr,uint32_t fre,uint16_t Phase)
-**  ɨĲ
-** ڲ Channel:  ͨ CH0-CH3
-							s_Ampli:	ʼȣֵ0~1023Ӧ0~500mVpp
-							e_Ampli:	ȣ
+** 函数名称 ：void AD9959_SetAmp_Sweep(uint8_t Channel, uint32_t s_Ampli,uint16_t e_Ampli,uint32_t r_delta,uint32_t f_delta,uint8_t rsrr,uint8_t fsrr,uint32_t fre,uint16_t Phase)
+** 函数功能 ：设置线性扫幅的参数
+** 入口参数 ：Channel:  输出通道 CH0-CH3
+							s_Ampli:	起始幅度，控制值0~1023对应输出幅度0~500mVpp左右
+							e_Ampli:	结束幅度，
 							
-							r_delta:	,0~1023
-							f_delta:	½,0~1023
+							r_delta:	上升步长幅度,0~1023
+							f_delta:	下降步长幅度,0~1023
 
-							rsrr:			б,Χ1~255ϵͳʱΪ500MhzʱһԼΪ8ns
-							fsrr:			½б,Χ1~255
+							rsrr:			上升斜率,范围：1~255，系统时钟为500Mhz时一个控制字约为8ns
+							fsrr:			下降斜率,范围：1~255
 
-							fre:			ƵʣΧ0~200 000 000 Hz
-							Phase:		λ,Χ0~16383(ӦǶȣ0~360)
-** ڲ 
-** ˵ ͣʱ dT = Xsrr*8 λnsɨ=(ʼ-)/
-							ɨʱ=ɨ*dT
+							fre:			输出频率，范围0~200 000 000 Hz
+							Phase:		输出相位,范围：0~16383(对应角度：0°~360°)
+** 出口参数 ：无
+** 函数说明 ：幅点与幅点间停留时间 dT = Xsrr*8 单位ns；扫描点数=(起始-结束)/步长
+							扫幅总时间=总扫描幅点数*dT
 **************************************************************/
 void AD9959_SetAmp_Sweep(uint8_t Channel, uint32_t s_Ampli,uint16_t e_Ampli,uint32_t r_delta,uint32_t f_delta,uint8_t rsrr,uint8_t fsrr,uint32_t fre,uint16_t Phase)
 {
@@ -570,60 +1292,60 @@ void AD9959_SetAmp_Sweep(uint8_t Channel, uint32_t s_Ampli,uint16_t e_Ampli,uint
 	uint8_t ACR_data[3] = {0x00,0x00,0x00};
 		
 	CHANNEL[0]=Channel;
-	AD9959_WriteData(CSR_ADD,1,CHANNEL); //ƼĴдCHnͨѡCHnþCHn
+	AD9959_WriteData(CSR_ADD,1,CHANNEL); //控制寄存器写入CHn通道，选择CHn；以下设置均针对CHn
 	
-	Write_CFTW0(fre); //Ƶ
-	Write_CPOW0(Phase);//λ
+	Write_CFTW0(fre); //幅度频率
+	Write_CPOW0(Phase);//设置相位
 	
-	Write_LSRR(rsrr,fsrr);//б
+	Write_LSRR(rsrr,fsrr);//斜率
 	
-	Write_RDW(r_delta<<22);//
+	Write_RDW(r_delta<<22);//上升步长
 	
-	Write_FDW(f_delta<<22);//½
+	Write_FDW(f_delta<<22);//下降步长
 
-	ACR_data[1] = (uint8_t)(s_Ampli>>8); //λ
-	ACR_data[2] = (uint8_t)s_Ampli;  //λ
-  AD9959_WriteData(ACR_ADD,3,ACR_data); //ACR 趨ʼ
+	ACR_data[1] = (uint8_t)(s_Ampli>>8); //高位数据
+	ACR_data[2] = (uint8_t)s_Ampli;  //低位数据
+  AD9959_WriteData(ACR_ADD,3,ACR_data); //ACR 设定起始幅度
 					
-	Write_Profile_Ampli(0, e_Ampli);//
+	Write_Profile_Ampli(0, e_Ampli);//结束幅度
 }
 
 
 /************************************************************
-**  void AD9959_SetPhase_Sweep(uint8_t Channel, uint16_t s_data,uint16_t e_data,uint16_t r_delta,uint16_t f_delta,uint8_t rsrr,uint8_t fsrr,uint32_t fre,uint16_t Ampli)
-**  ɨĲ
-** ڲ Channel:  ͨ CH0-CH3
-							s_data:	ʼλΧ0~16383(ӦǶȣ0~360)
-							e_data:	λ
-							r_delta:,Χ0~16383(ӦǶȣ0~360)
-							f_delta:½,
+** 函数名称 ：void AD9959_SetPhase_Sweep(uint8_t Channel, uint16_t s_data,uint16_t e_data,uint16_t r_delta,uint16_t f_delta,uint8_t rsrr,uint8_t fsrr,uint32_t fre,uint16_t Ampli)
+** 函数功能 ：设置线性扫相的参数
+** 入口参数 ：Channel:  输出通道 CH0-CH3
+							s_data:	起始相位，范围：0~16383(对应角度：0°~360°)
+							e_data:	结束相位，
+							r_delta:上升步长,范围：0~16383(对应角度：0°~360°)
+							f_delta:下降步长,
 
-							rsrr:		б,Χ1~255ϵͳʱΪ500MhzʱһԼΪ8ns
-							fsrr:		½б,Χ1~255
-							fre:		ƵʣΧ0~200 000 000 Hz
-							Ampli:	,Χ0~1023ֵ0~1023Ӧ0~500mVpp
-** ڲ 
-** ˵ ƵƵͣʱ dT = Xsrr*8 λnsɨ=(ʼ-)/
-							ɨƵʱ=ɨƵ*dT
+							rsrr:		上升斜率,范围：1~255，系统时钟为500Mhz时一个控制字约为8ns
+							fsrr:		下降斜率,范围：1~255
+							fre:		输出频率，范围0~200 000 000 Hz
+							Ampli:	输出幅度,范围0~1023，控制值0~1023对应输出幅度0~500mVpp左右
+** 出口参数 ：无
+** 函数说明 ：频点与频点间停留时间 dT = Xsrr*8 单位ns；扫描点数=(起始-结束)/步长
+							扫频总时间=总扫描频点数*dT
 **************************************************************/
 void AD9959_SetPhase_Sweep(uint8_t Channel, uint16_t s_data,uint16_t e_data,uint16_t r_delta,uint16_t f_delta,uint8_t rsrr,uint8_t fsrr,uint32_t fre,uint16_t Ampli)
 {
 	uint8_t CHANNEL[1]={0x00};
 	
 	CHANNEL[0]=Channel;
-	AD9959_WriteData(CSR_ADD,1,CHANNEL); //ƼĴдCHnͨѡCHnþCHn
+	AD9959_WriteData(CSR_ADD,1,CHANNEL); //控制寄存器写入CHn通道，选择CHn；以下设置均针对CHn
 	
-	Write_CFTW0(fre); //Ƶ
-	Write_ACR(Ampli); //
+	Write_CFTW0(fre); //幅度频率
+	Write_ACR(Ampli); //幅度设置
 	
-	Write_LSRR(rsrr,fsrr);//б
+	Write_LSRR(rsrr,fsrr);//斜率
 	
-	Write_RDW(r_delta<<18);//
+	Write_RDW(r_delta<<18);//上升步长
 	
-	Write_FDW(f_delta<<18);//½
+	Write_FDW(f_delta<<18);//下降步长
 	
-	Write_CPOW0(s_data);//ʼλ
-	Write_Profile_Phase(0, e_data);//λ
+	Write_CPOW0(s_data);//起始相位
+	Write_Profile_Phase(0, e_data);//结束相位
 }
 
 
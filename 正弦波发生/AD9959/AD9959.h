@@ -1,9 +1,13 @@
 #ifndef _AD9959_H_
 #define _AD9959_H_
+#if defined(AD9959_HOST)
+#include "ad9959_host_hal.h"		//在Linux主机上运行,见 tools/ 目录
+#else
 #include "sys.h"
+#endif
 #include "stdint.h"
 
-//AD9959ܽź궨
+//AD9959管脚宏定义
 #define CS			PFout(6)
 #define SCLK		PBout(1)
 #define UPDATE	PBout(0)
@@ -17,85 +21,356 @@
 #define SDIO1		PBout(4)
 #define SDIO2		PBout(3)
 #define SDIO3		PFout(8)
+#define SDIO0_IN	PBin(5)		//读寄存器时SDIO0作输入
 
 #define AD9959_PWR	PBout(12)
 #define Reset		PBout(13)
 
-//AD9959Ĵַ
-#define CSR_ADD   0x00   //CSR ͨѡĴ
-#define FR1_ADD   0x01   //FR1 ܼĴ1
-#define FR2_ADD   0x02   //FR2 ܼĴ2
-#define CFR_ADD   0x03   //CFR ܼͨĴ
+//AD9959通信方式,编译时选择(工程里定义AD9959_BUS或直接修改这里),实现见AD9959_Bus.c
+#define AD9959_BUS_SOFT			0	//模拟SPI单线,原接线 SCLK:PB1 SDIO0:PB5
+#define AD9959_BUS_SPI			1	//硬件SPI单线+DMA,SCLK接SPI_SCK,SDIO0接SPI_MOSI(如SPI1 PA5/PA7),CS仍为PF6
+#define AD9959_BUS_QSPI			2	//QUADSPI四线(F446/F469等),CS接NCS,SCLK接CLK,SDIO0~3接IO0~3
+#define AD9959_BUS_PARALLEL	3	//GPIO四线,SCLK和SDIO0~3接同一个GPIO口
+#ifndef AD9959_BUS
+#define AD9959_BUS	AD9959_BUS_SOFT
+#endif
+
+#define AD9959_SPI					hspi1	//CubeMX:主机,8位,CPOL=Low,CPHA=1Edge,MSB先发,软件NSS,开TX DMA
+#define AD9959_QSPI					hqspi	//CubeMX:时钟模式0,CS高电平时间至少1个时钟,开DMA
+#define AD9959_QSPI_IO3_PORT	GPIOA	//QUADSPI的IO3(接SDIO3/SYNC_IO)所在GPIO口和引脚号,按实际接线修改
+#define AD9959_QSPI_IO3_PIN		1
+#define AD9959_SPI_DMA_MIN	8				//SPI/QSPI不少于这么多字节才走DMA,短帧直接发更快
+#define AD9959_TIM_TICKS_MAX	0x10000UL	//播放/扫描/调制流定时器一个周期最多的计数个数,基本定时器TIM6/TIM7的ARR为16位
+
+#define AD9959_PAR_PORT			GPIOB	//AD9959_BUS_PARALLEL用的GPIO口,板子上SDIO3在PF8,需改接到这个口
+#define AD9959_PAR_CLK_ENABLE()	__HAL_RCC_GPIOB_CLK_ENABLE()
+#define AD9959_PAR_SCLK			GPIO_PIN_1
+#define AD9959_PAR_SDIO0		GPIO_PIN_5
+#define AD9959_PAR_SDIO1		GPIO_PIN_4
+#define AD9959_PAR_SDIO2		GPIO_PIN_3
+#define AD9959_PAR_SDIO3		GPIO_PIN_6
+
+#define AD9959_BUS_BUF_LEN	128			//一帧最多字节数
+
+#define AD9959_REF_CLK						25000000	//参考时钟,Hz
+#define AD9959_PLL_MUL						20				//PLL倍频4~20,1为不用PLL
+#define AD9959_SYSCLK							(AD9959_REF_CLK * AD9959_PLL_MUL)	//系统时钟,运行中可用AD9959_ClockConfig修改
+#define AD9959_UPDATE_SYNC_CLKS		2					//IO_UPDATE高电平保持的SYNC_CLK(SYSCLK/4)周期数,手册要求至少1个
+#define AD9959_PLL_LOCK_US				1000			//改写FR1开启PLL后等待锁定的时间,us
+
+//AD9959寄存器地址定义
+#define CSR_ADD   0x00   //CSR 通道选择寄存器
+#define FR1_ADD   0x01   //FR1 功能寄存器1
+#define FR2_ADD   0x02   //FR2 功能寄存器2
+#define CFR_ADD   0x03   //CFR 通道功能寄存器
 
-#define CFTW0_ADD 0x04   //CTW0 ͨƵתּĴ
-#define CPOW0_ADD 0x05   //CPW0 ͨλתּĴ
-#define ACR_ADD   0x06   //ACR ȿƼĴ
+#define CFTW0_ADD 0x04   //CTW0 通道频率转换字寄存器
+#define CPOW0_ADD 0x05   //CPW0 通道相位转换字寄存器
+#define ACR_ADD   0x06   //ACR 幅度控制寄存器
 
-#define LSRR_ADD  0x07   //LSR ɨбʼĴ
-#define RDW_ADD   0x08   //RDW ɨĴ
-#define FDW_ADD   0x09   //FDW ½ɨĴ
+#define LSRR_ADD  0x07   //LSR 线性扫描斜率寄存器
+#define RDW_ADD   0x08   //RDW 上升扫描增量寄存器
+#define FDW_ADD   0x09   //FDW 下降扫描增量寄存器
 
-#define PROFILE_ADDR_BASE   0x0A   //ProfileĴ,ļĴʼַ
+#define PROFILE_ADDR_BASE   0x0A   //Profile寄存器,配置文件寄存器起始地址
+#define AD9959_REG_NUM			0x19	 //寄存器个数,地址0x00~0x18
 
-//CSR[7:4]ͨѡλ
+//CSR[2:1]串行模式,每次写CSR都要带上,由AD9959_WriteData自动补上
+#define CSR_MODE_1BIT_2WIRE	0x00	//单线,SDIO0双向
+#define CSR_MODE_4BIT				0x06	//四线,SDIO0~3
+
+//CSR[7:4]通道选择启用位
 #define CH0 0x10
 #define CH1 0x20
 #define CH2 0x40
 #define CH3 0x80
 
-//FR1[9:8] Ƶƽѡλ
-#define LEVEL_MOD_2  	0x00//2ƽ 2׵
-#define LEVEL_MOD_4		0x01//4ƽ	4׵
-#define LEVEL_MOD_8		0x02//8ƽ	8׵
-#define LEVEL_MOD_16	0x03//16ƽ	16׵
-
-//CFR[23:22]  ƵλAFPѡλ
-#define	DISABLE_Mod		0x00	//00	ѽ
-#define	ASK 					0x40	//01	ƣƼ
-#define	FSK 					0x80	//10	ƵʵƣƵƼ
-#define	PSK 					0xc0	//11	λƣƼ
-
-//CFR[14]ɨ sweep enable																				
-#define	SWEEP_ENABLE	0x40	//1	
-#define	SWEEP_DISABLE	0x00	//0	
+//FR1[9:8] 调制电平选择位
+#define LEVEL_MOD_2  	0x00//2电平调制 2阶调制
+#define LEVEL_MOD_4		0x01//4电平调制	4阶调制
+#define LEVEL_MOD_8		0x02//8电平调制	8阶调制
+#define LEVEL_MOD_16	0x03//16电平调制	16阶调制
+
+//CFR[23:22]  幅频相位（AFP）选择位
+#define	DISABLE_Mod		0x00	//00	调制已禁用
+#define	ASK 					0x40	//01	振幅调制，幅移键控
+#define	FSK 					0x80	//10	频率调制，频移键控
+#define	PSK 					0xc0	//11	相位调制，相移键控
+
+//CFR[2] 自动清相位累加器,IO_Update时清零
+#define CFR_AUTOCLR_PHASE	0x000004
+
+//CFR[13] IO_Update时重新装载扫描斜率计数器,扫描从更新时刻开始
+#define CFR_LOAD_SRR			0x002000
+
+//（CFR[14]）线性扫描启用 sweep enable																				
+#define	SWEEP_ENABLE	0x40	//1	启用
+#define	SWEEP_DISABLE	0x00	//0	不启用
 		
-void delay1 (uint32_t length);//ʱ
-void IntReset(void);	 			//AD9959λ
-void IO_Update(void); 		  //AD9959
-void Intserve(void);				//IOڵƽ״̬ʼ
-void AD9959_Init(void);			//IOڳʼ
-
-/***********************AD9959Ĵ*****************************************/
-void AD9959_WriteData(uint8_t RegisterAddress, uint8_t NumberofRegisters, uint8_t *RegisterData);//AD9959д
-void Write_CFTW0(uint32_t fre);										//дCFTW0ͨƵתּĴ
-void Write_ACR(uint16_t Ampli);										//дACRͨתּĴ
-void Write_CPOW0(uint16_t Phase);									//дCPOW0ͨλתּĴ
-
-void Write_LSRR(uint8_t rsrr,uint8_t fsrr);				//дLSRRɨбʼĴ
-void Write_RDW(uint32_t r_delta);									//дRDWĴ
-void Write_FDW(uint32_t f_delta);									//дFDW½Ĵ
-
-void Write_Profile_Fre(uint8_t profile,uint32_t data);//дProfileĴ,Ƶ
-void Write_Profile_Ampli(uint8_t profile,uint16_t data);//дProfileĴ,
-void Write_Profile_Phase(uint8_t profile,uint16_t data);//дProfileĴ,λ
+//通信方式接口,AD9959_Bus为编译时选中的实现
+typedef struct
+{
+	void (*Init)(void);															//初始化通信用的IO口/外设
+	uint8_t (*Setup)(void);													//AD9959复位后调用,四线方式在这里切换到四线模式,0:成功
+	uint8_t (*Start)(const uint8_t *data, uint16_t len);	//拉低CS发送一帧,DMA方式启动后立即返回,0:成功 1:外设报错
+	void (*Wait)(void);															//等待发送完成并拉高CS
+	void (*Read)(uint8_t instr, uint8_t *data, uint16_t len);	//发读指令再收len字节,NULL为不支持读
+	uint8_t CsrMode;																//写CSR时带上的串行模式位
+	const char *Name;
+}AD9959_Bus_t;
+
+extern const AD9959_Bus_t AD9959_Bus;
+
+//影子寄存器:记录写入芯片的值和暂存待写的值,FR1/FR2等公共寄存器记在通道0
+typedef struct
+{
+	uint8_t  CSR;															//CSR当前选中的通道[7:4]
+	uint32_t Reg[4][AD9959_REG_NUM];					//已写入芯片(缓冲寄存器)的值
+	uint32_t Stage[4][AD9959_REG_NUM];				//AD9959_Stage暂存的值
+	uint8_t  Pending;													//1:缓冲寄存器有还没IO_Update的写入
+	uint32_t Owned[4];												//按地址置位:正被调制流直接写入、影子寄存器跟不上的寄存器
+}AD9959_Shadow_t;
+
+extern AD9959_Shadow_t AD9959_Shadow;
+
+//时钟配置和频率换算用的倒数
+typedef struct
+{
+	uint32_t RefClk;			//参考时钟,Hz
+	uint8_t  PllMul;			//PLL倍频,1为不用PLL
+	uint32_t SysClk;			//系统时钟,Hz
+	uint64_t FtwRecip;		//2^64/SysClk
+	uint64_t FtwRecipMilli;	//2^64/(SysClk*1000)
+}AD9959_Clock_t;
+
+extern AD9959_Clock_t AD9959_Clock;
+
+//通道组设置的一个通道
+typedef struct
+{
+	uint64_t Freq;				//频率,mHz
+	int32_t  Phase;				//相位,千分之一度
+	uint16_t Asf;					//幅度比例因子0~1023,大于1023不修改幅度
+}AD9959_ChSet_t;
+extern const uint8_t AD9959_RegLen[AD9959_REG_NUM];	//各寄存器字节数
+
+//多相输出的板级校准:补偿各通道输出电路、走线的相位和幅度差,全0为不校准
+typedef struct
+{
+	int32_t  Phase[4];		//固定相位补偿,千分之一度,加到设定相位上
+	int16_t  Delay[4];		//该通道比参考多出的延迟,ps,补偿相位为360°*频率*延迟,随频率变化
+	int16_t  Gain[4];			//幅度补偿,千分比,0为不变,-20为减小2%
+}AD9959_PhaseCal_t;
+
+extern AD9959_PhaseCal_t AD9959_PhaseCal;
+
+//线性扫描计划,AD9959_SweepPlan计算,值都是寄存器格式
+typedef struct
+{
+	uint8_t  Param;				//扫描的参数FSK/PSK/ASK
+	uint8_t  Up;					//1:从低到高 0:从高到低
+	uint32_t S0;					//起点(低端),CFTW0/CPOW0/ACR格式
+	uint32_t E0;					//终点(高端),CW1格式(左对齐)
+	uint32_t Rdw;					//上升步长,左对齐
+	uint32_t Fdw;					//下降步长,左对齐
+	uint8_t  Rsrr;				//上升斜率,每步的SYNC_CLK数
+	uint8_t  Fsrr;				//下降斜率
+	uint32_t Steps;				//扫描步数
+	uint64_t Time;				//实际扫描时间,ns
+}AD9959_SweepPlan_t;
+
+//跳频播放表的一项,可以放在RAM或flash中
+typedef struct
+{
+	uint8_t  Channel;			//通道CH0~CH3的组合
+	uint32_t Ftw;					//频率控制字,用AD9959_HzToFtw等换算
+	uint16_t Pow;					//相位控制字0~16383
+	uint16_t Asf;					//幅度比例因子0~1023,AD9959_PLAY_UPDATE方式下大于1023不修改幅度
+	uint32_t Dwell;				//停留时间,定时器计数个数,2~AD9959_TIM_TICKS_MAX
+}AD9959_Hop_t;
+
+//跳频播放方式,FSK/PSK/ASK为用Profile引脚切换对应参数
+#define AD9959_PLAY_UPDATE	0x00	//IO_Update切换,频率、相位、幅度一起变
+
+//跳频播放统计,时间单位为CPU周期
+typedef struct
+{
+	uint32_t Hops;					//已切换的次数
+	uint32_t Loops;					//循环播放的圈数
+	int32_t  JitterMin;			//实际切换时刻与理想时刻之差,包含固定的中断延迟
+	int32_t  JitterMax;
+	uint64_t JitterAbsSum;	//|差值|累计,除以Hops为平均值
+	uint32_t PrefetchMax;		//准备下一项用的最长时间
+}AD9959_PlayerStats_t;
+
+//模拟调制流:样点按定时器的速率写入CFTW0(调频)或ACR(调幅)
+typedef struct
+{
+	uint8_t  Channel;			//通道CH0~CH3的组合,写入同样的值
+	uint8_t  Param;				//FSK:调频 ASK:调幅
+	uint32_t Carrier;			//FSK:载波频率控制字 ASK:载波幅度比例因子0~1023
+	uint32_t Depth;				//样点满幅(+-32767)对应的偏移,FSK:频偏控制字 ASK:幅度比例因子
+}AD9959_Mod_t;
+
+#define AD9959_STREAM_FRAME_MAX	5	//一个样点的帧最多字节数,调频5字节,调幅4字节
+
+//调制流统计,时间单位为CPU周期
+typedef struct
+{
+	uint32_t Samples;				//已生效的样点数
+	uint32_t Loops;					//循环的圈数
+	uint32_t Overruns;			//中断用时超过一个样点周期的次数,说明速率太高
+	uint32_t BusErrors;			//启动发送时外设报错、样点没有写入的次数
+	uint32_t FrameCycles;		//启动时实测的一帧发送加IO_Update用时,样点周期至少要比它长1/4
+	int32_t  JitterMin;			//实际更新时刻与理想时刻之差
+	int32_t  JitterMax;
+	uint64_t JitterAbsSum;
+	uint32_t IrqMax;				//中断最长用时
+	uint32_t Rate;					//实测更新率,Hz
+}AD9959_StreamStats_t;
+
+//寄存器核对统计
+typedef struct
+{
+	uint32_t Checked;				//已读回核对的寄存器数
+	uint32_t Rounds;				//全部寄存器核对完的轮数
+	uint32_t Mismatch;			//读回值与影子寄存器不同的次数
+	uint32_t Rewrite;				//重写单个寄存器的次数
+	uint32_t Reinit;				//判断为芯片复位过(CSR/FR1不对),复位后整体重写的次数
+	uint32_t Skipped;				//正被调制流直接写入而跳过的寄存器数
+	uint32_t StepMax;				//一步的最长用时(关中断时间),CPU周期
+	uint8_t  LastCh;				//最近一次不同的通道0~3和寄存器
+	uint8_t  LastAddr;
+	uint32_t LastRead;			//最近一次不同时读回的值和应有的值
+	uint32_t LastExpect;
+}AD9959_VerifyStats_t;
+
+//定时切换的时刻统计,跳频播放和模拟调制流共用,时间单位为CPU周期
+typedef struct
+{
+	uint32_t LastStamp;			//上次记录时的DWT计数
+	uint64_t Elapsed;				//从第一次记录起的实际时间
+	uint64_t Ideal;					//从第一次记录起的理想时间,16.16定点
+	int32_t  JitterMin;			//实际时刻与理想时刻之差
+	int32_t  JitterMax;
+	uint64_t JitterAbsSum;
+}AD9959_Timing_t;
+
+uint8_t *AD9959_BusAlloc(void);		//取空闲发送缓冲区
+uint8_t AD9959_BusSend(uint16_t len);	//发送取得的缓冲区,0:成功 1:外设报错
+void AD9959_BusWait(void);				//等待发送完成
+
+void AD9959_DelayInit(void);						//初始化DWT精确延时
+void AD9959_DelayCycles(uint32_t cycles);	//延时若干CPU周期
+void AD9959_TimingStart(AD9959_Timing_t *t, uint32_t now);		//开始统计,now为第一次切换时的DWT计数
+void AD9959_TimingStamp(AD9959_Timing_t *t, uint32_t now, uint64_t stepQ16);	//记录一次切换,stepQ16为与上次的理想间隔
+void delay1 (uint32_t length);//延时,单位us
+uint8_t IntReset(void);	 			//AD9959复位,0:成功 1:切换四线模式失败
+void IO_Update(void); 		  //AD9959更新数据
+void Intserve(void);				//IO口电平状态初始化
+void AD9959_Init(void);			//IO口初始化
+
+/***********************AD9959基本寄存器操作函数*****************************************/
+uint8_t AD9959_WriteData(uint8_t RegisterAddress, uint8_t NumberofRegisters, uint8_t *RegisterData);//向AD9959写数据,0:成功 1:外设报错
+void Write_CFTW0(uint32_t fre);										//写CFTW0通道频率转换字寄存器
+void Write_ACR(uint16_t Ampli);										//写ACR通道幅度转换字寄存器
+void Write_CPOW0(uint16_t Phase);									//写CPOW0通道相位转换字寄存器
+
+void Write_LSRR(uint8_t rsrr,uint8_t fsrr);				//写LSRR线性扫描斜率寄存器
+void Write_RDW(uint32_t r_delta);									//写RDW上升增量寄存器
+void Write_FDW(uint32_t f_delta);									//写FDW下降增量寄存器
+
+void Write_Profile_Fre(uint8_t profile,uint32_t data);//写Profile寄存器,频率
+void Write_Profile_Ampli(uint8_t profile,uint16_t data);//写Profile寄存器,幅度
+void Write_Profile_Phase(uint8_t profile,uint16_t data);//写Profile寄存器,相位
+/********************************************************************************************/
+
+
+/*****************************影子寄存器与批量写入*****************************************/
+void AD9959_ShadowReset(void);																//影子寄存器恢复默认值
+void AD9959_Stage(uint8_t Channel, uint8_t addr, uint32_t value);//暂存寄存器值
+void AD9959_Stage_Fre(uint8_t Channel, uint32_t Freq);				//暂存频率
+void AD9959_Stage_Amp(uint8_t Channel, uint16_t Ampli);				//暂存幅度
+void AD9959_Stage_Phase(uint8_t Channel, uint16_t Phase);			//暂存相位
+uint16_t AD9959_Flush(void);																	//写入变化的暂存值
+uint16_t AD9959_Commit(void);																	//写入变化的暂存值并IO_Update
+void AD9959_Select(uint8_t Channel);													//需要时写CSR选中通道
+void AD9959_ProfilePins(uint8_t Channel, uint8_t Level);			//设置通道的Profile引脚PS0~PS3
+uint8_t AD9959_ReadReg(uint8_t Channel, uint8_t addr, uint32_t *value);//读回寄存器
+/********************************************************************************************/
+
+
+/*****************************整数频率换算与通道组*****************************************/
+void AD9959_ClockConfig(uint32_t RefClk, uint8_t PllMul);			//设置参考时钟和PLL倍频
+void AD9959_ClockSettle(void);			//FR1写入芯片后重算IO_UPDATE脉宽,开了PLL时等待锁定
+uint32_t AD9959_HzToFtw(uint32_t Freq);												//Hz -> 频率控制字
+uint32_t AD9959_MilliHzToFtw(uint64_t Freq);									//mHz -> 频率控制字
+uint64_t AD9959_FtwToMilliHz(uint32_t Ftw);										//频率控制字 -> mHz
+uint16_t AD9959_MilliDegToPow(int32_t Phase);									//千分之一度 -> 相位控制字
+uint16_t AD9959_PermilleToAsf(uint16_t Ampli);								//千分比 -> 幅度比例因子
+void AD9959_Stage_FreMilli(uint8_t Channel, uint64_t Freq);		//暂存频率,mHz
+void AD9959_Stage_PhaseMilli(uint8_t Channel, int32_t Phase);	//暂存相位,千分之一度
+uint16_t AD9959_GroupSet(uint8_t Channel, const AD9959_ChSet_t *set, uint8_t Sync);//多通道同一次IO_Update生效
+uint16_t AD9959_MultiPhase(uint8_t Channel, uint64_t Freq, int32_t Phase0, uint16_t Asf, const int16_t *Trim);//N个通道同频,相位等间隔
+uint16_t AD9959_IQ(uint8_t ChI, uint8_t ChQ, uint64_t Freq, uint16_t Asf);	//正交输出,Q滞后I 90°
+/********************************************************************************************/
+
+
+/*****************************定时器跳频播放(AD9959_Player.c)*****************************/
+uint8_t AD9959_PlayerStart(TIM_HandleTypeDef *htim, uint32_t TickHz, const AD9959_Hop_t *table, uint32_t count, uint8_t Mode, uint8_t Loop);//开始播放
+void AD9959_PlayerStop(void);																	//停止播放,保持当前输出
+uint8_t AD9959_PlayerBusy(void);															//1:正在播放
+void AD9959_PlayerIRQ(TIM_HandleTypeDef *htim);								//在HAL_TIM_PeriodElapsedCallback中调用
+void AD9959_PlayerGetStats(AD9959_PlayerStats_t *stats);			//读统计
+/********************************************************************************************/
+
+
+/*****************************模拟调制流(AD9959_Stream.c)*******************************/
+uint8_t AD9959_StreamFrameLen(uint8_t Param);													//一个样点的帧字节数
+uint8_t AD9959_StreamBuild(const AD9959_Mod_t *mod, const int16_t *src, uint32_t n, uint8_t *frames);//样点预先转换成帧
+uint8_t AD9959_StreamStart(TIM_HandleTypeDef *htim, uint32_t TickHz, uint32_t Rate, const AD9959_Mod_t *mod, const uint8_t *frames, uint32_t n, uint8_t Loop);//播放预先转换的帧
+uint8_t AD9959_StreamStartLive(TIM_HandleTypeDef *htim, uint32_t TickHz, uint32_t Rate, const AD9959_Mod_t *mod, const volatile int16_t *ring, uint32_t len);//循环读样点缓冲区(如ADC DMA)
+void AD9959_StreamStop(void);																	//停止,保持当前输出
+uint8_t AD9959_StreamBusy(void);															//1:正在输出
+void AD9959_StreamIRQ(TIM_HandleTypeDef *htim);								//在HAL_TIM_PeriodElapsedCallback中调用
+void AD9959_StreamGetStats(AD9959_StreamStats_t *stats);			//读统计
+/********************************************************************************************/
+
+
+/*****************************寄存器核对(AD9959_Verify.c)*********************************/
+void AD9959_VerifyStep(void);																	//核对一个寄存器,在主循环中调用
+void AD9959_VerifyRestore(void);															//复位芯片并按影子寄存器整体重写
+void AD9959_VerifyGetStats(AD9959_VerifyStats_t *stats);			//读统计
+/********************************************************************************************/
+
+
+/*****************************线性扫描规划(AD9959_Sweep.c)*******************************/
+uint8_t AD9959_SweepPlan(uint8_t Param, uint32_t Start, uint32_t Stop, uint64_t Time, AD9959_SweepPlan_t *plan);//计算扫描参数
+uint16_t AD9959_SweepLoad(uint8_t Channel, const AD9959_SweepPlan_t *plan);	//一帧写入扫描参数,不生效
+void AD9959_SweepGo(uint8_t Channel, const AD9959_SweepPlan_t *plan);				//生效并拉Profile引脚开始扫描
+uint8_t AD9959_Sweep(uint8_t Channel, uint8_t Param, uint32_t Start, uint32_t Stop, uint64_t Time);//规划、写入并开始一次扫描
+uint8_t AD9959_SweepStart(TIM_HandleTypeDef *htim, uint32_t TickHz, uint8_t Channel, const AD9959_SweepPlan_t *plans, uint32_t count, uint8_t Loop);//分段扫描
+void AD9959_SweepStop(void);																		//停止分段扫描
+uint8_t AD9959_SweepBusy(void);																	//1:分段扫描进行中
+void AD9959_SweepIRQ(TIM_HandleTypeDef *htim);									//在HAL_TIM_PeriodElapsedCallback中调用
 /********************************************************************************************/
 
 
-/*****************************Ƶ***********************************/
-void AD9959_Set_Fre(uint8_t Channel,uint32_t Freq); //дƵ
-void AD9959_Set_Amp(uint8_t Channel, uint16_t Ampli);//д
-void AD9959_Set_Phase(uint8_t Channel,uint16_t Phase);//дλ
+/*****************************点频操作函数***********************************/
+void AD9959_Set_Fre(uint8_t Channel,uint32_t Freq); //写频率
+void AD9959_Set_Amp(uint8_t Channel, uint16_t Ampli);//写幅度
+void AD9959_Set_Phase(uint8_t Channel,uint16_t Phase);//写相位
 /****************************************************************************/
 
-/*****************************Ʋ  ***********************************/
-void AD9959_Modulation_Init(uint8_t Channel,uint8_t Modulation,uint8_t Sweep_en,uint8_t Nlevel);//øͨĵģʽ
-void AD9959_SetFSK(uint8_t Channel, uint32_t *data,uint16_t Phase);//FSKƵĲ
-void AD9959_SetASK(uint8_t Channel, uint16_t *data,uint32_t fre,uint16_t Phase);//ASKƵĲ
-void AD9959_SetPSK(uint8_t Channel, uint16_t *data,uint32_t Freq);//PSKƵĲ
+/*****************************调制操作函数  ***********************************/
+void AD9959_Modulation_Init(uint8_t Channel,uint8_t Modulation,uint8_t Sweep_en,uint8_t Nlevel);//设置各个通道的调制模式。
+void AD9959_SetFSK(uint8_t Channel, uint32_t *data,uint16_t Phase);//设置FSK调制的参数
+void AD9959_SetASK(uint8_t Channel, uint16_t *data,uint32_t fre,uint16_t Phase);//设置ASK调制的参数
+void AD9959_SetPSK(uint8_t Channel, uint16_t *data,uint32_t Freq);//设置PSK调制的参数
 
-void AD9959_SetFre_Sweep(uint8_t Channel, uint32_t s_data,uint32_t e_data,uint32_t r_delta,uint32_t f_delta,uint8_t rsrr,uint8_t fsrr,uint16_t Ampli,uint16_t Phase);//ɨƵĲ
-void AD9959_SetAmp_Sweep(uint8_t Channel, uint32_t s_Ampli,uint16_t e_Ampli,uint32_t r_delta,uint32_t f_delta,uint8_t rsrr,uint8_t fsrr,uint32_t fre,uint16_t Phase);//ɨĲ
-void AD9959_SetPhase_Sweep(uint8_t Channel, uint16_t s_data,uint16_t e_data,uint16_t r_delta,uint16_t f_delta,uint8_t rsrr,uint8_t fsrr,uint32_t fre,uint16_t Ampli);//ɨĲ
+void AD9959_SetFre_Sweep(uint8_t Channel, uint32_t s_data,uint32_t e_data,uint32_t r_delta,uint32_t f_delta,uint8_t rsrr,uint8_t fsrr,uint16_t Ampli,uint16_t Phase);//设置线性扫频的参数
+void AD9959_SetAmp_Sweep(uint8_t Channel, uint32_t s_Ampli,uint16_t e_Ampli,uint32_t r_delta,uint32_t f_delta,uint8_t rsrr,uint8_t fsrr,uint32_t fre,uint16_t Phase);//设置线性扫幅的参数
+void AD9959_SetPhase_Sweep(uint8_t Channel, uint16_t s_data,uint16_t e_data,uint16_t r_delta,uint16_t f_delta,uint8_t rsrr,uint8_t fsrr,uint32_t fre,uint16_t Ampli);//设置线性扫相的参数
 /********************************************************************************************/
 
 #endif
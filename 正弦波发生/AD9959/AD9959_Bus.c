@@ -0,0 +1,486 @@
+#include "AD9959.h"
+#include <string.h>
+
+/************************************************************
+	AD9959通信方式,由 AD9959.h 中的 AD9959_BUS 在编译时选择:
+	AD9959_BUS_SOFT		模拟SPI,单线,原接线,不需要额外外设
+	AD9959_BUS_SPI		硬件SPI,单线,短帧直接写数据寄存器,长帧走DMA
+	AD9959_BUS_QSPI		QUADSPI四线,带QUADSPI的F4(F446/F469等)
+	AD9959_BUS_PARALLEL	GPIO四线,SCLK和SDIO0~3在同一个GPIO口,查表一次写BSRR输出4位
+	四线方式在AD9959复位后先用单线写CSR[2:1]=11切换到四线模式,之后指令字节和数据都按4位传输,
+	每个时钟SDIO3~SDIO0依次为一个半字节的bit3~bit0,高半字节先发
+	读寄存器:指令字节bit7为1,之后芯片在SCLK下降沿输出数据,单线方式从SDIO0,四线方式从SDIO0~3;
+	硬件SPI单线方式要把MOSI切换成双向才能读,没有实现,AD9959_Bus.Read为NULL
+**************************************************************/
+
+static uint8_t busBuf[2][AD9959_BUS_BUF_LEN];	//双缓冲,一个在发送时可以准备另一个
+static uint8_t busIdx = 0;
+
+
+
+#if AD9959_BUS == AD9959_BUS_SOFT
+/************************************************************
+** 函数名称 ：void ad9959_soft_init(void)
+** 函数功能 ：初始化模拟SPI用到的IO口 SCLK:PB1 SDIO0~2:PB5~3 SDIO3:PF8
+**************************************************************/
+static void ad9959_soft_init(void)
+{
+	GPIO_InitTypeDef  GPIO_InitStructure;
+
+	__HAL_RCC_GPIOB_CLK_ENABLE();
+	__HAL_RCC_GPIOF_CLK_ENABLE();
+
+	GPIO_InitStructure.Pin = GPIO_PIN_1|GPIO_PIN_3|GPIO_PIN_4|GPIO_PIN_5;
+	GPIO_InitStructure.Mode = GPIO_MODE_OUTPUT_PP;
+	GPIO_InitStructure.Pull = GPIO_NOPULL;
+	GPIO_InitStructure.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+	HAL_GPIO_Init(GPIOB, &GPIO_InitStructure);
+
+	GPIO_InitStructure.Pin = GPIO_PIN_8;
+	HAL_GPIO_Init(GPIOF, &GPIO_InitStructure);
+}
+
+static uint8_t ad9959_soft_setup(void)
+{
+	return 0;
+}
+
+/************************************************************
+** 函数名称 ：uint8_t ad9959_soft_start(const uint8_t *data, uint16_t len)
+** 函数功能 ：模拟SPI发送一帧,返回时已发送完成
+**************************************************************/
+static uint8_t ad9959_soft_start(const uint8_t *data, uint16_t len)
+{
+	uint8_t	ValueToWrite;
+	uint8_t	i;
+
+	SCLK = 0;
+	CS = 0;
+	while(len--)
+	{
+		ValueToWrite = *data++;
+		for(i=0; i<8; i++)
+		{
+			SCLK = 0;
+			SDIO0 = (ValueToWrite & 0x80) ? 1 : 0;
+			SCLK = 1;
+			ValueToWrite <<= 1;
+		}
+	}
+	SCLK = 0;
+	CS = 1;
+	return 0;
+}
+
+static void ad9959_soft_wait(void)
+{
+}
+
+/************************************************************
+** 函数名称 ：void ad9959_soft_read(uint8_t instr, uint8_t *data, uint16_t len)
+** 函数功能 ：模拟SPI读:发指令字节后PB5改为输入,在SCLK低电平期间采样
+**************************************************************/
+static void ad9959_soft_read(uint8_t instr, uint8_t *data, uint16_t len)
+{
+	uint8_t	v;
+	uint8_t	i;
+
+	SCLK = 0;
+	CS = 0;
+	for(i=0; i<8; i++)
+	{
+		SCLK = 0;
+		SDIO0 = (instr & 0x80) ? 1 : 0;
+		SCLK = 1;
+		instr <<= 1;
+	}
+	GPIOB->MODER &= ~(3UL << (5 * 2));		//PB5输入
+	while(len--)
+	{
+		for(v=0, i=0; i<8; i++)
+		{
+			SCLK = 0;					//芯片在下降沿输出下一位
+			v <<= 1;
+			__NOP();
+			v |= SDIO0_IN;
+			SCLK = 1;
+		}
+		*data++ = v;
+	}
+	SCLK = 0;
+	CS = 1;
+	GPIOB->MODER |= 1UL << (5 * 2);			//PB5恢复输出
+}
+
+const AD9959_Bus_t AD9959_Bus = { ad9959_soft_init, ad9959_soft_setup, ad9959_soft_start, ad9959_soft_wait, ad9959_soft_read, CSR_MODE_1BIT_2WIRE, "soft spi" };
+
+
+
+#elif AD9959_BUS == AD9959_BUS_SPI
+extern SPI_HandleTypeDef AD9959_SPI;
+static volatile uint8_t spiBusy = 0;
+
+/************************************************************
+** 函数名称 ：void ad9959_spi_init(void)
+** 函数功能 ：SPI本身和SCLK/SDIO0引脚由CubeMX初始化,这里只把不用的SDIO1~3设为输出并保持低电平
+					 (单线模式下SDIO3是SYNC_IO,必须为低)
+**************************************************************/
+static void ad9959_spi_init(void)
+{
+	GPIO_InitTypeDef  GPIO_InitStructure;
+
+	__HAL_RCC_GPIOB_CLK_ENABLE();
+	__HAL_RCC_GPIOF_CLK_ENABLE();
+
+	GPIO_InitStructure.Pin = GPIO_PIN_3|GPIO_PIN_4;
+	GPIO_InitStructure.Mode = GPIO_MODE_OUTPUT_PP;
+	GPIO_InitStructure.Pull = GPIO_NOPULL;
+	GPIO_InitStructure.Speed = GPIO_SPEED_FREQ_LOW;
+	HAL_GPIO_Init(GPIOB, &GPIO_InitStructure);
+
+	GPIO_InitStructure.Pin = GPIO_PIN_8;
+	HAL_GPIO_Init(GPIOF, &GPIO_InitStructure);
+
+	__HAL_SPI_ENABLE(&AD9959_SPI);		//短帧直接写数据寄存器,需要先使能SPI
+}
+
+static uint8_t ad9959_spi_setup(void)
+{
+	return 0;
+}
+
+/************************************************************
+** 函数名称 ：uint8_t ad9959_spi_start(const uint8_t *data, uint16_t len)
+** 函数功能 ：拉低CS发送一帧,不少于AD9959_SPI_DMA_MIN字节时启动DMA后立即返回
+** 函数说明 ：DMA启动失败时改为直接写数据寄存器,总是成功
+**************************************************************/
+static uint8_t ad9959_spi_start(const uint8_t *data, uint16_t len)
+{
+	SPI_TypeDef *spi = AD9959_SPI.Instance;
+
+	CS = 0;
+	spiBusy = 1;
+	if(len >= AD9959_SPI_DMA_MIN && AD9959_SPI.hdmatx != NULL)
+	{
+		if(HAL_SPI_Transmit_DMA(&AD9959_SPI, (uint8_t *)data, len) == HAL_OK)
+		{
+			return 0;
+		}
+	}
+	while(len--)
+	{
+		while(!(spi->SR & SPI_SR_TXE));
+		*(volatile uint8_t *)&spi->DR = *data++;
+	}
+	return 0;
+}
+
+/************************************************************
+** 函数名称 ：void ad9959_spi_wait(void)
+** 函数功能 ：等待DMA和移位寄存器发完再拉高CS
+					 在中断里调用时,SPI发送DMA中断的优先级要高于调用者
+**************************************************************/
+static void ad9959_spi_wait(void)
+{
+	SPI_TypeDef *spi = AD9959_SPI.Instance;
+
+	if(!spiBusy)
+	{
+		return;
+	}
+	while(HAL_SPI_GetState(&AD9959_SPI) == HAL_SPI_STATE_BUSY_TX);
+	while(!(spi->SR & SPI_SR_TXE));
+	while(spi->SR & SPI_SR_BSY);
+	(void)spi->DR;		//只发不收,清除接收溢出标志
+	(void)spi->SR;
+	CS = 1;
+	spiBusy = 0;
+}
+
+const AD9959_Bus_t AD9959_Bus = { ad9959_spi_init, ad9959_spi_setup, ad9959_spi_start, ad9959_spi_wait, NULL, CSR_MODE_1BIT_2WIRE, "spi" };
+
+
+
+#elif AD9959_BUS == AD9959_BUS_QSPI
+#if !defined(HAL_QSPI_MODULE_ENABLED)
+#error "AD9959_BUS_QSPI: 芯片没有QUADSPI或CubeMX没有开启QUADSPI"
+#endif
+extern QSPI_HandleTypeDef AD9959_QSPI;
+
+/************************************************************
+** 函数名称 ：uint8_t ad9959_qspi_send(uint32_t lines, const uint8_t *data, uint16_t len)
+** 函数功能 ：第一个字节作为QSPI指令,其余作为数据;QSPI自己产生片选,数据发完自动拉高
+** 出口参数 ：0:成功 1:HAL_QSPI_Command/HAL_QSPI_Transmit返回错误
+**************************************************************/
+static uint8_t ad9959_qspi_send(uint32_t lines, const uint8_t *data, uint16_t len)
+{
+	HAL_StatusTypeDef status;
+
+	QSPI_CommandTypeDef cmd;
+
+	memset(&cmd, 0, sizeof(cmd));
+	cmd.Instruction = data[0];
+	cmd.InstructionMode = (lines == 4) ? QSPI_INSTRUCTION_4_LINES : QSPI_INSTRUCTION_1_LINE;
+	cmd.AddressMode = QSPI_ADDRESS_NONE;
+	cmd.AlternateByteMode = QSPI_ALTERNATE_BYTES_NONE;
+	cmd.DataMode = (len < 2) ? QSPI_DATA_NONE : (lines == 4) ? QSPI_DATA_4_LINES : QSPI_DATA_1_LINE;
+	cmd.NbData = len - 1;
+	cmd.DdrMode = QSPI_DDR_MODE_DISABLE;
+	cmd.SIOOMode = QSPI_SIOO_INST_EVERY_CMD;
+	if(HAL_QSPI_Command(&AD9959_QSPI, &cmd, HAL_QPSI_TIMEOUT_DEFAULT_VALUE) != HAL_OK)
+	{
+		return 1;
+	}
+	if(len < 2)
+	{
+		return 0;
+	}
+	if(len - 1 >= AD9959_SPI_DMA_MIN)
+	{
+		status = HAL_QSPI_Transmit_DMA(&AD9959_QSPI, (uint8_t *)data + 1);
+	}
+	else
+	{
+		status = HAL_QSPI_Transmit(&AD9959_QSPI, (uint8_t *)data + 1, HAL_QPSI_TIMEOUT_DEFAULT_VALUE);
+	}
+	return status != HAL_OK;
+}
+
+static void ad9959_qspi_init(void)
+{
+}
+
+/************************************************************
+** 函数名称 ：uint8_t ad9959_qspi_setup(void)
+** 函数功能 ：复位后AD9959处于单线模式,用单线写CSR切换到四线模式,四个通道保持使能
+** 出口参数 ：0:成功 1:QSPI报错
+** 函数说明 ：单线指令期间QUADSPI把IO2/IO3驱动为高电平,而IO3接的是SYNC_IO,高电平会让AD9959
+							放弃这次写;所以先把IO3改成普通输出拉低,CSR写完再交还给QUADSPI
+**************************************************************/
+static uint8_t ad9959_qspi_setup(void)
+{
+	GPIO_TypeDef *port = AD9959_QSPI_IO3_PORT;
+	uint32_t moder = port->MODER;
+	uint8_t csr[2] = {CSR_ADD, 0xF0 | CSR_MODE_4BIT};
+	uint8_t err;
+
+	port->BSRR = (1UL << AD9959_QSPI_IO3_PIN) << 16;
+	port->MODER = (moder & ~(3UL << (AD9959_QSPI_IO3_PIN * 2))) | (1UL << (AD9959_QSPI_IO3_PIN * 2));
+	err = ad9959_qspi_send(1, csr, 2);
+	while(HAL_QSPI_GetState(&AD9959_QSPI) != HAL_QSPI_STATE_READY);
+	port->MODER = moder;
+	return err;
+}
+
+static uint8_t ad9959_qspi_start(const uint8_t *data, uint16_t len)
+{
+	return ad9959_qspi_send(4, data, len);
+}
+
+static void ad9959_qspi_wait(void)
+{
+	while(HAL_QSPI_GetState(&AD9959_QSPI) != HAL_QSPI_STATE_READY);
+}
+
+/************************************************************
+** 函数名称 ：void ad9959_qspi_read(uint8_t instr, uint8_t *data, uint16_t len)
+** 函数功能 ：四线读:指令字节后用间接读模式四线接收
+**************************************************************/
+static void ad9959_qspi_read(uint8_t instr, uint8_t *data, uint16_t len)
+{
+	QSPI_CommandTypeDef cmd;
+
+	memset(&cmd, 0, sizeof(cmd));
+	cmd.Instruction = instr;
+	cmd.InstructionMode = QSPI_INSTRUCTION_4_LINES;
+	cmd.AddressMode = QSPI_ADDRESS_NONE;
+	cmd.AlternateByteMode = QSPI_ALTERNATE_BYTES_NONE;
+	cmd.DataMode = QSPI_DATA_4_LINES;
+	cmd.NbData = len;
+	cmd.DdrMode = QSPI_DDR_MODE_DISABLE;
+	cmd.SIOOMode = QSPI_SIOO_INST_EVERY_CMD;
+	HAL_QSPI_Command(&AD9959_QSPI, &cmd, HAL_QPSI_TIMEOUT_DEFAULT_VALUE);
+	HAL_QSPI_Receive(&AD9959_QSPI, data, HAL_QPSI_TIMEOUT_DEFAULT_VALUE);
+}
+
+const AD9959_Bus_t AD9959_Bus = { ad9959_qspi_init, ad9959_qspi_setup, ad9959_qspi_start, ad9959_qspi_wait, ad9959_qspi_read, CSR_MODE_4BIT, "quadspi" };
+
+
+
+#elif AD9959_BUS == AD9959_BUS_PARALLEL
+static uint32_t parLut[16];		//半字节 -> BSRR值,同时拉低SCLK
+static uint32_t parModer;			//SDIO0~3在MODER中的位,读时清零改为输入
+
+/************************************************************
+** 函数名称 ：void ad9959_par_init(void)
+** 函数功能 ：初始化四线GPIO,生成半字节到BSRR的查找表
+**************************************************************/
+static void ad9959_par_init(void)
+{
+	GPIO_InitTypeDef  GPIO_InitStructure;
+	const uint32_t pins[4] = {AD9959_PAR_SDIO0, AD9959_PAR_SDIO1, AD9959_PAR_SDIO2, AD9959_PAR_SDIO3};
+	uint32_t set, all = AD9959_PAR_SDIO0|AD9959_PAR_SDIO1|AD9959_PAR_SDIO2|AD9959_PAR_SDIO3;
+	uint8_t n, i;
+
+	AD9959_PAR_CLK_ENABLE();
+	GPIO_InitStructure.Pin = all|AD9959_PAR_SCLK;
+	GPIO_InitStructure.Mode = GPIO_MODE_OUTPUT_PP;
+	GPIO_InitStructure.Pull = GPIO_NOPULL;
+	GPIO_InitStructure.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+	HAL_GPIO_Init(AD9959_PAR_PORT, &GPIO_InitStructure);
+
+	for(n=0; n<16; n++)
+	{
+		set = 0;
+		for(i=0; i<4; i++)
+		{
+			if(n & (1 << i))
+			{
+				set |= pins[i];
+			}
+		}
+		parLut[n] = set | (((all & ~set) | AD9959_PAR_SCLK) << 16);
+	}
+	for(parModer=0, n=0; n<16; n++)
+	{
+		if(all & (1UL << n))
+		{
+			parModer |= 3UL << (n * 2);
+		}
+	}
+	AD9959_PAR_PORT->BSRR = parLut[0];
+}
+
+/************************************************************
+** 函数名称 ：uint8_t ad9959_par_setup(void)
+** 函数功能 ：复位后AD9959处于单线模式,用SDIO0单线写CSR切换到四线模式,四个通道保持使能
+**************************************************************/
+static uint8_t ad9959_par_setup(void)
+{
+	GPIO_TypeDef *port = AD9959_PAR_PORT;
+	const uint8_t csr[2] = {CSR_ADD, 0xF0 | CSR_MODE_4BIT};
+	uint8_t i, j;
+
+	CS = 0;
+	for(i=0; i<2; i++)
+	{
+		for(j=0; j<8; j++)
+		{
+			port->BSRR = parLut[(csr[i] >> (7 - j)) & 1];
+			port->BSRR = AD9959_PAR_SCLK;
+		}
+	}
+	port->BSRR = parLut[0];
+	CS = 1;
+	return 0;
+}
+
+/************************************************************
+** 函数名称 ：uint8_t ad9959_par_start(const uint8_t *data, uint16_t len)
+** 函数功能 ：四线发送一帧,每字节两个时钟,返回时已发送完成
+**************************************************************/
+static uint8_t ad9959_par_start(const uint8_t *data, uint16_t len)
+{
+	GPIO_TypeDef *port = AD9959_PAR_PORT;
+	const uint32_t sclk = AD9959_PAR_SCLK;
+	uint8_t b;
+
+	CS = 0;
+	while(len--)
+	{
+		b = *data++;
+		port->BSRR = parLut[b >> 4];
+		port->BSRR = sclk;
+		port->BSRR = parLut[b & 0x0f];
+		port->BSRR = sclk;
+	}
+	port->BSRR = sclk << 16;
+	CS = 1;
+	return 0;
+}
+
+static void ad9959_par_wait(void)
+{
+}
+
+/************************************************************
+** 函数名称 ：void ad9959_par_read(uint8_t instr, uint8_t *data, uint16_t len)
+** 函数功能 ：四线读:发指令字节后SDIO0~3改为输入,SCLK低电平期间读IDR,每字节两个时钟
+**************************************************************/
+static void ad9959_par_read(uint8_t instr, uint8_t *data, uint16_t len)
+{
+	GPIO_TypeDef *port = AD9959_PAR_PORT;
+	const uint32_t sclk = AD9959_PAR_SCLK;
+	uint32_t moder = port->MODER, idr;
+	uint8_t b, k;
+
+	CS = 0;
+	port->BSRR = parLut[instr >> 4];
+	port->BSRR = sclk;
+	port->BSRR = parLut[instr & 0x0f];
+	port->BSRR = sclk;
+	port->MODER = moder & ~parModer;
+	while(len--)
+	{
+		for(b=0, k=0; k<2; k++)
+		{
+			port->BSRR = sclk << 16;		//芯片在下降沿输出下一个半字节
+			__NOP();
+			idr = port->IDR;
+			b = (uint8_t)((b << 4) | ((idr & AD9959_PAR_SDIO3) ? 8 : 0) | ((idr & AD9959_PAR_SDIO2) ? 4 : 0) |
+				((idr & AD9959_PAR_SDIO1) ? 2 : 0) | ((idr & AD9959_PAR_SDIO0) ? 1 : 0));
+			port->BSRR = sclk;
+		}
+		*data++ = b;
+	}
+	port->BSRR = sclk << 16;
+	CS = 1;
+	port->MODER = moder;
+}
+
+const AD9959_Bus_t AD9959_Bus = { ad9959_par_init, ad9959_par_setup, ad9959_par_start, ad9959_par_wait, ad9959_par_read, CSR_MODE_4BIT, "gpio 4-bit" };
+
+
+
+#else
+#error "AD9959_BUS: 未知的通信方式"
+#endif
+
+
+
+/************************************************************
+** 函数名称 ：uint8_t *AD9959_BusAlloc(void)
+** 函数功能 ：取一个当前没有在发送的缓冲区,用来拼一帧数据
+** 出口参数 ：缓冲区地址,长度AD9959_BUS_BUF_LEN
+** 函数说明 ：一帧里可以连续放多条"指令字节+寄存器数据",CS保持低电平依次写入
+**************************************************************/
+uint8_t *AD9959_BusAlloc(void)
+{
+	return busBuf[busIdx];
+}
+
+/************************************************************
+** 函数名称 ：uint8_t AD9959_BusSend(uint16_t len)
+** 函数功能 ：发送AD9959_BusAlloc取得的缓冲区,先等上一帧发完
+** 入口参数 ：len: 帧长度
+** 出口参数 ：0:成功 1:外设报错,这一帧没有发出
+** 函数说明 ：DMA方式下返回时还在发送,IO_Update()前会等待发送完成
+**************************************************************/
+uint8_t AD9959_BusSend(uint16_t len)
+{
+	uint8_t err;
+
+	AD9959_Bus.Wait();
+	err = AD9959_Bus.Start(busBuf[busIdx], len);
+	busIdx ^= 1;
+	return err;
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_BusWait(void)
+** 函数功能 ：等待正在发送的帧发完,CS拉高
+**************************************************************/
+void AD9959_BusWait(void)
+{
+	AD9959_Bus.Wait();
+}
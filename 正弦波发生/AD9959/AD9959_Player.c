@@ -0,0 +1,274 @@
+#include "AD9959.h"
+#include <string.h>
+
+/************************************************************
+	定时器驱动的跳频播放,播放表长度不限,每项可以指定通道、频率、相位、幅度和停留时间
+	定时器每到一项的停留时间产生一次更新中断,中断里先切换(时刻确定),再准备下一项:
+	AD9959_PLAY_UPDATE	下一项预先写入缓冲寄存器,切换时只给一个IO_Update脉冲
+	FSK/PSK/ASK			2电平调制,每个通道的Profile引脚(PS0~PS3对应CH0~CH3)选择
+						profile0(CFTW0/CPOW0/ACR)或profile1(CW1);下一项写入当前没有选中的
+						那个profile并IO_Update,输出不变,切换时只翻转引脚,只有对应的一个参数跳变
+	用法:	CubeMX配置一个基本定时器,预分频后的计数频率为TickHz,打开自动重装载预装载和更新中断;
+			void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+			{
+				AD9959_PlayerIRQ(htim);
+			}
+			AD9959_PlayerStart(&htim6, 1000000, table, n, AD9959_PLAY_UPDATE, 1);
+	播放期间AD9959只能由播放器访问;下一项要在当前项的停留时间内写完,
+	否则切换会推迟,从统计中的JitterMax、PrefetchMax可以看出
+**************************************************************/
+
+typedef struct
+{
+	TIM_HandleTypeDef *htim;
+	const AD9959_Hop_t *Table;
+	uint32_t Count;
+	uint32_t Index;				//正在播放的项
+	uint32_t Next;				//已准备好的下一项,等于Count表示没有
+	uint8_t  Mode;
+	uint8_t  Loop;
+	uint8_t  Level;				//Profile方式各通道引脚电平,[7:4]对应CH3~CH0
+	volatile uint8_t Running;
+	uint32_t CpuPerTick;		//每个定时器计数的CPU周期数,16.16定点
+	AD9959_Timing_t Timing;		//切换时刻统计
+	AD9959_PlayerStats_t Stats;
+}AD9959_Player_t;
+
+static AD9959_Player_t player;
+
+/************************************************************
+** 函数名称 ：void ad9959_prefetch(const AD9959_Hop_t *hop)
+** 函数功能 ：把一项写入芯片但不生效
+** 函数说明 ：IO_Update方式只写缓冲寄存器;Profile方式写没有选中的profile并IO_Update
+**************************************************************/
+static void ad9959_prefetch(const AD9959_Hop_t *hop)
+{
+	uint8_t high = hop->Channel & player.Level;		//引脚为高,选中profile1,写profile0
+	uint8_t low = hop->Channel & ~player.Level;		//引脚为低,选中profile0,写profile1(CW1)
+
+	switch(player.Mode)
+	{
+		case AD9959_PLAY_UPDATE:
+			AD9959_Stage(hop->Channel, CFTW0_ADD, hop->Ftw);
+			AD9959_Stage(hop->Channel, CPOW0_ADD, hop->Pow);
+			if(hop->Asf <= 1023)
+			{
+				AD9959_Stage(hop->Channel, ACR_ADD, hop->Asf | 0x1000);
+			}
+			AD9959_Flush();
+			return;
+		case FSK:
+			AD9959_Stage(high, CFTW0_ADD, hop->Ftw);
+			AD9959_Stage(low, PROFILE_ADDR_BASE, hop->Ftw);
+			break;
+		case PSK:
+			AD9959_Stage(high, CPOW0_ADD, hop->Pow);
+			AD9959_Stage(low, PROFILE_ADDR_BASE, (uint32_t)(hop->Pow & 0x3FFF) << 18);
+			break;
+		default:	//ASK
+			AD9959_Stage(high, ACR_ADD, (hop->Asf & 0x3FF) | 0x1000);
+			AD9959_Stage(low, PROFILE_ADDR_BASE, (uint32_t)(hop->Asf & 0x3FF) << 22);
+			break;
+	}
+	AD9959_Commit();
+}
+
+/************************************************************
+** 函数名称 ：void ad9959_hop(const AD9959_Hop_t *hop)
+** 函数功能 ：切换到已准备好的一项
+**************************************************************/
+static void ad9959_hop(const AD9959_Hop_t *hop)
+{
+	if(player.Mode == AD9959_PLAY_UPDATE)
+	{
+		IO_Update();
+	}
+	else
+	{
+		player.Level ^= hop->Channel;
+		AD9959_ProfilePins(hop->Channel, player.Level);
+	}
+}
+
+/************************************************************
+** 函数名称 ：uint32_t ad9959_next(uint32_t i)
+** 函数功能 ：第i项之后播放的项,没有时返回Count
+**************************************************************/
+static uint32_t ad9959_next(uint32_t i)
+{
+	if(++i < player.Count)
+	{
+		return i;
+	}
+	return player.Loop ? 0 : player.Count;
+}
+
+/************************************************************
+** 函数名称 ：void ad9959_prepare(void)
+** 函数功能 ：准备Next项,并统计用时
+**************************************************************/
+static void ad9959_prepare(void)
+{
+	uint32_t start = DWT->CYCCNT;
+
+	if(player.Next < player.Count)
+	{
+		ad9959_prefetch(&player.Table[player.Next]);
+	}
+	start = DWT->CYCCNT - start;
+	if(start > player.Stats.PrefetchMax)
+	{
+		player.Stats.PrefetchMax = start;
+	}
+}
+
+/************************************************************
+** 函数名称 ：uint8_t AD9959_PlayerStart(TIM_HandleTypeDef *htim, uint32_t TickHz, const AD9959_Hop_t *table, uint32_t count, uint8_t Mode, uint8_t Loop)
+** 函数功能 ：开始按播放表跳频,第一项立即输出
+** 入口参数 ：htim:		定时器,只用更新中断
+							TickHz:		定时器计数频率,只用于统计
+							table:		播放表,播放期间不能修改
+							count:		项数
+							Mode:			AD9959_PLAY_UPDATE,或FSK/PSK/ASK用Profile引脚切换对应参数
+							Loop:			1:循环播放 0:播放一遍后停在最后一项
+** 出口参数 ：0:成功 1:参数错误,或有一项的停留时间超出2~AD9959_TIM_TICKS_MAX
+** 函数说明 ：Profile方式把用到的通道设为2电平调制并关闭扫描,停止后需要时用AD9959_Modulation_Init恢复
+**************************************************************/
+uint8_t AD9959_PlayerStart(TIM_HandleTypeDef *htim, uint32_t TickHz, const AD9959_Hop_t *table, uint32_t count, uint8_t Mode, uint8_t Loop)
+{
+	uint8_t used = 0, ch;
+	uint32_t i;
+
+	if(htim == NULL || table == NULL || count == 0 || TickHz == 0 ||
+		(Mode != AD9959_PLAY_UPDATE && Mode != FSK && Mode != PSK && Mode != ASK))
+	{
+		return 1;
+	}
+	for(i=0; i<count; i++)
+	{
+		if(table[i].Dwell < 2 || table[i].Dwell > AD9959_TIM_TICKS_MAX || (table[i].Channel & 0xF0) == 0)
+		{
+			return 1;
+		}
+		used |= table[i].Channel & 0xF0;
+	}
+	AD9959_PlayerStop();
+
+	memset(&player, 0, sizeof(player));
+	player.htim = htim;
+	player.Table = table;
+	player.Count = count;
+	player.Mode = Mode;
+	player.Loop = Loop;
+	player.CpuPerTick = (uint32_t)(((uint64_t)SystemCoreClock << 16) / TickHz);
+
+	if(Mode != AD9959_PLAY_UPDATE)
+	{
+		//2电平调制:FR1[9:8]=00,CFR[23:22]选参数,关闭扫描;引脚先全部拉低
+		AD9959_Stage(0, FR1_ADD, AD9959_Shadow.Stage[0][FR1_ADD] & ~0x000300UL);
+		for(ch=0; ch<4; ch++)
+		{
+			if(used & (0x10 << ch))
+			{
+				AD9959_Stage(0x10 << ch, CFR_ADD, (AD9959_Shadow.Stage[ch][CFR_ADD] & ~0xC04000UL) | ((uint32_t)Mode << 16));
+			}
+		}
+		AD9959_ProfilePins(used, 0);
+		AD9959_Commit();
+	}
+
+	//第一项:ARPE=0时直接写入影子寄存器,再打开预装载放入第二项的停留时间
+	player.Next = 0;
+	ad9959_prepare();
+	player.Next = ad9959_next(0);
+	htim->Instance->CR1 &= ~TIM_CR1_ARPE;
+	__HAL_TIM_SET_AUTORELOAD(htim, table[0].Dwell - 1);
+	__HAL_TIM_SET_COUNTER(htim, 0);
+	htim->Instance->CR1 |= TIM_CR1_ARPE;
+	if(player.Next < count)
+	{
+		__HAL_TIM_SET_AUTORELOAD(htim, table[player.Next].Dwell - 1);
+	}
+	__HAL_TIM_CLEAR_FLAG(htim, TIM_FLAG_UPDATE);
+
+	player.Running = 1;
+	ad9959_hop(&table[0]);
+	AD9959_TimingStart(&player.Timing, DWT->CYCCNT);
+	HAL_TIM_Base_Start_IT(htim);
+	ad9959_prepare();
+	return 0;
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_PlayerStop(void)
+** 函数功能 ：停止播放,当前输出保持不变
+**************************************************************/
+void AD9959_PlayerStop(void)
+{
+	if(player.Running)
+	{
+		HAL_TIM_Base_Stop_IT(player.htim);
+		player.Running = 0;
+	}
+}
+
+/************************************************************
+** 函数名称 ：uint8_t AD9959_PlayerBusy(void)
+** 函数功能 ：是否正在播放,不循环时播放完最后一项自动停止
+**************************************************************/
+uint8_t AD9959_PlayerBusy(void)
+{
+	return player.Running;
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_PlayerIRQ(TIM_HandleTypeDef *htim)
+** 函数功能 ：定时器更新中断中调用:切换到已准备好的一项,记录时刻,再准备下一项
+** 函数说明 ：进入中断时定时器已按预装载值开始当前项的计时,这里预装载再下一项的停留时间
+**************************************************************/
+void AD9959_PlayerIRQ(TIM_HandleTypeDef *htim)
+{
+	uint32_t dwell;
+
+	if(!player.Running || htim != player.htim)
+	{
+		return;
+	}
+	if(player.Next >= player.Count)
+	{
+		AD9959_PlayerStop();		//最后一项播放完
+		return;
+	}
+
+	dwell = player.Table[player.Index].Dwell;
+	ad9959_hop(&player.Table[player.Next]);
+	AD9959_TimingStamp(&player.Timing, DWT->CYCCNT, (uint64_t)dwell * player.CpuPerTick);
+	player.Stats.Hops++;
+	if(player.Next == 0)
+	{
+		player.Stats.Loops++;
+	}
+	player.Index = player.Next;
+	player.Next = ad9959_next(player.Index);
+	if(player.Next < player.Count)
+	{
+		__HAL_TIM_SET_AUTORELOAD(htim, player.Table[player.Next].Dwell - 1);
+	}
+	ad9959_prepare();
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_PlayerGetStats(AD9959_PlayerStats_t *stats)
+** 函数功能 ：读播放统计
+**************************************************************/
+void AD9959_PlayerGetStats(AD9959_PlayerStats_t *stats)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	*stats = player.Stats;
+	stats->JitterMin = player.Timing.JitterMin;
+	stats->JitterMax = player.Timing.JitterMax;
+	stats->JitterAbsSum = player.Timing.JitterAbsSum;
+	__set_PRIMASK(primask);
+}
@@ -0,0 +1,429 @@
+#include "AD9959.h"
+#include <string.h>
+
+/************************************************************
+	模拟调制流:芯片自带的只有2~16电平的ASK/FSK/PSK,模拟调幅/调频由软件按固定速率
+	把基带样点换算成ACR/CFTW0写进去实现
+	每个样点一帧:指令字节+寄存器数据(调频5字节,调幅4字节),定时器每个样点周期中断一次,
+	中断里先IO_Update让上一周期写好的样点生效(时刻确定),再启动下一个样点的发送,
+	DMA方式下发送在后台进行,下一次IO_Update前等待发完
+	两种样点来源:
+	AD9959_StreamStart		AD9959_StreamBuild预先转换好的帧(如正弦表),中断里只取指针发送
+	AD9959_StreamStartLive	循环读一个int16样点缓冲区(如ADC循环DMA的目标),中断里用整数
+							运算换算,不用浮点,不调用换算函数
+	样点为有符号16位,+-32767对应+-Depth;12位ADC可以用 (x - 2048) << 4 换算
+	用法:	void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+			{
+				AD9959_StreamIRQ(htim);
+			}
+			AD9959_Mod_t fm = {CH0, FSK, AD9959_HzToFtw(10000000), AD9959_HzToFtw(75000)};
+			AD9959_StreamBuild(&fm, sine, 64, frames);			//frames[64*5]
+			AD9959_StreamStart(&htim6, 1000000, 100000, &fm, frames, 64, 1);
+	输出期间AD9959只能由调制流访问;能达到的速率受每帧的发送时间限制,启动时按通信方式实测
+	一帧的用时(统计中的FrameCycles),速率超过上限的拒绝启动;运行中从Rate、IrqMax和Overruns可以看出
+**************************************************************/
+
+typedef struct
+{
+	TIM_HandleTypeDef *htim;
+	AD9959_Mod_t Mod;
+	const uint8_t *Frames;					//预先转换的帧,NULL为实时换算
+	const volatile int16_t *Ring;		//实时换算的样点缓冲区
+	uint32_t Count;									//帧数或缓冲区样点数
+	uint32_t Index;									//下一个要发送的样点
+	uint8_t  Len;										//帧长度
+	uint8_t  Loop;
+	uint8_t  Pending;								//1:有已发送还没生效的帧
+	uint8_t  LiveIdx;
+	uint8_t  Live[2][AD9959_STREAM_FRAME_MAX];	//实时换算的帧,交替使用
+	const uint8_t *Sent;						//最后发送的帧
+	volatile uint8_t Running;
+	uint32_t Period;								//样点周期,CPU周期
+	uint64_t PeriodQ16;							//样点周期,CPU周期,16.16定点
+	AD9959_Timing_t Timing;					//样点生效时刻统计
+	AD9959_StreamStats_t Stats;
+}AD9959_Stream_t;
+
+static AD9959_Stream_t stream;
+
+//样点s换算成一帧写到f:调频为CFTW0,调幅为ACR(打开幅度乘法器,超出0~1023截掉)
+#define STREAM_ENCODE(f, m, s)	\
+	do	\
+	{	\
+		uint32_t v_;	\
+		int32_t a_;	\
+		if((m)->Param == FSK)	\
+		{	\
+			v_ = (m)->Carrier + (uint32_t)(((int64_t)(s) * (m)->Depth) >> 15);	\
+			(f)[0] = CFTW0_ADD;	\
+			(f)[1] = (uint8_t)(v_ >> 24);	\
+			(f)[2] = (uint8_t)(v_ >> 16);	\
+			(f)[3] = (uint8_t)(v_ >> 8);	\
+			(f)[4] = (uint8_t)v_;	\
+		}	\
+		else	\
+		{	\
+			a_ = (int32_t)(m)->Carrier + (((int32_t)(s) * (int32_t)(m)->Depth) >> 15);	\
+			a_ = (a_ < 0) ? 0 : (a_ > 1023) ? 1023 : a_;	\
+			(f)[0] = ACR_ADD;	\
+			(f)[1] = 0x00;	\
+			(f)[2] = (uint8_t)(0x10 | (a_ >> 8));	\
+			(f)[3] = (uint8_t)a_;	\
+		}	\
+	}while(0)
+
+/************************************************************
+** 函数名称 ：uint8_t AD9959_StreamFrameLen(uint8_t Param)
+** 函数功能 ：一个样点的帧字节数
+** 出口参数 ：FSK:5 ASK:4 其他:0
+**************************************************************/
+uint8_t AD9959_StreamFrameLen(uint8_t Param)
+{
+	return (Param == FSK) ? 5 : (Param == ASK) ? 4 : 0;
+}
+
+/************************************************************
+** 函数名称 ：uint8_t ad9959_mod_check(const AD9959_Mod_t *mod)
+** 函数功能 ：检查调制参数,0:正确
+**************************************************************/
+static uint8_t ad9959_mod_check(const AD9959_Mod_t *mod)
+{
+	return mod == NULL || (mod->Channel & 0xF0) == 0 || AD9959_StreamFrameLen(mod->Param) == 0 ||
+		(mod->Param == ASK && (mod->Carrier > 1023 || mod->Depth > 1023));
+}
+
+/************************************************************
+** 函数名称 ：uint8_t AD9959_StreamBuild(const AD9959_Mod_t *mod, const int16_t *src, uint32_t n, uint8_t *frames)
+** 函数功能 ：把n个样点预先转换成帧
+** 入口参数 ：mod:		调制参数
+							src:		样点
+							n:			样点数
+							frames:	结果,长度n*AD9959_StreamFrameLen(mod->Param)字节,用DMA时要放在DMA能访问的RAM中
+** 出口参数 ：0:成功 1:参数错误
+**************************************************************/
+uint8_t AD9959_StreamBuild(const AD9959_Mod_t *mod, const int16_t *src, uint32_t n, uint8_t *frames)
+{
+	uint8_t len;
+	uint32_t i;
+
+	if(ad9959_mod_check(mod) || src == NULL || frames == NULL)
+	{
+		return 1;
+	}
+	len = AD9959_StreamFrameLen(mod->Param);
+	for(i=0; i<n; i++)
+	{
+		STREAM_ENCODE(frames + i * len, mod, src[i]);
+	}
+	return 0;
+}
+
+/************************************************************
+** 函数名称 ：void ad9959_stream_send(void)
+** 函数功能 ：启动下一个样点的发送,不循环且已发完时什么也不做
+**************************************************************/
+static void ad9959_stream_send(void)
+{
+	uint8_t *live;
+	const uint8_t *f;
+
+	if(stream.Index >= stream.Count)
+	{
+		if(!stream.Loop)
+		{
+			return;
+		}
+		stream.Index = 0;
+		stream.Stats.Loops++;
+	}
+	if(stream.Frames != NULL)
+	{
+		f = stream.Frames + stream.Index * stream.Len;
+	}
+	else
+	{
+		live = stream.Live[stream.LiveIdx];
+		stream.LiveIdx ^= 1;
+		STREAM_ENCODE(live, &stream.Mod, stream.Ring[stream.Index]);
+		f = live;
+	}
+	stream.Index++;
+	if(AD9959_Bus.Start(f, stream.Len))
+	{
+		stream.Stats.BusErrors++;
+	}
+	stream.Sent = f;
+	stream.Pending = 1;
+}
+
+/************************************************************
+** 函数名称 ：uint32_t ad9959_stream_probe(const AD9959_Mod_t *mod)
+** 函数功能 ：实测一个样点的开销:把第一个通道CFTW0/ACR的当前值作为一帧发出再IO_Update,输出不变
+** 函数说明 ：只选中第一个通道,其他通道的值不同,一起选中会被改写
+** 出口参数 ：用时,CPU周期
+**************************************************************/
+static uint32_t ad9959_stream_probe(const AD9959_Mod_t *mod)
+{
+	uint8_t f[AD9959_STREAM_FRAME_MAX];
+	uint8_t len = AD9959_StreamFrameLen(mod->Param);
+	uint8_t ch, i;
+	uint32_t value, start;
+
+	for(ch=0; !(mod->Channel & (0x10 << ch)); ch++);
+	f[0] = (mod->Param == FSK) ? CFTW0_ADD : ACR_ADD;
+	value = AD9959_Shadow.Reg[ch][f[0]];
+	for(i=1; i<len; i++)
+	{
+		f[i] = (uint8_t)(value >> (8 * (len - 1 - i)));
+	}
+	AD9959_Select(0x10 << ch);
+	AD9959_BusWait();
+	start = DWT->CYCCNT;
+	AD9959_Bus.Start(f, len);
+	IO_Update();
+	return DWT->CYCCNT - start;
+}
+
+/************************************************************
+** 函数名称 ：uint8_t ad9959_stream_begin(TIM_HandleTypeDef *htim, uint32_t TickHz, uint32_t Rate, const AD9959_Mod_t *mod)
+** 函数功能 ：检查参数和速率,通道关闭调制和扫描,设置定时器周期
+** 出口参数 ：0:成功 1:参数错误或速率太高
+** 函数说明 ：中断里除了发一帧和IO_Update还有进出中断和换算,实测用时再留1/4余量
+**************************************************************/
+static uint8_t ad9959_stream_begin(TIM_HandleTypeDef *htim, uint32_t TickHz, uint32_t Rate, const AD9959_Mod_t *mod)
+{
+	uint32_t ticks, cost;
+	uint64_t period;
+	uint8_t ch;
+
+	if(htim == NULL || Rate == 0 || ad9959_mod_check(mod))
+	{
+		return 1;
+	}
+	ticks = TickHz / Rate;
+	if(ticks < 2 || ticks > AD9959_TIM_TICKS_MAX)
+	{
+		return 1;
+	}
+	AD9959_StreamStop();
+	period = (((uint64_t)SystemCoreClock << 16) / TickHz) * ticks;
+	cost = ad9959_stream_probe(mod);
+	if(cost + cost / 4 >= (period >> 16))
+	{
+		return 1;
+	}
+
+	memset(&stream, 0, sizeof(stream));
+	stream.htim = htim;
+	stream.Mod = *mod;
+	stream.Len = AD9959_StreamFrameLen(mod->Param);
+	stream.PeriodQ16 = period;
+	stream.Period = (uint32_t)(period >> 16);
+	stream.Stats.FrameCycles = cost;
+
+	//CFTW0/ACR直接决定输出:关闭调制和扫描
+	for(ch=0; ch<4; ch++)
+	{
+		if(mod->Channel & (0x10 << ch))
+		{
+			AD9959_Stage(0x10 << ch, CFR_ADD, AD9959_Shadow.Stage[ch][CFR_ADD] & ~0xC04000UL);
+		}
+	}
+	AD9959_Commit();
+	AD9959_Select(mod->Channel);
+	AD9959_BusWait();
+
+	htim->Instance->CR1 &= ~TIM_CR1_ARPE;
+	__HAL_TIM_SET_AUTORELOAD(htim, ticks - 1);
+	__HAL_TIM_SET_COUNTER(htim, 0);
+	__HAL_TIM_CLEAR_FLAG(htim, TIM_FLAG_UPDATE);
+	return 0;
+}
+
+/************************************************************
+** 函数名称 ：void ad9959_stream_own(uint8_t on)
+** 函数功能 ：在影子寄存器中标记/取消标记调制流直接写入的寄存器,寄存器核对跳过它们
+**************************************************************/
+static void ad9959_stream_own(uint8_t on)
+{
+	uint32_t bit = 1UL << ((stream.Mod.Param == FSK) ? CFTW0_ADD : ACR_ADD);
+	uint8_t ch;
+
+	for(ch=0; ch<4; ch++)
+	{
+		if(stream.Mod.Channel & (0x10 << ch))
+		{
+			AD9959_Shadow.Owned[ch] = on ? (AD9959_Shadow.Owned[ch] | bit) : (AD9959_Shadow.Owned[ch] & ~bit);
+		}
+	}
+}
+
+/************************************************************
+** 函数名称 ：void ad9959_stream_run(void)
+** 函数功能 ：第一个样点立即生效,发送第二个样点后启动定时器
+** 函数说明 ：先发完再启动,否则速率高时第一次中断会在发送途中到来;第一个样点因此多保持一帧的发送时间
+**************************************************************/
+static void ad9959_stream_run(void)
+{
+	ad9959_stream_own(1);
+	stream.Running = 1;
+	ad9959_stream_send();
+	IO_Update();
+	stream.Pending = 0;
+	stream.Stats.Samples = 1;
+	ad9959_stream_send();
+	AD9959_TimingStart(&stream.Timing, DWT->CYCCNT);
+	HAL_TIM_Base_Start_IT(stream.htim);
+}
+
+/************************************************************
+** 函数名称 ：uint8_t AD9959_StreamStart(TIM_HandleTypeDef *htim, uint32_t TickHz, uint32_t Rate, const AD9959_Mod_t *mod, const uint8_t *frames, uint32_t n, uint8_t Loop)
+** 函数功能 ：按Rate的速率输出AD9959_StreamBuild转换好的帧,第一个样点立即生效
+** 入口参数 ：htim:		定时器,只用更新中断
+							TickHz:		定时器计数频率
+							Rate:			样点速率,Hz,实际为TickHz/(TickHz/Rate)
+							mod:			调制参数,与转换帧时相同
+							frames:		帧,输出期间不能修改
+							n:				帧数
+							Loop:			1:循环 0:输出一遍后停在最后一个样点
+** 出口参数 ：0:成功 1:参数错误(定时器每个样点要计2~AD9959_TIM_TICKS_MAX个数),或样点周期放不下一帧的发送
+**************************************************************/
+uint8_t AD9959_StreamStart(TIM_HandleTypeDef *htim, uint32_t TickHz, uint32_t Rate, const AD9959_Mod_t *mod, const uint8_t *frames, uint32_t n, uint8_t Loop)
+{
+	if(frames == NULL || n == 0 || ad9959_stream_begin(htim, TickHz, Rate, mod))
+	{
+		return 1;
+	}
+	stream.Frames = frames;
+	stream.Count = n;
+	stream.Loop = Loop;
+	ad9959_stream_run();
+	return 0;
+}
+
+/************************************************************
+** 函数名称 ：uint8_t AD9959_StreamStartLive(TIM_HandleTypeDef *htim, uint32_t TickHz, uint32_t Rate, const AD9959_Mod_t *mod, const volatile int16_t *ring, uint32_t len)
+** 函数功能 ：按Rate的速率循环读ring中的样点,在中断里换算后输出
+** 入口参数 ：ring:		样点缓冲区,由ADC循环DMA等以同样的速率不断写入
+							len:			缓冲区样点数
+							其他同AD9959_StreamStart
+** 出口参数 ：0:成功 1:参数错误或速率太高,同AD9959_StreamStart
+** 函数说明 ：读位置与写入方不做同步,两边速率相同时固定相差一段延迟
+**************************************************************/
+uint8_t AD9959_StreamStartLive(TIM_HandleTypeDef *htim, uint32_t TickHz, uint32_t Rate, const AD9959_Mod_t *mod, const volatile int16_t *ring, uint32_t len)
+{
+	if(ring == NULL || len == 0 || ad9959_stream_begin(htim, TickHz, Rate, mod))
+	{
+		return 1;
+	}
+	stream.Ring = ring;
+	stream.Count = len;
+	stream.Loop = 1;
+	ad9959_stream_run();
+	return 0;
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_StreamStop(void)
+** 函数功能 ：停止输出,当前输出保持不变
+** 函数说明 ：已发送还没生效的一个样点留在缓冲寄存器中,影子寄存器按它记录
+**************************************************************/
+void AD9959_StreamStop(void)
+{
+	const uint8_t *f = stream.Sent;
+	uint32_t value;
+	uint8_t ch;
+
+	if(!stream.Running)
+	{
+		return;
+	}
+	HAL_TIM_Base_Stop_IT(stream.htim);
+	AD9959_BusWait();
+	stream.Running = 0;
+
+	if(f[0] == CFTW0_ADD)
+	{
+		value = ((uint32_t)f[1] << 24) | ((uint32_t)f[2] << 16) | ((uint32_t)f[3] << 8) | f[4];
+	}
+	else
+	{
+		value = ((uint32_t)f[1] << 16) | ((uint32_t)f[2] << 8) | f[3];
+	}
+	for(ch=0; ch<4; ch++)
+	{
+		if(stream.Mod.Channel & (0x10 << ch))
+		{
+			AD9959_Shadow.Reg[ch][f[0]] = value;
+			AD9959_Shadow.Stage[ch][f[0]] = value;
+		}
+	}
+	if(stream.Pending)
+	{
+		AD9959_Shadow.Pending = 1;
+	}
+	ad9959_stream_own(0);
+}
+
+/************************************************************
+** 函数名称 ：uint8_t AD9959_StreamBusy(void)
+** 函数功能 ：是否正在输出,不循环时最后一个样点生效后自动停止
+**************************************************************/
+uint8_t AD9959_StreamBusy(void)
+{
+	return stream.Running;
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_StreamIRQ(TIM_HandleTypeDef *htim)
+** 函数功能 ：定时器更新中断中调用:上一周期发送的样点生效,再发送下一个样点
+**************************************************************/
+void AD9959_StreamIRQ(TIM_HandleTypeDef *htim)
+{
+	uint32_t start = DWT->CYCCNT;
+
+	if(!stream.Running || htim != stream.htim)
+	{
+		return;
+	}
+	if(!stream.Pending)
+	{
+		AD9959_StreamStop();		//最后一个样点已生效
+		return;
+	}
+	IO_Update();
+	AD9959_TimingStamp(&stream.Timing, start, stream.PeriodQ16);
+	stream.Stats.Samples++;
+	stream.Pending = 0;
+	ad9959_stream_send();
+
+	start = DWT->CYCCNT - start;
+	if(start > stream.Stats.IrqMax)
+	{
+		stream.Stats.IrqMax = start;
+	}
+	if(start >= stream.Period)
+	{
+		stream.Stats.Overruns++;
+	}
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_StreamGetStats(AD9959_StreamStats_t *stats)
+** 函数功能 ：读统计,Rate按第一个样点以来的实际时间计算
+**************************************************************/
+void AD9959_StreamGetStats(AD9959_StreamStats_t *stats)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	*stats = stream.Stats;
+	stats->JitterMin = stream.Timing.JitterMin;
+	stats->JitterMax = stream.Timing.JitterMax;
+	stats->JitterAbsSum = stream.Timing.JitterAbsSum;
+	if(stream.Timing.Elapsed != 0)
+	{
+		stats->Rate = (uint32_t)((uint64_t)(stats->Samples - 1) * SystemCoreClock / stream.Timing.Elapsed);
+	}
+	__set_PRIMASK(primask);
+}
@@ -0,0 +1,320 @@
+#include "AD9959.h"
+#include <string.h>
+
+/************************************************************
+	线性扫描规划:给出起点、终点和扫描时间,自动选择步长(RDW/FDW)和斜率(RSRR/FSRR)
+	芯片的扫描时间 T = 步数 * SRR * 4 / SYSCLK,步数 = ceil(|终点-起点| / 步长),
+	对SRR=1~255逐个取最合适的步长,选实际时间误差最小的一组,相同时选SRR小的(台阶更细)
+	芯片要求起点S0小于终点E0,Profile引脚为高时向E0扫描、为低时向S0扫描:
+	上升扫描	用规划的RDW/RSRR,FDW取最大、FSRR=1,引脚先拉低回到起点再拉高
+	下降扫描	用规划的FDW/FSRR,RDW取最大、RSRR=1,引脚先拉高到起点再拉低
+	分段扫描用定时器在每段的实际扫描时间到时切换到下一段,下一段的参数预先写入缓冲寄存器,
+	切换时只需IO_Update和翻转引脚,中断调用方法与AD9959_Player.c相同
+**************************************************************/
+
+typedef struct
+{
+	TIM_HandleTypeDef *htim;
+	const AD9959_SweepPlan_t *Plans;
+	uint32_t Count;
+	uint32_t Index;				//正在扫描的段
+	uint32_t Next;				//已写入的下一段,等于Count表示没有
+	uint32_t TickHz;
+	uint8_t  Channel;
+	uint8_t  Loop;
+	volatile uint8_t Running;
+}AD9959_SweepRun_t;
+
+static AD9959_SweepRun_t sweep;
+
+/************************************************************
+** 函数名称 ：uint8_t AD9959_SweepPlan(uint8_t Param, uint32_t Start, uint32_t Stop, uint64_t Time, AD9959_SweepPlan_t *plan)
+** 函数功能 ：计算线性扫描的寄存器值
+** 入口参数 ：Param:	FSK扫频 PSK扫相 ASK扫幅
+							Start:	起点,频率控制字/相位控制字0~16383/幅度比例因子0~1023
+							Stop:		终点,可以比起点小
+							Time:		扫描时间,ns,超出芯片范围时取最接近的值
+							plan:		计算结果,plan->Time为实际扫描时间
+** 出口参数 ：0:成功 1:参数错误(Param不对或起点终点相同)
+** 函数说明 ：按当前系统时钟计算,AD9959_ClockConfig之后要重新规划;不在中断中调用
+**************************************************************/
+uint8_t AD9959_SweepPlan(uint8_t Param, uint32_t Start, uint32_t Stop, uint64_t Time, AD9959_SweepPlan_t *plan)
+{
+	uint64_t sys = AD9959_Clock.SysClk;
+	uint64_t a, k, n, t, err, best = UINT64_MAX;
+	uint32_t delta, dw, bestDw = 1, steps, bestSteps = 1;
+	uint8_t shift, i, r, bestR = 1;
+
+	switch(Param)
+	{
+		case FSK:	shift = 0;	break;
+		case PSK:	shift = 18;	Start &= 0x3FFF;	Stop &= 0x3FFF;	break;
+		case ASK:	shift = 22;	Start &= 0x3FF;		Stop &= 0x3FF;		break;
+		default:	return 1;
+	}
+	if(Start == Stop)
+	{
+		return 1;
+	}
+	delta = (Stop > Start) ? Stop - Start : Start - Stop;
+
+	//目标时间换算为SYNC_CLK个数 k = Time*SYSCLK/4e9,分成整秒和不足1秒两部分避免溢出
+	a = (Time / 1000000000) * sys;
+	k = a / 4 + ((Time % 1000000000) * sys + (a % 4) * 1000000000 + 2000000000) / 4000000000UL;
+	if(k == 0)
+	{
+		k = 1;
+	}
+
+	for(r=1; r!=0; r++)
+	{
+		n = (k + r / 2) / r;
+		n = (n == 0) ? 1 : (n > delta) ? delta : n;
+		//步长取 ceil(delta/n) 和 floor(delta/n) 两种,步数分别不多于和不少于n
+		for(i=0; i<2; i++)
+		{
+			dw = (i == 0) ? (uint32_t)((delta + n - 1) / n) : (uint32_t)(delta / n);
+			if(dw == 0)
+			{
+				continue;
+			}
+			steps = (uint32_t)((delta + (uint64_t)dw - 1) / dw);
+			t = (uint64_t)steps * r;
+			err = (t > k) ? t - k : k - t;
+			if(err < best)
+			{
+				best = err;
+				bestR = r;
+				bestDw = dw;
+				bestSteps = steps;
+			}
+		}
+	}
+
+	plan->Param = Param;
+	plan->Up = (Stop > Start);
+	plan->S0 = plan->Up ? Start : Stop;
+	plan->E0 = (plan->Up ? Stop : Start) << shift;
+	plan->Steps = bestSteps;
+	if(plan->Up)
+	{
+		plan->Rdw = bestDw << shift;
+		plan->Rsrr = bestR;
+		plan->Fdw = 0xFFFFFFFF;		//回到起点只需一步
+		plan->Fsrr = 1;
+	}
+	else
+	{
+		plan->Fdw = bestDw << shift;
+		plan->Fsrr = bestR;
+		plan->Rdw = 0xFFFFFFFF;
+		plan->Rsrr = 1;
+	}
+	//实际时间 = 步数*SRR*4/SYSCLK 秒
+	t = (uint64_t)bestSteps * bestR * 4;
+	plan->Time = (t / sys) * 1000000000 + ((t % sys) * 1000000000 + sys / 2) / sys;
+	return 0;
+}
+
+/************************************************************
+** 函数名称 ：uint16_t AD9959_SweepLoad(uint8_t Channel, const AD9959_SweepPlan_t *plan)
+** 函数功能 ：把扫描参数写入Channel中各通道的缓冲寄存器,不产生IO_Update
+** 出口参数 ：写入的字节数,所有寄存器拼成一帧发送,没有变化的不写
+** 函数说明 ：FR1设为2电平,CFR选择扫描参数、打开扫描和IO_Update时装载斜率计数器
+**************************************************************/
+uint16_t AD9959_SweepLoad(uint8_t Channel, const AD9959_SweepPlan_t *plan)
+{
+	uint8_t ch;
+
+	AD9959_Stage(0, FR1_ADD, AD9959_Shadow.Stage[0][FR1_ADD] & ~0x000300UL);
+	for(ch=0; ch<4; ch++)
+	{
+		if(Channel & (0x10 << ch))
+		{
+			AD9959_Stage(0x10 << ch, CFR_ADD, (AD9959_Shadow.Stage[ch][CFR_ADD] & ~0xC0C000UL) |
+				((uint32_t)plan->Param << 16) | ((uint32_t)SWEEP_ENABLE << 8) | CFR_LOAD_SRR);
+		}
+	}
+	AD9959_Stage(Channel, LSRR_ADD, ((uint32_t)plan->Fsrr << 8) | plan->Rsrr);
+	AD9959_Stage(Channel, RDW_ADD, plan->Rdw);
+	AD9959_Stage(Channel, FDW_ADD, plan->Fdw);
+	switch(plan->Param)
+	{
+		case FSK:	AD9959_Stage(Channel, CFTW0_ADD, plan->S0);					break;
+		case PSK:	AD9959_Stage(Channel, CPOW0_ADD, plan->S0);					break;
+		default:	AD9959_Stage(Channel, ACR_ADD, plan->S0 | 0x1000);	break;
+	}
+	AD9959_Stage(Channel, PROFILE_ADDR_BASE, plan->E0);
+	return AD9959_Flush();
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_SweepGo(uint8_t Channel, const AD9959_SweepPlan_t *plan)
+** 函数功能 ：已写入的扫描参数生效,并按方向拉Profile引脚开始扫描
+** 函数说明 ：引脚先到反方向停留约2个SYNC_CLK,以最大步长回到起点,再翻转开始扫描
+**************************************************************/
+void AD9959_SweepGo(uint8_t Channel, const AD9959_SweepPlan_t *plan)
+{
+	uint32_t cycles = (uint32_t)((8ULL * SystemCoreClock) / AD9959_Clock.SysClk) + 1;
+
+	IO_Update();
+	AD9959_ProfilePins(Channel, plan->Up ? 0 : Channel);
+	AD9959_DelayCycles(cycles);
+	AD9959_ProfilePins(Channel, plan->Up ? Channel : 0);
+}
+
+/************************************************************
+** 函数名称 ：uint8_t AD9959_Sweep(uint8_t Channel, uint8_t Param, uint32_t Start, uint32_t Stop, uint64_t Time)
+** 函数功能 ：规划并开始一次线性扫描,扫到终点后停在终点
+** 入口参数 ：Channel:  通道CH0~CH3的组合
+							其他参数同AD9959_SweepPlan
+** 出口参数 ：0:成功 1:参数错误
+** 示例     ：AD9959_Sweep(CH0, FSK, AD9959_HzToFtw(1000000), AD9959_HzToFtw(10000000), 1000000);//1ms从1MHz扫到10MHz
+**************************************************************/
+uint8_t AD9959_Sweep(uint8_t Channel, uint8_t Param, uint32_t Start, uint32_t Stop, uint64_t Time)
+{
+	AD9959_SweepPlan_t plan;
+
+	if(AD9959_SweepPlan(Param, Start, Stop, Time, &plan))
+	{
+		return 1;
+	}
+	AD9959_SweepLoad(Channel, &plan);
+	AD9959_SweepGo(Channel, &plan);
+	return 0;
+}
+
+/************************************************************
+** 函数名称 ：uint32_t ad9959_sweep_ticks(const AD9959_SweepPlan_t *plan, uint32_t TickHz)
+** 函数功能 ：一段扫描的实际时间换算为定时器计数个数
+**************************************************************/
+static uint32_t ad9959_sweep_ticks(const AD9959_SweepPlan_t *plan, uint32_t TickHz)
+{
+	uint64_t t = (plan->Time / 1000000000) * TickHz +
+		((plan->Time % 1000000000) * TickHz + 500000000) / 1000000000;
+
+	return (t < 2) ? 2 : (t > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32_t)t;
+}
+
+/************************************************************
+** 函数名称 ：uint32_t ad9959_sweep_next(uint32_t i)
+** 函数功能 ：第i段之后的段,没有时返回Count
+**************************************************************/
+static uint32_t ad9959_sweep_next(uint32_t i)
+{
+	if(++i < sweep.Count)
+	{
+		return i;
+	}
+	return sweep.Loop ? 0 : sweep.Count;
+}
+
+/************************************************************
+** 函数名称 ：uint8_t AD9959_SweepStart(TIM_HandleTypeDef *htim, uint32_t TickHz, uint8_t Channel, const AD9959_SweepPlan_t *plans, uint32_t count, uint8_t Loop)
+** 函数功能 ：分段扫描,每段扫描时间到时切换到下一段
+** 入口参数 ：htim:		定时器,只用更新中断,打开自动重装载预装载
+							TickHz:		定时器计数频率
+							Channel:  通道CH0~CH3的组合
+							plans:		各段的扫描计划,用AD9959_SweepPlan预先算好,扫描期间不能修改
+							count:		段数
+							Loop:			1:循环 0:扫完最后一段后停在终点
+** 出口参数 ：0:成功 1:参数错误,或有一段的扫描时间超过AD9959_TIM_TICKS_MAX个定时器计数
+** 示例     ：三角波扫频,上升1ms、下降3ms:
+							AD9959_SweepPlan(FSK, f1, f2, 1000000, &plans[0]);
+							AD9959_SweepPlan(FSK, f2, f1, 3000000, &plans[1]);
+							AD9959_SweepStart(&htim6, 1000000, CH0, plans, 2, 1);
+**************************************************************/
+uint8_t AD9959_SweepStart(TIM_HandleTypeDef *htim, uint32_t TickHz, uint8_t Channel, const AD9959_SweepPlan_t *plans, uint32_t count, uint8_t Loop)
+{
+	uint32_t i;
+
+	if(htim == NULL || plans == NULL || count == 0 || TickHz == 0 || (Channel & 0xF0) == 0)
+	{
+		return 1;
+	}
+	for(i=0; i<count; i++)
+	{
+		if(ad9959_sweep_ticks(&plans[i], TickHz) > AD9959_TIM_TICKS_MAX)
+		{
+			return 1;
+		}
+	}
+	AD9959_SweepStop();
+
+	memset(&sweep, 0, sizeof(sweep));
+	sweep.htim = htim;
+	sweep.Plans = plans;
+	sweep.Count = count;
+	sweep.TickHz = TickHz;
+	sweep.Channel = Channel & 0xF0;
+	sweep.Loop = Loop;
+
+	AD9959_SweepLoad(sweep.Channel, &plans[0]);
+	sweep.Next = ad9959_sweep_next(0);
+	htim->Instance->CR1 &= ~TIM_CR1_ARPE;
+	__HAL_TIM_SET_AUTORELOAD(htim, ad9959_sweep_ticks(&plans[0], TickHz) - 1);
+	__HAL_TIM_SET_COUNTER(htim, 0);
+	htim->Instance->CR1 |= TIM_CR1_ARPE;
+	if(sweep.Next < count)
+	{
+		__HAL_TIM_SET_AUTORELOAD(htim, ad9959_sweep_ticks(&plans[sweep.Next], TickHz) - 1);
+	}
+	__HAL_TIM_CLEAR_FLAG(htim, TIM_FLAG_UPDATE);
+
+	sweep.Running = 1;
+	AD9959_SweepGo(sweep.Channel, &plans[0]);
+	HAL_TIM_Base_Start_IT(htim);
+	if(sweep.Next < count)
+	{
+		AD9959_SweepLoad(sweep.Channel, &plans[sweep.Next]);
+	}
+	return 0;
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_SweepStop(void)
+** 函数功能 ：停止分段扫描,当前这一段照常扫完
+**************************************************************/
+void AD9959_SweepStop(void)
+{
+	if(sweep.Running)
+	{
+		HAL_TIM_Base_Stop_IT(sweep.htim);
+		sweep.Running = 0;
+	}
+}
+
+/************************************************************
+** 函数名称 ：uint8_t AD9959_SweepBusy(void)
+** 函数功能 ：分段扫描是否进行中,不循环时最后一段的时间到后自动停止
+**************************************************************/
+uint8_t AD9959_SweepBusy(void)
+{
+	return sweep.Running;
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_SweepIRQ(TIM_HandleTypeDef *htim)
+** 函数功能 ：定时器更新中断中调用:切换到已写入的下一段,再写入之后的一段
+**************************************************************/
+void AD9959_SweepIRQ(TIM_HandleTypeDef *htim)
+{
+	if(!sweep.Running || htim != sweep.htim)
+	{
+		return;
+	}
+	if(sweep.Next >= sweep.Count)
+	{
+		AD9959_SweepStop();
+		return;
+	}
+
+	AD9959_SweepGo(sweep.Channel, &sweep.Plans[sweep.Next]);
+	sweep.Index = sweep.Next;
+	sweep.Next = ad9959_sweep_next(sweep.Index);
+	if(sweep.Next < sweep.Count)
+	{
+		__HAL_TIM_SET_AUTORELOAD(htim, ad9959_sweep_ticks(&sweep.Plans[sweep.Next], sweep.TickHz) - 1);
+		AD9959_SweepLoad(sweep.Channel, &sweep.Plans[sweep.Next]);
+	}
+}
@@ -0,0 +1,167 @@
+#include "AD9959.h"
+#include <string.h>
+
+/************************************************************
+	寄存器核对:在主循环里每次读回一个寄存器,与影子寄存器(最后写入的值)比较,
+	掉电、干扰造成的错误不用停下正在输出的信号就能发现并修正
+	核对顺序为CSR、FR1、FR2,再依次是CH0~CH3的CFR~CW15,一轮共91个寄存器
+	CSR或FR1不对时认为芯片复位过,复位芯片后按影子寄存器整体重写;
+	其他寄存器不对时只重写这一个,缓冲寄存器没有等待生效的写入时立即IO_Update,
+	否则(如跳频播放已写好下一项)随下一次IO_Update一起生效
+	每一步在关中断下完成(一次寄存器读,需要时前后各写一次CSR),读完把CSR恢复原样,
+	因此可以和定时器中断里的跳频播放、分段扫描、调制流同时运行,只会让它们推迟几微秒;
+	播放和扫描经影子寄存器写入,照常核对,调制流直接发帧写CFTW0/ACR,输出期间跳过这些寄存器
+	(AD9959_Shadow.Owned),调制流有待生效的样点时重写的寄存器也等它的下一次IO_Update
+	用法:	while(1)
+			{
+				...
+				AD9959_VerifyStep();
+			}
+	通信方式不支持读(AD9959_BUS_SPI)时AD9959_VerifyStep什么也不做
+**************************************************************/
+
+#define VERIFY_CH_REGS	(AD9959_REG_NUM - CFR_ADD)				//每个通道核对的寄存器数
+#define VERIFY_TOTAL		(CFR_ADD + 4 * VERIFY_CH_REGS)		//一轮核对的寄存器数
+
+typedef struct
+{
+	uint8_t Pos;										//下一个要核对的寄存器在一轮中的序号
+	AD9959_VerifyStats_t Stats;
+}AD9959_Verify_t;
+
+static AD9959_Verify_t verify;
+
+/************************************************************
+** 函数名称 ：void ad9959_rewrite(uint8_t ch, uint8_t addr)
+** 函数功能 ：按影子寄存器重写通道ch的一个寄存器,应用暂存的值保持不变
+**************************************************************/
+static void ad9959_rewrite(uint8_t ch, uint8_t addr)
+{
+	uint8_t data[4];
+	uint8_t n = AD9959_RegLen[addr], i;
+	uint8_t pending = AD9959_Shadow.Pending || AD9959_Shadow.Owned[0] || AD9959_Shadow.Owned[1] ||
+										AD9959_Shadow.Owned[2] || AD9959_Shadow.Owned[3];
+	uint32_t value = AD9959_Shadow.Reg[ch][addr];
+	uint32_t stage = AD9959_Shadow.Stage[ch][addr];
+
+	if(addr >= CFR_ADD)
+	{
+		AD9959_Select(0x10 << ch);
+	}
+	for(i=0; i<n; i++)
+	{
+		data[i] = (uint8_t)(value >> (8 * (n - 1 - i)));
+	}
+	AD9959_WriteData(addr, n, data);
+	AD9959_Shadow.Stage[ch][addr] = stage;		//AD9959_WriteData会改写暂存值
+	if(!pending)
+	{
+		IO_Update();
+	}
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_VerifyRestore(void)
+** 函数功能 ：复位芯片,按影子寄存器把所有寄存器重写一遍并IO_Update
+** 函数说明 ：AD9959_VerifyStep发现CSR/FR1不对时自动调用;也可以在上电检测等场合直接调用
+							关中断执行,复位要30us,写回FR1后等待PLL重新锁定约1ms
+**************************************************************/
+void AD9959_VerifyRestore(void)
+{
+	static uint32_t reg[4][AD9959_REG_NUM];
+	static uint32_t stage[4][AD9959_REG_NUM];
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	memcpy(reg, AD9959_Shadow.Reg, sizeof(reg));
+	memcpy(stage, AD9959_Shadow.Stage, sizeof(stage));
+	IntReset();																	//影子寄存器回到默认值
+	memcpy(AD9959_Shadow.Stage, reg, sizeof(reg));
+	AD9959_Commit();														//与默认值不同的寄存器全部写入,IO_UPDATE按复位后的参考时钟定脉宽
+	AD9959_ClockSettle();
+	memcpy(AD9959_Shadow.Stage, stage, sizeof(stage));
+	__set_PRIMASK(primask);
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_VerifyStep(void)
+** 函数功能 ：读回并核对一个寄存器,不对时重写
+** 函数说明 ：在主循环等低优先级的地方反复调用,每次只做一个寄存器
+**************************************************************/
+void AD9959_VerifyStep(void)
+{
+	uint32_t start = DWT->CYCCNT;
+	uint32_t primask, value, expect;
+	uint8_t ch, addr, csr;
+	AD9959_VerifyStats_t *st = &verify.Stats;
+
+	if(AD9959_Bus.Read == NULL)
+	{
+		return;
+	}
+	if(verify.Pos < CFR_ADD)
+	{
+		ch = 0;
+		addr = verify.Pos;
+	}
+	else
+	{
+		ch = (verify.Pos - CFR_ADD) / VERIFY_CH_REGS;
+		addr = CFR_ADD + (verify.Pos - CFR_ADD) % VERIFY_CH_REGS;
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	csr = AD9959_Shadow.CSR;
+	if(AD9959_Shadow.Owned[ch] & (1UL << addr))
+	{
+		st->Skipped++;
+	}
+	else
+	{
+		expect = (addr == CSR_ADD) ? (uint32_t)(csr | AD9959_Bus.CsrMode) : AD9959_Shadow.Reg[ch][addr];
+		AD9959_ReadReg(0x10 << ch, addr, &value);
+		st->Checked++;
+		if(value != expect)
+		{
+			st->Mismatch++;
+			st->LastCh = ch;
+			st->LastAddr = addr;
+			st->LastRead = value;
+			st->LastExpect = expect;
+			if(addr <= FR1_ADD)
+			{
+				AD9959_VerifyRestore();
+				st->Reinit++;
+			}
+			else
+			{
+				ad9959_rewrite(ch, addr);
+				st->Rewrite++;
+			}
+		}
+		AD9959_Select(csr);		//调制流等按原来的CSR直接发帧
+		AD9959_BusWait();
+	}
+	__set_PRIMASK(primask);
+
+	if(++verify.Pos >= VERIFY_TOTAL)
+	{
+		verify.Pos = 0;
+		st->Rounds++;
+	}
+	start = DWT->CYCCNT - start;
+	if(start > st->StepMax)
+	{
+		st->StepMax = start;
+	}
+}
+
+/************************************************************
+** 函数名称 ：void AD9959_VerifyGetStats(AD9959_VerifyStats_t *stats)
+** 函数功能 ：读核对统计
+**************************************************************/
+void AD9959_VerifyGetStats(AD9959_VerifyStats_t *stats)
+{
+	*stats = verify.Stats;
+}
@@ -1,15 +1,15 @@
 /**********************************************************
-                       
+                       康威电子
 										 
-ܣADF4351ҲƵΧ35M-4400M0.1Mstm32f103rct6
-			ʾ12864
-ӿڣCLK-PC11 DATA-PC10 LE-PC9 CE-PC12  ӿkey.h
-ʱ䣺2015/11/3
-汾1.0
-ߣ
-
-
-뵽Ա꣬ӽ߳Ϊ ^_^
+功能：ADF4351正弦波点频输出，范围35M-4400M，步进0.1M，stm32f103rct6控制
+			显示：12864
+接口：CLK-PC11 DATA-PC10 LE-PC9 CE-PC12  按键接口请参照key.h
+时间：2015/11/3
+版本：1.0
+作者：康威电子
+其他：
+
+更多电子需求，请到淘宝店，康威电子竭诚为您服务 ^_^
 https://shop110336474.taobao.com/?spm=a230r.7195193.1997079397.2.Ic3MRJ
 
 **********************************************************/
@@ -34,6 +34,9 @@ https://shop110336474.taobao.com/?spm=a230r.7195193.1997079397.2.Ic3MRJ
 #define ADF4351_PD_ON		((u32)0X10E42)
 #define ADF4351_PD_OFF	((u32)0X10E02)
 
+ADF4351_Shadow_t ADF4351_Shadow;
+ADF4351_RefConfig_t ADF4351_RefConfig = {100000000, 4, 0, 0, 100000};	//板载100M参考,R=4得25M鉴相,输出步进0.1MHz
+
 
 //void ADF_Output_GPIOInit(void)
 //{
@@ -47,41 +50,41 @@ https://shop110336474.taobao.com/?spm=a230r.7195193.1997079397.2.Ic3MRJ
 //	GPIO_Init(GPIOC, &GPIO_InitStruct);
 //	
 //}
-// ADF  GPIO ʼ (C9~C12 )
+// ADF 输出 GPIO 初始化 (C9~C12 推挽输出)
 void ADF_Output_GPIOInit(void)
 {
     GPIO_InitTypeDef GPIO_InitStruct = {0};
 
-    // 1. ʹ GPIOC ʱ
+    // 1. 使能 GPIOC 时钟
     __HAL_RCC_GPIOC_CLK_ENABLE();
 
-    // 2.  PC9PC10PC11PC12 Ϊ
+    // 2. 配置 PC9、PC10、PC11、PC12 为推挽输出
     GPIO_InitStruct.Pin = GPIO_PIN_9 | GPIO_PIN_10 | GPIO_PIN_11 | GPIO_PIN_12;
-    GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;   // 
-    GPIO_InitStruct.Pull = GPIO_NOPULL;           // 
-    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH; // Ӧ׼ 50MHz
+    GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;   // 推挽输出
+    GPIO_InitStruct.Pull = GPIO_NOPULL;           // 无上下拉
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH; // 对应标准库的 50MHz
     HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
 }
 
-// ADF  GPIO ʼ (PC9/PC11/PC12 , PC10 )
+// ADF 输入 GPIO 初始化 (PC9/PC11/PC12 输出, PC10 浮空输入)
 void ADF_Input_GPIOInit(void)
 {
     GPIO_InitTypeDef GPIO_InitStruct = {0};
 
-    // 1. ʹ GPIOC ʱ
+    // 1. 使能 GPIOC 时钟
     __HAL_RCC_GPIOC_CLK_ENABLE();
 
-    // 2. PC9PC11PC12 Ϊ
+    // 2. PC9、PC11、PC12 配置为推挽输出
     GPIO_InitStruct.Pin = GPIO_PIN_9 | GPIO_PIN_11 | GPIO_PIN_12;
     GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
     GPIO_InitStruct.Pull = GPIO_NOPULL;
     GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
     HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
 
-    // 3. PC10 Ϊ
+    // 3. PC10 配置为浮空输入
     GPIO_InitStruct.Pin = GPIO_PIN_10;
     GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
-    GPIO_InitStruct.Pull = GPIO_NOPULL;  // HALûСIN_FLOATINGNOPULLЧ
+    GPIO_InitStruct.Pull = GPIO_NOPULL;  // HAL里没有“IN_FLOATING”，用NOPULL等效
     HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
 }
 
@@ -108,45 +111,27 @@ void delay (int length)
     	length--;
 }
 
+//寄存器字记入影子寄存器,控制位DB2~DB0为寄存器号
+static void ADF4351_Track(u32 value)
+{
+	if((value & 7) < 6)
+	{
+		ADF4351_Shadow.Reg[value & 7] = value;
+		ADF4351_Shadow.Valid |= 1 << (value & 7);
+	}
+}
+
+//buf[count-1]为最高字节,经ADF4351_Bus发送,发送方式见ADF4351_Bus.c
 void WriteToADF4351(u8 count, u8 *buf)
 {
-	u8 ValueToWrite = 0;
-	u8 i = 0;
-	u8 j = 0;
-	
-//	ADF_Output_GPIOInit();
-	
-	ADF4351_CE = 1;
-	delay_us(1);
-	ADF4351_CLK = 0;
-	ADF4351_LE = 0;
-	delay_us(1);
+	u32 value = 0;
+	u8 i;
 	
 	for(i = count; i>0; i--)
 	{
-		ValueToWrite = *(buf+i-1);
-		for(j=0; j<8; j++)
-		{
-			if(0x80 == (ValueToWrite & 0x80))
-			{
-				ADF4351_OUTPUT_DATA = 1;
-			}
-			else
-			{
-				ADF4351_OUTPUT_DATA = 0;
-			}
-			delay_us(1);
-			ADF4351_CLK = 1;
-			delay_us(1);
-			ValueToWrite <<= 1;
-			ADF4351_CLK = 0;	
-		}
+		value = (value << 8) | buf[i-1];
 	}
-	ADF4351_OUTPUT_DATA = 0;
-	delay_us(1);
-	ADF4351_LE = 1;
-	delay_us(1);
-	ADF4351_LE = 0;
+	WriteOneRegToADF4351(value);
 }
 
 
@@ -192,7 +177,10 @@ void ADF4351Init(void)
 {
 	u8 buf[4] = {0,0,0,0};
 	
-	ADF_Output_GPIOInit();
+	ADF4351_Bus.Init();
+	ADF4351_CE = 1;
+	delay_us(1);				//上电后等待芯片就绪
+	ADF4351_Shadow.Valid = 0;
 	
 	buf[3] = 0x00;
 	buf[2] = 0x58;
@@ -233,12 +221,10 @@ void ADF4351Init(void)
 }
 void WriteOneRegToADF4351(u32 Regster)
 {
-	u8 buf[4] = {0,0,0,0};
-	buf[3] = (u8)((Regster>>24)&(0X000000FF));
-	buf[2] = (u8)((Regster>>16)&(0X000000FF));
-	buf[1] = (u8)((Regster>>8) &(0X000000FF));
-	buf[0] = (u8)((Regster)&(0X000000FF));
-	WriteToADF4351(4,buf);	
+	if(ADF4351_BusWrite(&Regster, 1) == 0)
+	{
+		ADF4351_Track(Regster);
+	}
 }
 void ADF4351_Init_some(void)
 {
@@ -247,54 +233,102 @@ void ADF4351_Init_some(void)
 	WriteOneRegToADF4351(ADF4351_R5);
 }
 
-void ADF4351WriteFreq(float Fre)		//	freλMHz -> (xx.x) M Hz
+//当前的R0~R5,还没写过的寄存器取默认值
+void ADF4351_GetRegs(u32 *Reg)
 {
-	u16 Fre_temp, N_Mul = 1, Mul_Core = 0;
-	u16 INT_Fre, Frac_temp, Mod_temp, i;
-	u32 W_ADF4351_R0 = 0, W_ADF4351_R1 = 0, W_ADF4351_R4 = 0;
-	float multiple;
-	
-	if(Fre < 35.0)
-		Fre = 35.0;
-	if(Fre > 4400.0)
-		Fre = 4400.0;
-	Mod_temp = 1000;
-	Fre = ((float)((u32)(Fre*10)))/10;
+	const u32 def[6] = {ADF4351_R0, ADF4351_R1, ADF4351_R2, ADF4351_R3, ADF4351_R4, ADF4351_R5};
+	u8 i;
 	
-	Fre_temp = Fre;
-	for(i = 0; i < 10; i++)
+	for(i = 0; i < 6; i++)
 	{
-		if(((Fre_temp*N_Mul) >= 2199.9) && ((Fre_temp*N_Mul) <= 4400.1))
-			break;
-		Mul_Core++;
-		N_Mul = N_Mul*2;
+		Reg[i] = (ADF4351_Shadow.Valid & (1 << i)) ? ADF4351_Shadow.Reg[i] : def[i];
 	}
+}
+
+/************************************************************
+** 函数名称 ：u8 ADF4351_SetFreq(uint64_t FreqHz, ADF4351_Pll_t *Pll)
+** 函数功能 ：按ADF4351_RefConfig计算分频参数并写入,只写有变化的寄存器
+** 入口参数 ：FreqHz: 输出频率,Hz  Pll: 返回分频参数和实际频率,不需要时为NULL
+** 出口参数 ：0:成功 1:频率超出范围或参考通路配置不合法,没有写入
+** 函数说明 ：R4置MTLD,失锁期间由芯片关闭输出,不再先写关输出的R4
+**************************************************************/
+u8 ADF4351_SetFreq(uint64_t FreqHz, ADF4351_Pll_t *Pll)
+{
+	ADF4351_Pll_t pll;
+	u32 reg[6];
 	
-	multiple = (Fre*N_Mul)/25;		//25Ƶʣ100MοĴ4Ƶ25MࡣûΪ80Mο룬轫25Ϊ2010Mο룬轫25Ϊ2.5Դơ
-	INT_Fre = (u16)multiple;
-	Frac_temp = ((u32)(multiple*1000))%1000;
-	while(((Frac_temp%5) == 0) && ((Mod_temp%5) == 0))
+	if(ADF4351_Solve(&ADF4351_RefConfig, FreqHz, &pll))
 	{
-		Frac_temp = Frac_temp/5;
-		Mod_temp = Mod_temp/5;
+		return 1;
 	}
-	while(((Frac_temp%2) == 0)&&((Mod_temp%2) == 0))
+	ADF4351_GetRegs(reg);
+	reg[4] |= ADF4351_R4_MTLD;
+	ADF4351_PllRegs(&ADF4351_RefConfig, &pll, reg);
+	ADF4351_Update(reg);
+	if(Pll != NULL)
 	{
-		Frac_temp = Frac_temp/2;
-		Mod_temp = Mod_temp/2;
+		*Pll = pll;
 	}
+	return 0;
+}
+
+/************************************************************
+** 函数名称 ：u8 ADF4351_LoopApply(void)
+** 函数功能 ：修改ADF4351_LoopConfig后调用,按当前的MOD改写R2~R4,频率不变
+** 出口参数 ：写入的寄存器个数
+**************************************************************/
+u8 ADF4351_LoopApply(void)
+{
+	u32 reg[6];
 	
-	Mul_Core %= 7;
-	W_ADF4351_R0 = (INT_Fre<<15)+(Frac_temp<<3);
-	W_ADF4351_R1 = ADF4351_R1_Base + (Mod_temp<<3);
-	W_ADF4351_R4 = ADF4351_R4_ON + (Mul_Core<<20);
-	
+	ADF4351_GetRegs(reg);
+	ADF4351_LoopRegs(&ADF4351_RefConfig, (u16)((reg[1] >> 3) & 0xFFF), reg);
+	return ADF4351_Update(reg);
+}
+
+//fre单位MHz,步进由ADF4351_RefConfig.SpacingHz决定(默认0.1MHz),计算见ADF4351_Pll.c
+void ADF4351WriteFreq(float Fre)
+{
+	if(Fre < 35.0f)
+		Fre = 35.0f;
+	if(Fre > 4400.0f)
+		Fre = 4400.0f;
+	ADF4351_SetFreq((uint64_t)(Fre * 1000000.0f + 0.5f), NULL);
+}
+
+/************************************************************
+** 函数名称 ：u8 ADF4351_Update(const u32 *Reg)
+** 函数功能 ：把Reg[0]~Reg[5]与影子寄存器比较,按R5~R1的顺序写有变化的寄存器,
+							有写入时最后写R0
+** 入口参数 ：Reg: 新的R0~R5,控制位DB2~DB0要正确
+** 出口参数 ：写入的寄存器个数,0表示没有变化,或在中断里发送队列放不下(影子寄存器不变)
+** 函数说明 ：MOD、R计数器、电荷泵电流等双缓冲的设置在写R0时才生效,写R0同时启动VCO频段选择,
+							所以其他寄存器有变化时R0也要写;只有INT/FRAC变化时只写R0
+							要写的字整批放进发送队列,DMA方式下返回时可能还在发送
+**************************************************************/
+u8 ADF4351_Update(const u32 *Reg)
+{
+	u32 word[6];
+	u8 i, n = 0;
 	
-//	WriteOneRegToADF4351(ADF4351_PD_OFF); //ADF4351_RF_OFF
-//	WriteOneRegToADF4351((u32)(ADF4351_R4_OFF + (6<<20)));
-	WriteOneRegToADF4351(ADF4351_RF_OFF);
-	WriteOneRegToADF4351(W_ADF4351_R0);
-	WriteOneRegToADF4351(W_ADF4351_R1);
-	WriteOneRegToADF4351(W_ADF4351_R4);
-//	WriteOneRegToADF4351(ADF4351_PD_ON);
+	for(i = 5; i > 0; i--)
+	{
+		if(!(ADF4351_Shadow.Valid & (1 << i)) || ADF4351_Shadow.Reg[i] != Reg[i])
+		{
+			word[n++] = Reg[i];
+		}
+	}
+	if(n || !(ADF4351_Shadow.Valid & 1) || ADF4351_Shadow.Reg[0] != Reg[0])
+	{
+		word[n++] = Reg[0];
+	}
+	if(ADF4351_BusWrite(word, n))
+	{
+		return 0;
+	}
+	for(i = 0; i < n; i++)
+	{
+		ADF4351_Track(word[i]);
+	}
+	return n;
 }
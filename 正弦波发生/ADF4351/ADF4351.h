@@ -1,23 +1,178 @@
 #ifndef _ADF4351_H_
 #define _ADF4351_H_
+#if defined(ADF4351_HOST)
+#include "ad9959_host_hal.h"		//在Linux主机上运行,见 tools/ 目录
+#else
 #include "sys.h"
+#endif
+#include "stdint.h"
 
 #define ADF4351_CE PCout(12)
 #define ADF4351_LE PCout(9)
 #define ADF4351_OUTPUT_DATA PCout(10)
 #define ADF4351_CLK		PCout(11)
 
-//										õĹܽ
+//										无用的管脚
 #define ADF4351_INPUT_DATA PCin(10)
 
 #define ADF4351_RF_OFF	((u32)0XEC801C)
 
+//锁定检测:R5把LD引脚设为数字锁定检测(ADF4351Init的默认值),板子上LD需要接到这个引脚
+#define ADF4351_LD				PCin(8)
+#define ADF4351_LD_PORT		GPIOC
+#define ADF4351_LD_PIN		GPIO_PIN_8
+#define ADF4351_LD_IRQn		EXTI9_5_IRQn
+#define ADF4351_LOCK_BLANK_US	10		//写R0后这段时间内LD为高可能还是旧频率的锁定,不算锁定
+
+//串行时序:时钟高/低电平至少25ns,LE脉宽至少20ns;每个边沿前插入ADF4351_SPI_NOP个NOP,
+//F1(72MHz)下IO写入本身已经够慢可以设为0,F4(168MHz)下至少2
+#define ADF4351_SPI_NOP	2
+#define ADF4351_DELAY()	do{ u8 n_ = ADF4351_SPI_NOP; while(n_--) __NOP(); }while(0)
+
+//ADF4351通信方式,编译时选择(工程里定义ADF4351_BUS或直接修改这里),实现见ADF4351_Bus.c
+#define ADF4351_BUS_SOFT		0	//模拟SPI,原接线 CLK:PC11 DATA:PC10
+#define ADF4351_BUS_SPI			1	//硬件SPI+DMA,CLK接SPI_SCK,DATA接SPI_MOSI,LE仍为PC9,CE仍为PC12
+#ifndef ADF4351_BUS
+#define ADF4351_BUS	ADF4351_BUS_SOFT
+#endif
+
+#define ADF4351_SPI					hspi2	//CubeMX:主机,8位,CPOL=Low,CPHA=1Edge,MSB先发,软件NSS,SCK不超过20MHz,开TX DMA
+#define ADF4351_QUEUE_LEN		16		//发送队列能放的寄存器字数,2的幂
+#define ADF4351_TIM_TICKS_MAX	0x10000UL	//播放定时器一个周期最多的计数个数,基本定时器TIM6/TIM7的ARR为16位
+
+#define ADF4351_R4_MTLD	((u32)1 << 10)	//R4 DB10:失锁期间关闭RF输出
+
+//参考通路:fPFD = RefHz*(1+Doubler)/(R*(1+Div2)),小数分频时不超过32MHz
+typedef struct
+{
+	u32 RefHz;			//REFin频率,Hz
+	u16 R;					//R计数器1~1023
+	u8  Doubler;		//1:参考倍频,REFin不超过30MHz
+	u8  Div2;				//1:参考2分频
+	u32 SpacingHz;	//输出通道间隔,Hz,要求的频率先四舍五入到这个间隔的整数倍
+}ADF4351_RefConfig_t;
+
+extern ADF4351_RefConfig_t ADF4351_RefConfig;
+
+//环路和频段选择设置,ADF4351_PllRegs/ADF4351_LoopRegs按它填R2~R4
+typedef struct
+{
+	u8  Cp;					//电荷泵电流0~15,(Cp+1)*0.31mA,ADF4351Init为7(2.5mA)
+	u8  FastLock;		//1:快速锁定,跳频后Icp升到最大5mA(Cp=0时为16倍),环路滤波器的电阻要经SW引脚切换
+	u16 FastLockUs;	//快速锁定持续时间,us,换算成R3的时钟分频值(CLKDIV*MOD/fPFD)
+	u8  BandHigh;		//1:频段选择时钟高速模式,时钟可到500kHz,频段选择用时约为低速模式的1/4;fPFD高于31.875MHz时总是用
+}ADF4351_LoopConfig_t;
+
+extern ADF4351_LoopConfig_t ADF4351_LoopConfig;
+
+//一个频点的分频参数,输出频率 = fPFD*(Int+Frac/Mod)/2^RfDiv
+typedef struct
+{
+	u16 Int;				//23~65535(4/5预分频)或75~65535(8/9预分频)
+	u16 Frac;
+	u16 Mod;				//2~4095
+	u8  RfDiv;			//RF输出分频2^RfDiv,0~6
+	u8  Prescaler;	//0:4/5 1:8/9,VCO高于3.6GHz时用8/9
+	uint64_t Freq;	//实际输出频率,mHz,四舍五入
+	int64_t Err;		//实际输出频率减要求的频率,mHz
+}ADF4351_Pll_t;
+
+//频率计划的一项,ADF4351_PlanSweep/ADF4351_PlanList生成,可以放在RAM或flash中
+typedef struct
+{
+	u32 R0;					//INT/FRAC,每项都写
+	u32 R1;					//预分频/MOD,与芯片中的值相同时不写
+	u32 R3;					//快速锁定的时钟分频值随MOD变,与芯片中的值相同时不写
+	u32 R4;					//RF分频/频段选择时钟,与芯片中的值相同时不写
+	u32 Dwell;			//停留时间,定时器计数个数,2~ADF4351_TIM_TICKS_MAX
+}ADF4351_Step_t;
+
+//频率计划播放统计
+typedef struct
+{
+	u32 Hops;				//已切换的次数
+	u32 Loops;			//循环播放的圈数
+	u32 LockTimeouts;	//等锁定超时的次数
+	u32 IrqMax;			//中断最长用时,CPU周期
+	u32 QueueFull;	//中断里发送队列放不下,这一项没有写入的次数
+}ADF4351_PlayerStats_t;
+
+//锁定统计,时间为从R0锁存到LD变高,ns
+typedef struct
+{
+	u32 Locks;			//测到锁定的次数
+	u32 Timeouts;		//ADF4351_WaitLock超时的次数
+	u32 Last;				//最近一次的锁定时间
+	u32 Min;
+	u32 Max;
+	uint64_t Sum;		//累计,除以Locks为平均值
+}ADF4351_LockStats_t;
+
+//影子寄存器:记录写入芯片的R0~R5,只写有变化的寄存器
+typedef struct
+{
+	u32 Reg[6];
+	u8  Valid;			//bit n:Reg[n]已写入过芯片
+}ADF4351_Shadow_t;
+
+extern ADF4351_Shadow_t ADF4351_Shadow;
+
+//通信方式接口,ADF4351_Bus为编译时选中的实现
+typedef struct
+{
+	void (*Init)(void);					//初始化通信用的IO口/外设
+	u8 (*Word)(const u8 *data);	//发送一个寄存器字(4字节,高字节在前);返回0:已发完并锁存,
+															//返回1:DMA发送中,完成后由中断锁存并调用ADF4351_BusDone
+	const char *Name;
+}ADF4351_Bus_t;
+
+extern const ADF4351_Bus_t ADF4351_Bus;
+
+void ADF_Output_GPIOInit(void);
 void ADF4351Init(void);
 void ReadToADF4351(u8 count, u8 *buf);
 void WriteToADF4351(u8 count, u8 *buf);
 void WriteOneRegToADF4351(u32 Regster);
 void ADF4351_Init_some(void);
 void ADF4351WriteFreq(float Fre);		//	(xx.x) M Hz
+u8 ADF4351_Update(const u32 *Reg);		//按R5~R0的顺序只写有变化的寄存器,返回写入的个数
+u8 ADF4351_SetFreq(uint64_t FreqHz, ADF4351_Pll_t *Pll);	//整数计算设置频率,Pll可为NULL,返回0成功
+void ADF4351_GetRegs(u32 *Reg);					//当前R0~R5,没写过的取默认值
+
+/*****************************分频参数计算(ADF4351_Pll.c)*****************************/
+u8 ADF4351_Solve(const ADF4351_RefConfig_t *Ref, uint64_t FreqHz, ADF4351_Pll_t *Pll);	//频率,Hz -> 分频参数,返回0成功
+void ADF4351_PllRegs(const ADF4351_RefConfig_t *Ref, const ADF4351_Pll_t *Pll, u32 *Reg);	//分频参数填入R0~R5的对应位
+void ADF4351_LoopRegs(const ADF4351_RefConfig_t *Ref, u16 Mod, u32 *Reg);	//ADF4351_LoopConfig填入R2~R4的对应位
+u8 ADF4351_LoopApply(void);																		//按ADF4351_LoopConfig改写芯片,频率不变
+
+/*****************************频率计划表和播放(ADF4351_Plan.c)*****************************/
+u32 ADF4351_PlanSweep(uint64_t StartHz, uint64_t StopHz, uint64_t StepHz, u32 Dwell, ADF4351_Step_t *table, u32 max);//扫频编译成表,返回项数
+u32 ADF4351_PlanList(const uint64_t *Hz, u32 n, u32 Dwell, ADF4351_Step_t *table);	//跳频表编译成表,返回项数
+u8 ADF4351_PlayerStart(TIM_HandleTypeDef *htim, u32 TickHz, const ADF4351_Step_t *table, u32 count, u32 LockTimeout, u8 Loop);//开始播放
+void ADF4351_PlayerStop(void);																	//停止播放,保持当前频率
+u8 ADF4351_PlayerBusy(void);																		//1:正在播放
+void ADF4351_PlayerIRQ(TIM_HandleTypeDef *htim);								//在HAL_TIM_PeriodElapsedCallback中调用
+void ADF4351_PlayerLocked(void);																//锁定检测到锁定时调用,开始计停留时间
+void ADF4351_PlayerGetStats(ADF4351_PlayerStats_t *stats);			//读统计
+
+/*****************************锁定检测(ADF4351_Lock.c)*****************************/
+void ADF4351_LockInit(u8 Exti);									//初始化LD引脚,1:用外部中断 0:只轮询
+void ADF4351_LockStart(void);										//R0锁存时由发送队列调用,开始计锁定时间
+u8 ADF4351_LockPoll(void);											//检查一次,1:已锁定
+u32 ADF4351_LockBlankLeft(void);								//LD一直为高时还要多少CPU周期才算锁定,0:不用等
+u32 ADF4351_WaitLock(u32 TimeoutUs);						//等待锁定,返回锁定用时ns,超时返回0xFFFFFFFF
+void ADF4351_LockEXTI(u16 GPIO_Pin);						//在HAL_GPIO_EXTI_Callback中调用
+void ADF4351_LockGetStats(ADF4351_LockStats_t *stats);	//读统计
+void ADF4351_LockClearStats(void);							//清统计
+
+/*****************************寄存器发送队列(ADF4351_Bus.c)*****************************/
+u8 ADF4351_BusWrite(const u32 *Reg, u8 n);		//n个寄存器字依次加入发送队列并启动发送,中断里队列满返回1
+void ADF4351_BusDone(void);									//DMA方式一个字锁存后调用,接着发下一个
+void ADF4351_BusWait(void);									//等待队列发完
+u8 ADF4351_BusBusy(void);										//1:队列还在发送
+#if ADF4351_BUS == ADF4351_BUS_SPI
+void ADF4351_SpiIRQ(SPI_HandleTypeDef *hspi);	//在HAL_SPI_TxCpltCallback里调用
+#endif
 
 #endif
 
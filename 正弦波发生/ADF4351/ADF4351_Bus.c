@@ -0,0 +1,265 @@
+#include "ADF4351.h"
+
+/************************************************************
+	ADF4351通信方式,由 ADF4351.h 中的 ADF4351_BUS 在编译时选择:
+	ADF4351_BUS_SOFT	模拟SPI,原接线,不需要额外外设,返回时已写完
+	ADF4351_BUS_SPI		硬件SPI,每个寄存器字4字节走一次DMA,发完在SPI发送完成中断里拉一下LE锁存,
+										接着发队列里的下一个字;没有配置DMA时直接写数据寄存器
+	寄存器字先放进发送队列,ADF4351_Update等一次要写好几个寄存器时整批入队,
+	DMA方式下调用者入队后立即返回,扫频时主循环/定时器中断里不用等串行发送
+	主循环里队列满时等待;中断里(或关中断时)队列放不下时不等待,ADF4351_BusWrite返回1
+**************************************************************/
+
+static u8 busQueue[ADF4351_QUEUE_LEN][4];
+static volatile u8 busHead = 0;		//入队位置,关中断修改
+static volatile u8 busTail = 0;		//正在发送的字,只由发送方修改
+static volatile u8 busActive = 0;	//1:有字正在发送
+
+
+
+#if ADF4351_BUS == ADF4351_BUS_SOFT
+static void adf4351_soft_init(void)
+{
+	ADF_Output_GPIOInit();
+	ADF4351_CLK = 0;
+	ADF4351_LE = 0;
+}
+
+/************************************************************
+** 函数名称 ：u8 adf4351_soft_word(const u8 *data)
+** 函数功能 ：模拟SPI发送一个寄存器字并锁存,上升沿采样,高位先发
+**************************************************************/
+static u8 adf4351_soft_word(const u8 *data)
+{
+	u8 ValueToWrite;
+	u8 i, j;
+
+	for(i = 0; i < 4; i++)
+	{
+		ValueToWrite = data[i];
+		for(j = 0; j < 8; j++)
+		{
+			ADF4351_OUTPUT_DATA = (ValueToWrite & 0x80) ? 1 : 0;
+			ADF4351_DELAY();
+			ADF4351_CLK = 1;
+			ADF4351_DELAY();
+			ValueToWrite <<= 1;
+			ADF4351_CLK = 0;
+		}
+	}
+	ADF4351_OUTPUT_DATA = 0;
+	ADF4351_DELAY();
+	ADF4351_LE = 1;
+	ADF4351_DELAY();
+	ADF4351_LE = 0;
+	return 0;
+}
+
+const ADF4351_Bus_t ADF4351_Bus = { adf4351_soft_init, adf4351_soft_word, "soft spi" };
+
+
+
+#elif ADF4351_BUS == ADF4351_BUS_SPI
+extern SPI_HandleTypeDef ADF4351_SPI;
+
+/************************************************************
+** 函数名称 ：void adf4351_spi_init(void)
+** 函数功能 ：SPI本身和CLK/DATA引脚由CubeMX初始化,这里只初始化LE、CE
+**************************************************************/
+static void adf4351_spi_init(void)
+{
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+	__HAL_RCC_GPIOC_CLK_ENABLE();
+	GPIO_InitStruct.Pin = GPIO_PIN_9 | GPIO_PIN_12;
+	GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+	HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
+	ADF4351_LE = 0;
+
+	__HAL_SPI_ENABLE(&ADF4351_SPI);		//不走DMA时直接写数据寄存器,需要先使能SPI
+}
+
+/************************************************************
+** 函数名称 ：void adf4351_spi_latch(void)
+** 函数功能 ：等移位寄存器发完,拉一下LE把32位锁存进寄存器
+**************************************************************/
+static void adf4351_spi_latch(void)
+{
+	SPI_TypeDef *spi = ADF4351_SPI.Instance;
+
+	while(!(spi->SR & SPI_SR_TXE));
+	while(spi->SR & SPI_SR_BSY);
+	(void)spi->DR;		//只发不收,清除接收溢出标志
+	(void)spi->SR;
+	ADF4351_LE = 1;
+	ADF4351_DELAY();
+	ADF4351_LE = 0;
+}
+
+/************************************************************
+** 函数名称 ：u8 adf4351_spi_word(const u8 *data)
+** 函数功能 ：有DMA时启动DMA后立即返回1,否则直接写数据寄存器,发完锁存后返回0
+**************************************************************/
+static u8 adf4351_spi_word(const u8 *data)
+{
+	SPI_TypeDef *spi = ADF4351_SPI.Instance;
+	u8 i;
+
+	if(ADF4351_SPI.hdmatx != NULL)
+	{
+		if(HAL_SPI_Transmit_DMA(&ADF4351_SPI, (u8 *)data, 4) == HAL_OK)
+		{
+			return 1;
+		}
+	}
+	for(i = 0; i < 4; i++)
+	{
+		while(!(spi->SR & SPI_SR_TXE));
+		*(volatile u8 *)&spi->DR = data[i];
+	}
+	adf4351_spi_latch();
+	return 0;
+}
+
+/************************************************************
+** 函数名称 ：void ADF4351_SpiIRQ(SPI_HandleTypeDef *hspi)
+** 函数功能 ：一个寄存器字DMA发送完成:锁存,接着发队列里的下一个
+** 函数说明 ：在HAL_SPI_TxCpltCallback里调用,不是ADF4351的SPI时直接返回
+**************************************************************/
+void ADF4351_SpiIRQ(SPI_HandleTypeDef *hspi)
+{
+	if(hspi != &ADF4351_SPI || !busActive)
+	{
+		return;
+	}
+	adf4351_spi_latch();
+	ADF4351_BusDone();
+}
+
+const ADF4351_Bus_t ADF4351_Bus = { adf4351_spi_init, adf4351_spi_word, "spi dma" };
+
+
+
+#else
+#error "ADF4351_BUS: 未知的通信方式"
+#endif
+
+
+
+//队尾的字已锁存;R0锁存后频率开始改变,从这里计锁定时间
+static void adf4351_latched(void)
+{
+	if((busQueue[busTail & (ADF4351_QUEUE_LEN - 1)][3] & 7) == 0)
+	{
+		ADF4351_LockStart();
+	}
+	busTail++;
+}
+
+/************************************************************
+** 函数名称 ：void adf4351_pump(void)
+** 函数功能 ：从busTail开始发送队列,遇到DMA发送中的字就返回,队列空时清busActive
+**************************************************************/
+static void adf4351_pump(void)
+{
+	u32 primask;
+
+	for(;;)
+	{
+		if(busTail != busHead)
+		{
+			if(ADF4351_Bus.Word(busQueue[busTail & (ADF4351_QUEUE_LEN - 1)]))
+			{
+				return;
+			}
+			adf4351_latched();
+			continue;
+		}
+		primask = __get_PRIMASK();
+		__disable_irq();
+		if(busTail == busHead)		//关中断再确认一次,发送期间中断里入队的字不会漏掉
+		{
+			busActive = 0;
+			__set_PRIMASK(primask);
+			return;
+		}
+		__set_PRIMASK(primask);
+	}
+}
+
+/************************************************************
+** 函数名称 ：u8 ADF4351_BusWrite(const u32 *Reg, u8 n)
+** 函数功能 ：n个寄存器字按顺序加入发送队列,没有在发送时启动发送
+** 入口参数 ：Reg: 寄存器字,控制位DB2~DB0为寄存器号  n: 个数
+** 出口参数 ：0:成功 1:在中断里(或关中断时)队列放不下n个字,一个也没有加入
+** 函数说明 ：模拟SPI方式返回时已写完;DMA方式返回时可能还在发送,
+							需要确认已写入时调用ADF4351_BusWait
+							主循环里队列满时等待发走;中断里不能等:模拟SPI方式由被打断的主循环发送,
+							等下去就是死锁,所以直接返回1,由调用者决定丢弃还是下次再写
+**************************************************************/
+u8 ADF4351_BusWrite(const u32 *Reg, u8 n)
+{
+	u8 *p;
+	u32 primask = __get_PRIMASK();
+	u8 irq = (__get_IPSR() != 0 || primask != 0);
+
+	__disable_irq();		//中断里也可能入队,查空位和占位不能被打断
+	if(irq && (u8)(ADF4351_QUEUE_LEN - (u8)(busHead - busTail)) < n)
+	{
+		__set_PRIMASK(primask);
+		return 1;
+	}
+	while(n)
+	{
+		if((u8)(busHead - busTail) >= ADF4351_QUEUE_LEN)
+		{
+			__set_PRIMASK(primask);
+			while((u8)(busHead - busTail) >= ADF4351_QUEUE_LEN);		//队列满,等中断发走(只会在主循环里)
+			__disable_irq();
+			continue;
+		}
+		p = busQueue[busHead & (ADF4351_QUEUE_LEN - 1)];
+		p[0] = (u8)(*Reg >> 24);
+		p[1] = (u8)(*Reg >> 16);
+		p[2] = (u8)(*Reg >> 8);
+		p[3] = (u8)(*Reg);
+		Reg++;
+		busHead++;
+		n--;
+	}
+	if(busActive)		//正在发送(DMA中或被打断的模拟SPI),新入队的字由它接着发
+	{
+		__set_PRIMASK(primask);
+		return 0;
+	}
+	busActive = 1;
+	__set_PRIMASK(primask);
+	adf4351_pump();
+	return 0;
+}
+
+/************************************************************
+** 函数名称 ：void ADF4351_BusDone(void)
+** 函数功能 ：DMA方式当前字已锁存,发送下一个
+**************************************************************/
+void ADF4351_BusDone(void)
+{
+	adf4351_latched();
+	adf4351_pump();
+}
+
+/************************************************************
+** 函数名称 ：void ADF4351_BusWait(void)
+** 函数功能 ：等待队列里的字全部写入芯片
+**************************************************************/
+void ADF4351_BusWait(void)
+{
+	while(busActive);
+}
+
+u8 ADF4351_BusBusy(void)
+{
+	return busActive;
+}
@@ -0,0 +1,231 @@
+#include "ADF4351.h"
+
+/************************************************************
+	锁定检测:R0锁存时(发送队列调用ADF4351_LockStart)记下DWT计数,LD引脚变高时算出锁定用时
+	刚写完R0时LD可能还保持着旧频率的锁定,所以LD为高只有在以下情况才算锁定:
+	写R0后已经见过LD为低,或者已经过了ADF4351_LOCK_BLANK_US
+	检测方式:
+	轮询	ADF4351_WaitLock阻塞等待,或在主循环/定时器里反复调用ADF4351_LockPoll
+	中断	ADF4351_LockInit(1)打开LD引脚双边沿外部中断,
+			void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+			{
+				ADF4351_LockEXTI(GPIO_Pin);
+			}
+			LD在写R0后一直没有变低时不产生边沿,需要再调用一次ADF4351_LockPoll
+			(频率计划播放器在写入后过ADF4351_LOCK_BLANK_US时会自动调用)
+	测到锁定时调用ADF4351_PlayerLocked,播放器从锁定起计停留时间
+	统计中的锁定时间可以用来调整电荷泵电流和频段选择时钟
+**************************************************************/
+
+typedef struct
+{
+	u8  Init;						//1:已初始化LD引脚
+	volatile u8 Wait;		//1:R0已锁存,还没有测到锁定
+	volatile u8 SeenLow;	//写R0后见过LD为低
+	u32 Start;					//R0锁存时的DWT计数
+	u32 Blank;					//ADF4351_LOCK_BLANK_US对应的CPU周期数
+	ADF4351_LockStats_t Stats;
+}ADF4351_Lock_t;
+
+static ADF4351_Lock_t lock;
+
+//CPU周期 -> ns
+static u32 adf4351_ns(u32 cycles)
+{
+	return (u32)((uint64_t)cycles * 1000000000UL / SystemCoreClock);
+}
+
+/************************************************************
+** 函数名称 ：void ADF4351_LockInit(u8 Exti)
+** 函数功能 ：LD引脚设为输入,打开DWT计数
+** 入口参数 ：Exti: 1:打开双边沿外部中断 0:只轮询
+**************************************************************/
+void ADF4351_LockInit(u8 Exti)
+{
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	__HAL_RCC_GPIOC_CLK_ENABLE();
+	GPIO_InitStruct.Pin = ADF4351_LD_PIN;
+	GPIO_InitStruct.Mode = Exti ? GPIO_MODE_IT_RISING_FALLING : GPIO_MODE_INPUT;
+	GPIO_InitStruct.Pull = GPIO_PULLDOWN;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+	HAL_GPIO_Init(ADF4351_LD_PORT, &GPIO_InitStruct);
+	if(Exti)
+	{
+		HAL_NVIC_SetPriority(ADF4351_LD_IRQn, 1, 0);
+		HAL_NVIC_EnableIRQ(ADF4351_LD_IRQn);
+	}
+
+	lock.Blank = (u32)((uint64_t)SystemCoreClock * ADF4351_LOCK_BLANK_US / 1000000);
+	lock.Wait = 0;
+	ADF4351_LockClearStats();
+	lock.Init = 1;
+}
+
+/************************************************************
+** 函数名称 ：void ADF4351_LockStart(void)
+** 函数功能 ：R0已锁存,开始计锁定时间
+** 函数说明 ：由ADF4351_Bus.c在R0锁存后调用;上一次还没测到锁定时从这次重新计
+**************************************************************/
+void ADF4351_LockStart(void)
+{
+	lock.Start = DWT->CYCCNT;
+	lock.SeenLow = 0;
+	lock.Wait = 1;
+}
+
+/************************************************************
+** 函数名称 ：u8 adf4351_lock_eval(void)
+** 函数功能 ：按LD电平判断一次,测到锁定时记统计并通知播放器
+** 出口参数 ：1:已锁定
+**************************************************************/
+static u8 adf4351_lock_eval(void)
+{
+	u32 primask, t;
+	ADF4351_LockStats_t *st = &lock.Stats;
+
+	if(!lock.Init)
+	{
+		return 0;
+	}
+	primask = __get_PRIMASK();
+	__disable_irq();
+	if(!lock.Wait)
+	{
+		__set_PRIMASK(primask);
+		return ADF4351_LD ? 1 : 0;
+	}
+	t = DWT->CYCCNT - lock.Start;
+	if(!ADF4351_LD)
+	{
+		lock.SeenLow = 1;
+		__set_PRIMASK(primask);
+		return 0;
+	}
+	if(!lock.SeenLow && t < lock.Blank)
+	{
+		__set_PRIMASK(primask);
+		return 0;
+	}
+	lock.Wait = 0;
+	t = adf4351_ns(t);
+	st->Locks++;
+	st->Last = t;
+	st->Sum += t;
+	if(t < st->Min)
+	{
+		st->Min = t;
+	}
+	if(t > st->Max)
+	{
+		st->Max = t;
+	}
+	__set_PRIMASK(primask);
+	ADF4351_PlayerLocked();
+	return 1;
+}
+
+/************************************************************
+** 函数名称 ：u8 ADF4351_LockPoll(void)
+** 函数功能 ：检查一次是否锁定
+** 出口参数 ：1:已锁定 0:还没有锁定或没有初始化
+**************************************************************/
+u8 ADF4351_LockPoll(void)
+{
+	return adf4351_lock_eval();
+}
+
+/************************************************************
+** 函数名称 ：u32 ADF4351_LockBlankLeft(void)
+** 函数功能 ：R0锁存后LD一直为高时,还要过多久LD为高才算锁定
+** 出口参数 ：剩余的CPU周期数;不在等锁定、见过LD为低或已过ADF4351_LOCK_BLANK_US时为0
+**************************************************************/
+u32 ADF4351_LockBlankLeft(void)
+{
+	u32 primask = __get_PRIMASK();
+	u32 t, left = 0;
+
+	__disable_irq();
+	if(lock.Init && lock.Wait && !lock.SeenLow)
+	{
+		t = DWT->CYCCNT - lock.Start;
+		if(t < lock.Blank)
+		{
+			left = lock.Blank - t;
+		}
+	}
+	__set_PRIMASK(primask);
+	return left;
+}
+
+/************************************************************
+** 函数名称 ：u32 ADF4351_WaitLock(u32 TimeoutUs)
+** 函数功能 ：等待发送队列发完、PLL锁定
+** 入口参数 ：TimeoutUs: 从R0锁存起最长等待时间,us
+** 出口参数 ：这次的锁定用时,ns;超时或没有初始化返回0xFFFFFFFF
+**************************************************************/
+u32 ADF4351_WaitLock(u32 TimeoutUs)
+{
+	u32 limit = (u32)((uint64_t)SystemCoreClock * TimeoutUs / 1000000);
+
+	if(!lock.Init)
+	{
+		return 0xFFFFFFFF;
+	}
+	ADF4351_BusWait();
+	while(lock.Wait)
+	{
+		if(adf4351_lock_eval())
+		{
+			break;
+		}
+		if(DWT->CYCCNT - lock.Start > limit)
+		{
+			lock.Stats.Timeouts++;
+			return 0xFFFFFFFF;
+		}
+	}
+	return lock.Stats.Last;
+}
+
+/************************************************************
+** 函数名称 ：void ADF4351_LockEXTI(u16 GPIO_Pin)
+** 函数功能 ：LD引脚边沿中断:下降沿记下失锁,上升沿测锁定
+**************************************************************/
+void ADF4351_LockEXTI(u16 GPIO_Pin)
+{
+	if(GPIO_Pin == ADF4351_LD_PIN)
+	{
+		adf4351_lock_eval();
+	}
+}
+
+/************************************************************
+** 函数名称 ：void ADF4351_LockGetStats(ADF4351_LockStats_t *stats)
+** 函数功能 ：读锁定统计
+**************************************************************/
+void ADF4351_LockGetStats(ADF4351_LockStats_t *stats)
+{
+	u32 primask = __get_PRIMASK();
+
+	__disable_irq();
+	*stats = lock.Stats;
+	__set_PRIMASK(primask);
+}
+
+void ADF4351_LockClearStats(void)
+{
+	u32 primask = __get_PRIMASK();
+
+	__disable_irq();
+	lock.Stats.Locks = 0;
+	lock.Stats.Timeouts = 0;
+	lock.Stats.Last = 0;
+	lock.Stats.Min = 0xFFFFFFFF;
+	lock.Stats.Max = 0;
+	lock.Stats.Sum = 0;
+	__set_PRIMASK(primask);
+}
@@ -0,0 +1,421 @@
+#include "ADF4351.h"
+#include <string.h>
+
+/************************************************************
+	频率计划:扫频或跳频表预先算好每个频点的R0/R1/R3/R4,播放时每个频点只是查表和入队
+	ADF4351_PlanSweep/ADF4351_PlanList按当前的ADF4351_RefConfig和芯片中R1/R4的其他位生成表,
+	表可以在RAM中生成后直接播放,也可以在主机上生成后存成const数组放在flash中
+	播放时只写与芯片中不同的R4、R3、R1,再写R0,同一RF分频比内的扫频每点只写一个R0
+	(打开快速锁定时R3的时钟分频值按MOD换算,MOD不同的频点之间R3也要改写)
+	停留时间:
+	LockTimeout为0时,停留时间从写入频点开始计;
+	LockTimeout不为0时,写入后先等锁定检测调用ADF4351_PlayerLocked(ADF4351_Lock.c测到锁定时自动调用),
+	从锁定起计停留时间,LockTimeout个计数内没有等到锁定时记一次超时,照常开始停留;
+	写入后过ADF4351_LOCK_BLANK_US先查一次LD,LD一直为高没有边沿时靠这一次测到锁定
+	用法:	CubeMX配置一个基本定时器,打开更新中断;
+			void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+			{
+				ADF4351_PlayerIRQ(htim);
+			}
+			n = ADF4351_PlanSweep(100000000, 200000000, 1000000, 100, table, 128);
+			ADF4351_PlayerStart(&htim7, 1000000, table, n, 0, 1);
+	播放前芯片要已经按同样的ADF4351_RefConfig写过(ADF4351Init后ADF4351_SetFreq一次),
+	播放期间ADF4351只能由播放器访问
+**************************************************************/
+
+typedef struct
+{
+	TIM_HandleTypeDef *htim;
+	const ADF4351_Step_t *Table;
+	u32 Count;
+	u32 Index;					//正在播放的项
+	u32 LockTimeout;
+	u32 TickHz;
+	u32 BlankTicks;			//ADF4351_LOCK_BLANK_US对应的定时器计数
+	u32 Blank;					//不为0:正在计的这段是写入后查LD的空白期,计数个数
+	u32 Waited;					//这一项已经等锁定的计数个数
+	u8  Loop;
+	volatile u8 WaitLock;	//1:已写入,等锁定
+	volatile u8 Running;
+	ADF4351_PlayerStats_t Stats;
+}ADF4351_Player_t;
+
+static ADF4351_Player_t player;
+
+//按当前参考通路算一个频点
+static u8 adf4351_plan_point(uint64_t Hz, u32 Dwell, const u32 *base, ADF4351_Step_t *step)
+{
+	ADF4351_Pll_t pll;
+	u32 reg[6];
+
+	if(ADF4351_Solve(&ADF4351_RefConfig, Hz, &pll))
+	{
+		return 1;
+	}
+	memcpy(reg, base, sizeof(reg));
+	ADF4351_PllRegs(&ADF4351_RefConfig, &pll, reg);
+	step->R0 = reg[0];
+	step->R1 = reg[1];
+	step->R3 = reg[3];
+	step->R4 = reg[4];
+	step->Dwell = Dwell;
+	return 0;
+}
+
+/************************************************************
+** 函数名称 ：u32 ADF4351_PlanSweep(uint64_t StartHz, uint64_t StopHz, uint64_t StepHz, u32 Dwell, ADF4351_Step_t *table, u32 max)
+** 函数功能 ：从StartHz到StopHz(含)每StepHz一个频点,编译成频率计划表
+** 入口参数 ：StopHz小于StartHz时向下扫;Dwell: 每点停留时间,定时器计数个数,2~ADF4351_TIM_TICKS_MAX
+							table: 输出表,为NULL时只返回需要的项数  max: 表能放的项数
+** 出口参数 ：项数,0表示参数错误、表放不下或有频点超出范围
+**************************************************************/
+u32 ADF4351_PlanSweep(uint64_t StartHz, uint64_t StopHz, uint64_t StepHz, u32 Dwell, ADF4351_Step_t *table, u32 max)
+{
+	u32 base[6];
+	uint64_t span = (StopHz > StartHz) ? StopHz - StartHz : StartHz - StopHz;
+	uint64_t n, i;
+
+	if(StepHz == 0 || Dwell < 2 || Dwell > ADF4351_TIM_TICKS_MAX)
+	{
+		return 0;
+	}
+	n = span / StepHz + 1;
+	if(table == NULL)
+	{
+		return (n > 0xFFFFFFFFUL) ? 0 : (u32)n;
+	}
+	if(n > max)
+	{
+		return 0;
+	}
+	ADF4351_GetRegs(base);
+	base[4] |= ADF4351_R4_MTLD;
+	for(i = 0; i < n; i++)
+	{
+		if(adf4351_plan_point((StopHz > StartHz) ? StartHz + i * StepHz : StartHz - i * StepHz, Dwell, base, &table[i]))
+		{
+			return 0;
+		}
+	}
+	return (u32)n;
+}
+
+/************************************************************
+** 函数名称 ：u32 ADF4351_PlanList(const uint64_t *Hz, u32 n, u32 Dwell, ADF4351_Step_t *table)
+** 函数功能 ：跳频频点表编译成频率计划表,table至少n项
+** 出口参数 ：项数n,0表示参数错误或有频点超出范围
+**************************************************************/
+u32 ADF4351_PlanList(const uint64_t *Hz, u32 n, u32 Dwell, ADF4351_Step_t *table)
+{
+	u32 base[6];
+	u32 i;
+
+	if(Hz == NULL || table == NULL || Dwell < 2 || Dwell > ADF4351_TIM_TICKS_MAX)
+	{
+		return 0;
+	}
+	ADF4351_GetRegs(base);
+	base[4] |= ADF4351_R4_MTLD;
+	for(i = 0; i < n; i++)
+	{
+		if(adf4351_plan_point(Hz[i], Dwell, base, &table[i]))
+		{
+			return 0;
+		}
+	}
+	return n;
+}
+
+/************************************************************
+** 函数名称 ：void adf4351_play(const ADF4351_Step_t *step)
+** 函数功能 ：写入一项:与芯片不同的R4、R3、R1,再R0,整批放进发送队列
+** 函数说明 ：在中断里队列放不下时不写,记入QueueFull
+**************************************************************/
+static void adf4351_play(const ADF4351_Step_t *step)
+{
+	u32 word[4];
+	u8 n = 0;
+
+	if(ADF4351_Shadow.Reg[4] != step->R4)
+	{
+		word[n++] = step->R4;
+	}
+	if(ADF4351_Shadow.Reg[3] != step->R3)
+	{
+		word[n++] = step->R3;
+	}
+	if(ADF4351_Shadow.Reg[1] != step->R1)
+	{
+		word[n++] = step->R1;
+	}
+	word[n++] = step->R0;
+	if(ADF4351_BusWrite(word, n))
+	{
+		player.Stats.QueueFull++;		//主循环正占着队列,这一项跳过,频率停在上一项
+		return;
+	}
+	ADF4351_Shadow.Reg[4] = step->R4;
+	ADF4351_Shadow.Reg[3] = step->R3;
+	ADF4351_Shadow.Reg[1] = step->R1;
+	ADF4351_Shadow.Reg[0] = step->R0;
+}
+
+/************************************************************
+** 函数名称 ：void adf4351_preload(void)
+** 函数功能 ：预装载当前这段计时之后的下一段:等锁定之后是停留,停留之后是下一项的等锁定或停留
+** 函数说明 ：ARPE=1,更新时才生效;中断里先写寄存器再设ARR时,停留很短的话计数已超过ARR,
+							16位定时器要数满65536才再次更新,所以下一段总在上一次更新时就装好
+**************************************************************/
+static void adf4351_preload(void)
+{
+	u32 next;
+
+	if(player.WaitLock && player.Blank)
+	{
+		next = player.LockTimeout - player.Waited - player.Blank;		//查过LD后接着等到超时
+	}
+	else if(player.WaitLock)
+	{
+		next = player.Table[player.Index].Dwell;
+	}
+	else if(player.LockTimeout)
+	{
+		next = player.LockTimeout;
+	}
+	else
+	{
+		next = player.Table[(player.Index + 1 < player.Count) ? player.Index + 1 : 0].Dwell;
+	}
+	__HAL_TIM_SET_AUTORELOAD(player.htim, next - 1);
+}
+
+/************************************************************
+** 函数名称 ：void adf4351_restart(u32 ticks)
+** 函数功能 ：从0开始一段新的计时并预装载下一段
+** 函数说明 ：先关ARPE写ARR立即生效,再打开预装载
+**************************************************************/
+static void adf4351_restart(u32 ticks)
+{
+	player.htim->Instance->CR1 &= ~TIM_CR1_ARPE;
+	__HAL_TIM_SET_AUTORELOAD(player.htim, ticks - 1);
+	__HAL_TIM_SET_COUNTER(player.htim, 0);
+	player.htim->Instance->CR1 |= TIM_CR1_ARPE;
+	adf4351_preload();
+}
+
+/************************************************************
+** 函数名称 ：void adf4351_wait_arm(u32 ticks)
+** 函数功能 ：从现在起ticks个计数后查一次LD,之后接着等到LockTimeout
+** 入口参数 ：ticks: 0:不再查,直接等到超时
+** 函数说明 ：剩下的等待不够再分一段时也直接等到超时
+**************************************************************/
+static void adf4351_wait_arm(u32 ticks)
+{
+	u32 left = player.LockTimeout - player.Waited;
+
+	if(ticks == 0 || ticks + 2 > left)
+	{
+		player.Blank = 0;
+		adf4351_restart(left);
+	}
+	else
+	{
+		player.Blank = ticks;
+		adf4351_restart(ticks);
+	}
+}
+
+//CPU周期 -> 定时器计数,向上取整再加一个计数(定时器预分频的相位不确定)
+static u32 adf4351_ticks(u32 cycles)
+{
+	return (u32)(((uint64_t)cycles * player.TickHz + SystemCoreClock - 1) / SystemCoreClock) + 1;
+}
+
+/************************************************************
+** 函数名称 ：u8 ADF4351_PlayerStart(TIM_HandleTypeDef *htim, u32 TickHz, const ADF4351_Step_t *table, u32 count, u32 LockTimeout, u8 Loop)
+** 函数功能 ：开始播放频率计划,第一项立即写入
+** 入口参数 ：htim:				定时器,只用更新中断
+							TickHz:			定时器计数频率,Hz,用来换算ADF4351_LOCK_BLANK_US
+							table:			频率计划表,播放期间不能修改
+							count:			项数
+							LockTimeout:	0:停留时间从写入开始计 其他:等锁定的最长时间,定时器计数个数,不超过ADF4351_TIM_TICKS_MAX
+							Loop:				1:循环播放 0:播放一遍后停在最后一项
+** 出口参数 ：0:成功 1:参数错误或芯片还没有初始化
+**************************************************************/
+u8 ADF4351_PlayerStart(TIM_HandleTypeDef *htim, u32 TickHz, const ADF4351_Step_t *table, u32 count, u32 LockTimeout, u8 Loop)
+{
+	u32 i;
+
+	if(htim == NULL || TickHz == 0 || table == NULL || count == 0 || LockTimeout == 1 || LockTimeout > ADF4351_TIM_TICKS_MAX ||
+		ADF4351_Shadow.Valid != 0x3F)
+	{
+		return 1;
+	}
+	for(i = 0; i < count; i++)
+	{
+		if(table[i].Dwell < 2 || table[i].Dwell > ADF4351_TIM_TICKS_MAX)
+		{
+			return 1;
+		}
+	}
+	ADF4351_PlayerStop();
+
+	memset(&player, 0, sizeof(player));
+	player.htim = htim;
+	player.Table = table;
+	player.Count = count;
+	player.LockTimeout = LockTimeout;
+	player.TickHz = TickHz;
+	player.BlankTicks = (u32)(((uint64_t)ADF4351_LOCK_BLANK_US * TickHz + 999999) / 1000000) + 1;
+	player.Loop = Loop;
+
+	player.WaitLock = (LockTimeout != 0);
+
+	adf4351_play(&table[0]);
+	if(LockTimeout)
+	{
+		adf4351_wait_arm(player.BlankTicks);
+	}
+	else
+	{
+		adf4351_restart(table[0].Dwell);
+	}
+	__HAL_TIM_CLEAR_FLAG(htim, TIM_FLAG_UPDATE);
+	player.Running = 1;
+	HAL_TIM_Base_Start_IT(htim);
+	return 0;
+}
+
+/************************************************************
+** 函数名称 ：void ADF4351_PlayerStop(void)
+** 函数功能 ：停止播放,当前频率保持不变
+**************************************************************/
+void ADF4351_PlayerStop(void)
+{
+	if(player.Running)
+	{
+		HAL_TIM_Base_Stop_IT(player.htim);
+		player.Running = 0;
+		player.WaitLock = 0;
+	}
+}
+
+/************************************************************
+** 函数名称 ：u8 ADF4351_PlayerBusy(void)
+** 函数功能 ：是否正在播放,不循环时最后一项停留完自动停止
+**************************************************************/
+u8 ADF4351_PlayerBusy(void)
+{
+	return player.Running;
+}
+
+/************************************************************
+** 函数名称 ：void ADF4351_PlayerIRQ(TIM_HandleTypeDef *htim)
+** 函数功能 ：定时器更新中断中调用:空白期结束查一次LD,等锁定超时则开始停留,停留结束则写入下一项
+** 函数说明 ：进入中断时定时器已按预装载值开始下一段计时,这里预装载再下一段;
+							等锁定时写入后从0重新计时,空白期从R0锁存附近开始算
+**************************************************************/
+void ADF4351_PlayerIRQ(TIM_HandleTypeDef *htim)
+{
+	u32 start = DWT->CYCCNT;
+	u32 next, left;
+
+	if(!player.Running || htim != player.htim)
+	{
+		return;
+	}
+	if(player.WaitLock)
+	{
+		if(ADF4351_LockPoll() && !player.WaitLock)		//LD一直为高没有产生边沿时在这里测到锁定
+		{
+			return;
+		}
+		if(player.Blank)
+		{
+			player.Waited += player.Blank;
+			player.Blank = 0;
+			left = ADF4351_LockBlankLeft();
+			if(left)
+			{
+				adf4351_wait_arm(adf4351_ticks(left));	//R0锁存得晚(DMA还没发完),空白期过后再查一次
+			}
+			else
+			{
+				adf4351_preload();		//正在计的是剩下的等待,之后是停留
+			}
+		}
+		else
+		{
+			player.WaitLock = 0;
+			player.Stats.LockTimeouts++;
+			adf4351_preload();
+		}
+	}
+	else
+	{
+		next = player.Index + 1;
+		if(next >= player.Count)
+		{
+			if(!player.Loop)
+			{
+				ADF4351_PlayerStop();		//最后一项停留完
+				return;
+			}
+			next = 0;
+			player.Stats.Loops++;
+		}
+		player.Index = next;
+		if(player.LockTimeout)
+		{
+			player.WaitLock = 1;
+			player.Waited = 0;
+			adf4351_play(&player.Table[next]);
+			adf4351_wait_arm(player.BlankTicks);
+		}
+		else
+		{
+			adf4351_preload();
+			adf4351_play(&player.Table[next]);
+		}
+		player.Stats.Hops++;
+	}
+	start = DWT->CYCCNT - start;
+	if(start > player.Stats.IrqMax)
+	{
+		player.Stats.IrqMax = start;
+	}
+}
+
+/************************************************************
+** 函数名称 ：void ADF4351_PlayerLocked(void)
+** 函数功能 ：等锁定期间检测到锁定,计数清零开始停留
+** 函数说明 ：在锁定检测的中断或轮询里调用,不在等锁定时什么也不做;
+							中断优先级最好与定时器相同
+**************************************************************/
+void ADF4351_PlayerLocked(void)
+{
+	u32 primask = __get_PRIMASK();
+
+	__disable_irq();
+	if(player.Running && player.WaitLock)
+	{
+		player.WaitLock = 0;
+		player.Blank = 0;
+		adf4351_restart(player.Table[player.Index].Dwell);
+		__HAL_TIM_CLEAR_FLAG(player.htim, TIM_FLAG_UPDATE);
+	}
+	__set_PRIMASK(primask);
+}
+
+/************************************************************
+** 函数名称 ：void ADF4351_PlayerGetStats(ADF4351_PlayerStats_t *stats)
+** 函数功能 ：读播放统计
+**************************************************************/
+void ADF4351_PlayerGetStats(ADF4351_PlayerStats_t *stats)
+{
+	u32 primask = __get_PRIMASK();
+
+	__disable_irq();
+	*stats = player.Stats;
+	__set_PRIMASK(primask);
+}
@@ -0,0 +1,247 @@
+#include "ADF4351.h"
+
+/************************************************************
+	分频参数计算,全部用整数,没有FPU的F1上每个频点的计算量固定
+	(几次64位除法、两次辗转相除和最多十几步的连分数展开)
+	fPFD = RefHz*(1+Doubler)/(R*(1+Div2)) 记作 pn/pd,不要求是整数Hz
+	VCO = 输出频率*2^RfDiv,RfDiv取使VCO落在2.2~4.4GHz的最小值,反馈取自VCO
+	N = VCO/fPFD = Int + Frac/Mod
+	Mod的选取:
+	1.通道Mod:相邻通道的N相差 SpacingHz*2^RfDiv*pd/pn,化简后的分母能放进12位时,
+		同一RF分频比内所有通道都用这个Mod精确表示,扫频/跳频时R1不变,只需要写R0
+	2.否则用这个频点的Frac/Mod化简后的值,仍然精确
+	3.还放不下时取分母不超过4095的最佳有理逼近(连分数),误差在Err中给出
+	环路设置(ADF4351_LoopConfig):电荷泵电流、快速锁定和频段选择时钟,跳几MHz的小步进时:
+	快速锁定让跳频后的一段时间电荷泵电流升到16倍,环路带宽变大;频段选择时钟高速模式缩短频段选择;
+	ADF4351每次写R0都会做频段选择,不能跳过,只能缩短
+**************************************************************/
+
+#define PLL_VCO_MIN			2200000000ULL
+#define PLL_VCO_MAX			4400000000ULL
+#define PLL_PRESC45_MAX	3600000000ULL		//4/5预分频允许的最高VCO频率
+#define PLL_PFD_MAX			32000000UL			//小数分频最高鉴相频率
+#define PLL_REF_MAX			250000000UL
+#define PLL_DOUBLER_MAX	30000000UL			//参考倍频允许的最高REFin
+#define PLL_MOD_MAX			4095
+#define PLL_BAND_CLK		125000UL				//VCO频段选择时钟上限
+#define PLL_BAND_CLK_HIGH	500000UL			//频段选择时钟高速模式的上限
+#define PLL_CLKDIV_MAX	4095
+
+ADF4351_LoopConfig_t ADF4351_LoopConfig = {7, 0, 20, 0};	//2.5mA,不用快速锁定,频段选择低速模式
+
+static u32 pll_gcd(u32 a, u32 b)
+{
+	u32 t;
+
+	while(b)
+	{
+		t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+/************************************************************
+** 函数名称 ：void pll_best(u32 p, u32 q, u16 *Num, u16 *Den)
+** 函数功能 ：求分母不超过PLL_MOD_MAX、最接近p/q(p<q)的分数
+** 函数说明 ：依次求连分数的渐近分数,下一个分母超限时再比较中间分数,
+							结果与枚举全部分母的结果相同
+**************************************************************/
+static void pll_best(u32 p, u32 q, u16 *Num, u16 *Den)
+{
+	const u32 p0 = p, q0 = q;
+	u32 h0 = 0, h1 = 1, k0 = 1, k1 = 0;		//前两个渐近分数 h0/k0, h1/k1
+	u32 a, h, k, r, t;
+	uint64_t e1, e2;
+
+	while(q)
+	{
+		a = p / q;
+		k = a * k1 + k0;
+		if(k > PLL_MOD_MAX)
+		{
+			t = (PLL_MOD_MAX - k0) / k1;		//中间分数 (t*h1+h0)/(t*k1+k0)
+			h = t * h1 + h0;
+			k = t * k1 + k0;
+			e1 = (uint64_t)k1 * p0 > (uint64_t)h1 * q0 ? (uint64_t)k1 * p0 - (uint64_t)h1 * q0 : (uint64_t)h1 * q0 - (uint64_t)k1 * p0;
+			e2 = (uint64_t)k * p0 > (uint64_t)h * q0 ? (uint64_t)k * p0 - (uint64_t)h * q0 : (uint64_t)h * q0 - (uint64_t)k * p0;
+			if(e2 * k1 < e1 * k)		//|h/k-p0/q0| < |h1/k1-p0/q0|
+			{
+				h1 = h;
+				k1 = k;
+			}
+			break;
+		}
+		h = a * h1 + h0;
+		h0 = h1;
+		h1 = h;
+		k0 = k1;
+		k1 = k;
+		r = p - a * q;
+		p = q;
+		q = r;
+	}
+	*Num = (u16)h1;
+	*Den = (u16)k1;
+}
+
+/************************************************************
+** 函数名称 ：u8 ADF4351_Solve(const ADF4351_RefConfig_t *Ref, uint64_t FreqHz, ADF4351_Pll_t *Pll)
+** 函数功能 ：计算输出FreqHz需要的Int/Frac/Mod、RF分频和预分频
+** 入口参数 ：Ref: 参考通路和通道间隔
+							FreqHz: 要求的输出频率,Hz,先四舍五入到SpacingHz的整数倍
+							Pll: 结果,含实际输出频率和误差
+** 出口参数 ：0:成功 1:参考通路配置不合法或频率超出范围(约34.4MHz~4.4GHz,且Int不能低于预分频的下限)
+**************************************************************/
+u8 ADF4351_Solve(const ADF4351_RefConfig_t *Ref, uint64_t FreqHz, ADF4351_Pll_t *Pll)
+{
+	u32 pn, pd, rem, g;
+	uint64_t f, vco, n, a, d;
+	u16 frac, mod;
+	u8 div;
+
+	if(Ref->R == 0 || Ref->R > 1023 || Ref->RefHz == 0 || Ref->RefHz > PLL_REF_MAX || Ref->SpacingHz == 0)
+	{
+		return 1;
+	}
+	if(Ref->Doubler && Ref->RefHz > PLL_DOUBLER_MAX)
+	{
+		return 1;
+	}
+	pn = Ref->RefHz << (Ref->Doubler ? 1 : 0);
+	pd = (u32)Ref->R << (Ref->Div2 ? 1 : 0);
+	if(pn > (uint64_t)PLL_PFD_MAX * pd)
+	{
+		return 1;
+	}
+
+	f = (FreqHz + Ref->SpacingHz / 2) / Ref->SpacingHz * Ref->SpacingHz;
+	for(div = 0; div < 6 && (f << div) < PLL_VCO_MIN; div++);
+	vco = f << div;
+	if(vco < PLL_VCO_MIN || vco > PLL_VCO_MAX)
+	{
+		return 1;
+	}
+
+	n = vco * pd;							//N = n/pn
+	Pll->Int = (u16)(n / pn);
+	rem = (u32)(n % pn);
+	Pll->RfDiv = div;
+	Pll->Prescaler = (vco > PLL_PRESC45_MAX) ? 1 : 0;
+	if(n / pn > 65535)
+	{
+		return 1;
+	}
+
+	g = pll_gcd(pn, (u32)((((uint64_t)Ref->SpacingHz << div) * pd) % pn));
+	if(pn / g <= PLL_MOD_MAX)		//通道Mod,rem一定是g的整数倍
+	{
+		mod = (u16)(pn / g);
+		frac = (u16)(rem / g);
+	}
+	else
+	{
+		g = pll_gcd(pn, rem);
+		if(pn / g <= PLL_MOD_MAX)
+		{
+			mod = (u16)(pn / g);
+			frac = (u16)(rem / g);
+		}
+		else
+		{
+			pll_best(rem, pn, &frac, &mod);
+		}
+	}
+	if(frac == mod)						//逼近结果为1
+	{
+		if(Pll->Int == 65535)
+		{
+			return 1;
+		}
+		Pll->Int++;
+		frac = 0;
+	}
+	if(mod < 2)
+	{
+		mod = 2;
+		frac = 0;
+	}
+	if(Pll->Int < (Pll->Prescaler ? 75 : 23))
+	{
+		return 1;
+	}
+	Pll->Frac = frac;
+	Pll->Mod = mod;
+
+	a = ((uint64_t)Pll->Int * mod + frac) * pn;		//输出 = a/d
+	d = ((uint64_t)mod * pd) << div;
+	Pll->Freq = a / d * 1000 + ((a % d) * 1000 + d / 2) / d;
+	Pll->Err = (int64_t)(Pll->Freq - FreqHz * 1000);
+	return 0;
+}
+
+/************************************************************
+** 函数名称 ：void ADF4351_PllRegs(const ADF4351_RefConfig_t *Ref, const ADF4351_Pll_t *Pll, u32 *Reg)
+** 函数功能 ：把分频参数和参考通路填进R0~R5,其余位保持Reg中原来的值
+** 入口参数 ：Reg: 输入为当前的R0~R5,输出为新的R0~R5,配合ADF4351_Update只写有变化的寄存器
+** 函数说明 ：改写的位 R0:INT、FRAC  R1:预分频、MOD  R2:倍频、2分频、R计数器  R4:RF分频
+							以及ADF4351_LoopRegs改写的位
+**************************************************************/
+void ADF4351_PllRegs(const ADF4351_RefConfig_t *Ref, const ADF4351_Pll_t *Pll, u32 *Reg)
+{
+	Reg[0] = ((u32)Pll->Int << 15) | ((u32)Pll->Frac << 3) | 0;
+	Reg[1] = (Reg[1] & ~(((u32)1 << 27) | ((u32)0xFFF << 3) | 7)) | ((u32)Pll->Prescaler << 27) | ((u32)Pll->Mod << 3) | 1;
+	Reg[2] = (Reg[2] & ~(((u32)3 << 24) | ((u32)0x3FF << 14) | 7)) | ((u32)Ref->Doubler << 25) | ((u32)Ref->Div2 << 24) | ((u32)Ref->R << 14) | 2;
+	Reg[4] = (Reg[4] & ~(((u32)7 << 20) | 7)) | ((u32)Pll->RfDiv << 20) | 4;
+	ADF4351_LoopRegs(Ref, Pll->Mod, Reg);
+}
+
+/************************************************************
+** 函数名称 ：void ADF4351_LoopRegs(const ADF4351_RefConfig_t *Ref, u16 Mod, u32 *Reg)
+** 函数功能 ：把ADF4351_LoopConfig填进R2~R4,其余位保持Reg中原来的值
+** 入口参数 ：Mod: 当前的MOD,快速锁定时间按它换算
+** 函数说明 ：改写的位 R2:电荷泵电流  R3:频段选择时钟模式、时钟分频模式和分频值
+							R4:频段选择时钟分频,按鉴相频率取使频段选择时钟不超过125kHz(高速模式500kHz)的最小值,
+							BandHigh为0但fPFD高于31.875MHz(分频值超过255)时自动用高速模式
+							快速锁定关闭时R3的时钟分频值保持不变
+**************************************************************/
+void ADF4351_LoopRegs(const ADF4351_RefConfig_t *Ref, u16 Mod, u32 *Reg)
+{
+	const ADF4351_LoopConfig_t *cfg = &ADF4351_LoopConfig;
+	u32 pn = Ref->RefHz << (Ref->Doubler ? 1 : 0);
+	u32 pd = (u32)Ref->R << (Ref->Div2 ? 1 : 0);
+	u8 high = cfg->BandHigh ? 1 : 0;
+	u32 band = (pn + pd * PLL_BAND_CLK - 1) / (pd * PLL_BAND_CLK);
+	uint64_t div;
+
+	if(high || band > 255)		//低速模式分频值放不下(fPFD高于31.875MHz)时改用高速模式
+	{
+		high = 1;
+		band = (pn + pd * PLL_BAND_CLK_HIGH - 1) / (pd * PLL_BAND_CLK_HIGH);
+	}
+	if(band == 0)
+	{
+		band = 1;
+	}
+	if(band > 255)
+	{
+		band = 255;
+	}
+	Reg[2] = (Reg[2] & ~(((u32)0xF << 9) | 7)) | ((u32)(cfg->Cp & 0xF) << 9) | 2;
+	Reg[3] = (Reg[3] & ~(((u32)1 << 23) | ((u32)3 << 15) | 7)) | ((u32)high << 23) | 3;
+	if(cfg->FastLock)
+	{
+		div = ((uint64_t)cfg->FastLockUs * pn + (uint64_t)Mod * pd * 1000000 - 1) / ((uint64_t)Mod * pd * 1000000);
+		if(div == 0)
+		{
+			div = 1;
+		}
+		if(div > PLL_CLKDIV_MAX)
+		{
+			div = PLL_CLKDIV_MAX;
+		}
+		Reg[3] = (Reg[3] & ~((u32)0xFFF << 3)) | ((u32)div << 3) | ((u32)1 << 15);
+	}
+	Reg[4] = (Reg[4] & ~(((u32)0xFF << 12) | 7)) | (band << 12) | 4;
+}
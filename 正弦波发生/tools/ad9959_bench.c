@@ -0,0 +1,581 @@
+/**
+	AD9959驱动功能和性能测试,在Linux主机上运行真实的驱动代码,接寄存器级模拟器
+
+	编译:	gcc -O2 -DAD9959_HOST -I. -I../AD9959 -o ad9959_bench ad9959_bench.c bench_cost.c ad9959_host_hal.c ad9959_sim.c ../AD9959/AD9959.c ../AD9959/AD9959_Bus.c ../AD9959/AD9959_Player.c ../AD9959/AD9959_Sweep.c ../AD9959/AD9959_Stream.c ../AD9959/AD9959_Verify.c -lm
+	用法:	./ad9959_bench [-w 波形文件]
+	每项先调用驱动接口,再核对模拟器解码出的工作寄存器和通道输出,失败时打印差异
+	调制流测试核对每个样点生效的值,并逐步提高样点速率,打印实测速率、抖动和中断用时;
+	超过总线上限的速率必须拒绝启动,接受的速率不能有中断超时
+	多相/正交测试从采样波形测各通道相位差,核对等间隔和校准表的补偿
+	寄存器核对测试读回全部寄存器,再模拟单个寄存器出错和芯片掉电复位,核对能否自动修正
+	最后列出每个接口的SCLK边沿数、字节数、帧数和耗时(CPU周期按168MHz换算,模拟SPI)
+	-w 把扫频测试期间4个通道的采样写成CSV(时间us,CH0~CH3),可以用表格软件或gnuplot画图
+	AD9959.h 中 AD9959_BUS 要保持 AD9959_BUS_SOFT
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "ad9959_host_hal.h"
+#include "AD9959.h"
+#include "ad9959_sim.h"
+#include "bench_cost.h"
+
+#define CAP_HZ		100000000		//采样率
+#define CAP_LEN		20000			//采样点数,200us
+
+static TIM_TypeDef tim6;
+static TIM_HandleTypeDef htim6 = {&tim6};
+
+static const char* const costNames[] = {"SCLK", "bytes", "frames", "upd", NULL};
+static uint32_t failed;
+static float capture[CAP_LEN * 4];
+
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef* htim)
+{
+	AD9959_PlayerIRQ(htim);
+	AD9959_SweepIRQ(htim);
+	AD9959_StreamIRQ(htim);
+}
+
+//开销统计的计数:SCLK边沿、字节、帧、IO_Update
+static void cost_count(uint64_t* n)
+{
+	AD9959_SimStats_t s;
+
+	ad9959_host_sync();
+	ad9959_sim_get_stats(&s);
+	n[0] = s.SclkEdges;
+	n[1] = s.Bytes;
+	n[2] = s.Frames;
+	n[3] = s.Updates;
+}
+
+static void check(const char* what, uint32_t got, uint32_t expect)
+{
+	if(got != expect)
+	{
+		printf("  %s failed: got 0x%08X, expect 0x%08X\n", what, got, expect);
+		failed++;
+	}
+}
+
+static void check_near(const char* what, double got, double expect, double tol)
+{
+	if(fabs(got - expect) > tol)
+	{
+		printf("  %s failed: got %.6f, expect %.6f (tol %.6f)\n", what, got, expect, tol);
+		failed++;
+	}
+}
+
+static uint32_t out_ftw(uint8_t ch)
+{
+	uint32_t ftw;
+	uint16_t pow, asf;
+
+	ad9959_sim_output(ch, &ftw, &pow, &asf);
+	return ftw;
+}
+
+//采样中通道ch的频率:上升过零点线性插值,取首尾过零点之间的平均周期
+static double measure_hz(uint8_t ch, uint32_t n)
+{
+	double first = -1, last = -1, a, b, t;
+	uint32_t i, count = 0;
+
+	for(i=1; i<n; i++)
+	{
+		a = capture[(i - 1) * 4 + ch];
+		b = capture[i * 4 + ch];
+		if(a < 0 && b >= 0)
+		{
+			t = (i - 1) + a / (a - b);
+			if(first < 0)
+			{
+				first = t;
+			}
+			last = t;
+			count++;
+		}
+	}
+	if(count < 2)
+	{
+		return 0;
+	}
+	return (count - 1) * (double)CAP_HZ / (last - first);
+}
+
+static void test_init(void)
+{
+	const AD9959_Sim_t* s = ad9959_sim_state();
+
+	printf("init\n");
+	cost_begin();
+	AD9959_Init();
+	cost_end("AD9959_Init");
+	check("FR1", s->Act[0][FR1_ADD], 0xD00000);
+	check("SYSCLK", ad9959_sim_sysclk(), AD9959_SYSCLK);
+}
+
+static void test_single(void)
+{
+	const AD9959_Sim_t* s = ad9959_sim_state();
+	uint16_t pow, asf;
+	uint32_t ftw, n;
+
+	printf("single tone\n");
+	cost_begin();
+	AD9959_Set_Fre(CH1, 1000000);
+	cost_end("AD9959_Set_Fre");
+	cost_begin();
+	AD9959_Set_Fre(CH1, 1000000);
+	cost_end("AD9959_Set_Fre (same)");
+	cost_begin();
+	AD9959_Set_Amp(CH1, 512);
+	cost_end("AD9959_Set_Amp");
+	cost_begin();
+	AD9959_Set_Phase(CH1, 4096);
+	cost_end("AD9959_Set_Phase");
+	check("CFTW0 before update", s->Act[1][CFTW0_ADD], s->Act[0][CFTW0_ADD]);
+	cost_begin();
+	IO_Update();
+	cost_end("IO_Update");
+
+	ad9959_sim_output(1, &ftw, &pow, &asf);
+	check("CH1 FTW", ftw, AD9959_HzToFtw(1000000));
+	check("CH1 POW", pow, 4096);
+	check("CH1 ASF", asf, 512);
+
+	ad9959_sim_capture(capture, 2000, CAP_HZ);
+	run_us(21);
+	n = ad9959_sim_captured();
+	check("captured", n, 2000);
+	check_near("CH1 Hz", measure_hz(1, n), 1000000, 1);
+}
+
+static void test_group(void)
+{
+	AD9959_ChSet_t set[4];
+	const AD9959_Sim_t* s;
+	uint8_t ch;
+	uint16_t pow, asf;
+	uint32_t ftw;
+
+	printf("group set\n");
+	for(ch=0; ch<4; ch++)
+	{
+		set[ch].Freq = 10000000000ull;		//10MHz
+		set[ch].Phase = ch * 90000;
+		set[ch].Asf = 1023;
+	}
+	cost_begin();
+	AD9959_GroupSet(CH0|CH1|CH2|CH3, set, 1);
+	cost_end("AD9959_GroupSet x4 sync");
+	run_us(3);
+	s = ad9959_sim_state();
+	for(ch=0; ch<4; ch++)
+	{
+		ad9959_sim_output(ch, &ftw, &pow, &asf);
+		check("group FTW", ftw, AD9959_MilliHzToFtw(set[ch].Freq));
+		check("group POW", pow, AD9959_MilliDegToPow(set[ch].Phase));
+		check("group accumulator", s->Ch[ch].Phase, s->Ch[0].Phase);
+	}
+}
+
+static void test_fsk(void)
+{
+	uint32_t data[16];
+	uint8_t i;
+
+	printf("FSK\n");
+	for(i=0; i<16; i++)
+	{
+		data[i] = 1000000 + i * 100000;
+	}
+	cost_begin();
+	AD9959_Modulation_Init(CH0, FSK, SWEEP_DISABLE, LEVEL_MOD_2);
+	cost_end("AD9959_Modulation_Init");
+	cost_begin();
+	AD9959_SetFSK(CH0, data, 0);
+	cost_end("AD9959_SetFSK");
+	IO_Update();
+	PS0 = 0;
+	check("FSK PS0=0", out_ftw(0), AD9959_HzToFtw(data[0]));
+	PS0 = 1;
+	check("FSK PS0=1", out_ftw(0), AD9959_HzToFtw(data[1]));
+	PS0 = 0;
+	check("FSK PS0=0 again", out_ftw(0), AD9959_HzToFtw(data[0]));
+}
+
+static void test_sweep(const char* wave)
+{
+	AD9959_SweepPlan_t plan;
+	uint32_t s0 = AD9959_HzToFtw(1000000), e0 = AD9959_HzToFtw(10000000), mid, n, i;
+	FILE* f;
+
+	printf("sweep\n");
+	cost_begin();
+	AD9959_SweepPlan(FSK, s0, e0, 100000, &plan);		//100us
+	cost_end("AD9959_SweepPlan");
+	cost_begin();
+	AD9959_SweepLoad(CH0, &plan);
+	cost_end("AD9959_SweepLoad");
+	ad9959_sim_capture(capture, CAP_LEN, CAP_HZ);
+	cost_begin();
+	AD9959_SweepGo(CH0, &plan);
+	cost_end("AD9959_SweepGo");
+
+	run_us(50);
+	mid = out_ftw(0);
+	check_near("sweep midpoint", (double)mid / e0, 0.5 + 0.5 * s0 / e0, 0.02);
+	run_us(60);
+	check("sweep end", out_ftw(0), plan.E0);
+	run_us(CAP_LEN * 1000000ull / CAP_HZ);
+	n = ad9959_sim_captured();
+	check("captured", n, CAP_LEN);
+
+	if(wave != NULL && (f = fopen(wave, "w")) != NULL)
+	{
+		fprintf(f, "t_us,ch0,ch1,ch2,ch3\n");
+		for(i=0; i<n; i++)
+		{
+			fprintf(f, "%.3f,%.4f,%.4f,%.4f,%.4f\n", i * 1e6 / CAP_HZ,
+					capture[i * 4], capture[i * 4 + 1], capture[i * 4 + 2], capture[i * 4 + 3]);
+		}
+		fclose(f);
+		printf("  wrote %u samples to %s\n", n, wave);
+	}
+
+	cost_begin();
+	AD9959_Sweep(CH0, FSK, e0, s0, 50000);
+	cost_end("AD9959_Sweep (down)");
+	run_us(60);
+	check("sweep down end", out_ftw(0), s0);
+
+	AD9959_SweepPlan(FSK, s0, e0, 100000000, &plan);		//100ms,1MHz计数时超过16位ARR
+	check("sweep above ARR", AD9959_SweepStart(&htim6, 1000000, CH0, &plan, 1, 0), 1);
+}
+
+static void test_player(void)
+{
+	static const AD9959_Hop_t table[3] =
+	{
+		{CH2, 0x01000000, 0,    1023, 10},
+		{CH2, 0x02000000, 4096, 512,  20},
+		{CH2, 0x03000000, 8192, 2000, 30},
+	};
+	static const AD9959_Hop_t slow[1] = {{CH2, 0x01000000, 0, 1023, AD9959_TIM_TICKS_MAX + 1}};
+	AD9959_PlayerStats_t stats;
+	uint64_t t0;
+
+	printf("player\n");
+	check("dwell above ARR", AD9959_PlayerStart(&htim6, 1000000, slow, 1, AD9959_PLAY_UPDATE, 0), 1);
+	ad9959_host_tim_config(&htim6, 1000000);
+	cost_begin();
+	AD9959_PlayerStart(&htim6, 1000000, table, 3, AD9959_PLAY_UPDATE, 0);
+	cost_end("AD9959_PlayerStart");
+	t0 = ad9959_host_now();
+	run_us(5);
+	check("hop 0", out_ftw(2), table[0].Ftw);
+	run_us(10);
+	check("hop 1", out_ftw(2), table[1].Ftw);
+	run_us(20);
+	check("hop 2", out_ftw(2), table[2].Ftw);
+	run_us(40);
+	check("player stopped", AD9959_PlayerBusy(), 0);
+	check("hold last", out_ftw(2), table[2].Ftw);
+	AD9959_PlayerGetStats(&stats);
+	check("hops", stats.Hops, 2);		//第一项在启动时输出,不计入切换次数
+	printf("  jitter %d..%d cycles, prefetch max %u cycles, %.1f us\n", stats.JitterMin, stats.JitterMax,
+		   stats.PrefetchMax, (ad9959_host_now() - t0) * 1e6 / SystemCoreClock);
+}
+
+static void test_stream(void)
+{
+	static const uint32_t rates[] = {50000, 100000, 200000, 500000, 1000000, 2000000};
+	static uint8_t frames[16 * AD9959_STREAM_FRAME_MAX];
+	static volatile int16_t ring[16];
+	AD9959_Mod_t fm = {CH3, FSK, AD9959_HzToFtw(10000000), AD9959_HzToFtw(100000)};
+	AD9959_Mod_t am = {CH3, ASK, 512, 511};
+	AD9959_StreamStats_t stats;
+	int16_t sine[16];
+	uint16_t pow, asf;
+	uint32_t ftw, i, bad = 0, top = 0;
+
+	printf("stream\n");
+	for(i=0; i<16; i++)
+	{
+		sine[i] = (int16_t)lrint(32767 * sin(2 * M_PI * i / 16));
+		ring[i] = sine[i];
+	}
+	cost_begin();
+	AD9959_StreamBuild(&fm, sine, 16, frames);
+	cost_end("AD9959_StreamBuild x16");
+
+	//定时器1MHz,每10us一个样点;在每个样点周期的中间核对
+	ad9959_host_tim_config(&htim6, 1000000);
+	cost_begin();
+	check("FM start", AD9959_StreamStart(&htim6, 1000000, 100000, &fm, frames, 16, 0), 0);
+	cost_end("AD9959_StreamStart");
+	run_us(5);
+	for(i=0; i<16; i++)
+	{
+		ftw = out_ftw(3);
+		if(ftw != fm.Carrier + (uint32_t)(((int64_t)sine[i] * fm.Depth) >> 15))
+		{
+			bad++;
+		}
+		run_us(10);
+	}
+	check("FM samples", bad, 0);
+	check("FM stopped", AD9959_StreamBusy(), 0);
+	check("FM shadow", AD9959_Shadow.Reg[3][CFTW0_ADD], out_ftw(3));
+
+	check("AM start", AD9959_StreamStartLive(&htim6, 1000000, 100000, &am, ring, 16), 0);
+	run_us(5);
+	for(i=0, bad=0; i<32; i++)
+	{
+		ad9959_sim_output(3, &ftw, &pow, &asf);
+		if(asf != (uint16_t)(am.Carrier + (((int32_t)ring[i % 16] * (int32_t)am.Depth) >> 15)))
+		{
+			bad++;
+		}
+		run_us(10);
+	}
+	AD9959_StreamStop();
+	check("AM samples", bad, 0);
+	AD9959_StreamGetStats(&stats);
+	check("AM loops", stats.Loops, 2);
+
+	printf("  %-8s %8s %8s %10s %8s %8s\n", "set Hz", "got Hz", "overrun", "jitter", "irq max", "samples");
+	for(i=0; i<sizeof(rates) / sizeof(rates[0]); i++)
+	{
+		ad9959_host_tim_config(&htim6, 10000000);
+		if(AD9959_StreamStart(&htim6, 10000000, rates[i], &fm, frames, 16, 1))
+		{
+			printf("  %-8u rejected\n", rates[i]);
+			continue;
+		}
+		run_us(2000);
+		AD9959_StreamStop();
+		AD9959_StreamGetStats(&stats);
+		printf("  %-8u %8u %8u %4d..%-4d %8u %8u\n", rates[i], stats.Rate, stats.Overruns,
+			   stats.JitterMin, stats.JitterMax, stats.IrqMax, stats.Samples);
+		check("stream overruns", stats.Overruns, 0);
+		top = rates[i];
+	}
+	printf("  frame + IO_Update %u cycles\n", stats.FrameCycles);
+	check("500 kHz accepted", top >= 500000, 1);
+
+	//测开销的那一帧只能写第一个通道,速率太高被拒绝时其他通道也保持原样
+	AD9959_Set_Fre(CH1, 1000000);
+	AD9959_Set_Fre(CH2, 2000000);
+	fm.Channel = CH1 | CH2;
+	check("5 MHz rejected", AD9959_StreamStart(&htim6, 10000000, 5000000, &fm, frames, 16, 1), 1);
+	check("probe CH1", out_ftw(1), AD9959_HzToFtw(1000000));
+	check("probe CH2", out_ftw(2), AD9959_HzToFtw(2000000));
+}
+
+//采样中通道ch相对sin(2πft)的相位,度;n个样点要包含整数个周期
+static double measure_deg(uint8_t ch, uint32_t n, double hz)
+{
+	double i = 0, q = 0, w;
+	uint32_t k;
+
+	for(k=0; k<n; k++)
+	{
+		w = 2 * M_PI * hz * k / CAP_HZ;
+		i += capture[k * 4 + ch] * sin(w);
+		q += capture[k * 4 + ch] * cos(w);
+	}
+	return atan2(q, i) * 180 / M_PI;
+}
+
+static double wrap_deg(double d)
+{
+	while(d > 180)
+	{
+		d -= 360;
+	}
+	while(d <= -180)
+	{
+		d += 360;
+	}
+	return d;
+}
+
+static void test_multiphase(void)
+{
+	static const int16_t trim[4] = {0, -100, 50, 0};
+	uint16_t pow, asf;
+	uint32_t ftw, n;
+	uint8_t ch;
+	double p[4];
+
+	printf("multiphase\n");
+	cost_begin();
+	AD9959_MultiPhase(CH0|CH1|CH2, 10000000000ull, 0, 1000, trim);
+	cost_end("AD9959_MultiPhase x3");
+	ad9959_sim_capture(capture, 2000, CAP_HZ);
+	run_us(21);
+	n = ad9959_sim_captured();
+	for(ch=0; ch<3; ch++)
+	{
+		p[ch] = measure_deg(ch, n, 10e6);
+	}
+	check_near("3-phase CH1-CH0", wrap_deg(p[1] - p[0]), 120, 0.05);
+	check_near("3-phase CH2-CH0", wrap_deg(p[2] - p[0]), -120, 0.05);
+	ad9959_sim_output(1, &ftw, &pow, &asf);
+	check("trim CH1", asf, 900);
+	ad9959_sim_output(2, &ftw, &pow, &asf);
+	check("trim CH2", asf, 1023);
+
+	//CH3比CH2多走1ns,10MHz时应提前3.6°
+	AD9959_PhaseCal.Delay[3] = 1000;
+	AD9959_PhaseCal.Gain[2] = 20;
+	cost_begin();
+	AD9959_IQ(CH2, CH3, 10000000000ull, 1000);
+	cost_end("AD9959_IQ");
+	ad9959_sim_capture(capture, 2000, CAP_HZ);
+	run_us(21);
+	n = ad9959_sim_captured();
+	check_near("IQ I-Q", wrap_deg(measure_deg(2, n, 10e6) - measure_deg(3, n, 10e6)), 90 - 3.6, 0.05);
+	ad9959_sim_output(2, &ftw, &pow, &asf);
+	check("IQ gain CH2", asf, 1020);
+	memset(&AD9959_PhaseCal, 0, sizeof(AD9959_PhaseCal));
+}
+
+static void test_verify(void)
+{
+	const AD9959_Sim_t* s = ad9959_sim_state();
+	static volatile int16_t ring[16];
+	AD9959_Mod_t am = {CH3, ASK, 512, 511};
+	AD9959_VerifyStats_t stats;
+	uint16_t pow, asf;
+	uint32_t value, i, j, bad = 0, ftw = AD9959_HzToFtw(2000000);
+
+	printf("verify\n");
+	AD9959_Set_Fre(CH1, 2000000);
+	IO_Update();
+	cost_begin();
+	AD9959_ReadReg(CH1, CFTW0_ADD, &value);
+	cost_end("AD9959_ReadReg CFTW0");
+	check("read CFTW0", value, ftw);
+	AD9959_ReadReg(0, FR1_ADD, &value);
+	check("read FR1", value, 0xD00000);
+
+	cost_begin();
+	for(i=0; i<91; i++)
+	{
+		AD9959_VerifyStep();
+	}
+	cost_end("AD9959_VerifyStep x91");
+	AD9959_VerifyGetStats(&stats);
+	check("clean round", stats.Mismatch, 0);
+	check("rounds", stats.Rounds, 1);
+
+	//单个寄存器被改写:只重写这一个并立即生效
+	ad9959_sim_poke(1, CFTW0_ADD, 0x12345678);
+	for(i=0; i<91; i++)
+	{
+		AD9959_VerifyStep();
+	}
+	AD9959_VerifyGetStats(&stats);
+	check("upset found", stats.Rewrite, 1);
+	check("upset fixed", out_ftw(1), ftw);
+
+	//掉电复位:CSR/FR1不对,复位芯片后整体重写
+	ad9959_sim_brownout();
+	for(i=0; i<91; i++)
+	{
+		AD9959_VerifyStep();
+	}
+	AD9959_VerifyGetStats(&stats);
+	check("brownout found", stats.Reinit, 1);
+	check("brownout FR1", s->Act[0][FR1_ADD], 0xD00000);
+	check("brownout CH1", out_ftw(1), ftw);
+	check("brownout CH3 CFR", s->Act[3][CFR_ADD], AD9959_Shadow.Reg[3][CFR_ADD]);
+	for(i=0; i<91; i++)
+	{
+		AD9959_VerifyStep();
+	}
+	AD9959_VerifyGetStats(&stats);
+	check("clean after restore", stats.Mismatch, 2);
+
+	//与调制流同时运行:CH3的ACR由调制流直接写入,跳过不核对,不能按影子寄存器改回去
+	for(i=0; i<16; i++)
+	{
+		ring[i] = (int16_t)lrint(32767 * sin(2 * M_PI * i / 16));
+	}
+	ad9959_host_tim_config(&htim6, 1000000);
+	check("AM start", AD9959_StreamStartLive(&htim6, 1000000, 100000, &am, ring, 16), 0);
+	for(i=0; i<400; i++)
+	{
+		AD9959_VerifyStep();
+		run_us(3);
+		ad9959_sim_output(3, &value, &pow, &asf);
+		for(j=0; j<16 && asf != (uint16_t)(am.Carrier + (((int32_t)ring[j] * (int32_t)am.Depth) >> 15)); j++);
+		if(j == 16)
+		{
+			bad++;
+		}
+	}
+	check("AM running", AD9959_StreamBusy(), 1);
+	AD9959_StreamStop();
+	check("AM samples", bad, 0);
+	AD9959_VerifyGetStats(&stats);
+	check("AM mismatch", stats.Mismatch, 2);
+	check("AM skipped", stats.Skipped, 4);
+	for(i=0; i<91; i++)
+	{
+		AD9959_VerifyStep();
+	}
+	AD9959_VerifyGetStats(&stats);
+	check("clean after stream", stats.Mismatch, 2);
+	printf("  checked %u, step max %u cycles (%.2f us)\n", stats.Checked, stats.StepMax, stats.StepMax * 1e6 / SystemCoreClock);
+}
+
+int main(int argc, char** argv)
+{
+	const char* wave = NULL;
+	AD9959_SimStats_t s;
+	uint32_t i;
+
+	for(i=1; i<(uint32_t)argc; i++)
+	{
+		if(!strcmp(argv[i], "-w") && i + 1 < (uint32_t)argc)
+		{
+			wave = argv[++i];
+		}
+		else
+		{
+			printf("usage: %s [-w wave.csv]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	ad9959_sim_init(AD9959_REF_CLK, SystemCoreClock);
+	cost_init(cost_count, costNames);
+	test_init();
+	test_single();
+	test_group();
+	test_fsk();
+	test_sweep(wave);
+	test_player();
+	test_stream();
+	test_multiphase();
+	test_verify();
+
+	cost_print();
+	ad9959_sim_get_stats(&s);
+	printf("\nframes %u writes %u reads %u updates %u (short %u) resets %u bus errors %u\n",
+		   s.Frames, s.Writes, s.Reads, s.Updates, s.ShortUpdates, s.Resets, s.Errors);
+	if(s.Errors || s.ShortUpdates)
+	{
+		failed++;
+	}
+	printf("%s (%u failed)\n", failed ? "FAIL" : "PASS", failed);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,354 @@
+/**
+	Linux主机上的最小HAL,说明见 ad9959_host_hal.h
+*/
+
+#include <string.h>
+#include "ad9959_host_hal.h"
+
+#define AD9959_HOST_TIM_MAX		(4)
+#define AD9959_HOST_TIM_TOP		(0x10000ULL)	//16位定时器,计数超过ARR时数到0xFFFF回绕
+
+typedef struct
+{
+    TIM_HandleTypeDef* htim;
+    uint32_t TickHz;		//计数频率,默认1MHz
+    uint8_t  Running;
+    uint32_t Shadow;		//正在使用的ARR
+    uint64_t Start;			//启动时刻,CPU周期
+    uint64_t Last;			//到上一次更新为止的总计数个数
+    uint64_t Ticks;			//到下一次更新为止的总计数个数
+    uint64_t Next;			//下一次更新的时刻,CPU周期
+}AD9959_HostTim_t;
+
+GPIO_TypeDef ad9959HostGpio[6];
+CoreDebug_Type ad9959HostCoreDebug;
+uint32_t SystemCoreClock = 168000000;
+volatile uint32_t ad9959HostPrimask = 0;
+volatile uint32_t ad9959HostIpsr = 0;
+
+static volatile uint32_t pinOut[6][16];
+static volatile uint32_t pinIn[6][16];
+static volatile uint32_t* pendSlot = NULL;		//最后一次返回的输出引脚,下次访问时处理
+static uint8_t pendPort, pendPin;
+static uint32_t pendOld;
+
+static DWT_Type dwt;
+static uint64_t now = 0;
+static uint16_t extiPending = 0;
+static AD9959_HostTim_t tims[AD9959_HOST_TIM_MAX];
+static const AD9959_HostDev_t* devs[AD9959_HOST_DEV_MAX];
+static uint8_t devNum = 0;
+
+
+
+uint64_t ad9959_host_now(void)
+{
+	return now;
+}
+
+void ad9959_host_attach(const AD9959_HostDev_t* dev)
+{
+	uint8_t i;
+
+	for(i=0; i<devNum; i++)
+	{
+		if(devs[i] == dev)
+		{
+			return;
+		}
+	}
+	if(devNum < AD9959_HOST_DEV_MAX)
+	{
+		devs[devNum++] = dev;
+	}
+}
+
+//时间推进到now,交给每个模拟器
+static void host_devs_advance(void)
+{
+	uint8_t i;
+
+	for(i=0; i<devNum; i++)
+	{
+		devs[i]->Advance(now);
+	}
+}
+
+//最早的模拟器内部事件时刻
+static uint64_t host_devs_next(void)
+{
+	uint64_t next = UINT64_MAX, t;
+	uint8_t i;
+
+	for(i=0; i<devNum; i++)
+	{
+		if(devs[i]->Next != NULL && (t = devs[i]->Next()) < next)
+		{
+			next = t;
+		}
+	}
+	return next;
+}
+
+void ad9959_host_sync(void)
+{
+	uint8_t level, i;
+
+	if(pendSlot == NULL)
+	{
+		return;
+	}
+	level = (*pendSlot != 0);
+	*pendSlot = level;
+	if(level != (pendOld != 0))
+	{
+		for(i=0; i<devNum; i++)
+		{
+			devs[i]->Pin(pendPort, pendPin, level, now);
+		}
+	}
+	pendSlot = NULL;
+}
+
+static AD9959_HostTim_t* host_tim(TIM_HandleTypeDef* htim)
+{
+	uint8_t i;
+
+	for(i=0; i<AD9959_HOST_TIM_MAX; i++)
+	{
+		if(tims[i].htim == htim)
+		{
+			return &tims[i];
+		}
+	}
+	for(i=0; i<AD9959_HOST_TIM_MAX; i++)
+	{
+		if(tims[i].htim == NULL)
+		{
+			tims[i].htim = htim;
+			tims[i].TickHz = 1000000;
+			return &tims[i];
+		}
+	}
+	return NULL;
+}
+
+static uint64_t host_tim_at(AD9959_HostTim_t* t)
+{
+	return t->Start + (t->Ticks * SystemCoreClock + t->TickHz - 1) / t->TickHz;
+}
+
+//分发外部中断和到期的定时器中断,进入中断花费AD9959_HOST_IRQ_CYCLES
+static void host_dispatch(void)
+{
+	uint8_t i;
+	uint16_t pins;
+	AD9959_HostTim_t* t;
+
+	if(ad9959HostIpsr || ad9959HostPrimask)
+	{
+		return;
+	}
+	while(extiPending)
+	{
+		ad9959_host_sync();
+		ad9959HostIpsr = 1;
+		now += AD9959_HOST_IRQ_CYCLES;
+		host_devs_advance();
+		pins = extiPending;
+		extiPending = 0;
+		for(i=0; i<16; i++)
+		{
+			if(pins & (1u << i))
+			{
+				HAL_GPIO_EXTI_Callback((uint16_t)(1u << i));
+			}
+		}
+		ad9959_host_sync();
+		ad9959HostIpsr = 0;
+	}
+	for(i=0; i<AD9959_HOST_TIM_MAX; i++)
+	{
+		t = &tims[i];
+		if(!t->Running || now < t->Next)
+		{
+			continue;
+		}
+		ad9959_host_sync();
+		ad9959HostIpsr = 1;
+		now += AD9959_HOST_IRQ_CYCLES;
+		host_devs_advance();
+		t->Shadow = t->htim->Instance->ARR;		//预装载的周期在更新时生效
+		do		//中断来不及处理时,期间的多次更新只留下一个标志
+		{
+			t->Last = t->Ticks;
+			t->Ticks += t->Shadow + 1;
+			t->Next = host_tim_at(t);
+		}while(t->Next <= now);
+		HAL_TIM_PeriodElapsedCallback(t->htim);
+		ad9959_host_sync();
+		ad9959HostIpsr = 0;
+	}
+}
+
+static void host_advance(uint64_t cycles)
+{
+	now += cycles;
+	host_devs_advance();
+	host_dispatch();
+}
+
+volatile uint32_t* ad9959_host_pin(uint8_t port, uint8_t pin, uint8_t in)
+{
+	ad9959_host_sync();
+	host_advance(AD9959_HOST_PIN_CYCLES);
+	ad9959_host_sync();		//中断里最后一次写入
+	if(in)
+	{
+		return &pinIn[port][pin];
+	}
+	pendSlot = &pinOut[port][pin];
+	pendPort = port;
+	pendPin = pin;
+	pendOld = *pendSlot;
+	return pendSlot;
+}
+
+void ad9959_host_set_input(uint8_t port, uint8_t pin, uint8_t level)
+{
+	pinIn[port][pin] = level;
+}
+
+void ad9959_host_exti(uint16_t pins)
+{
+	extiPending |= pins;
+}
+
+DWT_Type* ad9959_host_dwt(void)
+{
+	ad9959_host_sync();		//DWT延时前刚写的引脚(如IO_UPDATE)按写入时刻交给模拟器,脉宽才准
+	host_advance(1);
+	dwt.CYCCNT = (uint32_t)now;
+	return &dwt;
+}
+
+void ad9959_host_set_primask(uint32_t primask)
+{
+	ad9959HostPrimask = primask;
+	if(!primask)
+	{
+		host_dispatch();
+	}
+}
+
+void ad9959_host_run(uint64_t cycles)
+{
+	uint64_t end = now + cycles, step, next;
+	uint8_t i;
+
+	ad9959_host_sync();
+	while(now < end)
+	{
+		step = end - now;
+		next = host_devs_next();
+		if(next > now && next - now < step)
+		{
+			step = next - now;		//模拟器在这一步中间改变输入(如ADF4351的LD)
+		}
+		for(i=0; i<AD9959_HOST_TIM_MAX; i++)
+		{
+			if(tims[i].Running && (tims[i].Next <= now || tims[i].Next - now < step))
+			{
+				step = (tims[i].Next > now) ? tims[i].Next - now : 1;		//已到期(中断中或关中断)时逐个周期推进
+			}
+		}
+		host_advance(step);
+	}
+}
+
+void ad9959_host_tim_config(TIM_HandleTypeDef* htim, uint32_t tick_hz)
+{
+	AD9959_HostTim_t* t = host_tim(htim);
+
+	if(t != NULL && tick_hz != 0)
+	{
+		t->TickHz = tick_hz;
+	}
+}
+
+void ad9959_host_tim_arr(TIM_HandleTypeDef* htim, uint32_t arr)
+{
+	AD9959_HostTim_t* t = host_tim(htim);
+
+	uint64_t cnt;
+
+	htim->Instance->ARR = arr;
+	if(t != NULL && !(htim->Instance->CR1 & TIM_CR1_ARPE))
+	{
+		t->Shadow = arr;
+		if(t->Running)		//当前周期按新的ARR结束;已经计过头时和硬件一样数到0xFFFF回绕,再数到ARR才更新
+		{
+			cnt = (now - t->Start) * t->TickHz / SystemCoreClock - t->Last;
+			t->Ticks = t->Last + arr + 1 + ((cnt > arr) ? AD9959_HOST_TIM_TOP : 0);
+			t->Next = host_tim_at(t);
+		}
+	}
+}
+
+void ad9959_host_tim_cnt(TIM_HandleTypeDef* htim, uint32_t cnt)
+{
+	AD9959_HostTim_t* t = host_tim(htim);
+
+	htim->Instance->CNT = cnt;
+	if(t != NULL && t->Running)
+	{
+		t->Start = now;
+		t->Last = 0;
+		t->Ticks = t->Shadow + 1 + ((cnt > t->Shadow) ? AD9959_HOST_TIM_TOP : 0) - cnt;
+		t->Next = host_tim_at(t);
+	}
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef* port, GPIO_InitTypeDef* init)
+{
+	(void)port;
+	(void)init;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef* htim)
+{
+	AD9959_HostTim_t* t = host_tim(htim);
+
+	if(t == NULL)
+	{
+		return HAL_ERROR;
+	}
+	t->Running = 1;
+	t->Start = now;
+	t->Last = 0;
+	t->Ticks = t->Shadow + 1;
+	t->Next = host_tim_at(t);
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef* htim)
+{
+	AD9959_HostTim_t* t = host_tim(htim);
+
+	if(t == NULL)
+	{
+		return HAL_ERROR;
+	}
+	t->Running = 0;
+	return HAL_OK;
+}
+
+__weak void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef* htim)
+{
+	(void)htim;
+}
+
+__weak void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+	(void)GPIO_Pin;
+}
@@ -0,0 +1,204 @@
+#ifndef __AD9959_HOST_HAL_H__
+#define __AD9959_HOST_HAL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+	在Linux主机上编译 AD9959.c 等驱动文件用的最小HAL(编译驱动时定义 AD9959_HOST)
+	PAout(n)等位带宏改为函数返回引脚变量的地址:每次访问引脚时先处理上一次的写入,
+	电平有变化就交给挂上来的模拟器(ad9959_sim.c等)解码,因此驱动代码不用改动
+	时间以CPU周期计,每次引脚访问、读DWT->CYCCNT都会推进一点时间,DWT延时因此能正常结束;
+	定时器更新中断和模拟器请求的外部中断在时间推进时分发,关中断期间不分发
+	只支持模拟SPI通信方式(AD9959_BUS_SOFT),其他方式用到的外设这里没有
+	模拟器在自己的init里用ad9959_host_attach挂上,HAL不依赖具体的模拟器;
+	ADF4351(ADF4351_HOST,模拟SPI)也用这个HAL,adf4351_sim.c同样挂上即可
+*/
+
+
+
+typedef uint8_t  u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+
+#define __weak	__attribute__((weak))
+
+typedef enum
+{
+    HAL_OK = 0,
+    HAL_ERROR,
+    HAL_BUSY,
+    HAL_TIMEOUT,
+}HAL_StatusTypeDef;
+
+typedef struct
+{
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Pull;
+    uint32_t Speed;
+    uint32_t Alternate;
+}GPIO_InitTypeDef;
+
+typedef struct
+{
+    volatile uint32_t MODER, OTYPER, OSPEEDR, PUPDR, IDR, ODR, BSRR, LCKR, AFR[2];
+}GPIO_TypeDef;
+
+extern GPIO_TypeDef ad9959HostGpio[6];
+#define GPIOA	(&ad9959HostGpio[0])
+#define GPIOB	(&ad9959HostGpio[1])
+#define GPIOC	(&ad9959HostGpio[2])
+#define GPIOD	(&ad9959HostGpio[3])
+#define GPIOE	(&ad9959HostGpio[4])
+#define GPIOF	(&ad9959HostGpio[5])
+
+#define GPIO_PIN_0		0x0001u
+#define GPIO_PIN_1		0x0002u
+#define GPIO_PIN_2		0x0004u
+#define GPIO_PIN_3		0x0008u
+#define GPIO_PIN_4		0x0010u
+#define GPIO_PIN_5		0x0020u
+#define GPIO_PIN_6		0x0040u
+#define GPIO_PIN_7		0x0080u
+#define GPIO_PIN_8		0x0100u
+#define GPIO_PIN_9		0x0200u
+#define GPIO_PIN_10		0x0400u
+#define GPIO_PIN_11		0x0800u
+#define GPIO_PIN_12		0x1000u
+#define GPIO_PIN_13		0x2000u
+#define GPIO_PIN_14		0x4000u
+#define GPIO_PIN_15		0x8000u
+
+#define GPIO_MODE_INPUT				0u
+#define GPIO_MODE_OUTPUT_PP			1u
+#define GPIO_MODE_IT_RISING			0x10110000u
+#define GPIO_MODE_IT_FALLING		0x10210000u
+#define GPIO_MODE_IT_RISING_FALLING	0x10310000u
+#define GPIO_NOPULL					0u
+#define GPIO_PULLUP					1u
+#define GPIO_PULLDOWN				2u
+#define GPIO_SPEED_FREQ_LOW			0u
+#define GPIO_SPEED_FREQ_MEDIUM		1u
+#define GPIO_SPEED_FREQ_HIGH		2u
+#define GPIO_SPEED_FREQ_VERY_HIGH	3u
+
+#define __HAL_RCC_GPIOA_CLK_ENABLE()	do{}while(0)
+#define __HAL_RCC_GPIOB_CLK_ENABLE()	do{}while(0)
+#define __HAL_RCC_GPIOC_CLK_ENABLE()	do{}while(0)
+#define __HAL_RCC_GPIOF_CLK_ENABLE()	do{}while(0)
+
+void HAL_GPIO_Init(GPIO_TypeDef* port, GPIO_InitTypeDef* init);
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+
+//NVIC:外部中断只按PRIMASK屏蔽,不区分优先级和通道
+typedef enum
+{
+    EXTI0_IRQn = 6,
+    EXTI9_5_IRQn = 23,
+    EXTI15_10_IRQn = 40,
+}IRQn_Type;
+
+#define HAL_NVIC_SetPriority(irq, pre, sub)		do{ (void)(irq); (void)(pre); (void)(sub); }while(0)
+#define HAL_NVIC_EnableIRQ(irq)					do{ (void)(irq); }while(0)
+#define HAL_NVIC_DisableIRQ(irq)				do{ (void)(irq); }while(0)
+
+//位带引脚:out为输出锁存,in为模拟器驱动的输入电平
+volatile uint32_t* ad9959_host_pin(uint8_t port, uint8_t pin, uint8_t in);
+#define PAout(n)	(*ad9959_host_pin(0, n, 0))
+#define PBout(n)	(*ad9959_host_pin(1, n, 0))
+#define PCout(n)	(*ad9959_host_pin(2, n, 0))
+#define PDout(n)	(*ad9959_host_pin(3, n, 0))
+#define PEout(n)	(*ad9959_host_pin(4, n, 0))
+#define PFout(n)	(*ad9959_host_pin(5, n, 0))
+#define PAin(n)		(*ad9959_host_pin(0, n, 1))
+#define PBin(n)		(*ad9959_host_pin(1, n, 1))
+#define PCin(n)		(*ad9959_host_pin(2, n, 1))
+#define PDin(n)		(*ad9959_host_pin(3, n, 1))
+#define PEin(n)		(*ad9959_host_pin(4, n, 1))
+#define PFin(n)		(*ad9959_host_pin(5, n, 1))
+
+
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+}DWT_Type;
+
+typedef struct
+{
+    volatile uint32_t DEMCR;
+}CoreDebug_Type;
+
+DWT_Type* ad9959_host_dwt(void);
+extern CoreDebug_Type ad9959HostCoreDebug;
+#define DWT				(ad9959_host_dwt())
+#define CoreDebug		(&ad9959HostCoreDebug)
+#define DWT_CTRL_CYCCNTENA_Msk			(1u << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk		(1u << 24)
+
+extern uint32_t SystemCoreClock;
+
+extern volatile uint32_t ad9959HostPrimask;
+extern volatile uint32_t ad9959HostIpsr;		//分发中断期间不为0
+void ad9959_host_set_primask(uint32_t primask);
+#define __get_PRIMASK()		(ad9959HostPrimask)
+#define __set_PRIMASK(x)	ad9959_host_set_primask(x)
+#define __disable_irq()		ad9959_host_set_primask(1)
+#define __enable_irq()		ad9959_host_set_primask(0)
+#define __get_IPSR()		(ad9959HostIpsr)
+#define __NOP()				do{}while(0)
+
+
+
+//基本定时器:只模拟更新中断;ARPE=1时写ARR只写预装载,更新时才生效,ARPE=0时立即生效(当前周期按新的ARR结束)
+//运行中写CNT从写入的计数继续计;计数已超过ARR时与16位硬件定时器一样数到0xFFFF回绕后再数到ARR
+typedef struct
+{
+    volatile uint32_t CR1, CR2, SMCR, DIER, SR, EGR, CCMR1, CCMR2, CCER, CNT, PSC, ARR;
+}TIM_TypeDef;
+
+typedef struct
+{
+    TIM_TypeDef* Instance;
+}TIM_HandleTypeDef;
+
+#define TIM_CR1_ARPE		(1u << 7)
+#define TIM_FLAG_UPDATE		(1u << 0)
+#define __HAL_TIM_SET_AUTORELOAD(h, v)	ad9959_host_tim_arr(h, v)
+#define __HAL_TIM_GET_AUTORELOAD(h)		((h)->Instance->ARR)
+#define __HAL_TIM_SET_COUNTER(h, v)		ad9959_host_tim_cnt(h, v)
+#define __HAL_TIM_CLEAR_FLAG(h, f)		((h)->Instance->SR = ~(f))
+
+void ad9959_host_tim_arr(TIM_HandleTypeDef* htim, uint32_t arr);
+void ad9959_host_tim_cnt(TIM_HandleTypeDef* htim, uint32_t cnt);
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef* htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef* htim);
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef* htim);
+
+
+
+#define AD9959_HOST_PIN_CYCLES	(2)		//一次引脚访问的CPU周期数
+#define AD9959_HOST_IRQ_CYCLES	(12)	//进入中断的CPU周期数
+
+void ad9959_host_tim_config(TIM_HandleTypeDef* htim, uint32_t tick_hz);	//定时器计数频率
+void ad9959_host_set_input(uint8_t port, uint8_t pin, uint8_t level);	//模拟器驱动输入引脚
+void ad9959_host_exti(uint16_t pins);		//模拟器请求外部中断,开中断时调用HAL_GPIO_EXTI_Callback
+void ad9959_host_sync(void);				//处理最后一次引脚写入
+void ad9959_host_run(uint64_t cycles);		//空转若干CPU周期,期间分发定时器中断
+uint64_t ad9959_host_now(void);				//当前时间,CPU周期
+
+//挂在引脚和时间上的模拟器
+typedef struct
+{
+	void (*Pin)(uint8_t port, uint8_t pin, uint8_t level, uint64_t now);	//输出引脚电平变化
+	void (*Advance)(uint64_t now);		//时间推进到now,处理到期的内部事件
+	uint64_t (*Next)(void);				//下一次内部事件(如改变输入引脚)的时刻,没有时为UINT64_MAX;可为NULL
+}AD9959_HostDev_t;
+
+#define AD9959_HOST_DEV_MAX		(4)
+void ad9959_host_attach(const AD9959_HostDev_t* dev);	//挂上模拟器,重复挂同一个不生效
+
+
+#endif
@@ -0,0 +1,614 @@
+/**
+	AD9959寄存器级模拟器,说明见 ad9959_sim.h
+*/
+
+#include <string.h>
+#include <math.h>
+#include "ad9959_sim.h"
+#include "ad9959_host_hal.h"
+
+enum
+{
+    SIM_NONE = 0,
+    SIM_CS,
+    SIM_SCLK,
+    SIM_UPDATE,
+    SIM_RESET,
+    SIM_PWR,
+    SIM_PS0,		//SIM_PS0~SIM_PS3连续
+    SIM_PS1,
+    SIM_PS2,
+    SIM_PS3,
+    SIM_SDIO0,		//SIM_SDIO0~SIM_SDIO3连续
+    SIM_SDIO1,
+    SIM_SDIO2,
+    SIM_SDIO3,
+};
+
+typedef struct
+{
+    uint8_t Port;		//0~5 对应 GPIOA~GPIOF
+    uint8_t Pin;
+    uint8_t Role;
+}AD9959_SimPin_t;
+
+//与 AD9959.h 中的引脚宏一致
+static const AD9959_SimPin_t simPins[] =
+{
+    {5, 6,  SIM_CS},
+    {1, 1,  SIM_SCLK},
+    {1, 0,  SIM_UPDATE},
+    {1, 13, SIM_RESET},
+    {1, 12, SIM_PWR},
+    {5, 7,  SIM_PS0},
+    {1, 2,  SIM_PS1},
+    {1, 10, SIM_PS2},
+    {2, 0,  SIM_PS3},
+    {1, 5,  SIM_SDIO0},
+    {1, 4,  SIM_SDIO1},
+    {1, 3,  SIM_SDIO2},
+    {5, 8,  SIM_SDIO3},
+};
+
+static const uint8_t simRegLen[AD9959_SIM_REG_NUM] = {1,3,2,3,4,2,3,2,4,4, 4,4,4,4,4,4,4,4,4,4,4,4,4,4,4};
+
+static AD9959_Sim_t sim;
+
+static float* capBuf = NULL;		//采样输出,4个通道交错
+static uint32_t capLen = 0;
+static uint32_t capCount = 0;
+static uint32_t capHz = 0;
+static uint64_t capStart = 0;		//第一个样点的时刻,SYSCLK周期
+
+
+
+uint32_t ad9959_sim_sysclk(void)
+{
+	uint32_t mul = (sim.Act[0][1] >> 18) & 0x1F;
+
+	return (mul >= 4 && mul <= 20) ? sim.RefClk * mul : sim.RefClk;
+}
+
+//把时间推进到now,换算SYSCLK周期数;系统时钟改变时从改变的时刻起按新时钟计
+static void sim_clock(uint64_t now)
+{
+	uint64_t n;
+
+	if(now <= sim.Now)
+	{
+		return;
+	}
+	n = (now - sim.Now) * ad9959_sim_sysclk() + sim.SysRem;
+	sim.SysT += n / sim.CpuClk;
+	sim.SysRem = n % sim.CpuClk;
+	sim.Now = now;
+}
+
+//通道ch当前选中的profile号,按FR1[9:8]调制电平数分配PS引脚(PPC为默认值)
+static uint8_t sim_profile(uint8_t ch)
+{
+	switch((sim.Act[0][1] >> 8) & 3)
+	{
+		case 0:		return (sim.Ps >> ch) & 1;
+		case 1:		return (ch < 2) ? (sim.Ps >> (2 * ch)) & 3 : 0;
+		case 2:		return (ch == 0) ? sim.Ps & 7 : 0;
+		default:	return (ch == 0) ? sim.Ps & 15 : 0;
+	}
+}
+
+static uint8_t sim_afp(uint8_t ch)
+{
+	return (sim.Act[ch][3] >> 22) & 3;		//0:不调制 1:幅度 2:频率 3:相位
+}
+
+static uint8_t sim_sweeping(uint8_t ch)
+{
+	return sim_afp(ch) != 0 && (sim.Act[ch][3] & 0x4000);
+}
+
+//调制参数的profile0值,左对齐
+static uint32_t sim_base(uint8_t ch)
+{
+	switch(sim_afp(ch))
+	{
+		case 1:		return (sim.Act[ch][6] & 0x3FF) << 22;
+		case 2:		return sim.Act[ch][4];
+		default:	return (sim.Act[ch][5] & 0x3FFF) << 18;
+	}
+}
+
+//调制参数当前值,左对齐
+static uint32_t sim_mod(uint8_t ch)
+{
+	uint8_t p;
+
+	if(sim_sweeping(ch))
+	{
+		return sim.Ch[ch].Sweep;
+	}
+	p = sim_profile(ch);
+	return (p == 0) ? sim_base(ch) : sim.Act[ch][0x0A + p - 1];
+}
+
+static uint32_t sim_ftw(uint8_t ch)
+{
+	return (sim_afp(ch) == 2) ? sim_mod(ch) : sim.Act[ch][4];
+}
+
+static uint16_t sim_pow(uint8_t ch)
+{
+	return (sim_afp(ch) == 3) ? (uint16_t)(sim_mod(ch) >> 18) : (uint16_t)(sim.Act[ch][5] & 0x3FFF);
+}
+
+static uint16_t sim_asf(uint8_t ch)
+{
+	if(sim_afp(ch) == 1)
+	{
+		return (uint16_t)(sim_mod(ch) >> 22);
+	}
+	return (sim.Act[ch][6] & 0x1000) ? (uint16_t)(sim.Act[ch][6] & 0x3FF) : 1023;
+}
+
+//扫描方向对应的斜率,0表示不扫描
+static uint8_t sim_srr(uint8_t ch)
+{
+	uint32_t lsrr = sim.Act[ch][7];
+
+	return (sim_profile(ch) != 0) ? (uint8_t)lsrr : (uint8_t)(lsrr >> 8);
+}
+
+static void sim_ramp_restart(uint8_t ch)
+{
+	uint8_t srr = sim_srr(ch);
+
+	sim.Ch[ch].NextStep = (sim_sweeping(ch) && srr) ? sim.Ch[ch].T + 4u * srr : 0;
+}
+
+//扫描走一步,到端点后停止
+static void sim_step(uint8_t ch)
+{
+	AD9959_SimChannel_t* c = &sim.Ch[ch];
+	uint32_t s0 = sim_base(ch), e0 = sim.Act[ch][0x0A];
+	uint64_t v;
+
+	if(sim_profile(ch) != 0)
+	{
+		v = (uint64_t)c->Sweep + sim.Act[ch][8];
+		c->Sweep = (v >= e0) ? e0 : (uint32_t)v;
+		c->NextStep = (c->Sweep == e0) ? 0 : c->NextStep + 4u * sim_srr(ch);
+	}
+	else
+	{
+		v = (c->Sweep > s0 + (uint64_t)sim.Act[ch][9]) ? c->Sweep - sim.Act[ch][9] : s0;
+		c->Sweep = (uint32_t)v;
+		c->NextStep = (c->Sweep == s0) ? 0 : c->NextStep + 4u * sim_srr(ch);
+	}
+}
+
+//把通道状态推进到SYSCLK时刻t,相位累加器按每段的FTW累加
+static void sim_channel(uint8_t ch, uint64_t t)
+{
+	AD9959_SimChannel_t* c = &sim.Ch[ch];
+	uint64_t end;
+
+	while(c->T < t)
+	{
+		end = (c->NextStep != 0 && c->NextStep <= t) ? c->NextStep : t;
+		c->Phase += (uint32_t)((uint64_t)sim_ftw(ch) * (uint32_t)(end - c->T));
+		c->T = end;
+		if(end == c->NextStep)
+		{
+			sim_step(ch);
+		}
+	}
+}
+
+static void sim_channels(uint64_t t)
+{
+	uint8_t ch;
+
+	for(ch=0; ch<4; ch++)
+	{
+		sim_channel(ch, t);
+	}
+}
+
+static float sim_sample(uint8_t ch)
+{
+	uint32_t phase;
+
+	if(sim.PwrLevel)
+	{
+		return 0.0f;
+	}
+	phase = sim.Ch[ch].Phase + ((uint32_t)sim_pow(ch) << 18);
+	return (float)(sim_asf(ch) / 1023.0 * sin(phase * (2.0 * M_PI / 4294967296.0)));
+}
+
+static void sim_reset(void)
+{
+	uint8_t ch;
+
+	memset(sim.Buf, 0, sizeof(sim.Buf));
+	memset(sim.Act, 0, sizeof(sim.Act));
+	sim.CSR = 0xF0;
+	for(ch=0; ch<4; ch++)
+	{
+		sim.Buf[ch][3] = 0x000302;
+		sim.Act[ch][3] = 0x000302;
+		sim.Ch[ch].Phase = 0;
+		sim.Ch[ch].Sweep = 0;
+		sim.Ch[ch].NextStep = 0;
+	}
+	sim.Need = 0;
+	sim.Bits = 0;
+	sim.ReadBit = -1;
+}
+
+static void sim_update(void)
+{
+	uint8_t ch, was[4];
+
+	for(ch=0; ch<4; ch++)
+	{
+		was[ch] = sim_sweeping(ch);
+	}
+	memcpy(sim.Act, sim.Buf, sizeof(sim.Act));
+	for(ch=0; ch<4; ch++)
+	{
+		if(sim.Act[ch][3] & 0x04)		//自动清相位累加器
+		{
+			sim.Ch[ch].Phase = 0;
+		}
+		if(!sim_sweeping(ch))
+		{
+			sim.Ch[ch].NextStep = 0;
+			continue;
+		}
+		if(!was[ch] || (sim.Act[ch][3] & 0x10))		//新开始扫描或自动清扫描累加器
+		{
+			sim.Ch[ch].Sweep = sim_base(ch);
+		}
+		if(sim.Ch[ch].Sweep < sim_base(ch))
+		{
+			sim.Ch[ch].Sweep = sim_base(ch);
+		}
+		if(sim.Ch[ch].Sweep > sim.Act[ch][0x0A])
+		{
+			sim.Ch[ch].Sweep = sim.Act[ch][0x0A];
+		}
+		sim_ramp_restart(ch);
+	}
+	sim.Stats.Updates++;
+}
+
+static void sim_write(uint8_t addr, uint32_t value)
+{
+	uint8_t ch;
+
+	if(addr == 0)
+	{
+		sim.CSR = (uint8_t)value;		//CSR立即生效
+	}
+	else if(addr < 3)
+	{
+		sim.Buf[0][addr] = value;
+	}
+	else
+	{
+		for(ch=0; ch<4; ch++)
+		{
+			if(sim.CSR & (0x10 << ch))
+			{
+				sim.Buf[ch][addr] = value;
+			}
+		}
+	}
+}
+
+static uint32_t sim_read(uint8_t addr)
+{
+	uint8_t ch;
+
+	if(addr == 0)
+	{
+		return sim.CSR;
+	}
+	if(addr < 3)
+	{
+		return sim.Buf[0][addr];
+	}
+	for(ch=0; ch<3 && !(sim.CSR & (0x10 << ch)); ch++);
+	return sim.Buf[ch][addr];
+}
+
+static void sim_byte(uint8_t b)
+{
+	sim.Stats.Bytes++;
+	if(sim.Need == 0)
+	{
+		sim.Addr = b & 0x1F;
+		sim.Read = b >> 7;
+		if(sim.Addr >= AD9959_SIM_REG_NUM)
+		{
+			sim.Stats.Errors++;
+			return;
+		}
+		sim.Need = simRegLen[sim.Addr];
+		sim.Data = 0;
+		if(sim.Read)
+		{
+			sim.ReadData = sim_read(sim.Addr);
+			sim.ReadBit = (int8_t)(sim.Need * 8 - 1);
+		}
+		return;
+	}
+	sim.Data = (sim.Data << 8) | b;
+	if(--sim.Need == 0)
+	{
+		sim_write(sim.Addr, sim.Data);
+		sim.Stats.Writes++;
+	}
+}
+
+static void sim_sclk_rise(void)
+{
+	uint8_t mode = (sim.CSR >> 1) & 3, k, v;
+
+	sim.Stats.SclkEdges++;
+	if(sim.Read && sim.Need)
+	{
+		//读数据:每个时钟1位,由单片机采样
+		if(++sim.Bits == 8)
+		{
+			sim.Bits = 0;
+			sim.Stats.Bytes++;
+			if(--sim.Need == 0)
+			{
+				sim.Read = 0;
+				sim.ReadBit = -1;
+				sim.Stats.Reads++;
+			}
+		}
+		return;
+	}
+	switch(mode)
+	{
+		case 2:		k = 2; v = (uint8_t)(sim.Sdio[1] << 1 | sim.Sdio[0]); break;
+		case 3:		k = 4; v = (uint8_t)(sim.Sdio[3] << 3 | sim.Sdio[2] << 2 | sim.Sdio[1] << 1 | sim.Sdio[0]); break;
+		default:	k = 1; v = sim.Sdio[0]; break;
+	}
+	sim.Shift = (uint8_t)(sim.Shift << k | v);
+	sim.Bits += k;
+	if(sim.Bits >= 8)
+	{
+		sim.Bits = 0;
+		sim_byte(sim.Shift);
+	}
+}
+
+static void sim_sclk_fall(void)
+{
+	uint8_t bit;
+
+	if(!sim.Read || sim.Need == 0 || sim.ReadBit < 0)
+	{
+		return;
+	}
+	bit = (sim.ReadData >> sim.ReadBit--) & 1;
+	if(((sim.CSR >> 1) & 3) == 1)
+	{
+		ad9959_host_set_input(1, 3, bit);		//3线方式从SDIO2输出
+	}
+	else
+	{
+		ad9959_host_set_input(1, 5, bit);
+	}
+}
+
+
+
+void ad9959_sim_init(uint32_t ref_clk, uint32_t cpu_clk)
+{
+	static const AD9959_HostDev_t dev = {ad9959_sim_pin, ad9959_sim_advance, NULL};
+
+	memset(&sim, 0, sizeof(sim));
+	sim.RefClk = ref_clk;
+	sim.CpuClk = cpu_clk;
+	sim.CsLevel = 1;
+	sim_reset();
+	capBuf = NULL;
+	capLen = 0;
+	capCount = 0;
+	ad9959_host_attach(&dev);
+}
+
+void ad9959_sim_advance(uint64_t now)
+{
+	uint64_t t;
+	uint8_t ch;
+
+	sim_clock(now);
+	while(capCount < capLen)
+	{
+		t = capStart + (uint64_t)capCount * ad9959_sim_sysclk() / capHz;
+		if(t > sim.SysT)
+		{
+			break;
+		}
+		sim_channels(t);
+		for(ch=0; ch<4; ch++)
+		{
+			capBuf[capCount * 4 + ch] = sim_sample(ch);
+		}
+		capCount++;
+	}
+}
+
+void ad9959_sim_pin(uint8_t port, uint8_t pin, uint8_t level, uint64_t now)
+{
+	uint8_t i, role = SIM_NONE;
+
+	for(i=0; i<sizeof(simPins) / sizeof(simPins[0]); i++)
+	{
+		if(simPins[i].Port == port && simPins[i].Pin == pin)
+		{
+			role = simPins[i].Role;
+			break;
+		}
+	}
+	if(role == SIM_NONE)
+	{
+		return;
+	}
+	ad9959_sim_advance(now);
+	sim_channels(sim.SysT);
+
+	switch(role)
+	{
+		case SIM_CS:
+			if(sim.CsLevel && !level)
+			{
+				sim.Stats.Frames++;
+				sim.CsLowAt = now;
+				sim.Bits = 0;
+				sim.Need = 0;
+				sim.Read = 0;
+				sim.ReadBit = -1;
+			}
+			else if(!sim.CsLevel && level)
+			{
+				sim.Stats.BusCycles += now - sim.CsLowAt;
+				if(sim.Need || sim.Bits)
+				{
+					sim.Stats.Errors++;
+				}
+				sim.Need = 0;
+				sim.Bits = 0;
+				sim.Read = 0;
+				sim.ReadBit = -1;
+			}
+			sim.CsLevel = level;
+			break;
+		case SIM_SCLK:
+			if(!sim.CsLevel && !sim.SclkLevel && level)
+			{
+				sim_sclk_rise();
+			}
+			else if(!sim.CsLevel && sim.SclkLevel && !level)
+			{
+				sim_sclk_fall();
+			}
+			sim.SclkLevel = level;
+			break;
+		case SIM_UPDATE:
+			//高电平期间在SYNC_CLK上升沿装入,不足1个SYNC_CLK的脉冲可能一个上升沿都碰不到,按丢失处理
+			if(!sim.UpdateLevel && level)
+			{
+				sim.UpdateAt = now;
+				sim.UpdateMin = ((uint64_t)4 * sim.CpuClk + ad9959_sim_sysclk() - 1) / ad9959_sim_sysclk();
+			}
+			else if(sim.UpdateLevel && !level)
+			{
+				if(now - sim.UpdateAt >= sim.UpdateMin)
+				{
+					sim_update();
+				}
+				else
+				{
+					sim.Stats.ShortUpdates++;
+				}
+			}
+			sim.UpdateLevel = level;
+			break;
+		case SIM_RESET:
+			if(!sim.ResetLevel && level)
+			{
+				sim_reset();
+				sim.Stats.Resets++;
+			}
+			sim.ResetLevel = level;
+			break;
+		case SIM_PWR:
+			sim.PwrLevel = level;
+			break;
+		case SIM_PS0: case SIM_PS1: case SIM_PS2: case SIM_PS3:
+			i = role - SIM_PS0;
+			sim.Ps = (uint8_t)((sim.Ps & ~(1u << i)) | (level << i));
+			for(i=0; i<4; i++)
+			{
+				if(sim_sweeping(i))
+				{
+					sim_ramp_restart(i);
+				}
+			}
+			break;
+		default:
+			sim.Sdio[role - SIM_SDIO0] = level;
+			break;
+	}
+}
+
+const AD9959_Sim_t* ad9959_sim_state(void)
+{
+	return &sim;
+}
+
+void ad9959_sim_get_stats(AD9959_SimStats_t* stats)
+{
+	*stats = sim.Stats;
+}
+
+//通道ch当前输出的频率控制字、相位控制字、幅度比例因子(含调制和扫描)
+void ad9959_sim_output(uint8_t ch, uint32_t* ftw, uint16_t* pow, uint16_t* asf)
+{
+	ad9959_host_sync();		//先处理最后一次引脚写入
+	ad9959_sim_advance(ad9959_host_now());
+	sim_channel(ch, sim.SysT);
+	*ftw = sim_ftw(ch);
+	*pow = sim_pow(ch);
+	*asf = sim_asf(ch);
+}
+
+//从现在开始按sample_hz采样4个通道的输出,共n个时刻,buf[n*4]交错存放
+void ad9959_sim_capture(float* buf, uint32_t n, uint32_t sample_hz)
+{
+	ad9959_host_sync();
+	ad9959_sim_advance(ad9959_host_now());
+	capBuf = buf;
+	capLen = n;
+	capCount = 0;
+	capHz = sample_hz;
+	capStart = sim.SysT;
+}
+
+uint32_t ad9959_sim_captured(void)
+{
+	return capCount;
+}
+
+void ad9959_sim_poke(uint8_t ch, uint8_t addr, uint32_t value)
+{
+	ad9959_host_sync();
+	ad9959_sim_advance(ad9959_host_now());
+	sim_channels(sim.SysT);
+	if(addr == 0)
+	{
+		sim.CSR = (uint8_t)value;
+		return;
+	}
+	if(addr < 3)
+	{
+		ch = 0;
+	}
+	sim.Buf[ch][addr] = value;
+	sim.Act[ch][addr] = value;
+}
+
+void ad9959_sim_brownout(void)
+{
+	ad9959_host_sync();
+	ad9959_sim_advance(ad9959_host_now());
+	sim_reset();
+	sim.Stats.Resets++;
+}
@@ -0,0 +1,88 @@
+#ifndef __AD9959_SIM_H__
+#define __AD9959_SIM_H__
+
+#include <stdint.h>
+
+/**
+	AD9959寄存器级模拟器(Linux主机上运行)
+	从引脚电平变化解码串行通信:CS低电平期间在SCLK上升沿采样,按CSR[2:1]取1/2/4位,
+	指令字节bit7为读,读数据在SCLK下降沿从SDIO0(3线方式为SDIO2)输出
+	寄存器分缓冲寄存器和工作寄存器,CSR立即生效,其他寄存器在IO_UPDATE下降沿装入工作寄存器,
+	IO_UPDATE高电平不足1个SYNC_CLK(按上升沿时的系统时钟)时不装入,计入ShortUpdates
+	输出按工作寄存器计算:相位累加器每个SYSCLK加FTW,Profile引脚选择调制值,
+	线性扫描每SRR个SYNC_CLK(SYSCLK/4)走一步,样点 = ASF/1023*sin(2π(相位+POW)/2^32)
+	引脚接法与 AD9959.h 相同
+*/
+
+
+
+#define AD9959_SIM_REG_NUM		(25)
+
+typedef struct
+{
+    uint64_t SclkEdges;		//CS低电平期间SCLK上升沿数
+    uint64_t Bytes;			//收发的字节数(含指令字节)
+    uint32_t Frames;		//CS低电平的次数
+    uint32_t Writes;		//完整的写寄存器指令
+    uint32_t Reads;			//完整的读寄存器指令
+    uint32_t Updates;		//装入工作寄存器的IO_UPDATE脉冲
+    uint32_t ShortUpdates;	//高电平不足1个SYNC_CLK、被丢弃的IO_UPDATE脉冲
+    uint32_t Resets;		//RESET上升沿
+    uint32_t Errors;		//CS拉高时指令不完整、地址无效
+    uint64_t BusCycles;		//CS低电平的总时间,CPU周期
+}AD9959_SimStats_t;
+
+typedef struct
+{
+    uint64_t T;				//状态对应的时刻,SYSCLK周期
+    uint32_t Phase;			//相位累加器
+    uint32_t Sweep;			//扫描当前值,左对齐
+    uint64_t NextStep;		//下一步扫描的时刻,SYSCLK周期
+}AD9959_SimChannel_t;
+
+typedef struct
+{
+    uint32_t RefClk;
+    uint32_t CpuClk;
+    uint8_t  CSR;
+    uint32_t Buf[4][AD9959_SIM_REG_NUM];	//缓冲寄存器,FR1/FR2等公共寄存器记在通道0
+    uint32_t Act[4][AD9959_SIM_REG_NUM];	//工作寄存器
+    uint8_t  Ps;							//PS0~PS3电平,bit0~bit3
+    uint8_t  CsLevel, SclkLevel, UpdateLevel, ResetLevel, PwrLevel;
+    uint8_t  Sdio[4];
+
+    uint8_t  Shift;			//正在接收的字节
+    uint8_t  Bits;			//已收到的位数
+    uint8_t  Addr;			//当前指令的寄存器
+    uint8_t  Read;			//1:读指令
+    uint8_t  Need;			//当前指令还要收发的数据字节数,0表示等待指令字节
+    uint32_t Data;
+    uint32_t ReadData;		//读指令待输出的数据
+    int8_t   ReadBit;		//下一个输出位,<0表示没有
+    uint64_t CsLowAt;
+    uint64_t UpdateAt;		//IO_UPDATE上升沿的时刻,CPU周期
+    uint64_t UpdateMin;		//1个SYNC_CLK对应的CPU周期数,上升沿时按当时的系统时钟算
+
+    uint64_t Now;			//最近一次的时刻,CPU周期
+    uint64_t SysT;			//Now对应的SYSCLK周期数
+    uint64_t SysRem;		//换算的余数
+    AD9959_SimChannel_t Ch[4];
+    AD9959_SimStats_t Stats;
+}AD9959_Sim_t;
+
+
+
+void ad9959_sim_init(uint32_t ref_clk, uint32_t cpu_clk);	//清零并挂到主机HAL上(ad9959_host_attach)
+void ad9959_sim_pin(uint8_t port, uint8_t pin, uint8_t level, uint64_t now);
+void ad9959_sim_advance(uint64_t now);
+const AD9959_Sim_t* ad9959_sim_state(void);
+void ad9959_sim_get_stats(AD9959_SimStats_t* stats);
+uint32_t ad9959_sim_sysclk(void);
+void ad9959_sim_output(uint8_t ch, uint32_t* ftw, uint16_t* pow, uint16_t* asf);
+void ad9959_sim_capture(float* buf, uint32_t n, uint32_t sample_hz);
+uint32_t ad9959_sim_captured(void);
+void ad9959_sim_poke(uint8_t ch, uint8_t addr, uint32_t value);	//直接改写寄存器(缓冲和工作寄存器),模拟干扰
+void ad9959_sim_brownout(void);										//芯片复位,模拟掉电
+
+
+#endif
@@ -0,0 +1,714 @@
+/**
+	ADF4351驱动测试,在Linux主机上运行
+
+	编译:	gcc -O2 -DADF4351_HOST -I. -I../ADF4351 -o adf4351_bench adf4351_bench.c bench_cost.c adf4351_sim.c ad9959_host_hal.c ../ADF4351/ADF4351.c ../ADF4351/ADF4351_Bus.c ../ADF4351/ADF4351_Pll.c ../ADF4351/ADF4351_Plan.c ../ADF4351/ADF4351_Lock.c -lm
+	用法:	./adf4351_bench [-n 随机配置数]
+	分频参数:每个频点把ADF4351_Solve的结果与枚举Mod=2~4095的最小误差比较,误差不能更大;
+	再按寄存器值独立算一遍输出频率,与返回的实际频率、误差核对
+	先用板载配置(100M参考,R=4,步进0.1MHz)扫35~4400MHz全范围,再用随机的参考、R、倍频、
+	2分频、通道间隔和频率测试,最后打印每次计算的平均用时
+	环路设置:核对不同鉴相频率下频段选择时钟不超过上限、快速锁定时间的换算和电荷泵电流位
+	驱动测试:真实的ADF4351.c等文件经主机HAL(tools/delay.h代替工程的delay.h)驱动寄存器级模拟器,
+	模拟器从CLK/DATA/LE解码出R0~R5,按寄存器值算出输出频率;ADF4351WriteFreq扫35~4400MHz全范围,
+	每点的输出频率要与要求的频率完全相同,寄存器要在芯片允许的范围内;
+	再测频率计划播放器和锁定检测(模拟LD在写R0后20us拉高),核对跳频顺序和测得的锁定时间
+	最后列出每个接口的SCLK边沿数、寄存器字数和耗时(CPU周期按168MHz换算,模拟SPI)
+	ADF4351.h 中 ADF4351_BUS 要保持 ADF4351_BUS_SOFT
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ad9959_host_hal.h"
+#include "ADF4351.h"
+#include "adf4351_sim.h"
+#include "bench_cost.h"
+
+#define SIM_LOCK_NS		20000		//模拟的锁定时间
+
+static TIM_TypeDef tim7;
+static TIM_HandleTypeDef htim7 = {&tim7};
+
+static const char* const costNames[] = {"SCLK", "words", NULL};
+static uint32_t failed;
+static uint32_t exactNum, approxNum;
+
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef* htim)
+{
+	ADF4351_PlayerIRQ(htim);
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+	ADF4351_LockEXTI(GPIO_Pin);
+}
+
+//开销统计的计数:SCLK边沿、寄存器字
+static void cost_count(uint64_t* n)
+{
+	ADF4351_SimStats_t s;
+
+	ADF4351_BusWait();
+	adf4351_sim_get_stats(&s);
+	n[0] = s.ClkEdges;
+	n[1] = s.Words;
+}
+
+static uint64_t absdiff(uint64_t a, uint64_t b)
+{
+	return a > b ? a - b : b - a;
+}
+
+/************************************************************
+	枚举参考:给定RF分频后,N的小数部分rem/pn对每个Mod取最近的Frac,
+	返回最小误差 |Frac/Mod - rem/pn|,以 num/(mod*pn) 表示
+**************************************************************/
+static void brute_best(uint32_t rem, uint32_t pn, uint64_t* num, uint32_t* mod)
+{
+	uint64_t e, bestNum = ~0ULL;
+	uint32_t m, f, bestMod = 1;
+
+	for(m=2; m<=4095; m++)
+	{
+		f = (uint32_t)(((uint64_t)rem * m + pn / 2) / pn);
+		e = absdiff((uint64_t)f * pn, (uint64_t)rem * m);
+		if(e * bestMod < bestNum * m)
+		{
+			bestNum = e;
+			bestMod = m;
+		}
+	}
+	*num = bestNum;
+	*mod = bestMod;
+}
+
+//核对一个频点,返回0为通过
+static uint8_t check_point(const ADF4351_RefConfig_t* ref, uint64_t hz)
+{
+	ADF4351_Pll_t pll;
+	uint32_t pn = ref->RefHz << (ref->Doubler ? 1 : 0);
+	uint32_t pd = (uint32_t)ref->R << (ref->Div2 ? 1 : 0);
+	uint64_t f, vco, n, sNum, bNum, a, d, mhz;
+	uint32_t rem, bMod, div;
+	uint64_t intN;
+
+	f = (hz + ref->SpacingHz / 2) / ref->SpacingHz * ref->SpacingHz;
+	for(div=0; div<6 && (f << div) < 2200000000ULL; div++);
+	vco = f << div;
+	if(ADF4351_Solve(ref, hz, &pll))
+	{
+		intN = vco * pd / pn;
+		if(vco >= 2200000000ULL && vco <= 4400000000ULL && intN >= (vco > 3600000000ULL ? 75u : 23u) && intN < 65535)
+		{
+			printf("  %llu Hz: solver rejected a valid frequency\n", (unsigned long long)hz);
+			return 1;
+		}
+		return 0;
+	}
+	if(pll.RfDiv != div || pll.Prescaler != (vco > 3600000000ULL) || pll.Mod < 2 || pll.Mod > 4095 || pll.Frac >= pll.Mod)
+	{
+		printf("  %llu Hz: bad fields int %u frac %u mod %u div %u presc %u\n", (unsigned long long)hz,
+			   pll.Int, pll.Frac, pll.Mod, pll.RfDiv, pll.Prescaler);
+		return 1;
+	}
+
+	n = vco * pd;
+	intN = n / pn;
+	rem = (uint32_t)(n % pn);
+	//求解结果的误差: |Int+Frac/Mod - n/pn| = sNum/(Mod*pn)
+	sNum = absdiff(((uint64_t)pll.Int * pll.Mod + pll.Frac) * pn, intN * pll.Mod * pn + (uint64_t)rem * pll.Mod);
+	brute_best(rem, pn, &bNum, &bMod);
+	if(sNum * bMod > bNum * pll.Mod)
+	{
+		printf("  %llu Hz: error %llu/%u worse than brute force %llu/%u (ref %u R %u D %u T %u spacing %u)\n",
+			   (unsigned long long)hz, (unsigned long long)sNum, pll.Mod, (unsigned long long)bNum, bMod,
+			   ref->RefHz, ref->R, ref->Doubler, ref->Div2, ref->SpacingHz);
+		return 1;
+	}
+	if(sNum == 0)
+	{
+		exactNum++;
+	}
+	else
+	{
+		approxNum++;
+	}
+
+	//按寄存器值独立算实际频率
+	a = ((uint64_t)pll.Int * pll.Mod + pll.Frac) * pn;
+	d = ((uint64_t)pll.Mod * pd) << div;
+	mhz = (uint64_t)((long double)a * 1000 / d + 0.5L);
+	if(absdiff(mhz, pll.Freq) > 1 || (int64_t)(pll.Freq - hz * 1000) != pll.Err || (sNum == 0 && pll.Freq != f * 1000))
+	{
+		printf("  %llu Hz: freq %llu mHz err %lld, expect %llu mHz\n", (unsigned long long)hz,
+			   (unsigned long long)pll.Freq, (long long)pll.Err, (unsigned long long)mhz);
+		return 1;
+	}
+	return 0;
+}
+
+//板载配置扫全范围,同一RF分频比内Mod应保持不变
+static void test_board(void)
+{
+	const ADF4351_RefConfig_t ref = {100000000, 4, 0, 0, 100000};
+	ADF4351_Pll_t pll;
+	uint64_t hz;
+	uint32_t bad = 0, modChange = 0;
+	uint16_t lastMod = 0;
+	uint8_t lastDiv = 0xFF;
+
+	printf("board config: 35~4400MHz step 0.1MHz\n");
+	for(hz=35000000; hz<=4400000000ULL; hz+=100000)
+	{
+		bad += check_point(&ref, hz);
+		if(!ADF4351_Solve(&ref, hz, &pll))
+		{
+			if(pll.RfDiv == lastDiv && pll.Mod != lastMod)
+			{
+				modChange++;
+			}
+			lastDiv = pll.RfDiv;
+			lastMod = pll.Mod;
+			if(pll.Err != 0)
+			{
+				bad++;
+			}
+		}
+		if(bad > 10)
+		{
+			break;
+		}
+	}
+	if(modChange)
+	{
+		printf("  mod changed %u times inside one RF divider band\n", modChange);
+		bad++;
+	}
+	failed += bad;
+}
+
+//随机参考通路、通道间隔和频率
+static void test_random(uint32_t num)
+{
+	ADF4351_RefConfig_t ref;
+	uint32_t i, bad = 0;
+	uint64_t hz;
+
+	printf("random configs: %u\n", num);
+	srand(1);
+	for(i=0; i<num && bad < 10; i++)
+	{
+		ref.RefHz = 10000000 + (uint32_t)(rand() % 240000000);
+		ref.R = 1 + rand() % 100;
+		ref.Doubler = (ref.RefHz <= 30000000) ? rand() & 1 : 0;
+		ref.Div2 = rand() & 1;
+		switch(rand() % 4)
+		{
+			case 0: ref.SpacingHz = 1; break;
+			case 1: ref.SpacingHz = 1 + rand() % 1000; break;
+			case 2: ref.SpacingHz = 1000 * (1 + rand() % 1000); break;
+			default: ref.SpacingHz = 12500 << (rand() % 4); break;
+		}
+		if((uint64_t)(ref.RefHz << ref.Doubler) > 32000000ULL * ((uint32_t)ref.R << ref.Div2))
+		{
+			ref.R = (uint16_t)((ref.RefHz << ref.Doubler) / 32000000 + 1);
+		}
+		hz = 34000000ULL + ((uint64_t)rand() * 7919 + rand()) % 4370000000ULL;
+		bad += check_point(&ref, hz);
+	}
+	failed += bad;
+}
+
+//频段选择时钟、快速锁定时间和电荷泵电流
+static void test_loop(void)
+{
+	ADF4351_RefConfig_t ref = {100000000, 4, 0, 0, 100000};
+	const uint16_t rs[] = {4, 5, 10, 40, 100, 1000};
+	ADF4351_Pll_t pll;
+	uint32_t reg[6], i, k, pfd, band, bad = 0;
+	double bsc, lockUs;
+
+	printf("loop config: band select clock, fast lock timer\n");
+	for(k=0; k<2; k++)
+	{
+		ADF4351_LoopConfig.BandHigh = (uint8_t)k;
+		ADF4351_LoopConfig.FastLock = (uint8_t)k;
+		ADF4351_LoopConfig.FastLockUs = 30;
+		ADF4351_LoopConfig.Cp = (uint8_t)(k ? 15 : 7);
+		for(i=0; i<sizeof(rs) / sizeof(rs[0]); i++)
+		{
+			ref.R = rs[i];
+			pfd = ref.RefHz / ref.R;
+			if(ADF4351_Solve(&ref, 1234500000ULL, &pll))
+			{
+				continue;
+			}
+			reg[0] = 0x2C8018; reg[1] = 0x8029; reg[2] = 0x10E42; reg[3] = 0x4B3; reg[4] = 0xEC803C; reg[5] = 0x580005;
+			ADF4351_PllRegs(&ref, &pll, reg);
+			band = (reg[4] >> 12) & 0xFF;
+			bsc = (double)pfd / band;
+			if(bsc > (k ? 500000.0 : 125000.0) || (band > 1 && (double)pfd / (band - 1) <= (k ? 500000.0 : 125000.0)) ||
+			   ((reg[3] >> 23) & 1) != k || ((reg[2] >> 9) & 0xF) != ADF4351_LoopConfig.Cp || ((reg[3] >> 15) & 3) != k)
+			{
+				printf("  R %u: band div %u (%.0f Hz) R2 %08X R3 %08X\n", ref.R, band, bsc, reg[2], reg[3]);
+				bad++;
+			}
+			lockUs = ((reg[3] >> 3) & 0xFFF) * (double)pll.Mod / pfd * 1e6;
+			if(k && (lockUs < 30 || lockUs > 30 + (double)pll.Mod / pfd * 1e6) && ((reg[3] >> 3) & 0xFFF) < 4095)
+			{
+				printf("  R %u: fast lock %.2f us, expect 30 us\n", ref.R, lockUs);
+				bad++;
+			}
+		}
+	}
+	ADF4351_LoopConfig.BandHigh = 0;
+	ADF4351_LoopConfig.FastLock = 0;
+	ADF4351_LoopConfig.Cp = 7;
+
+	//fPFD 32MHz:低速模式分频值要256,放不下时自动改用高速模式
+	ref.RefHz = 32000000;
+	ref.R = 1;
+	if(ADF4351_Solve(&ref, 2400000000ULL, &pll) == 0)
+	{
+		reg[0] = 0x2C8018; reg[1] = 0x8029; reg[2] = 0x10E42; reg[3] = 0x4B3; reg[4] = 0xEC803C; reg[5] = 0x580005;
+		ADF4351_PllRegs(&ref, &pll, reg);
+		if(adf4351_sim_check(reg, ref.RefHz) != NULL || !((reg[3] >> 23) & 1))
+		{
+			printf("  fPFD 32MHz: %s, R3 %08X R4 %08X\n", adf4351_sim_check(reg, ref.RefHz), reg[3], reg[4]);
+			bad++;
+		}
+	}
+	else
+	{
+		printf("  fPFD 32MHz: 2400MHz not solved\n");
+		bad++;
+	}
+	failed += bad;
+}
+
+static void bench_speed(void)
+{
+	const ADF4351_RefConfig_t ref = {100000000, 4, 0, 0, 1};	//1Hz步进,大多走连分数逼近
+	ADF4351_Pll_t pll;
+	struct timespec t0, t1;
+	uint64_t hz, sum = 0;
+	uint32_t i, n = 1000000;
+	double ns;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for(i=0; i<n; i++)
+	{
+		hz = 35000000ULL + (uint64_t)i * 4365;
+		if(!ADF4351_Solve(&ref, hz, &pll))
+		{
+			sum += pll.Frac;
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	ns = ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / n;
+	printf("ADF4351_Solve: %.1f ns/call on host (1Hz spacing, checksum %llu)\n", ns, (unsigned long long)sum);
+}
+
+//ADF4351Init写入的寄存器经模拟器解码后应与初值相同,输出35MHz
+static void test_init(void)
+{
+	const uint32_t def[6] = {0x2C8018, 0x8029, 0x10E42, 0x4B3, 0xEC803C, 0x580005};
+	const ADF4351_Sim_t* st = adf4351_sim_state();
+	uint32_t i, bad = 0;
+
+	printf("driver: ADF4351Init\n");
+	cost_begin();
+	ADF4351Init();
+	cost_end("ADF4351Init");
+	for(i=0; i<6; i++)
+	{
+		if(st->Act[i] != def[i])
+		{
+			printf("  R%u: got %08X, expect %08X\n", i, st->Act[i], def[i]);
+			bad++;
+		}
+	}
+	if(adf4351_sim_freq() != 35000000000ULL || ADF4351_Shadow.Valid != 0x3F)
+	{
+		printf("  output %llu mHz, shadow valid %02X\n", (unsigned long long)adf4351_sim_freq(), ADF4351_Shadow.Valid);
+		bad++;
+	}
+	failed += bad;
+}
+
+//ADF4351WriteFreq扫全范围,模拟器解码出的频率与要求的完全相同,影子寄存器与芯片一致
+static void test_writefreq(void)
+{
+	const ADF4351_Sim_t* st = adf4351_sim_state();
+	ADF4351_SimStats_t s0, s1;
+	uint64_t hz, t0, calls = 0;
+	uint32_t i, bad = 0;
+
+	printf("driver: ADF4351WriteFreq 35~4400MHz step 0.1MHz\n");
+	adf4351_sim_get_stats(&s0);
+	t0 = ad9959_host_now();
+	for(hz=35000000; hz<=4400000000ULL && bad<10; hz+=100000)
+	{
+		ADF4351WriteFreq((float)(hz / 1e6));
+		ADF4351_BusWait();
+		calls++;
+		if(adf4351_sim_freq() != hz * 1000)
+		{
+			printf("  %.1f MHz: output %llu mHz (%s)\n", hz / 1e6, (unsigned long long)adf4351_sim_freq(),
+				   adf4351_sim_check(st->Act, st->RefHz) ? adf4351_sim_check(st->Act, st->RefHz) : "registers valid");
+			bad++;
+		}
+		for(i=0; i<6; i++)
+		{
+			if(ADF4351_Shadow.Reg[i] != st->Reg[i])
+			{
+				printf("  %.1f MHz: shadow R%u %08X, chip %08X\n", hz / 1e6, i, ADF4351_Shadow.Reg[i], st->Reg[i]);
+				bad++;
+			}
+		}
+	}
+	adf4351_sim_get_stats(&s1);
+	printf("  %llu calls: %.1f SCLK edges, %.2f words, %.2f us per call\n", (unsigned long long)calls,
+		   (double)(s1.ClkEdges - s0.ClkEdges) / calls, (double)(s1.Words - s0.Words) / calls,
+		   (ad9959_host_now() - t0) * 1e6 / SystemCoreClock / calls);
+	if(s1.R0Writes - s0.R0Writes != calls)
+	{
+		printf("  %u R0 writes for %llu calls\n", s1.R0Writes - s0.R0Writes, (unsigned long long)calls);
+		bad++;
+	}
+
+	//单次调用的代价
+	ADF4351WriteFreq(100.0f);
+	ADF4351_BusWait();
+	cost_begin();
+	ADF4351WriteFreq(100.1f);
+	cost_end("WriteFreq same band");
+	cost_begin();
+	ADF4351WriteFreq(1000.0f);
+	cost_end("WriteFreq band change");
+	cost_begin();
+	ADF4351WriteFreq(1000.0f);
+	cost_end("WriteFreq unchanged");
+	cost_begin();
+	ADF4351_SetFreq(2400000000ULL, NULL);
+	cost_end("SetFreq 2400MHz");
+	if(adf4351_sim_freq() != 2400000000000ULL)
+	{
+		printf("  SetFreq 2400MHz: output %llu mHz\n", (unsigned long long)adf4351_sim_freq());
+		bad++;
+	}
+	failed += bad;
+}
+
+//频率计划播放和锁定检测:LD在写R0后SIM_LOCK_NS拉高,外部中断测锁定,从锁定起停留
+static void test_player_lock(void)
+{
+	static ADF4351_Step_t table[32];
+	const ADF4351_Sim_t* st = adf4351_sim_state();
+	ADF4351_PlayerStats_t ps;
+	ADF4351_LockStats_t ls;
+	uint64_t t0, gap;
+	uint32_t n, i, lockNs, bad = 0;
+
+	printf("driver: frequency plan player with lock detect (lock %u ns)\n", SIM_LOCK_NS);
+	adf4351_sim_lock(SIM_LOCK_NS, 1);
+	ADF4351_LockInit(1);
+
+	ADF4351_SetFreq(99000000, NULL);
+	lockNs = ADF4351_WaitLock(100);
+	if(lockNs + 1000 < SIM_LOCK_NS || lockNs > SIM_LOCK_NS + 1000)
+	{
+		printf("  WaitLock: %u ns\n", lockNs);
+		bad++;
+	}
+
+	n = ADF4351_PlanSweep(100000000, 120000000, 1000000, 50, table, 32);		//21点,锁定后停留50us
+	ad9959_host_tim_config(&htim7, 1000000);
+	adf4351_sim_clear_history();
+	ADF4351_LockClearStats();
+	t0 = ad9959_host_now();
+	cost_begin();
+	if(n != 21 || ADF4351_PlayerStart(&htim7, 1000000, table, n, 200, 0))
+	{
+		printf("  plan %u points, player did not start\n", n);
+		failed += bad + 1;
+		return;
+	}
+	cost_end("PlayerStart");
+	while(ADF4351_PlayerBusy() && ad9959_host_now() - t0 < SystemCoreClock / 100)
+	{
+		run_us(10);
+	}
+	ADF4351_PlayerGetStats(&ps);
+	ADF4351_LockGetStats(&ls);
+	if(ADF4351_PlayerBusy() || st->HistoryNum != n || ps.Hops != n - 1 || ps.LockTimeouts != 0 || ls.Locks != n || ls.Timeouts != 0)
+	{
+		printf("  busy %u hops %u/%u writes %u lock timeouts %u locks %u\n", ADF4351_PlayerBusy(), ps.Hops, n - 1,
+			   st->HistoryNum, ps.LockTimeouts, ls.Locks);
+		bad++;
+	}
+	for(i=0; i<st->HistoryNum && i<n; i++)
+	{
+		if(st->History[i].Freq != (100000000ULL + i * 1000000ULL) * 1000)
+		{
+			printf("  hop %u: %llu mHz\n", i, (unsigned long long)st->History[i].Freq);
+			bad++;
+		}
+		if(i == 0)
+		{
+			continue;
+		}
+		gap = st->History[i].Time - st->History[i - 1].Time;		//锁定时间+停留50us+中断开销
+		if(gap * 1000000000ULL / SystemCoreClock < SIM_LOCK_NS + 50000 || gap * 1000000000ULL / SystemCoreClock > SIM_LOCK_NS + 53000)
+		{
+			printf("  hop %u: %.2f us after previous\n", i, gap * 1e6 / SystemCoreClock);
+			bad++;
+		}
+	}
+	if(ls.Min + 1000 < SIM_LOCK_NS || ls.Max > SIM_LOCK_NS + 1000)
+	{
+		printf("  lock time %u~%u ns\n", ls.Min, ls.Max);
+		bad++;
+	}
+	printf("  %u hops, lock %u~%u ns (avg %llu), timer IRQ max %.2f us\n", ps.Hops, ls.Min, ls.Max,
+		   (unsigned long long)(ls.Locks ? ls.Sum / ls.Locks : 0), ps.IrqMax * 1e6 / SystemCoreClock);
+	adf4351_sim_lock(0, 0);
+	failed += bad;
+}
+
+//小步进跳频时LD一直为高,写R0后没有边沿:播放器要在空白期结束时查到锁定,不能等到LockTimeout
+static void test_player_hold(void)
+{
+	static ADF4351_Step_t table[8];
+	const ADF4351_Sim_t* st = adf4351_sim_state();
+	ADF4351_PlayerStats_t ps;
+	ADF4351_LockStats_t ls;
+	uint64_t t0, gap;
+	uint32_t n, i, bad = 0;
+
+	printf("driver: player with LD held high across hops\n");
+	adf4351_sim_lock(SIM_LOCK_NS, 1);
+	adf4351_sim_hold(1);
+	ADF4351_LockInit(1);
+	ADF4351_SetFreq(99000000, NULL);
+	ADF4351_WaitLock(100);
+
+	n = ADF4351_PlanSweep(100000000, 105000000, 1000000, 50, table, 8);		//6点,锁定后停留50us
+	ad9959_host_tim_config(&htim7, 1000000);
+	adf4351_sim_clear_history();
+	ADF4351_LockClearStats();
+	t0 = ad9959_host_now();
+	if(n != 6 || ADF4351_PlayerStart(&htim7, 1000000, table, n, 200, 0))
+	{
+		printf("  plan %u points, player did not start\n", n);
+		failed++;
+		adf4351_sim_hold(0);
+		adf4351_sim_lock(0, 0);
+		return;
+	}
+	while(ADF4351_PlayerBusy() && ad9959_host_now() - t0 < SystemCoreClock / 100)
+	{
+		run_us(10);
+	}
+	ADF4351_PlayerGetStats(&ps);
+	ADF4351_LockGetStats(&ls);
+	if(ADF4351_PlayerBusy() || st->HistoryNum != n || ps.LockTimeouts != 0 || ls.Locks != n)
+	{
+		printf("  busy %u writes %u lock timeouts %u locks %u\n", ADF4351_PlayerBusy(), st->HistoryNum, ps.LockTimeouts, ls.Locks);
+		bad++;
+	}
+	if(ls.Min < ADF4351_LOCK_BLANK_US * 1000 || ls.Max > ADF4351_LOCK_BLANK_US * 1000 + 3000)
+	{
+		printf("  lock time %u~%u ns\n", ls.Min, ls.Max);
+		bad++;
+	}
+	for(i=1; i<st->HistoryNum && i<n; i++)
+	{
+		gap = (st->History[i].Time - st->History[i - 1].Time) * 1000000000ULL / SystemCoreClock;	//空白期+停留50us+中断开销
+		if(gap < ADF4351_LOCK_BLANK_US * 1000 + 50000 || gap > ADF4351_LOCK_BLANK_US * 1000 + 56000)
+		{
+			printf("  hop %u: %.2f us after previous\n", i, gap / 1000.0);
+			bad++;
+		}
+	}
+	printf("  %u hops, lock %u~%u ns\n", ps.Hops, ls.Min, ls.Max);
+	adf4351_sim_hold(0);
+	adf4351_sim_lock(0, 0);
+	failed += bad;
+}
+
+//快速锁定时R3的时钟分频值按MOD换算:MOD不同的频点之间播放器要改写R3;停留时间超过16位定时器的拒绝
+static void test_player_r3(void)
+{
+	static const uint64_t hz[4] = {100000000, 2200000000ULL, 137300000, 1000100000};
+	static ADF4351_Step_t table[4];
+	const ADF4351_Sim_t* st = adf4351_sim_state();
+	uint32_t n, i, bad = 0, changes = 0;
+
+	printf("driver: fast lock R3 follows MOD while playing\n");
+	ADF4351_LoopConfig.FastLock = 1;
+	ADF4351_LoopConfig.FastLockUs = 30;
+	if(ADF4351_PlanList(hz, 4, ADF4351_TIM_TICKS_MAX + 1, table) != 0 || ADF4351_PlanSweep(100000000, 101000000, 1000000, ADF4351_TIM_TICKS_MAX + 1, table, 4) != 0)
+	{
+		printf("  dwell above %lu ticks accepted\n", ADF4351_TIM_TICKS_MAX);
+		bad++;
+	}
+	n = ADF4351_PlanList(hz, 4, 20, table);
+	ad9959_host_tim_config(&htim7, 1000000);
+	if(n != 4 || ADF4351_PlayerStart(&htim7, 1000000, table, n, 0, 0))
+	{
+		printf("  plan %u points, player did not start\n", n);
+		bad++;
+		n = 0;
+	}
+	run_us(10);
+	for(i=0; i<n; i++)
+	{
+		if(st->Act[3] != table[i].R3 || st->Act[1] != table[i].R1 || st->Act[0] != table[i].R0)
+		{
+			printf("  step %u: chip R3 %08X, plan R3 %08X\n", i, st->Act[3], table[i].R3);
+			bad++;
+		}
+		if(i > 0 && table[i].R3 != table[i - 1].R3)
+		{
+			changes++;
+		}
+		run_us(20);
+	}
+	if(changes == 0)
+	{
+		printf("  R3 never changes in the plan\n");
+		bad++;
+	}
+	ADF4351_PlayerStop();
+	ADF4351_LoopConfig.FastLock = 0;
+	failed += bad;
+}
+
+//停留时间比中断里写寄存器还短:ARR要在更新前预装载好,否则计数已超过ARR,16位定时器要数满65536才再次更新
+static void test_player_short(void)
+{
+	static ADF4351_Step_t table[4];
+	ADF4351_PlayerStats_t ps;
+	uint64_t t0, us;
+	uint32_t n;
+
+	printf("driver: player dwell shorter than the register writes\n");
+	n = ADF4351_PlanSweep(100000000, 103000000, 1000000, 5, table, 4);		//10MHz计数,每0.5us跳一次
+	ad9959_host_tim_config(&htim7, 10000000);
+	t0 = ad9959_host_now();
+	if(n != 4 || ADF4351_PlayerStart(&htim7, 10000000, table, n, 0, 0))
+	{
+		printf("  plan %u points, player did not start\n", n);
+		failed++;
+		return;
+	}
+	while(ADF4351_PlayerBusy() && ad9959_host_now() - t0 < SystemCoreClock / 50)
+	{
+		run_us(1);
+	}
+	us = (ad9959_host_now() - t0) * 1000000 / SystemCoreClock;
+	ADF4351_PlayerStop();
+	ADF4351_BusWait();
+	ADF4351_PlayerGetStats(&ps);
+	printf("  %u hops in %llu us\n", ps.Hops, (unsigned long long)us);
+	if(ps.Hops != n - 1 || us > 100)
+	{
+		failed++;
+	}
+}
+
+//主循环正用模拟SPI发一整队列时定时器中断来播放:中断里入队不能等,跳过这一项而不是死锁
+static void test_queue_full(void)
+{
+	static ADF4351_Step_t table[4];
+	const ADF4351_Sim_t* st = adf4351_sim_state();
+	ADF4351_PlayerStats_t ps;
+	u32 reg[6], word[ADF4351_QUEUE_LEN];
+	uint32_t n, i, bad = 0;
+
+	printf("driver: player IRQ while the main loop fills the queue\n");
+	n = ADF4351_PlanSweep(100000000, 103000000, 1000000, 5, table, 4);		//每5us跳一次
+	ADF4351_GetRegs(reg);
+	for(i=0; i<ADF4351_QUEUE_LEN; i++)
+	{
+		word[i] = reg[5];
+	}
+	ad9959_host_tim_config(&htim7, 1000000);
+	if(n != 4 || ADF4351_PlayerStart(&htim7, 1000000, table, n, 0, 1))
+	{
+		printf("  plan %u points, player did not start\n", n);
+		failed++;
+		return;
+	}
+	for(i=0; i<20; i++)		//每次发完要19us,开头发第一个字时队列是满的
+	{
+		if(ADF4351_BusWrite(word, ADF4351_QUEUE_LEN))
+		{
+			printf("  main loop write refused\n");
+			bad++;
+		}
+	}
+	ADF4351_PlayerStop();
+	ADF4351_BusWait();
+	ADF4351_PlayerGetStats(&ps);
+	if(ps.QueueFull == 0 || ps.Hops == 0)
+	{
+		printf("  queue full %u, hops %u\n", ps.QueueFull, ps.Hops);
+		bad++;
+	}
+	if(st->Act[0] != ADF4351_Shadow.Reg[0] || st->Act[1] != ADF4351_Shadow.Reg[1] || st->Act[4] != ADF4351_Shadow.Reg[4])
+	{
+		printf("  shadow R0 %08X chip %08X\n", ADF4351_Shadow.Reg[0], st->Act[0]);
+		bad++;
+	}
+	printf("  %u hops, %u skipped with the queue full\n", ps.Hops, ps.QueueFull);
+	failed += bad;
+}
+
+int main(int argc, char** argv)
+{
+	ADF4351_SimStats_t s;
+	uint32_t num = 20000;
+	int i;
+
+	for(i=1; i<argc; i++)
+	{
+		if(!strcmp(argv[i], "-n") && i + 1 < argc)
+		{
+			num = (uint32_t)atoi(argv[++i]);
+		}
+		else
+		{
+			printf("usage: %s [-n configs]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	test_board();
+	test_random(num);
+	test_loop();
+	printf("points: %u exact, %u approximated\n", exactNum, approxNum);
+	bench_speed();
+
+	adf4351_sim_init(ADF4351_RefConfig.RefHz, SystemCoreClock);
+	cost_init(cost_count, costNames);
+	test_init();
+	test_writefreq();
+	test_player_lock();
+	test_player_hold();
+	test_player_r3();
+	test_player_short();
+	test_queue_full();
+
+	cost_print();
+	adf4351_sim_get_stats(&s);
+	printf("\nwords %u R0 writes %u bus/register errors %u\n", s.Words, s.R0Writes, s.Errors);
+	if(s.Errors)
+	{
+		failed++;
+	}
+	printf("%s (%u failed)\n", failed ? "FAIL" : "PASS", failed);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,260 @@
+/**
+	ADF4351寄存器级模拟器,说明见 adf4351_sim.h
+*/
+
+#include <string.h>
+#include "adf4351_sim.h"
+#include "ad9959_host_hal.h"
+
+#define SIM_PORT		2		//GPIOC
+#define SIM_LE			9
+#define SIM_DATA		10
+#define SIM_CLK			11
+#define SIM_LD			8
+
+static ADF4351_Sim_t sim;
+
+
+
+void adf4351_sim_init(uint32_t ref_hz, uint32_t cpu_clk)
+{
+	static const AD9959_HostDev_t dev = {adf4351_sim_pin, adf4351_sim_advance, adf4351_sim_next};
+
+	memset(&sim, 0, sizeof(sim));
+	sim.RefHz = ref_hz;
+	sim.CpuClk = cpu_clk;
+	ad9959_host_attach(&dev);
+}
+
+void adf4351_sim_lock(uint32_t lock_ns, uint8_t exti)
+{
+	sim.LockCycles = (uint32_t)((uint64_t)lock_ns * sim.CpuClk / 1000000000ULL);
+	sim.Exti = exti;
+	sim.LdLevel = 1;
+	ad9959_host_set_input(SIM_PORT, SIM_LD, 1);
+}
+
+void adf4351_sim_hold(uint8_t hold)
+{
+	sim.Hold = hold;
+}
+
+static void sim_field(const uint32_t* reg, uint32_t ref_hz, uint64_t* pn, uint64_t* pd, uint32_t* a, uint32_t* mod, uint8_t* div)
+{
+	uint32_t r = (reg[2] >> 14) & 0x3FF;
+
+	*pn = (uint64_t)ref_hz << ((reg[2] >> 25) & 1);
+	*pd = (uint64_t)r << ((reg[2] >> 24) & 1);
+	*mod = (reg[1] >> 3) & 0xFFF;
+	*a = ((reg[0] >> 15) & 0xFFFF) * *mod + ((reg[0] >> 3) & 0xFFF);
+	*div = (reg[4] >> 20) & 7;
+}
+
+//输出频率 = fPFD*(INT+FRAC/MOD)/2^DIV(反馈取自VCO)或 fPFD*(INT+FRAC/MOD)(反馈取自分频器输出)
+uint64_t adf4351_sim_reg_freq(const uint32_t* reg, uint32_t ref_hz)
+{
+	uint64_t pn, pd;
+	uint32_t a, mod;
+	uint8_t div;
+	unsigned __int128 num, den;
+
+	sim_field(reg, ref_hz, &pn, &pd, &a, &mod, &div);
+	if(pd == 0 || mod == 0)
+	{
+		return 0;
+	}
+	num = (unsigned __int128)a * pn * 1000;
+	den = (unsigned __int128)mod * pd;
+	if((reg[4] >> 23) & 1)
+	{
+		den <<= div;
+	}
+	return (uint64_t)((num + den / 2) / den);
+}
+
+const char* adf4351_sim_check(const uint32_t* reg, uint32_t ref_hz)
+{
+	uint64_t pn, pd, out, vco, pfd, bsc;
+	uint32_t a, mod, n, frac, band;
+	uint8_t div;
+
+	sim_field(reg, ref_hz, &pn, &pd, &a, &mod, &div);
+	n = (reg[0] >> 15) & 0xFFFF;
+	frac = (reg[0] >> 3) & 0xFFF;
+	band = (reg[4] >> 12) & 0xFF;
+	if(pd == 0)
+	{
+		return "R counter is 0";
+	}
+	if(((reg[2] >> 25) & 1) && ref_hz > 30000000)
+	{
+		return "doubler with REFin above 30 MHz";
+	}
+	if(mod < 2)
+	{
+		return "MOD below 2";
+	}
+	if(frac >= mod)
+	{
+		return "FRAC not below MOD";
+	}
+	if(div > 6)
+	{
+		return "RF divider select above 64";
+	}
+	if(n < (((reg[1] >> 27) & 1) ? 75u : 23u))
+	{
+		return "INT below prescaler minimum";
+	}
+	pfd = pn / pd;
+	if(pfd > (frac ? 32000000ULL : 45000000ULL))
+	{
+		return "PFD frequency too high";
+	}
+	if(band == 0)
+	{
+		return "band select clock divider is 0";
+	}
+	bsc = pfd / band;
+	if(bsc > (((reg[3] >> 23) & 1) ? 500000ULL : 125000ULL))
+	{
+		return "band select clock too fast";
+	}
+	out = adf4351_sim_reg_freq(reg, ref_hz);
+	vco = out << div;				//两种反馈方式VCO都是输出的2^DIV倍
+	if(vco < 2200000000000ULL || vco > 4400000000000ULL)
+	{
+		return "VCO out of 2.2-4.4 GHz";
+	}
+	if(!((reg[1] >> 27) & 1) && vco > 3600000000000ULL)
+	{
+		return "4/5 prescaler above 3.6 GHz";
+	}
+	return NULL;
+}
+
+//LD电平变化,打开外部中断时请求中断
+static void sim_ld(uint8_t level)
+{
+	sim.LdLevel = level;
+	ad9959_host_set_input(SIM_PORT, SIM_LD, level);
+	if(sim.Exti)
+	{
+		ad9959_host_exti(1u << SIM_LD);
+	}
+}
+
+//LE上升沿:移位寄存器装入寄存器,写R0时整组生效
+static void sim_latch(uint64_t now)
+{
+	uint8_t n = sim.Shift & 7;
+
+	sim.Stats.Words++;
+	if(sim.Bits != 32 || n > 5)
+	{
+		sim.Stats.Errors++;
+		sim.Bits = 0;
+		return;
+	}
+	sim.Bits = 0;
+	sim.Reg[n] = sim.Shift;
+	if(n != 0)
+	{
+		return;
+	}
+	sim.Stats.R0Writes++;
+	memcpy(sim.Act, sim.Reg, sizeof(sim.Act));
+	if(adf4351_sim_check(sim.Act, sim.RefHz) != NULL)
+	{
+		sim.Stats.Errors++;
+	}
+	if(sim.HistoryNum < ADF4351_SIM_HISTORY)
+	{
+		sim.History[sim.HistoryNum].Time = now;
+		sim.History[sim.HistoryNum].Freq = adf4351_sim_freq();
+		sim.HistoryNum++;
+	}
+	if(sim.LockCycles && !sim.Hold)
+	{
+		if(sim.LdLevel)
+		{
+			sim_ld(0);
+		}
+		sim.LockAt = now + sim.LockCycles;
+	}
+}
+
+void adf4351_sim_pin(uint8_t port, uint8_t pin, uint8_t level, uint64_t now)
+{
+	if(port != SIM_PORT)
+	{
+		return;
+	}
+	switch(pin)
+	{
+		case SIM_CLK:
+			if(!sim.ClkLevel && level)
+			{
+				sim.Shift = (sim.Shift << 1) | sim.DataLevel;
+				if(sim.Bits < 255)
+				{
+					sim.Bits++;
+				}
+				sim.Stats.ClkEdges++;
+			}
+			sim.ClkLevel = level;
+			break;
+		case SIM_DATA:
+			sim.DataLevel = level;
+			break;
+		case SIM_LE:
+			if(!sim.LeLevel && level)
+			{
+				sim_latch(now);
+			}
+			sim.LeLevel = level;
+			break;
+		default:
+			break;
+	}
+}
+
+//LD按锁定时间拉高
+void adf4351_sim_advance(uint64_t now)
+{
+	if(sim.LockAt && now >= sim.LockAt)
+	{
+		sim.LockAt = 0;
+		sim_ld(1);
+	}
+}
+
+uint64_t adf4351_sim_next(void)
+{
+	return sim.LockAt ? sim.LockAt : UINT64_MAX;
+}
+
+const ADF4351_Sim_t* adf4351_sim_state(void)
+{
+	return &sim;
+}
+
+void adf4351_sim_get_stats(ADF4351_SimStats_t* stats)
+{
+	ad9959_host_sync();
+	*stats = sim.Stats;
+}
+
+uint64_t adf4351_sim_freq(void)
+{
+	if(adf4351_sim_check(sim.Act, sim.RefHz) != NULL)
+	{
+		return 0;
+	}
+	return adf4351_sim_reg_freq(sim.Act, sim.RefHz);
+}
+
+void adf4351_sim_clear_history(void)
+{
+	sim.HistoryNum = 0;
+}
@@ -0,0 +1,70 @@
+#ifndef __ADF4351_SIM_H__
+#define __ADF4351_SIM_H__
+
+#include <stdint.h>
+
+/**
+	ADF4351寄存器级模拟器(Linux主机上运行),由主机HAL在引脚电平变化时调用
+	CLK上升沿把DATA移入32位移位寄存器,LE上升沿按控制位DB2~DB0装入R0~R5,不是正好32位时记错误
+	写R0时把R0~R5整组装入工作寄存器(双缓冲的设置写R0才生效,频段选择也由写R0启动),
+	输出频率按工作寄存器计算,同时核对分频参数是否在芯片允许的范围内
+	锁定检测:写R0时LD拉低,经过设定的锁定时间后拉高,可以产生外部中断(双边沿)
+	引脚接法与 ADF4351.h 相同:CLK PC11 DATA PC10 LE PC9 CE PC12 LD PC8
+*/
+
+
+
+#define ADF4351_SIM_HISTORY		(4096)
+
+typedef struct
+{
+    uint64_t ClkEdges;		//CLK上升沿数
+    uint32_t Words;			//LE锁存的寄存器字
+    uint32_t R0Writes;		//写R0(频率生效)的次数
+    uint32_t Errors;		//不是32位的字、无效的寄存器号、写R0时分频参数超出范围
+}ADF4351_SimStats_t;
+
+typedef struct
+{
+    uint64_t Time;			//写R0的时刻,CPU周期
+    uint64_t Freq;			//输出频率,mHz,参数无效时为0
+}ADF4351_SimHop_t;
+
+typedef struct
+{
+    uint32_t RefHz;
+    uint32_t CpuClk;
+    uint32_t Reg[6];		//已写入的寄存器
+    uint32_t Act[6];		//工作寄存器,写R0时整组装入
+    uint32_t Shift;
+    uint8_t  Bits;
+    uint8_t  ClkLevel, DataLevel, LeLevel;
+
+    uint32_t LockCycles;	//锁定时间,CPU周期,0为不模拟LD
+    uint8_t  Exti;			//1:LD变化时请求外部中断(HAL_GPIO_EXTI_Callback)
+    uint8_t  LdLevel;
+    uint8_t  Hold;			//1:写R0时LD不变低(小步进跳频时一直在锁定窗口内)
+    uint64_t LockAt;		//LD拉高的时刻,0为没有
+
+    ADF4351_SimHop_t History[ADF4351_SIM_HISTORY];
+    uint32_t HistoryNum;
+    ADF4351_SimStats_t Stats;
+}ADF4351_Sim_t;
+
+
+
+void adf4351_sim_init(uint32_t ref_hz, uint32_t cpu_clk);	//清零并挂到主机HAL上(ad9959_host_attach)
+void adf4351_sim_lock(uint32_t lock_ns, uint8_t exti);		//LD模型:写R0后lock_ns拉高
+void adf4351_sim_hold(uint8_t hold);						//1:写R0时LD保持为高
+void adf4351_sim_pin(uint8_t port, uint8_t pin, uint8_t level, uint64_t now);
+void adf4351_sim_advance(uint64_t now);
+uint64_t adf4351_sim_next(void);							//下一次LD变化的时刻,没有时为UINT64_MAX
+const ADF4351_Sim_t* adf4351_sim_state(void);
+void adf4351_sim_get_stats(ADF4351_SimStats_t* stats);
+uint64_t adf4351_sim_freq(void);							//当前输出频率,mHz,参数无效时为0
+const char* adf4351_sim_check(const uint32_t* reg, uint32_t ref_hz);	//核对一组R0~R5,有效返回NULL,否则返回原因
+uint64_t adf4351_sim_reg_freq(const uint32_t* reg, uint32_t ref_hz);	//一组R0~R5的输出频率,mHz
+void adf4351_sim_clear_history(void);
+
+
+#endif
@@ -0,0 +1,87 @@
+/**
+	主机测试程序共用的接口开销统计,说明见 bench_cost.h
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "bench_cost.h"
+#include "ad9959_host_hal.h"
+
+typedef struct
+{
+    const char* Name;
+    uint64_t Count[COST_FIELDS];
+    uint64_t Cycles;
+}Cost_t;
+
+static Cost_t costs[COST_MAX];
+static uint32_t costNum;
+static CostCount_t costCount;
+static const char* const* costNames;
+static uint8_t costFields;
+static uint64_t costBase[COST_FIELDS];
+static uint64_t costStart;
+
+
+
+void cost_init(CostCount_t count, const char* const* names)
+{
+	costCount = count;
+	costNames = names;
+	for(costFields=0; costFields<COST_FIELDS && names[costFields] != NULL; costFields++);
+	costNum = 0;
+}
+
+void cost_begin(void)
+{
+	memset(costBase, 0, sizeof(costBase));
+	costCount(costBase);
+	costStart = ad9959_host_now();
+}
+
+void cost_end(const char* name)
+{
+	uint64_t n[COST_FIELDS] = {0};
+	Cost_t* c = &costs[costNum];
+	uint8_t i;
+
+	costCount(n);
+	if(costNum >= COST_MAX)
+	{
+		return;
+	}
+	c->Name = name;
+	for(i=0; i<COST_FIELDS; i++)
+	{
+		c->Count[i] = n[i] - costBase[i];
+	}
+	c->Cycles = ad9959_host_now() - costStart;
+	costNum++;
+}
+
+void cost_print(void)
+{
+	uint32_t i;
+	uint8_t k;
+
+	printf("\n%-26s", "call");
+	for(k=0; k<costFields; k++)
+	{
+		printf(" %8s", costNames[k]);
+	}
+	printf(" %10s\n", "us");
+	for(i=0; i<costNum; i++)
+	{
+		printf("%-26s", costs[i].Name);
+		for(k=0; k<costFields; k++)
+		{
+			printf(" %8llu", (unsigned long long)costs[i].Count[k]);
+		}
+		printf(" %10.2f\n", costs[i].Cycles * 1e6 / SystemCoreClock);
+	}
+}
+
+void run_us(uint32_t us)
+{
+	ad9959_host_run((uint64_t)us * SystemCoreClock / 1000000);
+}
@@ -0,0 +1,32 @@
+#ifndef __BENCH_COST_H__
+#define __BENCH_COST_H__
+
+#include <stdint.h>
+
+/**
+	主机测试程序共用的接口开销统计
+	cost_begin/cost_end之间的耗时(主机HAL的CPU周期)和模拟器各项计数的增量记为一行,
+	计数由测试程序在cost_init时给出的函数读出(如SCLK边沿数、字节数、寄存器字数),
+	最后cost_print按"call 各项计数 us"列表打印,CPU周期按SystemCoreClock换算
+	用法:	static void count(uint64_t* n) { ... n[0] = stats.SclkEdges; ... }
+			static const char* const names[] = {"SCLK", "bytes", NULL};
+			cost_init(count, names);
+			cost_begin();
+			AD9959_Set_Fre(CH0, 1000000);
+			cost_end("AD9959_Set_Fre");
+			...
+			cost_print();
+*/
+
+#define COST_MAX		32		//最多记录的行数
+#define COST_FIELDS		4		//每行最多的计数项数
+
+typedef void (*CostCount_t)(uint64_t* n);		//读出模拟器的各项累计计数,n有COST_FIELDS项
+
+void cost_init(CostCount_t count, const char* const* names);	//names:各项计数的列名,NULL结束
+void cost_begin(void);
+void cost_end(const char* name);			//name要在cost_print之前一直有效
+void cost_print(void);
+void run_us(uint32_t us);					//主机HAL空转us微秒,期间分发中断
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef __DELAY_H
+#define __DELAY_H
+
+#include "ad9959_host_hal.h"
+
+/**
+	主机编译时代替工程的 delay.h:延时按SystemCoreClock推进模拟时间
+*/
+
+#define delay_us(us)	ad9959_host_run((uint64_t)(us) * SystemCoreClock / 1000000)
+#define delay_ms(ms)	ad9959_host_run((uint64_t)(ms) * SystemCoreClock / 1000)
+
+#endif
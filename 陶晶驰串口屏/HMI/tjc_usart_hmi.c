@@ -0,0 +1,2794 @@
+/**
+使用注意事项:
+    1.将tjc_usart_hmi.c和tjc_usart_hmi.h 分别导入工程,F1/F4系列共用这一份代码,按芯片宏自动包含HAL头文件
+    2.在需要使用的函数所在的头文件中添加 #include "tjc_usart_hmi.h"
+    3.所有指令拼好后整条放进发送队列,串口空闲时一次发送(串口配置了发送DMA时走DMA,否则走发送中断),
+      移植到其他单片机时只需修改 tjc_tx_start() 这一个函数,并在发送完成中断里调用 tjc_hmi_tx_handler()
+      发送队列分紧急/普通两个通道,报警等指令用 tjc_cmd_send_lane(..., TJC_LANE_URGENT) 插到普通指令前面
+    4.只有一块屏时沿用旧接口即可:默认实例 tjcDefault 接在 TJC_UART 上(F1默认huart2,F4默认huart1,见头文件),
+      照旧调用 HAL_UART_Receive_IT(&TJC_UART, RxBuffer, 1) 开启接收
+    5.多块屏时每块屏定义一个 TJC_HMI_t,用 tjc_hmi_init() 绑定串口,再用 tjc_hmi_xxx() 接口收发
+    6.工程里还有其他串口也要用 HAL_UART_RxCpltCallback/HAL_UART_TxCpltCallback 时,把 TJC_DEFINE_HAL_CALLBACK 定义为0,
+      在自己的回调里先调用 tjc_hmi_rx_handler(huart)/tjc_hmi_tx_handler(huart),返回0再处理自己的串口;
+      或者保持为1,实现 tjc_uart_rx_other(huart)/tjc_uart_tx_other(huart) 处理非串口屏的串口;
+      默认实例一开始就挂在 TJC_UART 上,TJC_UART 另作他用时先调用 tjc_hmi_deinit(&tjcDefault)
+    7.没有串口屏时可以在电脑上测试:tools/ 下有伪终端串口屏模拟器 tjc_emu 和驱动性能测试 tjc_bench,
+      编译驱动时定义 TJC_HOST 即改用 tools/tjc_host_hal.h
+    8.界面上大量数值/进度条/指示灯要周期刷新时可用变量同步 tjc_sync_xxx():结构体字段打包进串口屏的
+      全局变量或隐藏的变量控件,只发变化的部分和变化位图,由串口屏定时器拆到控件上;
+      定时器脚本用 tjc_sync_script() 生成,修改字段表后要重新生成并下载到串口屏
+
+
+*/
+
+#if defined(TJC_HOST)
+#include "tjc_host_hal.h"		//在Linux主机上运行,见 tools/ 目录
+#else
+#include "main.h"
+#if defined(STM32F1)
+#include "stm32f1xx_hal.h"
+#include "stm32f1xx_hal_uart.h"
+#elif defined(STM32F4)
+#include "stm32f4xx_hal.h"
+#include "stm32f4xx_hal_uart.h"
+#else
+#error "tjc_usart_hmi: 仅支持STM32F1/STM32F4系列"
+#endif
+#endif
+#include <stdio.h>
+#include <string.h>
+#include "tjc_usart_hmi.h"
+
+TJC_HMI_t tjcDefault = { .huart = &TJC_UART };	//默认实例,兼容旧接口
+
+//已挂接的串口屏,串口中断按 huart 查表分发
+static TJC_HMI_t* hmiTable[TJC_HMI_MAX] = { &tjcDefault };
+
+static void tjc_rx_parse_byte(TJC_HMI_t* hmi, uint8_t data);
+static void tjc_get_reply(TJC_HMI_t* hmi, const TJC_Frame_t* frame);
+static void tjc_get_sent(TJC_HMI_t* hmi);
+static uint16_t tjc_get_mark(TJC_HMI_t* hmi);
+
+
+/********************************************************
+函数名：  		tjc_tx_start
+日期：    	2026.10.19
+功能：    	启动串口硬件发送,串口配置了发送DMA时走DMA,否则走发送中断
+			移植到其他单片机时只需修改这一个函数,发送完成后调用 tjc_hmi_tx_handler()
+输入参数：		串口屏实例,数据首地址,数据长度
+返回值： 		0:已开始发送 1:HAL返回HAL_BUSY/HAL_ERROR,不会有发送完成中断
+修改记录：
+**********************************************************/
+static uint8_t tjc_tx_start(TJC_HMI_t* hmi, const uint8_t* data, uint16_t len)
+{
+	HAL_StatusTypeDef status;
+
+	if(hmi->huart->hdmatx != NULL)
+	{
+		status = HAL_UART_Transmit_DMA(hmi->huart, (uint8_t*)data, len);
+	}
+	else
+	{
+		status = HAL_UART_Transmit_IT(hmi->huart, (uint8_t*)data, len);
+	}
+	return status != HAL_OK;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_tx_begin
+日期：    	2026.10.19
+功能：    	置忙并启动发送;启动失败时清除忙标志并记下这一帧,
+			下一次 tjc_tx_kick(发送接口、tjc_get_poll、tjc_wave_poll、tjc_tx_flush)先重发它
+输入参数：		串口屏实例,数据首地址(重发前必须保持有效),数据长度
+返回值： 		无
+修改记录：
+**********************************************************/
+static void tjc_tx_begin(TJC_HMI_t* hmi, const uint8_t* data, uint16_t len)
+{
+	hmi->txBusy = 1;
+	if(tjc_tx_start(hmi, data, len))
+	{
+		hmi->txBusy = 0;
+		hmi->txRetry = data;
+		hmi->txRetryLen = len;
+		hmi->txErrors++;
+	}
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_tx_kick
+日期：    	2026.10.19
+功能：    	串口空闲时取下一帧发送,关中断或在发送完成中断中调用
+			0.上次启动发送失败的帧最先重发,保持发送顺序
+			1.透传原始数据优先(此时串口屏只收原始数据)
+			2.addt 发出后到透传结束前不再发送队列里的指令
+			3.已发出的数据不是以\xff\xff\xff结尾(指令被分成几次发送)时继续发同一通道,不插队
+			4.有 get 请求超时时先发同步标记,见 tjc_get_mark
+			5.其余情况按通道号从小到大,紧急通道先发
+输入参数：		串口屏实例
+返回值： 		无
+修改记录：
+**********************************************************/
+static void tjc_tx_kick(TJC_HMI_t* hmi)
+{
+	TJC_TxLane_t* lane = NULL;
+	uint16_t len, head, wait;
+	uint32_t tick;
+	uint8_t flags, run;
+
+	if(hmi->txBusy)
+	{
+		return;
+	}
+	if(hmi->txRetryLen)
+	{
+		len = hmi->txRetryLen;
+		hmi->txRetryLen = 0;
+		tjc_tx_begin(hmi, hmi->txRetry, len);
+		return;
+	}
+	if(hmi->txStreamLen)
+	{
+		len = hmi->txStreamLen;
+		hmi->txStreamLen = 0;
+		tjc_tx_begin(hmi, hmi->txStream, len);
+		return;
+	}
+	if(hmi->txHold)
+	{
+		return;
+	}
+	if(hmi->txOpen)
+	{
+		lane = &hmi->txLane[hmi->txOpen - 1];
+		if(lane->Used == 0)
+		{
+			return;
+		}
+	}
+	else
+	{
+		if(hmi->getQueue.Sync == TJC_GET_SYNC_WANT)
+		{
+			len = tjc_get_mark(hmi);
+			tjc_tx_begin(hmi, hmi->TxBuffer, len);
+			return;
+		}
+		for(uint8_t i = 0; i < TJC_TX_LANES; i++)
+		{
+			if(hmi->txLane[i].Used)
+			{
+				lane = &hmi->txLane[i];
+				break;
+			}
+		}
+		if(lane == NULL)
+		{
+			return;
+		}
+	}
+
+	//帧头:长度(高位为标志) + 入队时刻
+	head = lane->Head;
+	len = lane->Data[head] | ((uint16_t)lane->Data[(head + 1) % TJC_TX_LANE_LEN] << 8);
+	tick = 0;
+	for(uint8_t i = 0; i < 4; i++)
+	{
+		tick |= (uint32_t)lane->Data[(head + 2 + i) % TJC_TX_LANE_LEN] << (8 * i);
+	}
+	flags = len >> 12;
+	len &= 0x0fff;
+	head = (head + TJC_TX_HEAD_LEN) % TJC_TX_LANE_LEN;
+	for(uint16_t i = 0; i < len; i++)
+	{
+		hmi->TxBuffer[i] = lane->Data[head];
+		head = (head + 1) % TJC_TX_LANE_LEN;
+	}
+	lane->Head = head;
+	lane->Used -= TJC_TX_HEAD_LEN + len;
+
+	wait = HAL_GetTick() - tick;
+	lane->Stats.Frames++;
+	lane->Stats.WaitSum += wait;
+	if(wait > lane->Stats.WaitMax)
+	{
+		lane->Stats.WaitMax = wait;
+	}
+
+	//结束符可能分在几帧里:旧接口逐字节发送0xff,或长数据按 TJC_CMD_MAX_LEN 分段后只剩1~2字节
+	run = 0;
+	while(run < 3 && run < len && hmi->TxBuffer[len - 1 - run] == 0xff)
+	{
+		run++;
+	}
+	if(run == len)
+	{
+		run += hmi->txFfRun;	//整帧都是0xff,接上前一帧末尾
+	}
+	hmi->txFfRun = (run > 3) ? 3 : run;
+	if(hmi->txFfRun == 3)
+	{
+		hmi->txOpen = 0;
+	}
+	else
+	{
+		hmi->txOpen = (uint8_t)(lane - hmi->txLane) + 1;
+	}
+	if(flags & TJC_TX_GET)
+	{
+		tjc_get_sent(hmi);
+	}
+	if(flags & TJC_TX_HOLD)
+	{
+		//addt 真正发出时才开始计透传超时
+		hmi->txHold = 1;
+		if(hmi->wave != NULL)
+		{
+			hmi->wave->Tick = HAL_GetTick();
+		}
+	}
+
+	tjc_tx_begin(hmi, hmi->TxBuffer, len);
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_tx_push
+日期：    	2026.10.19
+功能：    	把一帧数据放进发送通道,串口空闲时立即开始发送
+			通道满时等待前面的帧发出,超过 TJC_TX_TIMEOUT 仍放不下则丢弃;
+			在中断里或关中断时发送完成中断进不来,等也等不到空位,直接丢弃
+输入参数：		串口屏实例,通道,标志(TJC_TX_HOLD),数据首地址,数据长度
+返回值： 		0:已入队 1:参数错误、通道满或超时丢弃
+修改记录：
+**********************************************************/
+static uint8_t tjc_tx_push(TJC_HMI_t* hmi, uint8_t lane_id, uint8_t flags, const uint8_t* data, uint16_t len)
+{
+	TJC_TxLane_t* lane;
+	uint32_t primask, tick, now;
+	uint16_t tail, need;
+
+	if(data == NULL || len == 0 || len > TJC_CMD_MAX_LEN || lane_id >= TJC_TX_LANES)
+	{
+		return 1;
+	}
+	lane = &hmi->txLane[lane_id];
+	need = TJC_TX_HEAD_LEN + len;
+
+	if(TJC_TX_LANE_LEN - lane->Used < need && (__get_IPSR() != 0 || __get_PRIMASK() != 0))
+	{
+		lane->Stats.Drops++;
+		return 1;
+	}
+	tick = HAL_GetTick();
+	while(TJC_TX_LANE_LEN - lane->Used < need)
+	{
+		if(HAL_GetTick() - tick > TJC_TX_TIMEOUT)
+		{
+			lane->Stats.Drops++;
+			return 1;
+		}
+	}
+
+	now = HAL_GetTick();
+	primask = __get_PRIMASK();
+	__disable_irq();
+	tail = lane->Tail;
+	lane->Data[tail] = len & 0xff;
+	lane->Data[(tail + 1) % TJC_TX_LANE_LEN] = (len >> 8) | (flags << 4);
+	for(uint8_t i = 0; i < 4; i++)
+	{
+		lane->Data[(tail + 2 + i) % TJC_TX_LANE_LEN] = (now >> (8 * i)) & 0xff;
+	}
+	tail = (tail + TJC_TX_HEAD_LEN) % TJC_TX_LANE_LEN;
+	for(uint16_t i = 0; i < len; i++)
+	{
+		lane->Data[tail] = data[i];
+		tail = (tail + 1) % TJC_TX_LANE_LEN;
+	}
+	lane->Tail = tail;
+	lane->Used += need;
+	if(lane->Used > lane->Stats.MaxDepth)
+	{
+		lane->Stats.MaxDepth = lane->Used;
+	}
+	tjc_tx_kick(hmi);
+	__set_PRIMASK(primask);
+	return 0;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_tx_release
+日期：    	2026.10.19
+功能：    	透传结束(收到0xFD或超时),恢复发送队列里的指令
+输入参数：		串口屏实例
+返回值： 		无
+修改记录：
+**********************************************************/
+static void tjc_tx_release(TJC_HMI_t* hmi)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	hmi->txHold = 0;
+	hmi->txStreamLen = 0;
+	if(hmi->txRetryLen && hmi->txRetry == hmi->txStream)
+	{
+		hmi->txRetryLen = 0;	//透传已结束,没发出去的原始数据不再重发
+	}
+	tjc_tx_kick(hmi);
+	__set_PRIMASK(primask);
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_tx_stream
+日期：    	2026.10.19
+功能：    	发送透传原始数据,不进队列,在当前帧发完后立即发送
+输入参数：		串口屏实例,数据首地址(发送完成前必须保持有效),数据长度
+返回值： 		无
+修改记录：
+**********************************************************/
+static void tjc_tx_stream(TJC_HMI_t* hmi, const uint8_t* data, uint16_t len)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	hmi->txStream = data;
+	hmi->txStreamLen = len;
+	tjc_tx_kick(hmi);
+	__set_PRIMASK(primask);
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_tx_retry
+日期：    	2026.10.19
+功能：    	上次启动发送失败时重新启动发送,在主循环的轮询接口中调用
+输入参数：		串口屏实例
+返回值： 		无
+修改记录：
+**********************************************************/
+static void tjc_tx_retry(TJC_HMI_t* hmi)
+{
+	uint32_t primask;
+
+	if(hmi->txRetryLen == 0)
+	{
+		return;
+	}
+	primask = __get_PRIMASK();
+	__disable_irq();
+	tjc_tx_kick(hmi);
+	__set_PRIMASK(primask);
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_uart_send_lane
+日期：    	2026.10.19
+功能：    	把一整段数据放进指定优先级的发送通道
+			紧急通道的指令在当前帧发完后插到普通通道前面,不会拆开任何一条指令
+			超过 TJC_CMD_MAX_LEN 的数据分成几帧放进同一通道,中间不会插入其他通道的指令
+输入参数：		串口屏实例,通道(TJC_LANE_URGENT/TJC_LANE_NORMAL),数据首地址,数据长度
+返回值： 		0:已入队 1:参数错误或等待超时被丢弃(分帧时已入队的部分照常发出)
+修改记录：
+**********************************************************/
+uint8_t tjc_uart_send_lane(TJC_HMI_t* hmi, uint8_t lane, const uint8_t* data, uint16_t len)
+{
+	while(len > TJC_CMD_MAX_LEN)
+	{
+		if(tjc_tx_push(hmi, lane, 0, data, TJC_CMD_MAX_LEN))
+		{
+			return 1;
+		}
+		data += TJC_CMD_MAX_LEN;
+		len -= TJC_CMD_MAX_LEN;
+	}
+	return tjc_tx_push(hmi, lane, 0, data, len);
+}
+
+
+
+/********************************************************
+函数名：  		tjc_uart_send
+日期：    	2026.10.19
+功能：    	把一整段数据放进普通发送通道,串口空闲时一次性发送
+输入参数：		串口屏实例,数据首地址,数据长度
+返回值： 		无
+修改记录：		2026.10.19 改为经发送队列发送
+**********************************************************/
+void tjc_uart_send(TJC_HMI_t* hmi, const uint8_t* data, uint16_t len)
+{
+	tjc_uart_send_lane(hmi, TJC_LANE_NORMAL, data, len);
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_tx_idle
+日期：    	2026.10.19
+功能：    	查询发送队列是否已全部发完
+输入参数：		串口屏实例
+返回值： 		1:全部发完,串口空闲 0:还有数据在发送或排队
+修改记录：
+**********************************************************/
+uint8_t tjc_tx_idle(TJC_HMI_t* hmi)
+{
+	for(uint8_t i = 0; i < TJC_TX_LANES; i++)
+	{
+		if(hmi->txLane[i].Used)
+		{
+			return 0;
+		}
+	}
+	return !hmi->txBusy && !hmi->txStreamLen && !hmi->txRetryLen;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_tx_flush
+日期：    	2026.10.19
+功能：    	等待发送队列全部发完
+输入参数：		串口屏实例,超时时间(ms)
+返回值： 		0:已发完 1:超时
+修改记录：
+**********************************************************/
+uint8_t tjc_tx_flush(TJC_HMI_t* hmi, uint32_t timeout)
+{
+	uint32_t tick = HAL_GetTick();
+
+	while(!tjc_tx_idle(hmi))
+	{
+		tjc_tx_retry(hmi);
+		if(HAL_GetTick() - tick > timeout)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_tx_get_stats
+日期：    	2026.10.19
+功能：    	读取发送通道的统计信息,用于调整通道长度和发送节奏
+输入参数：		串口屏实例,通道,统计信息输出地址
+返回值： 		无
+修改记录：
+**********************************************************/
+void tjc_tx_get_stats(TJC_HMI_t* hmi, uint8_t lane, TJC_TxLaneStats_t* stats)
+{
+	if(lane >= TJC_TX_LANES)
+	{
+		return;
+	}
+	*stats = hmi->txLane[lane].Stats;
+	stats->Depth = hmi->txLane[lane].Used;
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_tx_reset_stats
+日期：    	2026.10.19
+功能：    	清零所有发送通道的统计信息和启动发送失败次数
+输入参数：		串口屏实例
+返回值： 		无
+修改记录：
+**********************************************************/
+void tjc_tx_reset_stats(TJC_HMI_t* hmi)
+{
+	for(uint8_t i = 0; i < TJC_TX_LANES; i++)
+	{
+		memset(&hmi->txLane[i].Stats, 0, sizeof(TJC_TxLaneStats_t));
+	}
+	hmi->txErrors = 0;
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		uart_send_char
+日期：    	2024.09.18
+功能：    	串口发送单个字符
+输入参数：		要发送的单个字符
+返回值： 		无
+修改记录：		2026.10.19 改为经 tjc_uart_send 发送
+**********************************************************/
+void uart_send_char(char ch)
+{
+	uint8_t ch2 = (uint8_t)ch;
+	tjc_uart_send(&tjcDefault, &ch2, 1);
+	return;
+}
+
+
+void uart_send_string(char* str)
+{
+	if(str == 0)
+	{
+		return;
+	}
+	tjc_uart_send(&tjcDefault, (uint8_t*)str, strlen(str));
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_cmd_begin
+日期：    	2026.10.19
+功能：    	开始拼接一条指令,清空指令缓冲区
+输入参数：		指令缓冲区(一般定义为局部变量)
+返回值： 		无
+示例:			TJC_Cmd_t cmd;
+				tjc_cmd_begin(&cmd);
+				tjc_cmd_str(&cmd, "n0.val=");
+				tjc_cmd_int(&cmd, 100);
+				tjc_cmd_send(&tjcDefault, &cmd);	发出的数据就是 n0.val=100\xff\xff\xff
+修改记录：
+**********************************************************/
+void tjc_cmd_begin(TJC_Cmd_t* cmd)
+{
+	cmd->Length = 0;
+	cmd->Overflow = 0;
+	cmd->Hmi = NULL;
+	cmd->Lane = TJC_LANE_NORMAL;
+	cmd->Chunks = 0;
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_cmd_begin_chunked
+日期：    	2026.10.19
+功能：    	开始拼接一条不限长度的指令,缓冲区满时已拼好的部分先放进发送通道
+			分出去的几帧在同一通道里连续发送,结束符到达前不会插入其他通道的指令,
+			串口屏收到的和一次发完的完全相同;长文本、旧接口用这种方式
+输入参数：		指令缓冲区,串口屏实例,通道(发送时以这里为准)
+返回值： 		无
+修改记录：
+**********************************************************/
+void tjc_cmd_begin_chunked(TJC_Cmd_t* cmd, TJC_HMI_t* hmi, uint8_t lane)
+{
+	tjc_cmd_begin(cmd);
+	cmd->Hmi = hmi;
+	cmd->Lane = lane;
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_cmd_char
+日期：    	2026.10.19
+功能：    	向指令缓冲区追加一个字符
+输入参数：		指令缓冲区,字符
+返回值： 		无
+			缓冲区满时:tjc_cmd_begin 开始的置超长标志丢弃,tjc_cmd_begin_chunked 开始的先发出已拼好的部分
+修改记录：
+**********************************************************/
+void tjc_cmd_char(TJC_Cmd_t* cmd, char ch)
+{
+	//末尾预留3字节结束符
+	if(cmd->Length >= TJC_CMD_MAX_LEN - 3)
+	{
+		if(cmd->Hmi == NULL || cmd->Overflow
+		   || tjc_tx_push(cmd->Hmi, cmd->Lane, 0, (uint8_t*)cmd->Buffer, cmd->Length))
+		{
+			cmd->Overflow = 1;
+			return;
+		}
+		cmd->Length = 0;
+		cmd->Chunks++;
+	}
+	cmd->Buffer[cmd->Length++] = ch;
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_cmd_str
+日期：    	2026.10.19
+功能：    	向指令缓冲区追加字符串
+输入参数：		指令缓冲区,以'\0'结尾的字符串
+返回值： 		无
+修改记录：
+**********************************************************/
+void tjc_cmd_str(TJC_Cmd_t* cmd, const char* str)
+{
+	while(str!=0&&*str!=0)
+	{
+		tjc_cmd_char(cmd, *str++);
+	}
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_cmd_nstr
+日期：    	2026.10.19
+功能：    	向指令缓冲区追加指定长度的数据
+输入参数：		指令缓冲区,数据首地址,数据长度
+返回值： 		无
+修改记录：
+**********************************************************/
+void tjc_cmd_nstr(TJC_Cmd_t* cmd, const char* str, uint16_t len)
+{
+	for(uint16_t i = 0; i < len; i++)
+	{
+		tjc_cmd_char(cmd, str[i]);
+	}
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_cmd_digits
+日期：    	2026.10.19
+功能：    	向指令缓冲区追加无符号十进制数,位数不足时高位补0
+输入参数：		指令缓冲区,数值,最少位数
+返回值： 		无
+修改记录：
+**********************************************************/
+static void tjc_cmd_digits(TJC_Cmd_t* cmd, uint32_t val, uint8_t width)
+{
+	//uint32_t 最多10位
+	char digits[10];
+	uint8_t n = 0;
+
+	do {
+		digits[n++] = (val % 10) + '0';
+		val /= 10;
+	} while (val && n < sizeof(digits));
+
+	while(n < width && n < sizeof(digits))
+	{
+		digits[n++] = '0';
+	}
+	//倒序取出,省去反转字符串
+	while(n)
+	{
+		tjc_cmd_char(cmd, digits[--n]);
+	}
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_cmd_int
+日期：    	2026.10.19
+功能：    	向指令缓冲区追加有符号十进制整数
+输入参数：		指令缓冲区,数值
+返回值： 		无
+修改记录：
+**********************************************************/
+void tjc_cmd_int(TJC_Cmd_t* cmd, int32_t val)
+{
+	uint32_t mag = (uint32_t)val;
+
+	if(val < 0)
+	{
+		tjc_cmd_char(cmd, '-');
+		mag = 0u - mag;		//-2147483648 也能正确取绝对值
+	}
+	tjc_cmd_digits(cmd, mag, 1);
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_cmd_fixed
+日期：    	2026.10.19
+功能：    	向指令缓冲区追加定点小数
+输入参数：		指令缓冲区,放大10^decimals倍后的整数,小数位数(0~9)
+返回值： 		无
+示例:			tjc_cmd_fixed(&cmd, -1234, 2); 追加的数据就是 -12.34
+修改记录：
+**********************************************************/
+void tjc_cmd_fixed(TJC_Cmd_t* cmd, int32_t val, uint8_t decimals)
+{
+	uint32_t mag = (uint32_t)val;
+	uint32_t scale = 1;
+
+	if(decimals > 9)
+	{
+		decimals = 9;
+	}
+	for(uint8_t i = 0; i < decimals; i++)
+	{
+		scale *= 10;
+	}
+	if(val < 0)
+	{
+		tjc_cmd_char(cmd, '-');
+		mag = 0u - mag;
+	}
+	tjc_cmd_digits(cmd, mag / scale, 1);
+	if(decimals)
+	{
+		tjc_cmd_char(cmd, '.');
+		tjc_cmd_digits(cmd, mag % scale, decimals);
+	}
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_cmd_hex
+日期：    	2026.10.19
+功能：    	向指令缓冲区追加大写十六进制数,位数不足时高位补0
+输入参数：		指令缓冲区,数值,最少位数(1~8)
+返回值： 		无
+修改记录：
+**********************************************************/
+void tjc_cmd_hex(TJC_Cmd_t* cmd, uint32_t val, uint8_t digits)
+{
+	const char hex[] = "0123456789ABCDEF";
+	int8_t shift;
+
+	if(digits == 0)
+	{
+		digits = 1;
+	}
+	if(digits > 8)
+	{
+		digits = 8;
+	}
+	//跳过多余的前导0
+	shift = 28;
+	while(shift >= digits * 4 && ((val >> shift) & 0x0F) == 0)
+	{
+		shift -= 4;
+	}
+	for(; shift >= 0; shift -= 4)
+	{
+		tjc_cmd_char(cmd, hex[(val >> shift) & 0x0F]);
+	}
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_cmd_push
+日期：    	2026.10.19
+功能：    	给指令加上结束符放进发送通道
+输入参数：		串口屏实例,指令,通道,标志;tjc_cmd_begin_chunked 开始的指令按其中的实例和通道发送
+返回值： 		0:已入队 1:指令超长或等待超时被丢弃
+修改记录：
+**********************************************************/
+static uint8_t tjc_cmd_push(TJC_HMI_t* hmi, TJC_Cmd_t* cmd, uint8_t lane, uint8_t flags)
+{
+	if(cmd->Hmi != NULL)
+	{
+		hmi = cmd->Hmi;
+		lane = cmd->Lane;
+	}
+	if(cmd->Overflow)
+	{
+		//已经分段发出了一部分,补上结束符让通道恢复,串口屏按错误指令处理
+		if(cmd->Chunks)
+		{
+			tjc_tx_push(hmi, lane, 0, (const uint8_t*)"\xff\xff\xff", 3);
+		}
+		return 1;
+	}
+	//tjc_cmd_char 已为结束符预留空间
+	cmd->Buffer[cmd->Length++] = (char)0xff;
+	cmd->Buffer[cmd->Length++] = (char)0xff;
+	cmd->Buffer[cmd->Length++] = (char)0xff;
+	return tjc_tx_push(hmi, lane, flags, (uint8_t*)cmd->Buffer, cmd->Length);
+}
+
+
+
+/********************************************************
+函数名：  		tjc_cmd_send
+日期：    	2026.10.19
+功能：    	追加结束符\xff\xff\xff,整条指令放进普通发送通道
+输入参数：		串口屏实例,指令缓冲区
+返回值： 		0:已入队 1:指令超长或等待超时,未发送
+修改记录：		2026.10.19 改为经发送队列发送
+**********************************************************/
+uint8_t tjc_cmd_send(TJC_HMI_t* hmi, TJC_Cmd_t* cmd)
+{
+	return tjc_cmd_push(hmi, cmd, TJC_LANE_NORMAL, 0);
+}
+
+
+
+/********************************************************
+函数名：  		tjc_cmd_send_lane
+日期：    	2026.10.19
+功能：    	同 tjc_cmd_send,指定发送通道
+输入参数：		串口屏实例,指令,通道(TJC_LANE_URGENT/TJC_LANE_NORMAL)
+返回值： 		0:已入队 1:指令超长或等待超时被丢弃
+示例:			tjc_cmd_begin(&cmd);
+				tjc_cmd_str(&cmd, "t0.pco=63488");
+				tjc_cmd_send_lane(&tjcDefault, &cmd, TJC_LANE_URGENT);
+修改记录：
+**********************************************************/
+uint8_t tjc_cmd_send_lane(TJC_HMI_t* hmi, TJC_Cmd_t* cmd, uint8_t lane)
+{
+	return tjc_cmd_push(hmi, cmd, lane, 0);
+}
+
+
+
+/********************************************************
+函数名：  		tjc_hmi_send_string
+日期：    	2024.09.18
+功能：    	串口发送字符串和结束符
+输入参数：		串口屏实例,要发送的字符串
+返回值： 		无
+示例:			tjc_hmi_send_string(hmi, "n0.val=100"); 发出的数据就是 n0.val=100
+修改记录：		2026.10.19 整条指令拼好后一次发送
+**********************************************************/
+void tjc_hmi_send_string(TJC_HMI_t* hmi, char* str)
+{
+	TJC_Cmd_t cmd;
+
+	tjc_cmd_begin_chunked(&cmd, hmi, TJC_LANE_NORMAL);
+	tjc_cmd_str(&cmd, str);
+	tjc_cmd_send(hmi, &cmd);
+	return;
+}
+
+/********************************************************
+函数名：  		tjc_hmi_send_txt
+日期：    	2024.09.18
+功能：    	串口发送字符串和结束符
+输入参数：		串口屏实例,要发送的字符串
+返回值： 		无
+示例:			tjc_hmi_send_txt(hmi, "t0", "txt", "ABC"); 发出的数据就是t0.txt="ABC"
+修改记录：		2026.10.19 整条指令拼好后一次发送
+**********************************************************/
+void tjc_hmi_send_txt(TJC_HMI_t* hmi, char* objname, char* attribute, char* txt)
+{
+	TJC_Cmd_t cmd;
+
+	tjc_cmd_begin_chunked(&cmd, hmi, TJC_LANE_NORMAL);
+	tjc_cmd_str(&cmd, objname);
+	tjc_cmd_char(&cmd, '.');
+	tjc_cmd_str(&cmd, attribute);
+	tjc_cmd_str(&cmd, "=\"");
+	tjc_cmd_str(&cmd, txt);
+	tjc_cmd_char(&cmd, '\"');
+	tjc_cmd_send(hmi, &cmd);
+	return;
+}
+
+
+/********************************************************
+函数名：  		tjc_hmi_send_val
+日期：    	2024.09.18
+功能：    	串口发送字符串和结束符
+输入参数：		串口屏实例,要发送的字符串
+返回值： 		无
+示例:			tjc_hmi_send_val(hmi, "n0", "val", 100); 发出的数据就是 n0.val=100
+修改记录：		2026.10.19 整条指令拼好后一次发送
+**********************************************************/
+void tjc_hmi_send_val(TJC_HMI_t* hmi, char* objname, char* attribute, int val)
+{
+	TJC_Cmd_t cmd;
+
+	//拼接字符串,例如n0.val=123
+	tjc_cmd_begin_chunked(&cmd, hmi, TJC_LANE_NORMAL);
+	tjc_cmd_str(&cmd, objname);
+	tjc_cmd_char(&cmd, '.');
+	tjc_cmd_str(&cmd, attribute);
+	tjc_cmd_char(&cmd, '=');
+	tjc_cmd_int(&cmd, val);
+	tjc_cmd_send(hmi, &cmd);
+	return;
+}
+
+/********************************************************
+函数名：  		tjc_hmi_send_nstring
+日期：    	2024.09.18
+功能：    	串口发送字符串和结束符
+输入参数：		串口屏实例,要发送的字符串,字符串长度
+返回值： 		无
+修改记录：		2026.10.19 整条指令拼好后一次发送
+**********************************************************/
+void tjc_hmi_send_nstring(TJC_HMI_t* hmi, char* str, unsigned char str_length)
+{
+	TJC_Cmd_t cmd;
+
+	tjc_cmd_begin_chunked(&cmd, hmi, TJC_LANE_NORMAL);
+	tjc_cmd_nstr(&cmd, str, str_length);
+	tjc_cmd_send(hmi, &cmd);
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_hmi_send_fixed
+日期：    	2026.10.19
+功能：    	以定点小数形式发送文本属性
+输入参数：		串口屏实例,控件名,属性名,放大10^decimals倍后的整数,小数位数
+返回值： 		无
+示例:			tjc_hmi_send_fixed(hmi, "t0", "txt", 3300, 3); 发出的数据就是 t0.txt="3.300"
+修改记录：
+**********************************************************/
+void tjc_hmi_send_fixed(TJC_HMI_t* hmi, char* objname, char* attribute, int32_t val, uint8_t decimals)
+{
+	TJC_Cmd_t cmd;
+
+	tjc_cmd_begin_chunked(&cmd, hmi, TJC_LANE_NORMAL);
+	tjc_cmd_str(&cmd, objname);
+	tjc_cmd_char(&cmd, '.');
+	tjc_cmd_str(&cmd, attribute);
+	tjc_cmd_str(&cmd, "=\"");
+	tjc_cmd_fixed(&cmd, val, decimals);
+	tjc_cmd_char(&cmd, '\"');
+	tjc_cmd_send(hmi, &cmd);
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_hmi_send_hex
+日期：    	2026.10.19
+功能：    	以十六进制形式发送文本属性
+输入参数：		串口屏实例,控件名,属性名,数值,最少位数
+返回值： 		无
+示例:			tjc_hmi_send_hex(hmi, "t0", "txt", 0x1A, 4); 发出的数据就是 t0.txt="001A"
+修改记录：
+**********************************************************/
+void tjc_hmi_send_hex(TJC_HMI_t* hmi, char* objname, char* attribute, uint32_t val, uint8_t digits)
+{
+	TJC_Cmd_t cmd;
+
+	tjc_cmd_begin_chunked(&cmd, hmi, TJC_LANE_NORMAL);
+	tjc_cmd_str(&cmd, objname);
+	tjc_cmd_char(&cmd, '.');
+	tjc_cmd_str(&cmd, attribute);
+	tjc_cmd_str(&cmd, "=\"");
+	tjc_cmd_hex(&cmd, val, digits);
+	tjc_cmd_char(&cmd, '\"');
+	tjc_cmd_send(hmi, &cmd);
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_hmi_send_color
+日期：    	2026.10.19
+功能：    	发送颜色属性,RGB888转换为串口屏使用的RGB565
+输入参数：		串口屏实例,控件名,属性名(bco/pco等),红,绿,蓝(0~255)
+返回值： 		无
+示例:			tjc_hmi_send_color(hmi, "t0", "pco", 255, 0, 0); 发出的数据就是 t0.pco=63488
+修改记录：
+**********************************************************/
+void tjc_hmi_send_color(TJC_HMI_t* hmi, char* objname, char* attribute, uint8_t r, uint8_t g, uint8_t b)
+{
+	TJC_Cmd_t cmd;
+	uint16_t rgb565 = ((uint16_t)(r >> 3) << 11) | ((uint16_t)(g >> 2) << 5) | (b >> 3);
+
+	tjc_cmd_begin_chunked(&cmd, hmi, TJC_LANE_NORMAL);
+	tjc_cmd_str(&cmd, objname);
+	tjc_cmd_char(&cmd, '.');
+	tjc_cmd_str(&cmd, attribute);
+	tjc_cmd_char(&cmd, '=');
+	tjc_cmd_digits(&cmd, rgb565, 1);
+	tjc_cmd_send(hmi, &cmd);
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_hmi_send_add
+日期：    	2026.10.19
+功能：    	向曲线控件添加一个数据点
+输入参数：		串口屏实例,曲线控件id,通道号,数据(0~255)
+返回值： 		无
+示例:			tjc_hmi_send_add(hmi, 1, 0, 128); 发出的数据就是 add 1,0,128
+修改记录：
+**********************************************************/
+void tjc_hmi_send_add(TJC_HMI_t* hmi, uint8_t id, uint8_t ch, uint8_t val)
+{
+	TJC_Cmd_t cmd;
+
+	tjc_cmd_begin(&cmd);
+	tjc_cmd_str(&cmd, "add ");
+	tjc_cmd_digits(&cmd, id, 1);
+	tjc_cmd_char(&cmd, ',');
+	tjc_cmd_digits(&cmd, ch, 1);
+	tjc_cmd_char(&cmd, ',');
+	tjc_cmd_digits(&cmd, val, 1);
+	tjc_cmd_send(hmi, &cmd);
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_hmi_send_addt
+日期：    	2026.10.19
+功能：    	向曲线控件发起透传,之后串口屏等待qty字节的原始数据
+输入参数：		串口屏实例,曲线控件id,通道号,透传数据字节数
+返回值： 		无
+示例:			tjc_hmi_send_addt(hmi, 1, 0, 100); 发出的数据就是 addt 1,0,100
+修改记录：
+**********************************************************/
+void tjc_hmi_send_addt(TJC_HMI_t* hmi, uint8_t id, uint8_t ch, uint16_t qty)
+{
+	TJC_Cmd_t cmd;
+
+	tjc_cmd_begin(&cmd);
+	tjc_cmd_str(&cmd, "addt ");
+	tjc_cmd_digits(&cmd, id, 1);
+	tjc_cmd_char(&cmd, ',');
+	tjc_cmd_digits(&cmd, ch, 1);
+	tjc_cmd_char(&cmd, ',');
+	tjc_cmd_digits(&cmd, qty, 1);
+	tjc_cmd_send(hmi, &cmd);
+	return;
+}
+
+
+
+
+
+/********************************************************
+函数名：  		tjc_hmi_init
+日期：    	2026.10.19
+功能：    	初始化一个串口屏实例,挂接到串口中断分发表并开启接收
+				同一串口上原来挂接的实例(包括接在 TJC_UART 上的默认实例 tjcDefault)会被摘下,
+				否则中断按串口查表时先找到旧实例,新实例收不到数据,发送完成也清不掉忙标志
+输入参数：		串口屏实例,串口句柄
+返回值： 		0:成功 1:实例数量超过 TJC_HMI_MAX
+示例:			TJC_HMI_t hmi1, hmi2;
+				tjc_hmi_init(&hmi1, &huart1);
+				tjc_hmi_init(&hmi2, &huart3);
+				tjc_hmi_send_val(&hmi2, "n0", "val", 100);
+修改记录：
+**********************************************************/
+uint8_t tjc_hmi_init(TJC_HMI_t* hmi, UART_HandleTypeDef* huart)
+{
+	uint8_t slot = TJC_HMI_MAX;
+
+	for(uint8_t i = 0; i < TJC_HMI_MAX; i++)
+	{
+		if(hmiTable[i] != NULL && hmiTable[i] != hmi && hmiTable[i]->huart->Instance == huart->Instance)
+		{
+			hmiTable[i] = NULL;
+		}
+	}
+	for(uint8_t i = 0; i < TJC_HMI_MAX; i++)
+	{
+		if(hmiTable[i] == hmi)
+		{
+			slot = i;
+			break;
+		}
+		if(hmiTable[i] == NULL && slot == TJC_HMI_MAX)
+		{
+			slot = i;
+		}
+	}
+	if(slot == TJC_HMI_MAX)
+	{
+		return 1;
+	}
+
+	memset(hmi, 0, sizeof(TJC_HMI_t));
+	hmi->huart = huart;
+	hmiTable[slot] = hmi;
+	HAL_UART_Receive_IT(huart, hmi->RxByte, 1);
+	return 0;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_hmi_deinit
+日期：    	2026.10.19
+功能：    	把串口屏实例从串口中断分发表摘下,之后该串口的中断交给 tjc_uart_rx_other/tjc_uart_tx_other
+				TJC_UART 不接串口屏而另作他用时,先调用 tjc_hmi_deinit(&tjcDefault)
+输入参数：		串口屏实例
+返回值： 		void
+修改记录：
+**********************************************************/
+void tjc_hmi_deinit(TJC_HMI_t* hmi)
+{
+	for(uint8_t i = 0; i < TJC_HMI_MAX; i++)
+	{
+		if(hmiTable[i] == hmi)
+		{
+			hmiTable[i] = NULL;
+		}
+	}
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_hmi_find
+日期：    	2026.10.19
+功能：    	按串口句柄查找串口屏实例
+输入参数：		串口句柄
+返回值： 		串口屏实例,不是串口屏的串口返回NULL
+修改记录：
+**********************************************************/
+static TJC_HMI_t* tjc_hmi_find(UART_HandleTypeDef* huart)
+{
+	for(uint8_t i = 0; i < TJC_HMI_MAX; i++)
+	{
+		if(hmiTable[i] != NULL && hmiTable[i]->huart->Instance == huart->Instance)
+		{
+			return hmiTable[i];
+		}
+	}
+	return NULL;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_hmi_rx_handler
+日期：    	2026.10.19
+功能：    	串口接收完成分发,将接收到的数据写入对应串口屏的环形缓冲区
+输入参数：		触发中断的串口句柄
+返回值： 		1:是串口屏的串口,已处理 0:不是串口屏的串口
+修改记录：
+**********************************************************/
+uint8_t tjc_hmi_rx_handler(UART_HandleTypeDef* huart)
+{
+	TJC_HMI_t* hmi = tjc_hmi_find(huart);
+	RingBuffer_t* ring;
+
+	if(hmi == NULL)
+	{
+		return 0;
+	}
+	ring = &hmi->ringBuffer;
+	if(ring->Length < RINGBUFFER_LEN) //判断缓冲区是否已满
+	{
+		ring->Ring_data[ring->Tail] = hmi->RxByte[0];
+		ring->Tail = (ring->Tail+1)%RINGBUFFER_LEN;//防止越界非法访问
+		ring->Length++;
+	}
+	tjc_rx_parse_byte(hmi, hmi->RxByte[0]);
+	HAL_UART_Receive_IT(hmi->huart, hmi->RxByte, 1);		// 重新使能接收中断
+	return 1;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_hmi_error_handler
+日期：    	2026.10.19
+功能：    	串口错误(溢出、噪声等)后HAL会停止接收,这里重新开启接收并恢复发送队列
+输入参数：		触发中断的串口句柄
+返回值： 		1:是串口屏的串口,已处理 0:不是串口屏的串口
+修改记录：
+**********************************************************/
+uint8_t tjc_hmi_error_handler(UART_HandleTypeDef* huart)
+{
+	TJC_HMI_t* hmi = tjc_hmi_find(huart);
+
+	if(hmi == NULL)
+	{
+		return 0;
+	}
+	hmi->rxFrame.Length = 0;
+	hmi->rxFrame.FfCount = 0;
+	HAL_UART_Receive_IT(hmi->huart, hmi->RxByte, 1);
+	//发送被错误中止时不会再有发送完成中断,在这里接着发
+	if(hmi->txBusy && hmi->huart->gState == HAL_UART_STATE_READY)
+	{
+		hmi->txBusy = 0;
+		tjc_tx_kick(hmi);
+	}
+	return 1;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_hmi_tx_handler
+日期：    	2026.10.19
+功能：    	串口发送完成分发,开始发送对应串口屏队列里的下一帧
+输入参数：		触发中断的串口句柄
+返回值： 		1:是串口屏的串口,已处理 0:不是串口屏的串口
+修改记录：
+**********************************************************/
+uint8_t tjc_hmi_tx_handler(UART_HandleTypeDef* huart)
+{
+	TJC_HMI_t* hmi = tjc_hmi_find(huart);
+
+	if(hmi == NULL)
+	{
+		return 0;
+	}
+	hmi->txBusy = 0;
+	tjc_tx_kick(hmi);
+	return 1;
+}
+
+
+
+#if TJC_DEFINE_HAL_CALLBACK
+/********************************************************
+函数名：  		tjc_uart_rx_other
+日期：    	2026.10.19
+功能：    	非串口屏串口的接收完成回调,需要时在其他文件中重新实现
+输入参数：		触发中断的串口句柄
+返回值： 		void
+修改记录：
+**********************************************************/
+__weak void tjc_uart_rx_other(UART_HandleTypeDef *huart)
+{
+	(void)huart;
+	return;
+}
+
+
+
+/********************************************************
+函数名：  	HAL_UART_RxCpltCallback
+日期：    	2022.10.08
+功能：    	串口接收中断,串口屏的数据交给 tjc_hmi_rx_handler,其他串口交给 tjc_uart_rx_other
+输入参数：
+返回值： 		void
+修改记录：		2026.10.19 按串口句柄分发到各串口屏实例
+**********************************************************/
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+	if(!tjc_hmi_rx_handler(huart))
+	{
+		tjc_uart_rx_other(huart);
+	}
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_uart_tx_other
+日期：    	2026.10.19
+功能：    	非串口屏串口的发送完成回调,需要时在其他文件中重新实现
+输入参数：		触发中断的串口句柄
+返回值： 		void
+修改记录：
+**********************************************************/
+__weak void tjc_uart_tx_other(UART_HandleTypeDef *huart)
+{
+	(void)huart;
+	return;
+}
+
+
+
+/********************************************************
+函数名：  	HAL_UART_TxCpltCallback
+日期：    	2026.10.19
+功能：    	串口发送完成中断,串口屏的串口接着发送队列里的下一帧
+输入参数：
+返回值： 		void
+修改记录：
+**********************************************************/
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+	if(!tjc_hmi_tx_handler(huart))
+	{
+		tjc_uart_tx_other(huart);
+	}
+	return;
+}
+
+
+
+/********************************************************
+函数名：  	HAL_UART_ErrorCallback
+日期：    	2026.10.19
+功能：    	串口错误中断,重新开启串口屏的接收
+输入参数：
+返回值： 		void
+修改记录：
+**********************************************************/
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+	tjc_hmi_error_handler(huart);
+	return;
+}
+#endif
+
+
+
+/********************************************************
+函数名：  		tjc_hmi_rx_clear
+日期：    	2022.10.08
+功能：    	初始化环形缓冲区
+输入参数：		串口屏实例
+返回值： 		void
+修改记录：		2026.10.19 改为按实例操作
+**********************************************************/
+void tjc_hmi_rx_clear(TJC_HMI_t* hmi)
+{
+	//初始化相关信息
+	hmi->ringBuffer.Head = 0;
+	hmi->ringBuffer.Tail = 0;
+	hmi->ringBuffer.Length = 0;
+	return;
+}
+
+
+
+
+/********************************************************
+函数名：  		tjc_hmi_rx_delete
+作者：
+日期：    	2022.10.08
+功能：    	删除串口缓冲区中相应长度的数据
+输入参数：		串口屏实例,要删除的长度
+返回值： 		void
+修改记录：		2026.10.19 改为按实例操作;修正只删除1字节的问题
+**********************************************************/
+void tjc_hmi_rx_delete(TJC_HMI_t* hmi, uint16_t size)
+{
+	if(size >= hmi->ringBuffer.Length)
+	{
+	    tjc_hmi_rx_clear(hmi);
+	    return;
+	}
+	hmi->ringBuffer.Head = (hmi->ringBuffer.Head+size)%RINGBUFFER_LEN;//防止越界非法访问
+	hmi->ringBuffer.Length -= size;
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_hmi_rx_read
+作者：
+日期：    	2022.10.08
+功能：    	从串口缓冲区读取1字节数据
+输入参数：		串口屏实例,position:读取的位置
+返回值： 		所在位置的数据(1字节)
+修改记录：		2026.10.19 改为按实例操作
+**********************************************************/
+uint8_t tjc_hmi_rx_read(TJC_HMI_t* hmi, uint16_t position)
+{
+	uint16_t realPosition = (hmi->ringBuffer.Head + position) % RINGBUFFER_LEN;
+
+	return hmi->ringBuffer.Ring_data[realPosition];
+}
+
+
+
+
+/********************************************************
+函数名：  		tjc_hmi_rx_length
+作者：
+日期：    	2022.10.08
+功能：    	获取串口缓冲区的数据数量
+输入参数：		串口屏实例
+返回值： 		串口缓冲区的数据数量
+修改记录：		2026.10.19 改为按实例操作
+**********************************************************/
+uint16_t tjc_hmi_rx_length(TJC_HMI_t* hmi)
+{
+	return hmi->ringBuffer.Length;
+}
+
+
+
+/*****************************默认实例接口***********************************/
+void tjc_send_string(char* str)
+{
+	tjc_hmi_send_string(&tjcDefault, str);
+}
+
+void tjc_send_txt(char* objname, char* attribute, char* txt)
+{
+	tjc_hmi_send_txt(&tjcDefault, objname, attribute, txt);
+}
+
+void tjc_send_val(char* objname, char* attribute, int val)
+{
+	tjc_hmi_send_val(&tjcDefault, objname, attribute, val);
+}
+
+void tjc_send_nstring(char* str, unsigned char str_length)
+{
+	tjc_hmi_send_nstring(&tjcDefault, str, str_length);
+}
+
+void tjc_send_fixed(char* objname, char* attribute, int32_t val, uint8_t decimals)
+{
+	tjc_hmi_send_fixed(&tjcDefault, objname, attribute, val, decimals);
+}
+
+void tjc_send_hex(char* objname, char* attribute, uint32_t val, uint8_t digits)
+{
+	tjc_hmi_send_hex(&tjcDefault, objname, attribute, val, digits);
+}
+
+void tjc_send_color(char* objname, char* attribute, uint8_t r, uint8_t g, uint8_t b)
+{
+	tjc_hmi_send_color(&tjcDefault, objname, attribute, r, g, b);
+}
+
+void tjc_send_add(uint8_t id, uint8_t ch, uint8_t val)
+{
+	tjc_hmi_send_add(&tjcDefault, id, ch, val);
+}
+
+void tjc_send_addt(uint8_t id, uint8_t ch, uint16_t qty)
+{
+	tjc_hmi_send_addt(&tjcDefault, id, ch, qty);
+}
+
+void initRingBuffer(void)
+{
+	tjc_hmi_rx_clear(&tjcDefault);
+}
+
+void write1ByteToRingBuffer(uint8_t data)
+{
+	RingBuffer_t* ring = &tjcDefault.ringBuffer;
+
+	if(ring->Length >= RINGBUFFER_LEN) //判断缓冲区是否已满
+	{
+	return ;
+	}
+	ring->Ring_data[ring->Tail]=data;
+	ring->Tail = (ring->Tail+1)%RINGBUFFER_LEN;//防止越界非法访问
+	ring->Length++;
+	return ;
+}
+
+void deleteRingBuffer(uint16_t size)
+{
+	tjc_hmi_rx_delete(&tjcDefault, size);
+}
+
+uint8_t read1ByteFromRingBuffer(uint16_t position)
+{
+	return tjc_hmi_rx_read(&tjcDefault, position);
+}
+
+uint16_t getRingBufferLength()
+{
+	return tjc_hmi_rx_length(&tjcDefault);
+}
+
+/********************************************************
+函数名：  		isRingBufferOverflow
+作者：
+日期：    	2022.10.08
+功能：    	判断环形缓冲区是否已满
+输入参数：
+返回值： 		0:环形缓冲区已满 , 1:环形缓冲区未满
+修改记录：
+**********************************************************/
+uint8_t isRingBufferOverflow()
+{
+	return tjcDefault.ringBuffer.Length < RINGBUFFER_LEN;
+}
+/****************************************************************************/
+
+
+
+
+/********************************************************
+函数名：  		tjc_rx_parse_byte
+日期：    	2026.10.19
+功能：    	按帧解析串口屏返回的数据,识别透传相关的返回码和 get 应答
+			帧以\xff\xff\xff结尾;0x71数值返回固定8字节,数据中可能含0xff,按长度判断
+输入参数：		串口屏实例,接收到的1字节数据
+返回值： 		无
+修改记录：
+**********************************************************/
+static void tjc_rx_parse_byte(TJC_HMI_t* hmi, uint8_t data)
+{
+	TJC_Frame_t* frame = &hmi->rxFrame;
+
+	if(frame->Length < TJC_FRAME_MAX_LEN)
+	{
+		frame->Data[frame->Length] = data;
+	}
+	frame->Length++;
+
+	if(frame->Data[0] == 0x71)
+	{
+		if(frame->Length >= 8)
+		{
+			tjc_get_reply(hmi, frame);
+			frame->Length = 0;
+			frame->FfCount = 0;
+		}
+		return;
+	}
+
+	frame->FfCount = (data == 0xff) ? frame->FfCount + 1 : 0;
+	if(frame->FfCount < 3)
+	{
+		return;
+	}
+
+	switch(frame->Data[0])
+	{
+		case 0xFE:	//透传就绪
+			if(hmi->wave != NULL)
+			{
+				hmi->wave->Ready = 1;
+			}
+			break;
+		case 0xFD:	//透传完成,放行发送队列
+			if(hmi->wave != NULL)
+			{
+				hmi->wave->Done = 1;
+			}
+			tjc_tx_release(hmi);
+			break;
+		case 0x70:	//get 字符串返回
+		case 0x1A:	//变量名称无效
+		case 0x1B:	//变量运算无效
+			tjc_get_reply(hmi, frame);
+			break;
+		default:
+			break;
+	}
+	frame->Length = 0;
+	frame->FfCount = 0;
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_wave_start
+日期：    	2026.10.19
+功能：    	开启曲线控件透传(addt)数据流,清空各通道采样缓存
+输入参数：		串口屏实例,数据流(每路透传定义一个),曲线控件id,使用的通道数(1~TJC_WAVE_MAX_CH),
+				每次透传的采样点数(1~TJC_WAVE_BLOCK_MAX)
+返回值： 		无
+示例:			static TJC_Wave_t wave;
+				tjc_wave_start(&tjcDefault, &wave, 1, 2, 100);
+				采样中断里 tjc_wave_push(&wave, 0, &adc0, 1); tjc_wave_push(&wave, 1, &adc1, 1);
+				主循环里   tjc_wave_poll(&wave);
+修改记录：
+**********************************************************/
+void tjc_wave_start(TJC_HMI_t* hmi, TJC_Wave_t* wave, uint8_t id, uint8_t ch_count, uint16_t block)
+{
+	if(ch_count == 0 || ch_count > TJC_WAVE_MAX_CH)
+	{
+		ch_count = TJC_WAVE_MAX_CH;
+	}
+	if(block == 0 || block > TJC_WAVE_BLOCK_MAX)
+	{
+		block = TJC_WAVE_BLOCK_MAX;
+	}
+	memset(wave, 0, sizeof(TJC_Wave_t));
+	wave->hmi = hmi;
+	wave->Id = id;
+	wave->ChCount = ch_count;
+	wave->Block = block;
+	wave->State = TJC_WAVE_IDLE;
+	wave->Enable = 1;
+	hmi->wave = wave;
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_wave_stop
+日期：    	2026.10.19
+功能：    	关闭透传数据流,正在进行的透传会被放弃
+输入参数：		数据流
+返回值： 		无
+修改记录：
+**********************************************************/
+void tjc_wave_stop(TJC_Wave_t* wave)
+{
+	if(wave->hmi != NULL && wave->State != TJC_WAVE_IDLE)
+	{
+		tjc_tx_release(wave->hmi);
+	}
+	wave->Enable = 0;
+	wave->State = TJC_WAVE_IDLE;
+	if(wave->hmi != NULL && wave->hmi->wave == wave)
+	{
+		wave->hmi->wave = NULL;
+	}
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_wave_free
+日期：    	2026.10.19
+功能：    	查询通道采样缓存的剩余空间
+输入参数：		数据流,通道号
+返回值： 		还能写入的采样点数
+修改记录：
+**********************************************************/
+uint16_t tjc_wave_free(TJC_Wave_t* wave, uint8_t ch)
+{
+	uint16_t used;
+
+	if(ch >= wave->ChCount)
+	{
+		return 0;
+	}
+	used = (wave->Fifo[ch].Head + TJC_WAVE_FIFO_LEN - wave->Fifo[ch].Tail) % TJC_WAVE_FIFO_LEN;
+	return TJC_WAVE_FIFO_LEN - 1 - used;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_wave_push
+日期：    	2026.10.19
+功能：    	向通道采样缓存写入数据,可在中断中调用
+			缓存满时只写入放得下的部分(背压),由调用者决定丢弃或稍后重试
+输入参数：		数据流,通道号,采样数据(0~255),采样点数
+返回值： 		实际写入的采样点数
+修改记录：
+**********************************************************/
+uint16_t tjc_wave_push(TJC_Wave_t* wave, uint8_t ch, const uint8_t* samples, uint16_t n)
+{
+	uint16_t room = tjc_wave_free(wave, ch);
+	uint16_t head;
+
+	if(n > room)
+	{
+		n = room;
+		wave->Stats.Overruns++;
+	}
+	if(n == 0)
+	{
+		return 0;
+	}
+	head = wave->Fifo[ch].Head;
+	for(uint16_t i = 0; i < n; i++)
+	{
+		wave->Fifo[ch].Data[head] = samples[i];
+		head = (head + 1) % TJC_WAVE_FIFO_LEN;
+	}
+	//数据写完再更新写指针,tjc_wave_poll 读到的数据总是完整的
+	wave->Fifo[ch].Head = head;
+	return n;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_wave_flush
+日期：    	2026.10.19
+功能：    	要求把缓存中不足一块的采样也发出去(例如停止采样时)
+输入参数：		数据流
+返回值： 		无
+修改记录：
+**********************************************************/
+void tjc_wave_flush(TJC_Wave_t* wave)
+{
+	wave->Flush = 1;
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_wave_busy
+日期：    	2026.10.19
+功能：    	查询是否正处于透传过程中
+			透传过程中串口屏只接收原始数据,此时不能发送其他指令
+输入参数：		数据流
+返回值： 		0:空闲,可以发送其他指令 1:透传中
+修改记录：
+**********************************************************/
+uint8_t tjc_wave_busy(TJC_Wave_t* wave)
+{
+	return wave->State != TJC_WAVE_IDLE;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_wave_get_stats
+日期：    	2026.10.19
+功能：    	读取透传统计信息
+输入参数：		数据流,统计信息输出地址
+返回值： 		无
+修改记录：
+**********************************************************/
+void tjc_wave_get_stats(TJC_Wave_t* wave, TJC_WaveStats_t* stats)
+{
+	*stats = wave->Stats;
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_wave_poll
+日期：    	2026.10.19
+功能：    	透传状态机,在主循环中反复调用
+			空闲时轮流挑选攒够一块数据的通道发送 addt,
+			收到0xFE后一次发出整块原始数据,收到0xFD后本块结束
+输入参数：		数据流
+返回值： 		无
+修改记录：
+**********************************************************/
+void tjc_wave_poll(TJC_Wave_t* wave)
+{
+	TJC_Cmd_t cmd;
+	uint16_t used, qty, tail;
+	uint8_t ch;
+
+	if(!wave->Enable)
+	{
+		return;
+	}
+	tjc_tx_retry(wave->hmi);
+
+	switch(wave->State)
+	{
+		case TJC_WAVE_IDLE:
+			for(uint8_t i = 0; i < wave->ChCount; i++)
+			{
+				//从上次发送通道的下一个开始轮询,各通道机会均等
+				ch = (wave->Channel + 1 + i) % wave->ChCount;
+				used = TJC_WAVE_FIFO_LEN - 1 - tjc_wave_free(wave, ch);
+				if(used >= wave->Block || (wave->Flush && used))
+				{
+					qty = (used > wave->Block) ? wave->Block : used;
+					//addt 带 TJC_TX_HOLD 标志,发出后发送队列暂停,直到透传结束
+					tjc_cmd_begin(&cmd);
+					tjc_cmd_str(&cmd, "addt ");
+					tjc_cmd_int(&cmd, wave->Id);
+					tjc_cmd_char(&cmd, ',');
+					tjc_cmd_int(&cmd, ch);
+					tjc_cmd_char(&cmd, ',');
+					tjc_cmd_int(&cmd, qty);
+					wave->Channel = ch;
+					wave->Qty = qty;
+					wave->Ready = 0;
+					wave->Done = 0;
+					wave->Tick = HAL_GetTick();
+					wave->State = TJC_WAVE_WAIT_READY;
+					if(tjc_cmd_push(wave->hmi, &cmd, TJC_LANE_NORMAL, TJC_TX_HOLD))
+					{
+						wave->State = TJC_WAVE_IDLE;
+					}
+					return;
+				}
+			}
+			wave->Flush = 0;
+			break;
+
+		case TJC_WAVE_WAIT_READY:
+			if(wave->Ready)
+			{
+				ch = wave->Channel;
+				tail = wave->Fifo[ch].Tail;
+				for(uint16_t i = 0; i < wave->Qty; i++)
+				{
+					wave->Buffer[i] = wave->Fifo[ch].Data[tail];
+					tail = (tail + 1) % TJC_WAVE_FIFO_LEN;
+				}
+				wave->Fifo[ch].Tail = tail;
+				wave->Tick = HAL_GetTick();
+				wave->State = TJC_WAVE_WAIT_DONE;
+				tjc_tx_stream(wave->hmi, wave->Buffer, wave->Qty);
+			}
+			else if(wave->hmi->txHold && HAL_GetTick() - wave->Tick > TJC_WAVE_TIMEOUT)
+			{
+				//addt 发出后串口屏没有进入透传,数据留在缓存中下次再发
+				//addt 还在队列里排队时不算超时
+				wave->Stats.Timeouts++;
+				wave->State = TJC_WAVE_IDLE;
+				tjc_tx_release(wave->hmi);
+			}
+			break;
+
+		case TJC_WAVE_WAIT_DONE:
+			if(wave->Done)
+			{
+				wave->Stats.Blocks++;
+				wave->Stats.Samples += wave->Qty;
+				wave->State = TJC_WAVE_IDLE;
+			}
+			else if(HAL_GetTick() - wave->Tick > TJC_WAVE_TIMEOUT)
+			{
+				wave->Stats.Timeouts++;
+				wave->State = TJC_WAVE_IDLE;
+				tjc_tx_release(wave->hmi);
+			}
+			break;
+
+		default:
+			wave->State = TJC_WAVE_IDLE;
+			break;
+	}
+	return;
+}
+
+
+
+
+/********************************************************
+函数名：  		tjc_uart_set_baud
+日期：    	2026.10.19
+功能：    	修改单片机串口波特率,并重新开启接收中断
+			等待当前发送完成后才修改,接收中的半帧数据会被丢弃
+输入参数：		串口屏实例,新的波特率
+返回值： 		0:成功 1:串口初始化失败
+修改记录：
+**********************************************************/
+uint8_t tjc_uart_set_baud(TJC_HMI_t* hmi, uint32_t baud)
+{
+	tjc_tx_flush(hmi, TJC_TX_TIMEOUT);
+	HAL_UART_AbortReceive(hmi->huart);
+	hmi->huart->Init.BaudRate = baud;
+	if(HAL_UART_Init(hmi->huart) != HAL_OK)
+	{
+		return 1;
+	}
+	hmi->rxFrame.Length = 0;
+	hmi->rxFrame.FfCount = 0;
+	hmi->txBusy = 0;		//重新初始化后串口一定空闲
+	tjc_get_cancel(hmi);	//旧波特率下的应答不会再到达
+	HAL_UART_Receive_IT(hmi->huart, hmi->RxByte, 1);
+	return 0;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_get_reply
+日期：    	2026.10.19
+功能：    	把一帧 get 应答交给最早的在途请求(串口接收中断中调用)
+			串口屏按指令顺序应答,所以应答总是属于最早发出且未应答的请求;
+			有请求超时后丢弃所有应答,直到读回同步标记
+输入参数：		串口屏实例,收到的完整返回帧
+返回值： 		无
+修改记录：		2026.10.19 超时后按同步标记重新配对,不再把迟到的应答交给下一个请求
+**********************************************************/
+static void tjc_get_reply(TJC_HMI_t* hmi, const TJC_Frame_t* frame)
+{
+	TJC_GetQueue_t* q = &hmi->getQueue;
+	TJC_GetReq_t* req;
+	uint16_t stored, len;
+	int32_t number;
+
+	if(frame->Data[0] == 0x71)
+	{
+		//小端4字节有符号数
+		number = (int32_t)((uint32_t)frame->Data[1] | ((uint32_t)frame->Data[2] << 8) |
+				 ((uint32_t)frame->Data[3] << 16) | ((uint32_t)frame->Data[4] << 24));
+	}
+	else
+	{
+		number = 0;
+	}
+	if(q->Sync != TJC_GET_SYNC_NONE)
+	{
+		if(q->Sync == TJC_GET_SYNC_WAIT && frame->Data[0] == 0x71 && number == q->Mark)
+		{
+			q->Sync = TJC_GET_SYNC_NONE;
+		}
+		return;
+	}
+	if(q->Reply == q->Sent)
+	{
+		return;		//没有在途请求,丢弃
+	}
+	req = &q->Req[q->Reply % TJC_GET_MAX];
+
+	if(frame->Data[0] != req->Type)
+	{
+		req->Result.Status = TJC_GET_ERROR;
+	}
+	else if(frame->Data[0] == 0x71)
+	{
+		req->Result.Number = number;
+		req->Result.Status = TJC_GET_OK;
+	}
+	else
+	{
+		//0x70 + 字符串 + \xff\xff\xff,帧过长时只保存了前 TJC_FRAME_MAX_LEN 字节
+		stored = (frame->Length < TJC_FRAME_MAX_LEN) ? frame->Length : TJC_FRAME_MAX_LEN;
+		len = frame->Length - 4;
+		if(len > stored - 1)
+		{
+			len = stored - 1;
+		}
+		if(len > TJC_GET_STRING_MAX)
+		{
+			len = TJC_GET_STRING_MAX;
+		}
+		memcpy(req->Result.String, &frame->Data[1], len);
+		req->Result.String[len] = '\0';
+		req->Result.Length = len;
+		req->Result.Status = TJC_GET_OK;
+	}
+	q->Reply++;
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_get_sent
+日期：    	2026.10.19
+功能：    	一条 get 指令开始发送,记下发出时刻(tjc_tx_kick 中调用)
+输入参数：		串口屏实例
+返回值： 		无
+修改记录：
+**********************************************************/
+static void tjc_get_sent(TJC_HMI_t* hmi)
+{
+	TJC_GetQueue_t* q = &hmi->getQueue;
+
+	if(q->Sent != q->Tail)
+	{
+		q->Req[q->Sent % TJC_GET_MAX].Tick = HAL_GetTick();
+		q->Sent++;
+	}
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_get_mark
+日期：    	2026.10.19
+功能：    	在 TxBuffer 里生成同步标记 get <Mark>\xff\xff\xff(tjc_tx_kick 中调用)
+			标记之前发出的请求应答可能迟到也可能丢了,一律取消,之后发出的请求在读回标记后照常配对
+输入参数：		串口屏实例
+返回值： 		帧长度
+修改记录：
+**********************************************************/
+static uint16_t tjc_get_mark(TJC_HMI_t* hmi)
+{
+	TJC_GetQueue_t* q = &hmi->getQueue;
+	char digits[10];
+	uint32_t val = (uint32_t)q->Mark;
+	uint16_t len = 4;
+	uint8_t n = 0;
+
+	while(q->Reply != q->Sent)
+	{
+		q->Req[q->Reply % TJC_GET_MAX].Result.Status = TJC_GET_CANCEL;
+		q->Reply++;
+	}
+	q->Sync = TJC_GET_SYNC_WAIT;
+
+	memcpy(hmi->TxBuffer, "get ", 4);
+	do
+	{
+		digits[n++] = '0' + val % 10;
+		val /= 10;
+	}while(val);
+	while(n)
+	{
+		hmi->TxBuffer[len++] = digits[--n];
+	}
+	hmi->TxBuffer[len++] = 0xff;
+	hmi->TxBuffer[len++] = 0xff;
+	hmi->TxBuffer[len++] = 0xff;
+	return len;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_get_async
+日期：    	2026.10.19
+功能：    	发送 get 指令后立即返回,应答到达或超时后在 tjc_get_poll() 中调用回调
+			可以连续提交多个请求(最多 TJC_GET_MAX 个),不必等上一个应答
+			注意:bkcmd 为默认值2时其他指令执行失败也会返回0x1A/0x1B,
+			会被当成最早的 get 请求失败,有 get 在途时应保证其他指令正确
+输入参数：		串口屏实例,变量名(如 "n0.val" "t0.txt"),期望的返回类型(0x70:字符串 0x71:数值),
+				请求标记(原样放进结果),超时时间(ms,从指令真正发出时算起),完成回调,回调参数
+返回值： 		0:已发送 1:在途请求已满或发送通道满 2:参数错误或指令超长
+示例:			tjc_get_async(&tjcDefault, "n0.val", 0x71, CFG_GAIN, 100, on_cfg, NULL);
+				tjc_get_async(&tjcDefault, "t0.txt", 0x70, CFG_NAME, 100, on_cfg, NULL);
+				主循环里 tjc_get_poll(&tjcDefault);
+修改记录：
+**********************************************************/
+uint8_t tjc_get_async(TJC_HMI_t* hmi, const char* name, uint8_t type, uint16_t tag,
+                      uint32_t timeout, TJC_GetCallback_t callback, void* arg)
+{
+	TJC_GetQueue_t* q = &hmi->getQueue;
+	TJC_GetReq_t* req;
+	TJC_Cmd_t cmd;
+
+	if(type != 0x70 && type != 0x71)
+	{
+		return 2;
+	}
+	if((uint8_t)(q->Tail - q->Head) >= TJC_GET_MAX)
+	{
+		return 1;
+	}
+	tjc_cmd_begin(&cmd);
+	tjc_cmd_str(&cmd, "get ");
+	tjc_cmd_str(&cmd, name);
+	if(cmd.Overflow)
+	{
+		return 2;
+	}
+
+	req = &q->Req[q->Tail % TJC_GET_MAX];
+	memset(&req->Result, 0, sizeof(req->Result));
+	req->Result.Tag = tag;
+	req->Callback = callback;
+	req->Arg = arg;
+	req->Type = type;
+	req->Timeout = timeout;
+	req->Tick = HAL_GetTick();
+	//先入队再发送,应答不会早于入队;帧没能放进通道时撤回,发送中断只处理已入队的帧
+	q->Tail++;
+	if(tjc_cmd_push(hmi, &cmd, TJC_LANE_NORMAL, TJC_TX_GET))
+	{
+		q->Tail--;
+		return 1;
+	}
+	return 0;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_get_number_async
+日期：    	2026.10.19
+功能：    	异步读取数值变量,等同于 tjc_get_async(..., 0x71, ...)
+输入参数：		串口屏实例,变量名,请求标记,超时时间(ms),完成回调,回调参数
+返回值： 		同 tjc_get_async
+修改记录：
+**********************************************************/
+uint8_t tjc_get_number_async(TJC_HMI_t* hmi, const char* name, uint16_t tag,
+                             uint32_t timeout, TJC_GetCallback_t callback, void* arg)
+{
+	return tjc_get_async(hmi, name, 0x71, tag, timeout, callback, arg);
+}
+
+
+
+/********************************************************
+函数名：  		tjc_get_string_async
+日期：    	2026.10.19
+功能：    	异步读取字符串变量,等同于 tjc_get_async(..., 0x70, ...)
+输入参数：		串口屏实例,变量名,请求标记,超时时间(ms),完成回调,回调参数
+返回值： 		同 tjc_get_async
+修改记录：
+**********************************************************/
+uint8_t tjc_get_string_async(TJC_HMI_t* hmi, const char* name, uint16_t tag,
+                             uint32_t timeout, TJC_GetCallback_t callback, void* arg)
+{
+	return tjc_get_async(hmi, name, 0x70, tag, timeout, callback, arg);
+}
+
+
+
+/********************************************************
+函数名：  		tjc_get_pending
+日期：    	2026.10.19
+功能：    	查询还没有调用回调的请求数量(在途 + 已有结果未处理)
+输入参数：		串口屏实例
+返回值： 		请求数量
+修改记录：
+**********************************************************/
+uint8_t tjc_get_pending(TJC_HMI_t* hmi)
+{
+	return (uint8_t)(hmi->getQueue.Tail - hmi->getQueue.Head);
+}
+
+
+
+/********************************************************
+函数名：  		tjc_get_cancel
+日期：    	2026.10.19
+功能：    	取消所有在途请求,回调在下一次 tjc_get_poll() 中以 TJC_GET_CANCEL 调用
+			修改波特率、串口屏复位等应答不会再到达的场合使用
+输入参数：		串口屏实例
+返回值： 		无
+修改记录：
+**********************************************************/
+void tjc_get_cancel(TJC_HMI_t* hmi)
+{
+	TJC_GetQueue_t* q = &hmi->getQueue;
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	while(q->Reply != q->Tail)
+	{
+		q->Req[q->Reply % TJC_GET_MAX].Result.Status = TJC_GET_CANCEL;
+		q->Reply++;
+	}
+	q->Sent = q->Tail;
+	q->Sync = TJC_GET_SYNC_NONE;
+	__set_PRIMASK(primask);
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_get_poll
+日期：    	2026.10.19
+功能：    	处理超时并按提交顺序调用已完成请求的回调,在主循环中反复调用
+			请求超时后发同步标记重新对齐,此前已发出的其他请求以 TJC_GET_CANCEL 结束
+输入参数：		串口屏实例
+返回值： 		无
+修改记录：		2026.10.19 超时从指令发出时算起,超时后按同步标记重新配对
+**********************************************************/
+void tjc_get_poll(TJC_HMI_t* hmi)
+{
+	TJC_GetQueue_t* q = &hmi->getQueue;
+	TJC_GetReq_t* req;
+	TJC_GetResult_t result;
+	uint32_t primask;
+
+	tjc_tx_retry(hmi);
+	//只需检查最早发出的请求,还在发送队列里的不计时
+	primask = __get_PRIMASK();
+	__disable_irq();
+	if(q->Reply != q->Sent)
+	{
+		req = &q->Req[q->Reply % TJC_GET_MAX];
+		if(HAL_GetTick() - req->Tick > req->Timeout)
+		{
+			req->Result.Status = TJC_GET_TIMEOUT;
+			q->Reply++;
+			//上一个标记没读回就再次超时,换一个新标记,旧标记的应答也一起丢弃
+			q->Mark = TJC_GET_MARK + (uint16_t)(q->Mark + 1);
+			q->Sync = TJC_GET_SYNC_WANT;
+			tjc_tx_kick(hmi);
+		}
+	}
+	__set_PRIMASK(primask);
+
+	while(q->Head != q->Reply)
+	{
+		//先取出结果再释放位置,回调里可以马上提交新请求
+		req = &q->Req[q->Head % TJC_GET_MAX];
+		result = req->Result;
+		q->Head++;
+		if(req->Callback != NULL)
+		{
+			req->Callback(hmi, &result, req->Arg);
+		}
+	}
+	return;
+}
+
+
+
+typedef struct
+{
+    uint8_t Done;
+    TJC_GetResult_t Result;
+}TJC_GetWait_t;
+
+static void tjc_get_wait_callback(TJC_HMI_t* hmi, const TJC_GetResult_t* result, void* arg)
+{
+	TJC_GetWait_t* wait = (TJC_GetWait_t*)arg;
+
+	(void)hmi;
+	wait->Result = *result;
+	wait->Done = 1;
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_get_wait
+日期：    	2026.10.19
+功能：    	提交一个 get 请求并阻塞等待其完成,等待期间其他请求的回调照常调用
+			请求自己的超时从指令发出时算起,发送卡住或排在大量 addt 数据后面时可能迟迟不开始计时,
+			这里另从提交时算起,到时仍未完成就放弃等待;请求留在队列里照常完成,只是不再回调
+输入参数：		串口屏实例,变量名,期望的返回类型,结果输出地址,超时时间(ms)
+返回值： 		0:成功 1:超时、出错或在途请求已满
+修改记录：		2026.10.19 等待时间从提交时算起
+**********************************************************/
+static uint8_t tjc_get_wait(TJC_HMI_t* hmi, const char* name, uint8_t type,
+                            TJC_GetWait_t* wait, uint32_t timeout)
+{
+	TJC_GetQueue_t* q = &hmi->getQueue;
+	uint32_t start = HAL_GetTick();
+	uint32_t primask;
+
+	wait->Done = 0;
+	if(tjc_get_async(hmi, name, type, 0, timeout, tjc_get_wait_callback, wait))
+	{
+		return 1;
+	}
+	while(!wait->Done)
+	{
+		tjc_get_poll(hmi);
+		if(!wait->Done && HAL_GetTick() - start > timeout)
+		{
+			//wait 在调用者的栈上,返回前摘掉回调
+			primask = __get_PRIMASK();
+			__disable_irq();
+			for(uint8_t i = q->Head; i != q->Tail; i++)
+			{
+				if(q->Req[i % TJC_GET_MAX].Arg == wait)
+				{
+					q->Req[i % TJC_GET_MAX].Callback = NULL;
+				}
+			}
+			__set_PRIMASK(primask);
+			return 1;
+		}
+	}
+	return wait->Result.Status != TJC_GET_OK;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_get_number
+日期：    	2026.10.19
+功能：    	发送 get 指令读取串口屏的数值变量,阻塞等待0x71返回
+输入参数：		串口屏实例,变量名(如 "n0.val" "baud"),结果输出地址,超时时间(ms)
+返回值： 		0:成功 1:超时或出错
+示例:			tjc_get_number(&tjcDefault, "n0.val", &val, 100); 发出的数据就是 get n0.val
+修改记录：		2026.10.19 改为基于 get 请求队列,可与异步请求混用
+**********************************************************/
+uint8_t tjc_get_number(TJC_HMI_t* hmi, const char* name, int32_t* val, uint32_t timeout)
+{
+	TJC_GetWait_t wait;
+
+	if(tjc_get_wait(hmi, name, 0x71, &wait, timeout))
+	{
+		return 1;
+	}
+	*val = wait.Result.Number;
+	return 0;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_get_string
+日期：    	2026.10.19
+功能：    	发送 get 指令读取串口屏的字符串变量,阻塞等待0x70返回
+输入参数：		串口屏实例,变量名(如 "t0.txt"),结果输出地址,输出缓冲区大小,超时时间(ms)
+返回值： 		0:成功 1:超时或出错
+修改记录：
+**********************************************************/
+uint8_t tjc_get_string(TJC_HMI_t* hmi, const char* name, char* str, uint16_t size, uint32_t timeout)
+{
+	TJC_GetWait_t wait;
+	uint16_t len;
+
+	if(size == 0 || tjc_get_wait(hmi, name, 0x70, &wait, timeout))
+	{
+		return 1;
+	}
+	len = (wait.Result.Length < size - 1) ? wait.Result.Length : size - 1;
+	memcpy(str, wait.Result.String, len);
+	str[len] = '\0';
+	return 0;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_baud_probe
+日期：    	2026.10.19
+功能：    	在指定波特率下确认串口屏能正常应答
+输入参数：		串口屏实例,波特率
+返回值： 		1:串口屏在该波特率下应答正确 0:无应答
+修改记录：
+**********************************************************/
+static uint8_t tjc_baud_probe(TJC_HMI_t* hmi, uint32_t baud)
+{
+	const uint8_t clear[3] = {0xff, 0xff, 0xff};
+	int32_t val;
+
+	if(tjc_uart_set_baud(hmi, baud))
+	{
+		return 0;
+	}
+	//先发一次结束符,让串口屏丢弃之前收到的残缺指令
+	tjc_uart_send(hmi, clear, sizeof(clear));
+	if(tjc_get_number(hmi, "baud", &val, TJC_BAUD_PROBE_TIMEOUT))
+	{
+		return 0;
+	}
+	return (uint32_t)val == baud;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_baud_negotiate
+日期：    	2026.10.19
+功能：    	上电后把串口屏和单片机的波特率一起提到目标值
+			1.先在当前配置的波特率下确认链路,不通则依次探测串口屏支持的波特率
+			2.发送 baud=目标值(掉电不保存),单片机切换到目标值后用 get baud 校验
+			3.校验失败则回退到原波特率
+输入参数：		串口屏实例,目标波特率(串口屏最高支持921600)
+返回值： 		协商后实际使用的波特率,0表示找不到串口屏
+示例:			在 tjc_hmi_init() 或 HAL_UART_Receive_IT(&TJC_UART, RxBuffer, 1) 之后调用
+				tjc_baud_negotiate(&tjcDefault, 921600);
+修改记录：
+**********************************************************/
+uint32_t tjc_baud_negotiate(TJC_HMI_t* hmi, uint32_t target)
+{
+	static const uint32_t baudList[] = {9600, 115200, 921600, 512000, 256000, 250000,
+										230400, 57600, 38400, 31250, 19200, 4800, 2400};
+	uint32_t current = hmi->huart->Init.BaudRate;
+	TJC_Cmd_t cmd;
+
+	if(!tjc_baud_probe(hmi, current))
+	{
+		current = 0;
+		for(uint8_t i = 0; i < sizeof(baudList) / sizeof(baudList[0]); i++)
+		{
+			if(tjc_baud_probe(hmi, baudList[i]))
+			{
+				current = baudList[i];
+				break;
+			}
+		}
+		if(current == 0)
+		{
+			return 0;
+		}
+	}
+
+	if(target != current)
+	{
+		tjc_cmd_begin(&cmd);
+		tjc_cmd_str(&cmd, "baud=");
+		tjc_cmd_int(&cmd, (int32_t)target);
+		tjc_cmd_send(hmi, &cmd);
+		tjc_tx_flush(hmi, TJC_TX_TIMEOUT);
+		HAL_Delay(TJC_BAUD_SWITCH_DELAY);
+
+		if(tjc_baud_probe(hmi, target))
+		{
+			current = target;
+		}
+		else if(!tjc_baud_probe(hmi, current))
+		{
+			//串口屏已切到目标波特率但链路不稳定,在目标波特率下把它切回去
+			tjc_uart_set_baud(hmi, target);
+			tjc_cmd_begin(&cmd);
+			tjc_cmd_str(&cmd, "baud=");
+			tjc_cmd_int(&cmd, (int32_t)current);
+			tjc_cmd_send(hmi, &cmd);
+			tjc_tx_flush(hmi, TJC_TX_TIMEOUT);
+			HAL_Delay(TJC_BAUD_SWITCH_DELAY);
+			if(!tjc_baud_probe(hmi, current))
+			{
+				return 0;
+			}
+		}
+	}
+
+	//丢弃协商过程中收到的应答,不影响用户的解析
+	tjc_hmi_rx_clear(hmi);
+	return current;
+}
+
+
+
+
+/********************************************************
+函数名：  		tjc_sync_init
+日期：    	2026.10.19
+功能：    	初始化变量同步,按顺序把字段打包进32位的变量字
+			一个字放不下当前字段时换下一个字,字段不跨字
+输入参数：		同步对象,串口屏实例,字段表,字段数(不超过TJC_SYNC_FIELD_MAX),
+				变量字名字表(如 "sys2" "va0.val"),变量字个数
+返回值： 		0:成功 1:字段数或位宽不合法 2:变量字不够用
+示例:			typedef struct { uint16_t volt; uint16_t curr; uint8_t mode; int32_t power; } Meter_t;
+				static const TJC_SyncField_t fields[] = {
+					TJC_SYNC_FIELD(Meter_t, volt, 16, "n0.val"),
+					TJC_SYNC_FIELD(Meter_t, curr, 16, "n1.val"),
+					TJC_SYNC_FIELD(Meter_t, mode, 8, "bt0.val"),
+					TJC_SYNC_FIELD(Meter_t, power, 32, "x0.val"),
+				};
+				static const char* const slots[] = {"sys2", "va0.val", "va1.val"};
+				tjc_sync_init(&sync, &tjcDefault, fields, 4, slots, 3);
+				定时调用 tjc_sync_update(&sync, &meter);
+修改记录：
+**********************************************************/
+uint8_t tjc_sync_init(TJC_Sync_t* sync, TJC_HMI_t* hmi, const TJC_SyncField_t* fields, uint8_t field_count,
+                      const char* const* slots, uint8_t slot_count)
+{
+	uint8_t slot = 0, shift = 0;
+
+	if(field_count == 0 || field_count > TJC_SYNC_FIELD_MAX)
+	{
+		return 1;
+	}
+	memset(sync, 0, sizeof(TJC_Sync_t));
+	for(uint8_t i = 0; i < field_count; i++)
+	{
+		if(fields[i].Bits == 0 || fields[i].Bits > 32)
+		{
+			return 1;
+		}
+		if(shift + fields[i].Bits > 32)
+		{
+			slot++;
+			shift = 0;
+		}
+		if(slot >= slot_count)
+		{
+			return 2;
+		}
+		sync->FieldSlot[i] = slot;
+		sync->FieldShift[i] = shift;
+		shift += fields[i].Bits;
+	}
+	sync->hmi = hmi;
+	sync->Fields = fields;
+	sync->FieldCount = field_count;
+	sync->Slots = slots;
+	sync->SlotCount = slot + 1;
+	sync->Settle = TJC_SYNC_SETTLE;
+	sync->PackedAt = HAL_GetTick() - TJC_SYNC_SETTLE;
+	sync->Force = 1;
+	return 0;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_sync_force
+日期：    	2026.10.19
+功能：    	下次 tjc_sync_update 时发送全部字段(串口屏复位、切换页面后调用)
+输入参数：		同步对象
+返回值： 		无
+修改记录：
+**********************************************************/
+void tjc_sync_force(TJC_Sync_t* sync)
+{
+	sync->Force = 1;
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_sync_read
+日期：    	2026.10.19
+功能：    	从结构体中读出字段值,截到打包位宽
+			8/16位字段按无符号处理,有符号数请用 int32_t 字段并按32位打包
+输入参数：		字段描述,结构体首地址
+返回值： 		字段值
+修改记录：
+**********************************************************/
+static uint32_t tjc_sync_read(const TJC_SyncField_t* field, const void* data)
+{
+	const uint8_t* p = (const uint8_t*)data + field->Offset;
+	uint16_t val16;
+	uint32_t val;
+
+	switch(field->Size)
+	{
+		case 1:
+			val = *p;
+			break;
+		case 2:
+			memcpy(&val16, p, 2);
+			val = val16;
+			break;
+		case 4:
+			memcpy(&val, p, 4);
+			break;
+		default:
+			val = 0;
+			break;
+	}
+	if(field->Bits < 32)
+	{
+		val &= (1UL << field->Bits) - 1;
+	}
+	return val;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_sync_append
+日期：    	2026.10.19
+功能：    	把一条指令加上结束符拼进本次的发送数据,放不下时先发出已拼好的部分
+输入参数：		同步对象,拼接缓冲区,已拼长度,指令
+返回值： 		0:成功 1:先发出的部分没能放进发送队列
+修改记录：
+**********************************************************/
+static uint8_t tjc_sync_append(TJC_Sync_t* sync, uint8_t* burst, uint16_t* len, const TJC_Cmd_t* cmd)
+{
+	uint8_t lost = 0;
+
+	if(*len + cmd->Length + 3 > TJC_CMD_MAX_LEN)
+	{
+		lost = tjc_uart_send_lane(sync->hmi, TJC_LANE_NORMAL, burst, *len);
+		if(!lost)
+		{
+			sync->Stats.Bytes += *len;
+		}
+		*len = 0;
+	}
+	memcpy(&burst[*len], cmd->Buffer, cmd->Length);
+	*len += cmd->Length;
+	burst[(*len)++] = 0xff;
+	burst[(*len)++] = 0xff;
+	burst[(*len)++] = 0xff;
+	return lost;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_sync_word
+日期：    	2026.10.19
+功能：    	生成一个变量字的赋值指令 "va0.val=打包值"
+输入参数：		同步对象,变量字序号,指令输出地址
+返回值： 		无
+修改记录：
+**********************************************************/
+static void tjc_sync_word(TJC_Sync_t* sync, uint8_t slot, TJC_Cmd_t* cmd)
+{
+	uint32_t word = 0;
+
+	for(uint8_t i = 0; i < sync->FieldCount; i++)
+	{
+		if(sync->FieldSlot[i] == slot)
+		{
+			word |= sync->Last[i] << sync->FieldShift[i];
+		}
+	}
+	tjc_cmd_begin(cmd);
+	tjc_cmd_str(cmd, sync->Slots[slot]);
+	tjc_cmd_char(cmd, '=');
+	tjc_cmd_int(cmd, (int32_t)word);
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_sync_flag
+日期：    	2026.10.19
+功能：    	生成位图指令,定时器可能还没处理完上次的位图时用或运算保留未处理的位
+输入参数：		同步对象,变化位图,上次位图是否已处理,指令输出地址
+返回值： 		无
+修改记录：
+**********************************************************/
+static void tjc_sync_flag(uint32_t changed, uint8_t settled, TJC_Cmd_t* cmd)
+{
+	tjc_cmd_begin(cmd);
+	tjc_cmd_str(cmd, settled ? TJC_SYNC_FLAG "=" : TJC_SYNC_FLAG "=" TJC_SYNC_FLAG "|");
+	tjc_cmd_int(cmd, (int32_t)changed);
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_sync_field
+日期：    	2026.10.19
+功能：    	生成直接给控件赋值的指令 "n0.val=值",值和定时器脚本拆出来的一致(截短的字段为无符号)
+输入参数：		同步对象,字段序号,指令输出地址
+返回值： 		无
+修改记录：
+**********************************************************/
+static void tjc_sync_field(TJC_Sync_t* sync, uint8_t field, TJC_Cmd_t* cmd)
+{
+	tjc_cmd_begin(cmd);
+	tjc_cmd_str(cmd, sync->Fields[field].Target);
+	tjc_cmd_char(cmd, '=');
+	tjc_cmd_int(cmd, (int32_t)sync->Last[field]);
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_sync_update
+日期：    	2026.10.19
+功能：    	比较结构体和上次发送的值,只发送变化的字段,全部拼成一次发送
+			一般发送变化字段所在的变量字,最后把变化位图写进 TJC_SYNC_FLAG,
+			串口屏定时器按位图把变量字拆到控件上(脚本由 tjc_sync_script 生成);
+			只有零星字段变化、直接 "控件=值" 更短时改为直接赋值,
+			但距上次打包发送不足 Settle 毫秒时不直接赋值,免得被定时器用旧的变量字覆盖;
+			发送队列放不下时 Last[] 已经更新,置 Force 下次全部重发
+输入参数：		同步对象,结构体首地址
+返回值： 		本次发出的变化字段位图,0表示没有变化或没能发送
+修改记录：
+**********************************************************/
+uint32_t tjc_sync_update(TJC_Sync_t* sync, const void* data)
+{
+	uint8_t burst[TJC_CMD_MAX_LEN];
+	uint16_t len = 0, packed = 0, plain = 0;
+	uint32_t changed = 0, slots = 0, val;
+	uint32_t now = HAL_GetTick();
+	uint8_t settled = (now - sync->PackedAt >= sync->Settle);
+	uint8_t lost = 0;
+	TJC_Cmd_t cmd;
+
+	for(uint8_t i = 0; i < sync->FieldCount; i++)
+	{
+		val = tjc_sync_read(&sync->Fields[i], data);
+		if(sync->Force || val != sync->Last[i])
+		{
+			sync->Last[i] = val;
+			changed |= 1UL << i;
+			slots |= 1UL << sync->FieldSlot[i];
+			tjc_sync_field(sync, i, &cmd);
+			plain += cmd.Length + 3;
+		}
+	}
+	sync->Force = 0;
+	sync->Stats.Updates++;
+	if(changed == 0)
+	{
+		return 0;
+	}
+	sync->Stats.PlainBytes += plain;
+
+	for(uint8_t s = 0; s < sync->SlotCount; s++)
+	{
+		if(slots & (1UL << s))
+		{
+			tjc_sync_word(sync, s, &cmd);
+			packed += cmd.Length + 3;
+		}
+	}
+	tjc_sync_flag(changed, settled, &cmd);
+	packed += cmd.Length + 3;
+
+	if(settled && plain <= packed)
+	{
+		for(uint8_t i = 0; i < sync->FieldCount; i++)
+		{
+			if(changed & (1UL << i))
+			{
+				tjc_sync_field(sync, i, &cmd);
+				lost |= tjc_sync_append(sync, burst, &len, &cmd);
+			}
+		}
+		sync->Stats.Direct++;
+	}
+	else
+	{
+		for(uint8_t s = 0; s < sync->SlotCount; s++)
+		{
+			if(slots & (1UL << s))
+			{
+				tjc_sync_word(sync, s, &cmd);
+				lost |= tjc_sync_append(sync, burst, &len, &cmd);
+			}
+		}
+		//位图最后发,串口屏看到位图时变量字一定已经更新
+		tjc_sync_flag(changed, settled, &cmd);
+		lost |= tjc_sync_append(sync, burst, &len, &cmd);
+		sync->PackedAt = now;
+		sync->Stats.Bursts++;
+	}
+	lost |= tjc_uart_send_lane(sync->hmi, TJC_LANE_NORMAL, burst, len);
+	if(lost)
+	{
+		sync->Force = 1;
+		sync->Stats.Drops++;
+		return 0;
+	}
+
+	sync->Stats.Bytes += len;
+	for(uint32_t bits = changed; bits; bits &= bits - 1)
+	{
+		sync->Stats.Fields++;
+	}
+	return changed;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_sync_script
+日期：    	2026.10.19
+功能：    	生成串口屏定时器事件脚本,复制到定时器控件(如 tm0,tim=50,en=1)的定时事件中
+			串口屏的运算从左到右依次计算,脚本里的表达式都按这个规则书写
+输入参数：		同步对象,输出缓冲区,缓冲区大小
+返回值： 		脚本长度,0表示缓冲区不够
+示例:			char script[1024];
+				if(tjc_sync_script(&sync, script, sizeof(script))) printf("%s", script);
+修改记录：
+**********************************************************/
+uint16_t tjc_sync_script(TJC_Sync_t* sync, char* buf, uint16_t size)
+{
+	const TJC_SyncField_t* field;
+	uint16_t len;
+	int n;
+
+	n = snprintf(buf, size, "if(" TJC_SYNC_FLAG "!=0)\r\n{\r\n");
+	len = (n > 0) ? (uint16_t)n : size;
+	for(uint8_t i = 0; i < sync->FieldCount && len < size; i++)
+	{
+		field = &sync->Fields[i];
+		n = snprintf(buf + len, size - len, "  " TJC_SYNC_TEMP "=" TJC_SYNC_FLAG "&%lu\r\n  if(" TJC_SYNC_TEMP "!=0)\r\n  {\r\n    %s=%s",
+					 1UL << i, field->Target, sync->Slots[sync->FieldSlot[i]]);
+		len = (n > 0 && len + n < size) ? len + (uint16_t)n : size;
+		if(len < size && sync->FieldShift[i])
+		{
+			n = snprintf(buf + len, size - len, ">>%u", sync->FieldShift[i]);
+			len = (n > 0 && len + n < size) ? len + (uint16_t)n : size;
+		}
+		if(len < size && field->Bits < 32)
+		{
+			n = snprintf(buf + len, size - len, "&%lu", (1UL << field->Bits) - 1);
+			len = (n > 0 && len + n < size) ? len + (uint16_t)n : size;
+		}
+		if(len < size)
+		{
+			n = snprintf(buf + len, size - len, "\r\n  }\r\n");
+			len = (n > 0 && len + n < size) ? len + (uint16_t)n : size;
+		}
+	}
+	if(len < size)
+	{
+		n = snprintf(buf + len, size - len, "  " TJC_SYNC_FLAG "=0\r\n}\r\n");
+		len = (n > 0 && len + n < size) ? len + (uint16_t)n : size;
+	}
+	return (len < size) ? len : 0;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_sync_get_stats
+日期：    	2026.10.19
+功能：    	读取变量同步统计,PlainBytes/Bytes 即比逐条赋值节省的倍数
+输入参数：		同步对象,统计信息输出地址
+返回值： 		无
+修改记录：
+**********************************************************/
+void tjc_sync_get_stats(TJC_Sync_t* sync, TJC_SyncStats_t* stats)
+{
+	*stats = sync->Stats;
+	return;
+}
@@ -0,0 +1,398 @@
+#ifndef __TJCUSARTHMI_H__
+#define __TJCUSARTHMI_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+	打印到屏幕串口
+*/
+
+
+
+//默认实例使用的串口,旧接口(tjc_send_string、usize、u(x)等)都作用在默认实例上
+//默认与原来的两份驱动相同:F1系列 huart2,F4系列 huart1(STM32F1/STM32F4 由HAL头文件定义);
+//接在其他串口时在编译选项里定义(如 -DTJC_UART=huart3)或写在 main.h 里,
+//只在包含本文件前定义对 tjc_usart_hmi.c 不起作用
+#ifndef TJC_UART
+#if defined(STM32F1)
+#define TJC_UART huart2
+#elif defined(STM32F4) || defined(TJC_HOST)
+#define TJC_UART huart1
+#else
+#error "tjc_usart_hmi: 请定义 TJC_UART(默认实例使用的串口句柄),并在本文件之前包含HAL头文件"
+#endif
+#endif
+
+//1:驱动自己定义 HAL_UART_RxCpltCallback/HAL_UART_TxCpltCallback/HAL_UART_ErrorCallback
+//0:工程里还有其他串口要用这些回调时置0,在自己的回调里调用 tjc_hmi_rx_handler/tjc_hmi_tx_handler/tjc_hmi_error_handler
+#ifndef TJC_DEFINE_HAL_CALLBACK
+#define TJC_DEFINE_HAL_CALLBACK	(1)
+#endif
+
+#define TJC_HMI_MAX		(4)       //最多同时挂接的串口屏数量(含默认实例)
+#define TJC_CMD_MAX_LEN	(260)     //单条指令最大字节数,255字节数据+3字节结束符
+
+#define TJC_TX_LANES		(2)     //发送通道数,通道号越小越优先
+#define TJC_TX_LANE_LEN		(512)   //每个通道的排队字节数(每帧另占 TJC_TX_HEAD_LEN 字节帧头)
+#define TJC_TX_HEAD_LEN		(6)     //帧头:2字节长度和标志 + 4字节入队时刻
+#define TJC_TX_TIMEOUT		(100)   //通道满时等待的最长时间,超时丢弃该帧,单位ms
+#define TJC_TX_HOLD			(0x01)  //帧标志:发出后暂停队列,直到透传结束(addt用)
+#define TJC_TX_GET			(0x02)  //帧标志:get 请求,真正发出时才开始计超时
+
+#define TJC_LANE_URGENT		(0)     //紧急通道:报警、状态切换等
+#define TJC_LANE_NORMAL		(1)     //普通通道:旧接口、曲线数据、长文本
+
+#if (TJC_TX_LANE_LEN < TJC_CMD_MAX_LEN + TJC_TX_HEAD_LEN)
+#error "TJC_TX_LANE_LEN 至少要放得下一条最长的指令"
+#endif
+
+extern UART_HandleTypeDef TJC_UART;
+
+
+
+#define RINGBUFFER_LEN	(500)     //定义最大接收字节数 500
+#define TJC_FRAME_MAX_LEN	(64)  //返回帧最大保存字节数,超出部分丢弃
+
+#define TJC_WAVE_MAX_CH		(4)     //曲线控件最多4个通道
+#define TJC_WAVE_FIFO_LEN	(512)   //每个通道的采样缓存字节数
+#define TJC_WAVE_BLOCK_MAX	(255)   //单次透传最大字节数,不超过 TJC_CMD_MAX_LEN
+#define TJC_WAVE_TIMEOUT	(100)   //等待0xFE/0xFD的超时时间,单位ms
+
+#define TJC_BAUD_PROBE_TIMEOUT	(100)   //探测波特率时等待 get baud 应答的时间,单位ms
+#define TJC_BAUD_SWITCH_DELAY	(50)    //发送 baud= 后等待串口屏切换的时间,单位ms
+
+#define TJC_GET_MAX			(8)     //每块屏同时在途的 get 请求数,必须是2的幂且不超过128
+#define TJC_GET_STRING_MAX	(32)    //0x70字符串返回保存的最大字节数,超出部分截断
+#define TJC_GET_MARK		(0x54A70000)    //超时后重新对齐用的 get 常数,低16位每次加1
+
+#define TJC_SYNC_FIELD_MAX	(31)    //变量同步最多字段数,位图放在一个int32里,不用符号位
+#ifndef TJC_SYNC_FLAG
+#define TJC_SYNC_FLAG		"sys0"  //串口屏上存放变化位图的全局变量
+#endif
+#ifndef TJC_SYNC_SETTLE
+#define TJC_SYNC_SETTLE		(100)   //打包发送后多久定时器一定处理完位图,ms,取定时器周期的2倍
+#endif
+#ifndef TJC_SYNC_TEMP
+#define TJC_SYNC_TEMP		"sys1"  //定时器脚本里的临时变量
+#endif
+
+#if (TJC_GET_MAX & (TJC_GET_MAX - 1)) || (TJC_GET_MAX > 128)
+#error "TJC_GET_MAX 必须是2的幂且不超过128"
+#endif
+
+
+
+typedef struct
+{
+    uint16_t Head;
+    uint16_t Tail;
+    uint16_t Length;
+    uint8_t  Ring_data[RINGBUFFER_LEN];
+}RingBuffer_t;
+
+typedef struct
+{
+    uint8_t  Data[TJC_FRAME_MAX_LEN];
+    uint16_t Length;
+    uint8_t  FfCount;	//连续0xff的个数,满3个为一帧结束
+}TJC_Frame_t;
+
+typedef struct TJC_Wave_s TJC_Wave_t;
+typedef struct TJC_HMI_s TJC_HMI_t;
+
+typedef struct
+{
+    uint32_t Frames;		//已发出的帧数
+    uint32_t Drops;			//通道满等待超时丢弃的帧数
+    uint16_t Depth;			//当前排队字节数(含帧头)
+    uint16_t MaxDepth;		//排队字节数峰值
+    uint32_t WaitSum;		//帧从入队到开始发送的等待时间累计,单位ms
+    uint32_t WaitMax;		//最长等待时间,单位ms
+}TJC_TxLaneStats_t;
+
+//一个发送通道,按帧存放待发送的指令
+typedef struct
+{
+    uint8_t  Data[TJC_TX_LANE_LEN];
+    volatile uint16_t Head;
+    volatile uint16_t Tail;
+    volatile uint16_t Used;
+    TJC_TxLaneStats_t Stats;
+}TJC_TxLane_t;
+
+typedef enum
+{
+    TJC_GET_OK = 0,			//收到期望类型的返回
+    TJC_GET_TIMEOUT,		//超时未收到返回
+    TJC_GET_ERROR,			//串口屏返回变量名无效(0x1A)/变量操作无效(0x1B),或返回类型不符
+    TJC_GET_CANCEL,			//修改波特率等操作取消了在途请求
+}TJC_GetStatus_t;
+
+typedef struct
+{
+    TJC_GetStatus_t Status;
+    uint16_t Tag;			//提交请求时传入的标记,用于区分是哪一个请求
+    int32_t  Number;		//0x71返回的数值
+    uint16_t Length;		//0x70返回的字符串长度(截断后)
+    char     String[TJC_GET_STRING_MAX + 1];
+}TJC_GetResult_t;
+
+//请求完成回调,在 tjc_get_poll() 中(主循环)调用,回调里可以继续发送指令或提交请求
+typedef void (*TJC_GetCallback_t)(TJC_HMI_t* hmi, const TJC_GetResult_t* result, void* arg);
+
+typedef struct
+{
+    TJC_GetCallback_t Callback;
+    void*    Arg;
+    uint32_t Tick;			//指令真正发出的时刻,超时从这里算起
+    uint32_t Timeout;
+    uint8_t  Type;			//期望的返回类型 0x70:字符串 0x71:数值
+    TJC_GetResult_t Result;
+}TJC_GetReq_t;
+
+typedef enum
+{
+    TJC_GET_SYNC_NONE = 0,	//应答按顺序与请求配对
+    TJC_GET_SYNC_WANT,		//有请求超时,丢弃应答,串口空闲时发出同步标记
+    TJC_GET_SYNC_WAIT,		//同步标记已发出,丢弃应答直到读回标记
+}TJC_GetSync_t;
+
+//get 请求队列,串口屏按发送顺序应答,返回帧按先进先出与请求配对
+//Head~Reply:已有结果等待回调 Reply~Sent:已发出等待应答 Sent~Tail:还在发送队列里,四个下标自由递增
+//请求超时后它的应答可能迟到,也可能丢了,无法再按个数配对:
+//超时时取消标记之前发出的请求,发一条 get <Mark>,丢弃所有应答直到读回 Mark,之后的请求照常配对
+typedef struct
+{
+    TJC_GetReq_t Req[TJC_GET_MAX];
+    uint8_t  Head;
+    volatile uint8_t Reply;
+    volatile uint8_t Sent;
+    volatile uint8_t Tail;
+    volatile uint8_t Sync;	//TJC_GetSync_t
+    int32_t  Mark;			//同步标记的数值
+}TJC_GetQueue_t;
+
+//一块串口屏的全部状态,每块屏定义一个(全局或静态变量)
+struct TJC_HMI_s
+{
+    UART_HandleTypeDef* huart;
+    uint8_t  RxByte[1];						//中断接收的1字节
+    RingBuffer_t ringBuffer;				//接收环形缓冲区
+    TJC_Frame_t  rxFrame;					//正在接收的返回帧
+    TJC_GetQueue_t getQueue;				//在途的 get 请求
+    TJC_Wave_t* wave;						//曲线透传数据流,未开启时为空
+    TJC_TxLane_t txLane[TJC_TX_LANES];		//发送队列,每个优先级一个通道
+    volatile uint8_t txBusy;				//串口正在发送
+    volatile uint8_t txHold;				//addt 已发出,透传结束前只发原始数据
+    volatile uint8_t txOpen;				//上一帧不完整时为其通道号+1,下一帧必须从同一通道取
+    volatile uint8_t txFfRun;				//通道已发出数据末尾连续0xff的个数(到3为止),可以跨帧
+    const uint8_t* volatile txStream;		//待发送的透传原始数据
+    volatile uint16_t txStreamLen;
+    const uint8_t* volatile txRetry;		//启动发送失败(HAL_BUSY/HAL_ERROR)待重发的数据
+    volatile uint16_t txRetryLen;
+    volatile uint32_t txErrors;				//启动发送失败的次数
+    uint8_t  TxBuffer[TJC_CMD_MAX_LEN];		//正在发送的帧,中断/DMA发送期间必须保持有效
+};
+
+typedef struct
+{
+    uint16_t Length;
+    uint8_t  Overflow;	//指令超长或分段发送失败标志,置位后 tjc_cmd_send 不发送
+    uint8_t  Lane;		//分段发送的通道
+    uint16_t Chunks;	//已分段发出的次数
+    TJC_HMI_t* Hmi;		//不为空时超长指令分段发送,见 tjc_cmd_begin_chunked
+    char     Buffer[TJC_CMD_MAX_LEN];
+}TJC_Cmd_t;
+
+typedef struct
+{
+    uint32_t Blocks;		//完成的透传次数
+    uint32_t Samples;		//已发送的采样点数
+    uint32_t Timeouts;		//等待0xFE/0xFD超时次数
+    uint32_t Overruns;		//缓存满导致写入不完整的次数
+}TJC_WaveStats_t;
+
+typedef struct
+{
+    volatile uint16_t Head;
+    volatile uint16_t Tail;
+    uint8_t  Data[TJC_WAVE_FIFO_LEN];
+}TJC_WaveFifo_t;
+
+typedef enum
+{
+    TJC_WAVE_IDLE = 0,		//空闲,等待某个通道攒够一块数据
+    TJC_WAVE_WAIT_READY,	//已发送addt,等待0xFE
+    TJC_WAVE_WAIT_DONE,		//已发送原始数据,等待0xFD
+}TJC_WaveState_t;
+
+//曲线透传数据流,需要透传的串口屏才定义
+struct TJC_Wave_s
+{
+    TJC_HMI_t* hmi;
+    uint8_t  Enable;
+    uint8_t  Id;			//曲线控件id
+    uint8_t  ChCount;
+    uint8_t  Channel;		//当前(上次)透传的通道
+    uint16_t Block;			//每次透传的采样点数
+    uint16_t Qty;			//当前透传的字节数
+    uint32_t Tick;			//超时计时起点
+    volatile uint8_t Ready;
+    volatile uint8_t Done;
+    volatile uint8_t Flush;
+    TJC_WaveState_t State;
+    TJC_WaveFifo_t  Fifo[TJC_WAVE_MAX_CH];
+    TJC_WaveStats_t Stats;
+    uint8_t  Buffer[TJC_WAVE_BLOCK_MAX];
+};
+
+//变量同步的一个字段:结构体成员 -> 串口屏控件属性
+typedef struct
+{
+    uint16_t Offset;		//成员在结构体中的偏移
+    uint8_t  Size;			//成员大小,1/2/4字节
+    uint8_t  Bits;			//打包位宽,1~32
+    const char* Target;		//串口屏上显示它的控件属性,如 "n0.val"
+}TJC_SyncField_t;
+
+#define TJC_SYNC_FIELD(type, member, bits, target) \
+    { offsetof(type, member), sizeof(((type*)0)->member), (bits), (target) }
+
+typedef struct
+{
+    uint32_t Updates;		//tjc_sync_update 调用次数
+    uint32_t Bursts;		//打包发送(变量字+位图)的次数
+    uint32_t Direct;		//直接给控件赋值的次数
+    uint32_t Fields;		//发送的变化字段数
+    uint32_t Bytes;			//实际发送的字节数
+    uint32_t PlainBytes;	//同样的变化逐条用 "控件=值" 发送需要的字节数
+    uint32_t Drops;			//发送队列放不下被丢弃的次数,下次全部重发
+}TJC_SyncStats_t;
+
+//变量同步:结构体字段打包进串口屏的全局变量/隐藏变量,只发变化部分和变化位图
+typedef struct
+{
+    TJC_HMI_t* hmi;
+    const TJC_SyncField_t* Fields;
+    const char* const* Slots;				//变量字名字,如 "sys2" "va0.val"
+    uint8_t  FieldCount;
+    uint8_t  SlotCount;						//实际用到的变量字个数
+    uint8_t  Force;							//下次全部发送
+    uint16_t Settle;						//见 TJC_SYNC_SETTLE,初始化后可改
+    uint32_t PackedAt;						//上次打包发送的时刻
+    uint8_t  FieldSlot[TJC_SYNC_FIELD_MAX];	//字段所在的变量字
+    uint8_t  FieldShift[TJC_SYNC_FIELD_MAX];	//字段在变量字中的起始位
+    uint32_t Last[TJC_SYNC_FIELD_MAX];		//上次发送的值
+    TJC_SyncStats_t Stats;
+}TJC_Sync_t;
+
+extern TJC_HMI_t tjcDefault;	//默认实例,串口为 TJC_UART
+
+
+
+/*****************************多实例接口***********************************/
+uint8_t tjc_hmi_init(TJC_HMI_t* hmi, UART_HandleTypeDef* huart);
+void tjc_hmi_deinit(TJC_HMI_t* hmi);
+uint8_t tjc_hmi_rx_handler(UART_HandleTypeDef* huart);
+uint8_t tjc_hmi_tx_handler(UART_HandleTypeDef* huart);
+uint8_t tjc_hmi_error_handler(UART_HandleTypeDef* huart);
+void tjc_uart_rx_other(UART_HandleTypeDef* huart);
+void tjc_uart_tx_other(UART_HandleTypeDef* huart);
+
+void tjc_uart_send(TJC_HMI_t* hmi, const uint8_t* data, uint16_t len);
+uint8_t tjc_uart_send_lane(TJC_HMI_t* hmi, uint8_t lane, const uint8_t* data, uint16_t len);
+uint8_t tjc_tx_idle(TJC_HMI_t* hmi);
+uint8_t tjc_tx_flush(TJC_HMI_t* hmi, uint32_t timeout);
+void tjc_tx_get_stats(TJC_HMI_t* hmi, uint8_t lane, TJC_TxLaneStats_t* stats);
+void tjc_tx_reset_stats(TJC_HMI_t* hmi);
+void tjc_cmd_begin(TJC_Cmd_t* cmd);
+void tjc_cmd_begin_chunked(TJC_Cmd_t* cmd, TJC_HMI_t* hmi, uint8_t lane);
+void tjc_cmd_char(TJC_Cmd_t* cmd, char ch);
+void tjc_cmd_str(TJC_Cmd_t* cmd, const char* str);
+void tjc_cmd_nstr(TJC_Cmd_t* cmd, const char* str, uint16_t len);
+void tjc_cmd_int(TJC_Cmd_t* cmd, int32_t val);
+void tjc_cmd_fixed(TJC_Cmd_t* cmd, int32_t val, uint8_t decimals);
+void tjc_cmd_hex(TJC_Cmd_t* cmd, uint32_t val, uint8_t digits);
+uint8_t tjc_cmd_send(TJC_HMI_t* hmi, TJC_Cmd_t* cmd);
+uint8_t tjc_cmd_send_lane(TJC_HMI_t* hmi, TJC_Cmd_t* cmd, uint8_t lane);
+
+void tjc_hmi_send_string(TJC_HMI_t* hmi, char* str);
+void tjc_hmi_send_txt(TJC_HMI_t* hmi, char* objname, char* attribute, char* txt);
+void tjc_hmi_send_val(TJC_HMI_t* hmi, char* objname, char* attribute, int val);
+void tjc_hmi_send_nstring(TJC_HMI_t* hmi, char* str, unsigned char str_length);
+void tjc_hmi_send_fixed(TJC_HMI_t* hmi, char* objname, char* attribute, int32_t val, uint8_t decimals);
+void tjc_hmi_send_hex(TJC_HMI_t* hmi, char* objname, char* attribute, uint32_t val, uint8_t digits);
+void tjc_hmi_send_color(TJC_HMI_t* hmi, char* objname, char* attribute, uint8_t r, uint8_t g, uint8_t b);
+void tjc_hmi_send_add(TJC_HMI_t* hmi, uint8_t id, uint8_t ch, uint8_t val);
+void tjc_hmi_send_addt(TJC_HMI_t* hmi, uint8_t id, uint8_t ch, uint16_t qty);
+
+void tjc_hmi_rx_clear(TJC_HMI_t* hmi);
+void tjc_hmi_rx_delete(TJC_HMI_t* hmi, uint16_t size);
+uint16_t tjc_hmi_rx_length(TJC_HMI_t* hmi);
+uint8_t tjc_hmi_rx_read(TJC_HMI_t* hmi, uint16_t position);
+
+void tjc_wave_start(TJC_HMI_t* hmi, TJC_Wave_t* wave, uint8_t id, uint8_t ch_count, uint16_t block);
+void tjc_wave_stop(TJC_Wave_t* wave);
+uint16_t tjc_wave_free(TJC_Wave_t* wave, uint8_t ch);
+uint16_t tjc_wave_push(TJC_Wave_t* wave, uint8_t ch, const uint8_t* samples, uint16_t n);
+void tjc_wave_flush(TJC_Wave_t* wave);
+uint8_t tjc_wave_busy(TJC_Wave_t* wave);
+void tjc_wave_get_stats(TJC_Wave_t* wave, TJC_WaveStats_t* stats);
+void tjc_wave_poll(TJC_Wave_t* wave);
+
+uint8_t tjc_uart_set_baud(TJC_HMI_t* hmi, uint32_t baud);
+uint8_t tjc_get_async(TJC_HMI_t* hmi, const char* name, uint8_t type, uint16_t tag,
+                      uint32_t timeout, TJC_GetCallback_t callback, void* arg);
+uint8_t tjc_get_number_async(TJC_HMI_t* hmi, const char* name, uint16_t tag,
+                             uint32_t timeout, TJC_GetCallback_t callback, void* arg);
+uint8_t tjc_get_string_async(TJC_HMI_t* hmi, const char* name, uint16_t tag,
+                             uint32_t timeout, TJC_GetCallback_t callback, void* arg);
+uint8_t tjc_get_pending(TJC_HMI_t* hmi);
+void tjc_get_cancel(TJC_HMI_t* hmi);
+void tjc_get_poll(TJC_HMI_t* hmi);
+uint8_t tjc_get_number(TJC_HMI_t* hmi, const char* name, int32_t* val, uint32_t timeout);
+uint8_t tjc_get_string(TJC_HMI_t* hmi, const char* name, char* str, uint16_t size, uint32_t timeout);
+uint32_t tjc_baud_negotiate(TJC_HMI_t* hmi, uint32_t target);
+
+uint8_t tjc_sync_init(TJC_Sync_t* sync, TJC_HMI_t* hmi, const TJC_SyncField_t* fields, uint8_t field_count,
+                      const char* const* slots, uint8_t slot_count);
+void tjc_sync_force(TJC_Sync_t* sync);
+uint32_t tjc_sync_update(TJC_Sync_t* sync, const void* data);
+uint16_t tjc_sync_script(TJC_Sync_t* sync, char* buf, uint16_t size);
+void tjc_sync_get_stats(TJC_Sync_t* sync, TJC_SyncStats_t* stats);
+/****************************************************************************/
+
+
+
+/*****************************默认实例接口***********************************/
+void tjc_send_string(char* str);
+void tjc_send_txt(char* objname, char* attribute, char* txt);
+void tjc_send_val(char* objname, char* attribute, int val);
+void tjc_send_nstring(char* str, unsigned char str_length);
+void tjc_send_fixed(char* objname, char* attribute, int32_t val, uint8_t decimals);
+void tjc_send_hex(char* objname, char* attribute, uint32_t val, uint8_t digits);
+void tjc_send_color(char* objname, char* attribute, uint8_t r, uint8_t g, uint8_t b);
+void tjc_send_add(uint8_t id, uint8_t ch, uint8_t val);
+void tjc_send_addt(uint8_t id, uint8_t ch, uint16_t qty);
+void initRingBuffer(void);
+void write1ByteToRingBuffer(uint8_t data);
+void deleteRingBuffer(uint16_t size);
+uint16_t getRingBufferLength(void);
+uint8_t read1ByteFromRingBuffer(uint16_t position);
+/****************************************************************************/
+
+
+
+#define usize getRingBufferLength()
+#define code_c() initRingBuffer()
+#define udelete(x) deleteRingBuffer(x)
+#define u(x) read1ByteFromRingBuffer(x)
+
+//兼容旧代码 HAL_UART_Receive_IT(&TJC_UART, RxBuffer, 1)
+#define RxBuffer (tjcDefault.RxByte)
+extern uint32_t msTicks;
+
+
+#endif
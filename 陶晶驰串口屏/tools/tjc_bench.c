@@ -0,0 +1,762 @@
+/**
+	tjc_usart_hmi.c 收发性能测试,在Linux主机上运行真实的驱动代码
+
+	编译:	gcc -O2 -DTJC_HOST -I. -I../HMI -o tjc_bench tjc_bench.c tjc_host_hal.c tjc_emu.c ../HMI/tjc_usart_hmi.c
+	用法:	./tjc_bench [-n 次数] [串口路径]
+			不给串口路径时驱动直接接进程内模拟器,测的是驱动本身的开销;
+			给出路径(如 tjc_emu 打印的 /dev/pts/3)时经伪终端和模拟器通信,测的是整条链路
+	每项测试结束都用一次 get 读回并核对,保证计时覆盖到串口屏真正处理完
+	超长文本测试核对分段发送后串口屏收到的仍是一条完整指令
+	迟到应答测试扣住模拟器的应答让请求超时,再放出(或丢掉)迟到的应答,核对后面的请求不会错位
+	启动发送失败测试让 HAL_UART_Transmit_xx 返回HAL_BUSY,核对失败的帧会重发且两个通道都不会卡死
+	最后一项按115200模拟发送耗时,打印紧急/普通发送通道的排队深度和等待时间
+	变量同步测试在进程内执行 tjc_sync_script 生成的定时器脚本,核对控件值,并对比逐条发送的字节数
+	发送卡死测试扣住发送完成中断,核对排在后面的阻塞 get 从提交时算起按时返回,恢复后请求照常配对
+	结束符拆分测试把\xff\xff\xff分到几帧里发出,核对之后的紧急指令不会一直被挡住
+	同步丢帧测试在发送队列满时更新变量,核对没发出去的变化在下一次更新时补发
+	多屏测试在默认实例的串口上 tjc_hmi_init 另一个实例,再接第二块屏和一个非串口屏的串口,
+	核对两块屏各自收发正常,非串口屏串口的数据交给 tjc_uart_rx_other
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <termios.h>
+#include "tjc_host_hal.h"
+#include "tjc_usart_hmi.h"
+#include "tjc_emu.h"
+
+UART_HandleTypeDef huart1;		//TJC_UART,默认实例使用
+UART_HandleTypeDef huart3;		//多屏测试的第二块屏
+UART_HandleTypeDef huart4;		//多屏测试中不接串口屏的串口
+
+static TJC_Emu_t emu;
+static TJC_Emu_t emu3;
+static TJC_Emu_t emu4;
+static uint8_t otherByte;
+static uint32_t otherRx;
+static uint32_t count = 10000;
+static uint32_t done;
+static uint32_t failed;
+
+static void report(const char* name, uint32_t n, uint64_t t0, const char* unit)
+{
+	uint64_t us = tjc_host_us() - t0;
+
+	if(us == 0)
+	{
+		us = 1;
+	}
+	printf("%-22s %8u %-8s %10.3f ms %12.0f %s/s %8.2f us/%s\n",
+		   name, n, unit, us / 1000.0, n * 1e6 / us, unit, (double)us / n, unit);
+}
+
+//读回校验,同时作为同步点:串口屏按顺序执行,应答到达说明前面的指令都已处理
+static void check(const char* name, int32_t expect)
+{
+	int32_t val = 0;
+
+	if(tjc_get_number(&tjcDefault, name, &val, 1000) || val != expect)
+	{
+		printf("  check %s failed: got %d, expect %d\n", name, val, expect);
+		failed++;
+	}
+}
+
+static void on_get(TJC_HMI_t* hmi, const TJC_GetResult_t* result, void* arg)
+{
+	(void)hmi;
+	(void)arg;
+	if(result->Status != TJC_GET_OK || result->Number != (int32_t)result->Tag)
+	{
+		failed++;
+	}
+	done++;
+}
+
+static void bench_tx(void)
+{
+	uint64_t t0 = tjc_host_us();
+
+	for(uint32_t i = 0; i < count; i++)
+	{
+		tjc_send_val("n0", "val", (int)i);
+	}
+	check("n0.val", (int32_t)count - 1);
+	report("tx n0.val=", count, t0, "cmd");
+
+	t0 = tjc_host_us();
+	for(uint32_t i = 0; i < count; i++)
+	{
+		tjc_send_txt("t0", "txt", "The quick brown fox jumps over the lazy dog 0123");
+	}
+	tjc_send_string("n1.val=7");
+	check("n1.val", 7);
+	report("tx t0.txt= (48 chars)", count, t0, "cmd");
+}
+
+//超过 TJC_CMD_MAX_LEN 的文本分段发送,串口屏收到的仍是一条完整指令
+static void bench_long(void)
+{
+	static char txt[601];
+	uint32_t cmds = emu.Stats.Commands, errors = emu.Stats.Errors;
+	TJC_EmuVar_t* var;
+
+	for(uint16_t i = 0; i < sizeof(txt) - 1; i++)
+	{
+		txt[i] = (char)('a' + i % 26);
+	}
+	tjc_send_txt("t1", "txt", txt);
+	tjc_send_string("n4.val=5");
+	check("n4.val", 5);
+	var = tjc_emu_var(&emu, "t1.txt", 0);
+	//模拟器只保存前 TJC_EMU_STR_LEN-1 个字符
+	if(var == NULL || strncmp(var->Str, txt, TJC_EMU_STR_LEN - 1) != 0
+	   || emu.Stats.Commands - cmds != 3 || emu.Stats.Errors != errors)
+	{
+		printf("  long txt (%u chars) not received as one command\n", (unsigned)(sizeof(txt) - 1));
+		failed++;
+	}
+}
+
+static TJC_EmuWrite_t heldWrite;
+static void* heldCtx;
+static uint8_t held[256];
+static uint16_t heldLen;
+
+//串口屏忙:应答先存起来不发
+static void hold_write(void* ctx, const uint8_t* data, uint16_t len)
+{
+	(void)ctx;
+	if(heldLen + len <= sizeof(held))
+	{
+		memcpy(&held[heldLen], data, len);
+		heldLen += len;
+	}
+}
+
+static void on_late(TJC_HMI_t* hmi, const TJC_GetResult_t* result, void* arg)
+{
+	(void)hmi;
+	(void)arg;
+	if(result->Status != TJC_GET_TIMEOUT)
+	{
+		failed++;
+	}
+	done++;
+}
+
+//请求超时后应答才到(lost=1时应答丢失),超时后提交的请求必须读到自己的值
+static void bench_late_run(uint8_t lost)
+{
+	uint32_t fails = failed;
+	uint16_t skip = lost ? 8 : 0;	//0x71应答连结束符共8字节
+
+	tjc_send_val("n5", "val", 111);
+	tjc_send_val("n6", "val", 222);
+	check("n6.val", 222);
+
+	heldLen = 0;
+	heldWrite = emu.Write;
+	heldCtx = emu.WriteCtx;
+	emu.Write = hold_write;
+	done = 0;
+	tjc_get_number_async(&tjcDefault, "n5.val", 111, 20, on_late, NULL);
+	while(done < 1)
+	{
+		tjc_get_poll(&tjcDefault);
+	}
+	tjc_get_number_async(&tjcDefault, "n6.val", 222, 1000, on_get, NULL);
+	tjc_get_poll(&tjcDefault);
+
+	//依次放出:迟到的 n5 应答、同步标记应答、n6 应答
+	emu.Write = heldWrite;
+	emu.WriteCtx = heldCtx;
+	if(heldLen > skip)
+	{
+		heldWrite(heldCtx, &held[skip], heldLen - skip);
+	}
+	while(done < 2)
+	{
+		tjc_get_poll(&tjcDefault);
+	}
+	check("n5.val", 111);
+	if(failed != fails)
+	{
+		printf("  %s reply after timeout: later request mismatched\n", lost ? "lost" : "late");
+	}
+}
+
+static void bench_late(void)
+{
+	bench_late_run(0);
+	bench_late_run(1);
+}
+
+//启动发送失败后发送队列不能卡死,失败的帧要重发
+static void bench_busy(void)
+{
+	uint32_t errors = tjcDefault.txErrors;
+	TJC_Cmd_t cmd;
+
+	tjc_host_uart_fail(&huart1, 3);
+	tjc_send_val("n7", "val", 1);
+	tjc_send_val("n7", "val", 2);
+	tjc_cmd_begin(&cmd);
+	tjc_cmd_str(&cmd, "n8.val=3");
+	tjc_cmd_send_lane(&tjcDefault, &cmd, TJC_LANE_URGENT);
+	check("n7.val", 2);
+	check("n8.val", 3);
+	if(tjcDefault.txErrors - errors != 3)
+	{
+		printf("  transmit busy: %u errors counted, expect 3\n", tjcDefault.txErrors - errors);
+		failed++;
+	}
+}
+
+//发送完成中断一直不来时 get 还没发出,请求自己的超时不开始计时,阻塞等待也要按时返回
+static void bench_stall(void)
+{
+	int32_t val = 0;
+	uint32_t t0;
+
+	tjc_host_uart_stall(&huart1, 1);
+	tjc_send_val("n9", "val", 1);
+	t0 = HAL_GetTick();
+	if(tjc_get_number(&tjcDefault, "n0.val", &val, 50) == 0 || HAL_GetTick() - t0 > 200)
+	{
+		printf("  tx stall: get returned after %u ms, expect a timeout after 50 ms\n", HAL_GetTick() - t0);
+		failed++;
+	}
+	tjc_host_uart_stall(&huart1, 0);
+	tjc_send_val("n9", "val", 9);
+	check("n9.val", 9);
+}
+
+//紧急指令在 ms 毫秒内是否已经执行(不用 get 核对,get 的结束符会顺带放行紧急通道)
+static uint8_t urgent_within(const char* name, int32_t val, uint32_t ms)
+{
+	TJC_EmuVar_t* var;
+	TJC_Cmd_t cmd;
+	uint32_t t0;
+
+	tjc_cmd_begin(&cmd);
+	tjc_cmd_str(&cmd, name);
+	tjc_cmd_char(&cmd, '=');
+	tjc_cmd_int(&cmd, val);
+	tjc_cmd_send_lane(&tjcDefault, &cmd, TJC_LANE_URGENT);
+	t0 = HAL_GetTick();
+	do
+	{
+		var = tjc_emu_var(&emu, name, 0);
+		if(var != NULL && var->Val == val)
+		{
+			return 1;
+		}
+	}while(HAL_GetTick() - t0 < ms);
+	printf("  %s=%d not sent within %u ms\n", name, val, ms);
+	return 0;
+}
+
+//结束符分在几帧里时也要认出指令已结束,否则普通通道一直占着发送,紧急通道和同步标记都发不出去
+static void bench_split(void)
+{
+	static const uint8_t ff = 0xff;
+	uint8_t buf[TJC_CMD_MAX_LEN + 1];
+	uint16_t n;
+
+	//旧接口 uart_send_char(0xff) 三次的发法,每个0xff单独一帧
+	tjc_uart_send(&tjcDefault, (const uint8_t*)"n5.val=5", 8);
+	for(uint8_t i = 0; i < 3; i++)
+	{
+		tjc_uart_send(&tjcDefault, &ff, 1);
+	}
+	failed += !urgent_within("n6.val", 6, 50);
+
+	//按 TJC_CMD_MAX_LEN 分段后只剩最后一个0xff
+	n = (uint16_t)sprintf((char*)buf, "t1.txt=\"");
+	memset(buf + n, 'a', sizeof(buf) - n - 4);
+	memcpy(buf + sizeof(buf) - 4, "\"\xff\xff\xff", 4);
+	tjc_uart_send(&tjcDefault, buf, sizeof(buf));
+	failed += !urgent_within("n6.val", 7, 50);
+	check("n5.val", 5);
+}
+
+static void bench_get(void)
+{
+	uint64_t t0;
+	uint32_t sent = 0;
+
+	tjc_send_val("n2", "val", 12345);
+	t0 = tjc_host_us();
+	for(uint32_t i = 0; i < count; i++)
+	{
+		check("n2.val", 12345);
+	}
+	report("get blocking", count, t0, "get");
+
+	//请求的标记就是期望读到的值,回调里核对
+	tjc_send_string("sys0=0");
+	t0 = tjc_host_us();
+	done = 0;
+	while(done < count)
+	{
+		while(sent < count && tjc_get_pending(&tjcDefault) < TJC_GET_MAX)
+		{
+			if(tjc_get_number_async(&tjcDefault, "sys0", 0, 1000, on_get, NULL) == 0)
+			{
+				sent++;
+			}
+		}
+		tjc_get_poll(&tjcDefault);
+	}
+	report("get pipelined", count, t0, "get");
+}
+
+static void bench_wave(void)
+{
+	static TJC_Wave_t wave;
+	TJC_WaveStats_t stats;
+	uint8_t sample[2];
+	uint32_t pushed = 0;
+	uint64_t t0 = tjc_host_us();
+
+	tjc_wave_start(&tjcDefault, &wave, 1, 2, 200);
+	while(pushed < count)
+	{
+		sample[0] = (uint8_t)pushed;
+		sample[1] = (uint8_t)(255 - pushed);
+		if(tjc_wave_free(&wave, 0) && tjc_wave_free(&wave, 1))
+		{
+			tjc_wave_push(&wave, 0, &sample[0], 1);
+			tjc_wave_push(&wave, 1, &sample[1], 1);
+			pushed++;
+		}
+		tjc_wave_poll(&wave);
+	}
+	tjc_wave_flush(&wave);
+	do
+	{
+		tjc_wave_poll(&wave);
+		tjc_wave_get_stats(&wave, &stats);
+	}while(stats.Samples < 2 * count && stats.Timeouts == 0);
+	tjc_wave_stop(&wave);
+	report("wave addt (2 ch)", 2 * count, t0, "sample");
+	if(stats.Timeouts)
+	{
+		printf("  wave timeouts %u\n", stats.Timeouts);
+		failed++;
+	}
+}
+
+static void print_lane(const char* name, uint8_t lane)
+{
+	TJC_TxLaneStats_t st;
+
+	tjc_tx_get_stats(&tjcDefault, lane, &st);
+	printf("  lane %-7s frames %6u drops %u max depth %4u B, wait avg %.2f ms max %u ms\n", name, st.Frames,
+		   st.Drops, st.MaxDepth, st.Frames ? (double)st.WaitSum / st.Frames : 0.0, st.WaitMax);
+}
+
+//按 115200 模拟发送耗时,普通通道塞满长文本的同时插入紧急指令
+static void bench_lanes(void)
+{
+	TJC_Cmd_t cmd;
+	uint32_t rounds = count / 100 + 1;
+	uint64_t t0;
+
+	tjc_uart_set_baud(&tjcDefault, 115200);
+	tjc_send_string("baud=115200");
+	tjc_tx_flush(&tjcDefault, 1000);
+	tjc_host_uart_pace(&huart1, 1);
+	tjc_tx_reset_stats(&tjcDefault);
+
+	t0 = tjc_host_us();
+	for(uint32_t r = 0; r < rounds; r++)
+	{
+		for(uint8_t i = 0; i < 6; i++)
+		{
+			tjc_send_txt("t0", "txt", "The quick brown fox jumps over the lazy dog 0123");
+		}
+		tjc_cmd_begin(&cmd);
+		tjc_cmd_str(&cmd, "n3.val=");
+		tjc_cmd_int(&cmd, (int32_t)r);
+		tjc_cmd_send_lane(&tjcDefault, &cmd, TJC_LANE_URGENT);
+	}
+	check("n3.val", (int32_t)rounds - 1);
+	report("lanes @115200", rounds * 7, t0, "cmd");
+	print_lane("urgent", TJC_LANE_URGENT);
+	print_lane("normal", TJC_LANE_NORMAL);
+	tjc_host_uart_pace(&huart1, 0);
+}
+
+typedef struct
+{
+	uint16_t volt;
+	uint16_t curr;
+	uint8_t  bar[4];		//进度条 0~100
+	uint8_t  led[4];		//指示灯 0/1
+	int32_t  power;
+	uint32_t uptime;
+}Meter_t;
+
+static const TJC_SyncField_t meterFields[] =
+{
+	TJC_SYNC_FIELD(Meter_t, volt, 16, "n0.val"),
+	TJC_SYNC_FIELD(Meter_t, curr, 16, "n1.val"),
+	TJC_SYNC_FIELD(Meter_t, bar[0], 7, "j0.val"),
+	TJC_SYNC_FIELD(Meter_t, bar[1], 7, "j1.val"),
+	TJC_SYNC_FIELD(Meter_t, bar[2], 7, "j2.val"),
+	TJC_SYNC_FIELD(Meter_t, bar[3], 7, "j3.val"),
+	TJC_SYNC_FIELD(Meter_t, led[0], 1, "bt0.val"),
+	TJC_SYNC_FIELD(Meter_t, led[1], 1, "bt1.val"),
+	TJC_SYNC_FIELD(Meter_t, led[2], 1, "bt2.val"),
+	TJC_SYNC_FIELD(Meter_t, led[3], 1, "bt3.val"),
+	TJC_SYNC_FIELD(Meter_t, power, 32, "x0.val"),
+	TJC_SYNC_FIELD(Meter_t, uptime, 24, "n2.val"),
+};
+static const char* const meterSlots[] = {"sys2", "va0.val", "va1.val", "va2.val"};
+#define METER_FIELDS	(sizeof(meterFields) / sizeof(meterFields[0]))
+
+//模拟串口屏定时器:逐行执行脚本,if(x!=0) 不成立时跳过后面的 {} 块
+static void run_script(const char* script)
+{
+	char line[128];
+	const char* p = script;
+	const char* end;
+	int skip = 0, depth = 0;
+	size_t n;
+	TJC_EmuVar_t* var;
+
+	while(*p)
+	{
+		end = strstr(p, "\r\n");
+		n = end ? (size_t)(end - p) : strlen(p);
+		while(n && *p == ' ')
+		{
+			p++;
+			n--;
+		}
+		snprintf(line, sizeof(line), "%.*s", (int)n, p);
+		p += n + (end ? 2 : 0);
+
+		if(skip)
+		{
+			depth += (line[0] == '{') - (line[0] == '}');
+			skip = (depth > 0) || (line[0] == '{');
+			continue;
+		}
+		if(strncmp(line, "if(", 3) == 0)
+		{
+			line[strcspn(line, "!")] = '\0';
+			var = tjc_emu_var(&emu, line + 3, 0);
+			skip = (var == NULL || var->Val == 0);
+			depth = 0;
+		}
+		else if(line[0] != '{' && line[0] != '}' && line[0] != '\0')
+		{
+			tjc_emu_feed(&emu, (const uint8_t*)line, (uint32_t)strlen(line), tjc_host_us());
+			tjc_emu_feed(&emu, (const uint8_t*)"\xff\xff\xff", 3, tjc_host_us());
+		}
+	}
+}
+
+static uint8_t sync_check(const Meter_t* m)
+{
+	const uint8_t* base = (const uint8_t*)m;
+	TJC_EmuVar_t* var;
+	uint32_t val;
+
+	for(uint8_t i = 0; i < METER_FIELDS; i++)
+	{
+		val = 0;
+		memcpy(&val, base + meterFields[i].Offset, meterFields[i].Size);
+		var = tjc_emu_var(&emu, meterFields[i].Target, 0);
+		if(var == NULL || var->Val != (int32_t)val)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static void bench_sync_run(const char* name, uint8_t sparse)
+{
+	static TJC_Sync_t sync;
+	static char script[4096];
+	TJC_SyncStats_t st;
+	Meter_t m = {2200, 150, {10, 20, 30, 40}, {0, 1, 0, 1}, -1200, 0};
+	uint32_t errors = emu.Stats.Errors;
+	uint64_t t0;
+
+	if(tjc_sync_init(&sync, &tjcDefault, meterFields, METER_FIELDS, meterSlots, 4) ||
+	   tjc_sync_script(&sync, script, sizeof(script)) == 0)
+	{
+		printf("  sync init failed\n");
+		failed++;
+		return;
+	}
+	sync.Settle = 0;	//这里每次更新后都马上执行定时器脚本
+	tjc_send_string("sys0=0");
+	t0 = tjc_host_us();
+	for(uint32_t i = 0; i < count; i++)
+	{
+		//sparse=0:数值和进度条每次都在跳;sparse=1:每次只有一两个字段变化
+		m.uptime = i / 10;
+		if(!sparse || i % 8 == 0) m.volt = (uint16_t)(2200 + i * 7 % 31);
+		if(!sparse || i % 16 == 0) m.curr = (uint16_t)(150 + i * 5 % 13);
+		for(uint8_t k = 0; k < 4; k++)
+		{
+			if(!sparse || i % 4 == k) m.bar[k] = (uint8_t)((i + k) * 13 % 101);
+		}
+		if(!sparse || i % 64 == 0) m.power = -1200 - (int32_t)(i * 3 % 100);
+		if(i % 32 == 0) m.led[i / 32 % 4] ^= 1;
+		tjc_sync_update(&sync, &m);
+		tjc_tx_flush(&tjcDefault, 1000);
+		run_script(script);
+		if((i % 97 == 0 || i == count - 1) && (sync_check(&m) || tjc_emu_var(&emu, "sys0", 0)->Val != 0))
+		{
+			printf("  sync mismatch at %u\n", i);
+			failed++;
+			break;
+		}
+	}
+	report(name, count, t0, "tick");
+	tjc_sync_get_stats(&sync, &st);
+	printf("  packed %u direct %u fields %u, %u bytes vs %u bytes as n0.val=... (%.2fx)\n", st.Bursts, st.Direct,
+		   st.Fields, st.Bytes, st.PlainBytes, st.Bytes ? (double)st.PlainBytes / st.Bytes : 0.0);
+	if(emu.Stats.Errors != errors)
+	{
+		printf("  sync script errors %u\n", emu.Stats.Errors - errors);
+		failed++;
+	}
+}
+
+//发送队列满时这次的变化发不出去,下一次更新数据没变也要补发
+static void bench_sync_drop(void)
+{
+	static TJC_Sync_t sync;
+	static char script[4096];
+	static const uint8_t fill[] = "sys1=1\xff\xff\xff";
+	TJC_SyncStats_t st;
+	Meter_t m = {2300, 160, {11, 21, 31, 41}, {1, 0, 1, 0}, -1300, 0};
+
+	if(tjc_sync_init(&sync, &tjcDefault, meterFields, METER_FIELDS, meterSlots, 4) ||
+	   tjc_sync_script(&sync, script, sizeof(script)) == 0)
+	{
+		printf("  sync init failed\n");
+		failed++;
+		return;
+	}
+	sync.Settle = 0;
+	tjc_sync_update(&sync, &m);
+	tjc_tx_flush(&tjcDefault, 1000);
+	run_script(script);
+
+	tjc_host_uart_stall(&huart1, 1);
+	while(tjc_uart_send_lane(&tjcDefault, TJC_LANE_NORMAL, fill, sizeof(fill) - 1) == 0);
+	m.volt = 2345;
+	m.bar[2] = 77;
+	if(tjc_sync_update(&sync, &m) != 0)
+	{
+		printf("  sync drop: update reported as sent with a full queue\n");
+		failed++;
+	}
+	tjc_host_uart_stall(&huart1, 0);
+	tjc_tx_flush(&tjcDefault, 1000);
+
+	tjc_sync_update(&sync, &m);
+	tjc_tx_flush(&tjcDefault, 1000);
+	run_script(script);
+	tjc_sync_get_stats(&sync, &st);
+	if(sync_check(&m) || st.Drops != 1)
+	{
+		printf("  sync drop: dropped change not resent (drops %u)\n", st.Drops);
+		failed++;
+	}
+}
+
+static void bench_sync(void)
+{
+	bench_sync_run("sync busy", 0);
+	bench_sync_run("sync sparse", 1);
+	bench_sync_drop();
+}
+
+static void bench_rx(void)
+{
+	uint32_t frames = 0;
+	uint64_t t0;
+
+	//触摸事件只能在进程内注入
+	code_c();
+	t0 = tjc_host_us();
+	for(uint32_t i = 0; i < count; i++)
+	{
+		tjc_emu_touch(&emu, 0, (uint8_t)i, 1);
+		tjc_host_poll();
+		//主循环里常见的解析方式:按 usize/u(x) 找帧尾
+		while(usize >= 7)
+		{
+			if(u(0) == 0x65 && u(4) == 0xff && u(5) == 0xff && u(6) == 0xff)
+			{
+				frames++;
+				udelete(7);
+			}
+			else
+			{
+				udelete(1);
+			}
+		}
+	}
+	report("rx touch frames", frames, t0, "frame");
+	if(frames != count)
+	{
+		failed++;
+	}
+}
+
+void tjc_uart_rx_other(UART_HandleTypeDef* huart)
+{
+	otherRx++;
+	HAL_UART_Receive_IT(huart, &otherByte, 1);
+}
+
+static void panel_check(TJC_HMI_t* hmi, const char* name, int32_t expect)
+{
+	int32_t val = 0;
+	uint32_t t0 = HAL_GetTick();
+
+	if(tjc_get_number(hmi, name, &val, 200) || val != expect)
+	{
+		printf("  panel %s failed: got %d, expect %d\n", name, val, expect);
+		failed++;
+	}
+	//应答到达后发送完成中断也要能清掉忙标志
+	while(hmi->txBusy && HAL_GetTick() - t0 < 200);
+	if(hmi->txBusy)
+	{
+		printf("  panel %s: tx busy never cleared\n", name);
+		failed++;
+	}
+}
+
+static void other_check(TJC_Emu_t* e, uint32_t expect)
+{
+	uint32_t t0 = HAL_GetTick();
+
+	otherRx = 0;
+	tjc_emu_send_raw(e, (const uint8_t*)"abc", 3);
+	while(otherRx < expect && HAL_GetTick() - t0 < 100);
+	if(otherRx != expect)
+	{
+		printf("  other uart: %u bytes reached tjc_uart_rx_other, expect %u\n", otherRx, expect);
+		failed++;
+	}
+}
+
+//旧问题:默认实例预先挂在 TJC_UART 上,同一串口再 tjc_hmi_init 的实例被它挡住,收不到应答
+static void bench_panels(void)
+{
+	static TJC_HMI_t hmiA, hmiB;
+
+	tjc_host_uart_emu(&huart3, (void*)3, &emu3);
+	tjc_host_uart_emu(&huart4, (void*)4, &emu4);
+	huart3.Init.BaudRate = 921600;
+	huart4.Init.BaudRate = 921600;
+	if(tjc_hmi_init(&hmiA, &huart1) || tjc_hmi_init(&hmiB, &huart3))
+	{
+		printf("  panels: tjc_hmi_init failed\n");
+		failed++;
+		return;
+	}
+	HAL_UART_Receive_IT(&huart4, &otherByte, 1);
+
+	tjc_hmi_send_val(&hmiA, "n0", "val", 111);
+	tjc_hmi_send_val(&hmiB, "n0", "val", 222);
+	panel_check(&hmiA, "n0.val", 111);
+	panel_check(&hmiB, "n0.val", 222);
+	other_check(&emu4, 3);
+
+	//摘下后该串口的数据交给 tjc_uart_rx_other
+	tjc_hmi_deinit(&hmiA);
+	other_check(&emu, 3);
+	printf("%-22s two panels and a non-panel uart\n", "panels");
+}
+
+int main(int argc, char** argv)
+{
+	TJC_HostUartStats_t stats;
+	struct termios tio;
+	const char* path = NULL;
+	int opt, fd;
+
+	while((opt = getopt(argc, argv, "n:")) != -1)
+	{
+		if(opt == 'n')
+		{
+			count = (uint32_t)atol(optarg);
+		}
+		else
+		{
+			fprintf(stderr, "usage: %s [-n count] [tty]\n", argv[0]);
+			return 1;
+		}
+	}
+	if(optind < argc)
+	{
+		path = argv[optind];
+	}
+
+	if(path != NULL)
+	{
+		fd = open(path, O_RDWR | O_NOCTTY);
+		if(fd < 0 || tcgetattr(fd, &tio))
+		{
+			perror(path);
+			return 1;
+		}
+		cfmakeraw(&tio);
+		tcsetattr(fd, TCSANOW, &tio);
+		tjc_host_uart_fd(&huart1, (void*)1, fd);
+	}
+	else
+	{
+		tjc_host_uart_emu(&huart1, (void*)1, &emu);
+	}
+	huart1.Init.BaudRate = 9600;
+	tjc_hmi_init(&tjcDefault, &huart1);
+	printf("link: %s, baud negotiated: %u\n", path ? path : "in-process emulator",
+		   tjc_baud_negotiate(&tjcDefault, 921600));
+
+	bench_tx();
+	bench_get();
+	bench_wave();
+	if(path == NULL)
+	{
+		bench_long();
+		bench_late();
+		bench_busy();
+		bench_stall();
+		bench_split();
+		bench_rx();
+		bench_sync();
+	}
+	bench_lanes();
+	if(path == NULL)
+	{
+		bench_panels();
+	}
+
+	tjc_host_get_stats(&huart1, &stats);
+	printf("uart: tx %llu bytes in %u writes, rx %llu bytes\n",
+		   (unsigned long long)stats.TxBytes, stats.TxCalls, (unsigned long long)stats.RxBytes);
+	if(path == NULL)
+	{
+		tjc_emu_print_stats(&emu);
+	}
+	printf("%s\n", failed ? "FAILED" : "OK");
+	return failed != 0;
+}
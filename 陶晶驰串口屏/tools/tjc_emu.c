@@ -0,0 +1,630 @@
+/**
+	陶晶驰串口屏模拟器核心,不依赖串口,收到的字节用 tjc_emu_feed() 喂进来,
+	应答通过初始化时给的 write 回调发出。
+	tjc_emu_main.c 把它接到伪终端上,tjc_bench.c 直接在进程内调用
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "tjc_emu.h"
+
+
+
+/********************************************************
+函数名：  		tjc_emu_reply
+日期：    	2026.10.19
+功能：    	发送一帧返回数据,自动加结束符
+输入参数：		模拟器,帧数据,长度
+返回值： 		无
+修改记录：
+**********************************************************/
+static void tjc_emu_reply(TJC_Emu_t* emu, const uint8_t* data, uint16_t len)
+{
+	static const uint8_t end[3] = {0xff, 0xff, 0xff};
+
+	emu->Write(emu->WriteCtx, data, len);
+	emu->Write(emu->WriteCtx, end, sizeof(end));
+	emu->Stats.TxBytes += len + sizeof(end);
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_emu_result
+日期：    	2026.10.19
+功能：    	按 bkcmd 设置返回指令执行结果
+输入参数：		模拟器,结果码(0x01成功,其他为失败码)
+返回值： 		无
+修改记录：
+**********************************************************/
+static void tjc_emu_result(TJC_Emu_t* emu, uint8_t code)
+{
+	if(code != 0x01)
+	{
+		emu->Stats.Errors++;
+	}
+	if((code == 0x01 && (emu->Bkcmd & 1)) || (code != 0x01 && (emu->Bkcmd & 2)))
+	{
+		tjc_emu_reply(emu, &code, 1);
+	}
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_emu_init
+日期：    	2026.10.19
+功能：    	初始化模拟器,状态与串口屏上电时一致(9600波特率,bkcmd=2,第0页)
+输入参数：		模拟器,应答输出回调,回调参数
+返回值： 		无
+修改记录：
+**********************************************************/
+void tjc_emu_init(TJC_Emu_t* emu, TJC_EmuWrite_t write, void* ctx)
+{
+	memset(emu, 0, sizeof(TJC_Emu_t));
+	emu->Write = write;
+	emu->WriteCtx = ctx;
+	emu->Bkcmd = 2;
+	emu->Baud = 9600;
+	emu->Stats.LatMin = UINT32_MAX;
+	tjc_emu_set_val(emu, "baud", 9600);
+	tjc_emu_set_val(emu, "dp", 0);
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_emu_var
+日期：    	2026.10.19
+功能：    	按名字查找变量
+输入参数：		模拟器,变量名,不存在时是否创建
+返回值： 		变量,找不到(或变量表满)返回NULL
+修改记录：
+**********************************************************/
+TJC_EmuVar_t* tjc_emu_var(TJC_Emu_t* emu, const char* name, uint8_t create)
+{
+	TJC_EmuVar_t* var;
+
+	for(uint16_t i = 0; i < emu->VarCount; i++)
+	{
+		if(strcmp(emu->Var[i].Name, name) == 0)
+		{
+			return &emu->Var[i];
+		}
+	}
+	if(!create || emu->VarCount >= TJC_EMU_VAR_MAX || strlen(name) >= TJC_EMU_NAME_LEN)
+	{
+		return NULL;
+	}
+	var = &emu->Var[emu->VarCount++];
+	memset(var, 0, sizeof(TJC_EmuVar_t));
+	strcpy(var->Name, name);
+	//控件的文本属性都叫 txt,其余按数值处理
+	var->IsString = (strstr(name, ".txt") != NULL);
+	return var;
+}
+
+
+
+void tjc_emu_set_val(TJC_Emu_t* emu, const char* name, int32_t val)
+{
+	TJC_EmuVar_t* var = tjc_emu_var(emu, name, 1);
+
+	if(var != NULL)
+	{
+		var->IsString = 0;
+		var->Val = val;
+	}
+	return;
+}
+
+
+
+void tjc_emu_set_str(TJC_Emu_t* emu, const char* name, const char* str)
+{
+	TJC_EmuVar_t* var = tjc_emu_var(emu, name, 1);
+
+	if(var != NULL)
+	{
+		var->IsString = 1;
+		snprintf(var->Str, sizeof(var->Str), "%s", str);
+	}
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_emu_touch
+日期：    	2026.10.19
+功能：    	模拟触摸控件,发出 0x65 触摸热区事件
+输入参数：		模拟器,页面id,控件id,1:按下 0:松开
+返回值： 		无
+修改记录：
+**********************************************************/
+void tjc_emu_touch(TJC_Emu_t* emu, uint8_t page, uint8_t id, uint8_t press)
+{
+	uint8_t frame[4] = {0x65, page, id, press};
+
+	tjc_emu_reply(emu, frame, sizeof(frame));
+	return;
+}
+
+
+
+void tjc_emu_send_raw(TJC_Emu_t* emu, const uint8_t* data, uint16_t len)
+{
+	emu->Write(emu->WriteCtx, data, len);
+	emu->Stats.TxBytes += len;
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_emu_eval
+日期：    	2026.10.19
+功能：    	计算赋值语句右边的整数表达式,支持数字和数值变量,
+			运算符 + - * / % & | ^ << >>,和串口屏一样不分优先级,从左到右依次计算
+输入参数：		模拟器,表达式,结果输出地址
+返回值： 		0x01:成功 0x1A:变量名无效 0x1B:变量运算无效
+修改记录：
+**********************************************************/
+static uint8_t tjc_emu_eval(TJC_Emu_t* emu, const char* expr, int32_t* out)
+{
+	char name[TJC_EMU_NAME_LEN];
+	int32_t sum = 0, term;
+	char op = '+';
+	uint16_t n;
+	TJC_EmuVar_t* var;
+
+	if(*expr == '-' || *expr == '+')
+	{
+		op = *expr++;
+	}
+	while(*expr)
+	{
+		if(isdigit((unsigned char)*expr))
+		{
+			term = (int32_t)strtoul(expr, (char**)&expr, 10);
+		}
+		else if(isalpha((unsigned char)*expr) || *expr == '_')
+		{
+			for(n = 0; (isalnum((unsigned char)*expr) || *expr == '_' || *expr == '.') && n < sizeof(name) - 1; n++)
+			{
+				name[n] = *expr++;
+			}
+			name[n] = '\0';
+			var = tjc_emu_var(emu, name, 0);
+			if(var == NULL)
+			{
+				return 0x1A;
+			}
+			if(var->IsString)
+			{
+				return 0x1B;
+			}
+			term = var->Val;
+		}
+		else
+		{
+			return 0x1B;
+		}
+		switch(op)
+		{
+			case '+': sum = (int32_t)((uint32_t)sum + (uint32_t)term); break;
+			case '-': sum = (int32_t)((uint32_t)sum - (uint32_t)term); break;
+			case '*': sum = (int32_t)((uint32_t)sum * (uint32_t)term); break;
+			case '/': if(term == 0) return 0x1B; sum /= term; break;
+			case '%': if(term == 0) return 0x1B; sum %= term; break;
+			case '&': sum &= term; break;
+			case '|': sum |= term; break;
+			case '^': sum ^= term; break;
+			case '<': sum = (int32_t)((uint32_t)sum << (term & 31)); break;
+			case '>': sum >>= (term & 31); break;
+		}
+
+		if(*expr == '\0')
+		{
+			break;
+		}
+		if(strchr("+-*/%&|^", *expr) != NULL)
+		{
+			op = *expr++;
+		}
+		else if((expr[0] == '<' || expr[0] == '>') && expr[1] == expr[0])
+		{
+			op = *expr;
+			expr += 2;
+		}
+		else
+		{
+			return 0x1B;
+		}
+	}
+	*out = sum;
+	return 0x01;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_emu_assign
+日期：    	2026.10.19
+功能：    	执行 obj.attr=val / obj.attr+=val / obj.attr-=val
+输入参数：		模拟器,指令,等号位置
+返回值： 		结果码
+修改记录：
+**********************************************************/
+static uint8_t tjc_emu_assign(TJC_Emu_t* emu, char* cmd, char* eq)
+{
+	char op = 0;
+	char* rhs = eq + 1;
+	char* end;
+	TJC_EmuVar_t* var;
+	int32_t val;
+	uint8_t code;
+
+	if(eq > cmd && (eq[-1] == '+' || eq[-1] == '-'))
+	{
+		op = eq[-1];
+		eq--;
+	}
+	*eq = '\0';
+
+	if(strcmp(cmd, "bkcmd") == 0)
+	{
+		emu->Bkcmd = (uint8_t)atoi(rhs) & 3;
+		return 0x01;
+	}
+	if(strcmp(cmd, "baud") == 0 || strcmp(cmd, "bauds") == 0)
+	{
+		emu->Baud = (uint32_t)atol(rhs);
+		tjc_emu_set_val(emu, "baud", (int32_t)emu->Baud);
+		return 0x01;
+	}
+
+	var = tjc_emu_var(emu, cmd, 1);
+	if(var == NULL)
+	{
+		return 0x1A;
+	}
+	if(rhs[0] == '"')
+	{
+		end = strrchr(rhs + 1, '"');
+		if(!var->IsString || end == NULL)
+		{
+			return 0x1B;
+		}
+		*end = '\0';
+		if(op == '+')
+		{
+			strncat(var->Str, rhs + 1, sizeof(var->Str) - strlen(var->Str) - 1);
+		}
+		else if(op == 0)
+		{
+			snprintf(var->Str, sizeof(var->Str), "%s", rhs + 1);
+		}
+		else
+		{
+			return 0x1B;
+		}
+		return 0x01;
+	}
+
+	if(var->IsString)
+	{
+		return 0x1B;
+	}
+	code = tjc_emu_eval(emu, rhs, &val);
+	if(code != 0x01)
+	{
+		return code;
+	}
+	var->Val = (op == '+') ? var->Val + val : (op == '-') ? var->Val - val : val;
+	return 0x01;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_emu_get
+日期：    	2026.10.19
+功能：    	执行 get 指令,数值返回0x71,字符串返回0x70;参数是数值常数时原样返回(get 123)
+输入参数：		模拟器,变量名或常数
+返回值： 		结果码
+修改记录：
+**********************************************************/
+static uint8_t tjc_emu_get(TJC_Emu_t* emu, const char* name)
+{
+	uint8_t frame[1 + TJC_EMU_STR_LEN];
+	TJC_EmuVar_t* var;
+	TJC_EmuVar_t num;
+	uint32_t val;
+	uint16_t len;
+
+	emu->Stats.Gets++;
+	if(isdigit((unsigned char)name[0]) || name[0] == '-')
+	{
+		memset(&num, 0, sizeof(num));
+		num.Val = (int32_t)strtol(name, NULL, 10);
+		var = &num;
+	}
+	else
+	{
+		var = tjc_emu_var(emu, name, 0);
+	}
+	if(var == NULL)
+	{
+		return 0x1A;
+	}
+	if(var->IsString)
+	{
+		len = (uint16_t)strlen(var->Str);
+		frame[0] = 0x70;
+		memcpy(&frame[1], var->Str, len);
+		tjc_emu_reply(emu, frame, 1 + len);
+	}
+	else
+	{
+		val = (uint32_t)var->Val;
+		frame[0] = 0x71;
+		frame[1] = val & 0xff;
+		frame[2] = (val >> 8) & 0xff;
+		frame[3] = (val >> 16) & 0xff;
+		frame[4] = (val >> 24) & 0xff;
+		tjc_emu_reply(emu, frame, 5);
+	}
+	return 0;	//get 成功时只返回数据,不再返回0x01
+}
+
+
+
+/********************************************************
+函数名：  		tjc_emu_exec
+日期：    	2026.10.19
+功能：    	执行一条完整指令(已去掉结束符)
+输入参数：		模拟器,指令字符串
+返回值： 		无
+修改记录：
+**********************************************************/
+static void tjc_emu_exec(TJC_Emu_t* emu, char* cmd)
+{
+	static const char* const others[] = {"ref", "vis", "cls", "tsw", "click", "ref_stop", "ref_star",
+										 "com_stop", "com_star", "doevents", "rest", "delay", "randset", NULL};
+	uint8_t frame[2];
+	unsigned int id, ch, val;
+	char* eq;
+	uint8_t code = 0x00;
+
+	if(emu->Verbose)
+	{
+		printf("<< %s\n", cmd);
+	}
+
+	if(strncmp(cmd, "get ", 4) == 0)
+	{
+		code = tjc_emu_get(emu, cmd + 4);
+	}
+	else if(sscanf(cmd, "addt %u,%u,%u", &id, &ch, &val) == 3)
+	{
+		//先回0xFE,之后 val 个字节是原始数据
+		frame[0] = 0xFE;
+		tjc_emu_reply(emu, frame, 1);
+		emu->AddtLeft = val;
+		emu->Stats.Points += val;
+		code = 0;
+	}
+	else if(sscanf(cmd, "add %u,%u,%u", &id, &ch, &val) == 3)
+	{
+		emu->Stats.Points++;
+		code = 0x01;
+	}
+	else if(strcmp(cmd, "sendme") == 0)
+	{
+		frame[0] = 0x66;
+		frame[1] = emu->Page;
+		tjc_emu_reply(emu, frame, 2);
+		code = 0;
+	}
+	else if(strncmp(cmd, "page ", 5) == 0)
+	{
+		emu->Page = (uint8_t)atoi(cmd + 5);
+		tjc_emu_set_val(emu, "dp", emu->Page);
+		code = 0x01;
+	}
+	else if((eq = strchr(cmd, '=')) != NULL)
+	{
+		code = tjc_emu_assign(emu, cmd, eq);
+	}
+	else
+	{
+		for(uint8_t i = 0; others[i] != NULL; i++)
+		{
+			if(strncmp(cmd, others[i], strlen(others[i])) == 0)
+			{
+				code = 0x01;
+				break;
+			}
+		}
+	}
+
+	if(code != 0)
+	{
+		tjc_emu_result(emu, code);
+	}
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_emu_feed
+日期：    	2026.10.19
+功能：    	喂入单片机发来的数据,按 \xff\xff\xff 切分指令并执行
+			addt 透传期间收到的字节作为原始数据计数,收满后回0xFD
+输入参数：		模拟器,数据,长度,当前时刻(us,用于统计指令传输时间)
+返回值： 		无
+修改记录：
+**********************************************************/
+void tjc_emu_feed(TJC_Emu_t* emu, const uint8_t* data, uint32_t len, uint64_t now_us)
+{
+	const uint8_t done = 0xFD;
+	uint32_t lat;
+
+	for(uint32_t i = 0; i < len; i++)
+	{
+		emu->Stats.RxBytes++;
+		if(emu->AddtLeft)
+		{
+			emu->Stats.AddtBytes++;
+			if(--emu->AddtLeft == 0)
+			{
+				emu->Stats.Addt++;
+				tjc_emu_reply(emu, &done, 1);
+			}
+			continue;
+		}
+
+		if(emu->CmdLen == 0 && emu->FfCount == 0)
+		{
+			emu->CmdStart = now_us;
+		}
+		if(data[i] == 0xff)
+		{
+			if(++emu->FfCount < 3)
+			{
+				continue;
+			}
+			//收到结束符,空指令(单独的结束符)只用来清除残缺指令
+			emu->FfCount = 0;
+			if(emu->CmdLen == 0)
+			{
+				continue;
+			}
+			emu->Cmd[emu->CmdLen] = '\0';
+			emu->CmdLen = 0;
+			lat = (uint32_t)(now_us - emu->CmdStart);
+			emu->Stats.Commands++;
+			emu->Stats.LatSum += lat;
+			emu->Stats.LatMin = (lat < emu->Stats.LatMin) ? lat : emu->Stats.LatMin;
+			emu->Stats.LatMax = (lat > emu->Stats.LatMax) ? lat : emu->Stats.LatMax;
+			tjc_emu_exec(emu, (char*)emu->Cmd);
+			continue;
+		}
+		//不足3个的0xff属于指令内容
+		while(emu->FfCount)
+		{
+			if(emu->CmdLen < TJC_EMU_CMD_LEN - 1)
+			{
+				emu->Cmd[emu->CmdLen++] = 0xff;
+			}
+			emu->FfCount--;
+		}
+		if(emu->CmdLen < TJC_EMU_CMD_LEN - 1)
+		{
+			emu->Cmd[emu->CmdLen++] = data[i];
+		}
+	}
+	return;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_emu_script_line
+日期：    	2026.10.19
+功能：    	执行一行脚本
+				set 名字 值         预置变量,值用双引号括起来时为字符串
+				touch 页面 控件 1/0  发送触摸事件(0x65)
+				raw 71 01 00 ...     按十六进制发送原始字节(不自动加结束符)
+				sendme               发送当前页面(0x66)
+				wait 毫秒            由调用者等待
+				stats                打印统计
+				# 开头为注释
+输入参数：		模拟器,脚本行,等待时间输出地址(非wait行写0)
+返回值： 		0:成功 1:无法识别
+修改记录：
+**********************************************************/
+uint8_t tjc_emu_script_line(TJC_Emu_t* emu, const char* line, uint32_t* wait_ms)
+{
+	char name[TJC_EMU_NAME_LEN];
+	char str[TJC_EMU_STR_LEN];
+	uint8_t raw[64];
+	unsigned int a, b, c;
+	int n, pos;
+	long val;
+
+	*wait_ms = 0;
+	while(isspace((unsigned char)*line))
+	{
+		line++;
+	}
+	if(*line == '\0' || *line == '#')
+	{
+		return 0;
+	}
+	if(sscanf(line, "set %31s \"%127[^\"]\"", name, str) == 2)
+	{
+		tjc_emu_set_str(emu, name, str);
+	}
+	else if(sscanf(line, "set %31s %ld", name, &val) == 2)
+	{
+		tjc_emu_set_val(emu, name, (int32_t)val);
+	}
+	else if(sscanf(line, "touch %u %u %u", &a, &b, &c) == 3)
+	{
+		tjc_emu_touch(emu, (uint8_t)a, (uint8_t)b, (uint8_t)c);
+	}
+	else if(strncmp(line, "raw", 3) == 0)
+	{
+		line += 3;
+		for(n = 0; n < (int)sizeof(raw) && sscanf(line, "%x%n", &a, &pos) == 1; n++)
+		{
+			raw[n] = (uint8_t)a;
+			line += pos;
+		}
+		tjc_emu_send_raw(emu, raw, (uint16_t)n);
+	}
+	else if(strncmp(line, "sendme", 6) == 0)
+	{
+		str[0] = 0x66;
+		str[1] = (char)emu->Page;
+		tjc_emu_reply(emu, (uint8_t*)str, 2);
+	}
+	else if(sscanf(line, "wait %u", &a) == 1)
+	{
+		*wait_ms = a;
+	}
+	else if(strncmp(line, "stats", 5) == 0)
+	{
+		tjc_emu_print_stats(emu);
+	}
+	else
+	{
+		return 1;
+	}
+	return 0;
+}
+
+
+
+void tjc_emu_print_stats(TJC_Emu_t* emu)
+{
+	TJC_EmuStats_t* s = &emu->Stats;
+
+	printf("rx %llu bytes, tx %llu bytes\n", (unsigned long long)s->RxBytes, (unsigned long long)s->TxBytes);
+	printf("commands %u (get %u, failed %u), addt %u (%llu bytes), points %u\n",
+		   s->Commands, s->Gets, s->Errors, s->Addt, (unsigned long long)s->AddtBytes, s->Points);
+	if(s->Commands)
+	{
+		printf("command transfer time: min %u us, avg %llu us, max %u us\n",
+			   s->LatMin, (unsigned long long)(s->LatSum / s->Commands), s->LatMax);
+	}
+	return;
+}
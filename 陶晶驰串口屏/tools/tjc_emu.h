@@ -0,0 +1,79 @@
+#ifndef __TJC_EMU_H__
+#define __TJC_EMU_H__
+
+#include <stdint.h>
+
+/**
+	陶晶驰串口屏模拟器(Linux主机上运行)
+	只模拟驱动用到的指令:obj.attr=val、get、add、addt透传、baud=、bkcmd=、sendme,
+	其他指令(page/ref/vis/cls...)只计数并按 bkcmd 应答成功
+	变量表是扁平的 "对象.属性" 名字表,赋值时自动创建
+*/
+
+
+
+#define TJC_EMU_VAR_MAX		(128)   //变量表容量
+#define TJC_EMU_NAME_LEN	(32)    //变量名 "obj.attr" 最大长度
+#define TJC_EMU_STR_LEN		(128)   //字符串属性最大长度
+#define TJC_EMU_CMD_LEN		(1024)  //单条指令最大长度
+
+typedef void (*TJC_EmuWrite_t)(void* ctx, const uint8_t* data, uint16_t len);
+
+typedef struct
+{
+    char     Name[TJC_EMU_NAME_LEN];
+    uint8_t  IsString;
+    int32_t  Val;
+    char     Str[TJC_EMU_STR_LEN];
+}TJC_EmuVar_t;
+
+typedef struct
+{
+    uint64_t RxBytes;		//收到的字节数(含透传数据)
+    uint64_t TxBytes;		//发出的字节数
+    uint32_t Commands;		//完整指令数
+    uint32_t Gets;			//get 指令数
+    uint32_t Errors;		//应答失败的指令数
+    uint32_t Addt;			//完成的透传次数
+    uint64_t AddtBytes;		//透传的原始数据字节数
+    uint32_t Points;		//add/addt 写入曲线的点数
+    uint64_t LatSum;		//指令从第一个字节到结束符的时间累计,单位us
+    uint32_t LatMin;
+    uint32_t LatMax;
+}TJC_EmuStats_t;
+
+typedef struct
+{
+    TJC_EmuVar_t Var[TJC_EMU_VAR_MAX];
+    uint16_t VarCount;
+
+    uint8_t  Cmd[TJC_EMU_CMD_LEN];	//正在接收的指令
+    uint16_t CmdLen;
+    uint8_t  FfCount;
+    uint64_t CmdStart;				//指令第一个字节到达的时刻,us
+
+    uint32_t AddtLeft;				//透传中还要接收的原始字节数
+    uint8_t  Bkcmd;					//0:不返回 1:只返回成功 2:只返回失败(默认) 3:都返回
+    uint8_t  Page;
+    uint32_t Baud;
+    uint8_t  Verbose;				//1:打印每条指令
+
+    TJC_EmuWrite_t Write;			//发往单片机的数据
+    void*    WriteCtx;
+    TJC_EmuStats_t Stats;
+}TJC_Emu_t;
+
+
+
+void tjc_emu_init(TJC_Emu_t* emu, TJC_EmuWrite_t write, void* ctx);
+void tjc_emu_feed(TJC_Emu_t* emu, const uint8_t* data, uint32_t len, uint64_t now_us);
+TJC_EmuVar_t* tjc_emu_var(TJC_Emu_t* emu, const char* name, uint8_t create);
+void tjc_emu_set_val(TJC_Emu_t* emu, const char* name, int32_t val);
+void tjc_emu_set_str(TJC_Emu_t* emu, const char* name, const char* str);
+void tjc_emu_touch(TJC_Emu_t* emu, uint8_t page, uint8_t id, uint8_t press);
+void tjc_emu_send_raw(TJC_Emu_t* emu, const uint8_t* data, uint16_t len);
+uint8_t tjc_emu_script_line(TJC_Emu_t* emu, const char* line, uint32_t* wait_ms);
+void tjc_emu_print_stats(TJC_Emu_t* emu);
+
+
+#endif
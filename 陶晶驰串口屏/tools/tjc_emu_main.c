@@ -0,0 +1,179 @@
+/**
+	陶晶驰串口屏模拟器,在Linux伪终端上模拟一块串口屏
+
+	编译:	gcc -O2 -o tjc_emu tjc_emu_main.c tjc_emu.c
+	用法:	./tjc_emu [-v] [-s 脚本文件] [-l 链接路径]
+			-v  打印收到的每条指令
+			-s  启动后按行执行脚本(预置变量、定时发送触摸事件等,格式见 tjc_emu_script_line)
+			-l  在指定路径建立指向伪终端的符号链接,方便其他程序固定打开
+	启动后打印伪终端路径(如 /dev/pts/3),把它当作串口屏的串口打开即可,
+	例如 tjc_bench /dev/pts/3,或用USB转串口的调试程序打开。Ctrl+C 退出时打印统计
+*/
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 600
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <time.h>
+#include "tjc_emu.h"
+
+static volatile sig_atomic_t quit = 0;
+
+static void on_signal(int sig)
+{
+	(void)sig;
+	quit = 1;
+}
+
+static uint64_t now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+//应答先攒起来,每处理完一批收到的数据再一起写出,减少系统调用
+static uint8_t out[65536];
+static uint32_t outLen = 0;
+
+static void pty_flush(int fd)
+{
+	uint32_t pos = 0;
+	ssize_t n;
+
+	while(pos < outLen)
+	{
+		n = write(fd, out + pos, outLen - pos);
+		if(n <= 0)
+		{
+			break;
+		}
+		pos += (uint32_t)n;
+	}
+	outLen = 0;
+}
+
+static void pty_write(void* ctx, const uint8_t* data, uint16_t len)
+{
+	if(outLen + len > sizeof(out))
+	{
+		pty_flush(*(int*)ctx);
+	}
+	memcpy(out + outLen, data, len);
+	outLen += len;
+}
+
+int main(int argc, char** argv)
+{
+	static TJC_Emu_t emu;
+	const char* script_path = NULL;
+	const char* link_path = NULL;
+	FILE* script = NULL;
+	char line[256];
+	uint8_t buf[4096];
+	struct termios tio;
+	struct pollfd pfd;
+	uint64_t resume = 0;
+	uint32_t wait_ms;
+	int master, slave, opt, verbose = 0;
+	ssize_t n;
+
+	while((opt = getopt(argc, argv, "vs:l:")) != -1)
+	{
+		switch(opt)
+		{
+			case 'v': verbose = 1; break;
+			case 's': script_path = optarg; break;
+			case 'l': link_path = optarg; break;
+			default:
+				fprintf(stderr, "usage: %s [-v] [-s script] [-l link]\n", argv[0]);
+				return 1;
+		}
+	}
+
+	master = posix_openpt(O_RDWR | O_NOCTTY);
+	if(master < 0 || grantpt(master) || unlockpt(master))
+	{
+		perror("posix_openpt");
+		return 1;
+	}
+	//保持一个从端打开,客户端关闭重开时主端不会读到EOF;同时设为原始模式,0xff等字节原样传输
+	slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+	if(slave < 0 || tcgetattr(slave, &tio))
+	{
+		perror("open slave");
+		return 1;
+	}
+	cfmakeraw(&tio);
+	tcsetattr(slave, TCSANOW, &tio);
+	if(link_path != NULL)
+	{
+		unlink(link_path);
+		if(symlink(ptsname(master), link_path))
+		{
+			perror("symlink");
+		}
+	}
+	if(script_path != NULL && (script = fopen(script_path, "r")) == NULL)
+	{
+		perror(script_path);
+		return 1;
+	}
+
+	tjc_emu_init(&emu, pty_write, &master);
+	emu.Verbose = (uint8_t)verbose;
+	printf("TJC HMI emulator on %s\n", ptsname(master));
+	fflush(stdout);
+	signal(SIGINT, on_signal);
+	signal(SIGTERM, on_signal);
+
+	pfd.fd = master;
+	pfd.events = POLLIN;
+	while(!quit)
+	{
+		//脚本按行执行,遇到 wait 暂停,期间照常处理串口数据
+		while(script != NULL && now_us() >= resume)
+		{
+			if(fgets(line, sizeof(line), script) == NULL)
+			{
+				fclose(script);
+				script = NULL;
+				break;
+			}
+			line[strcspn(line, "\r\n")] = '\0';
+			if(tjc_emu_script_line(&emu, line, &wait_ms))
+			{
+				fprintf(stderr, "script: unknown line '%s'\n", line);
+			}
+			resume = now_us() + (uint64_t)wait_ms * 1000u;
+		}
+		pty_flush(master);
+
+		if(poll(&pfd, 1, (script != NULL) ? 1 : 100) <= 0)
+		{
+			continue;
+		}
+		n = read(master, buf, sizeof(buf));
+		if(n > 0)
+		{
+			tjc_emu_feed(&emu, buf, (uint32_t)n, now_us());
+			pty_flush(master);
+		}
+	}
+
+	tjc_emu_print_stats(&emu);
+	if(link_path != NULL)
+	{
+		unlink(link_path);
+	}
+	close(slave);
+	close(master);
+	return 0;
+}
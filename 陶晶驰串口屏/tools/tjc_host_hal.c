@@ -0,0 +1,387 @@
+/**
+	Linux主机上的最小HAL,说明见 tjc_host_hal.h
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include "tjc_host_hal.h"
+#include "tjc_emu.h"
+
+#define TJC_HOST_PORT_MAX	(4)
+#define TJC_HOST_RX_LEN		(65536)
+
+typedef struct TJC_HostPort_s
+{
+    UART_HandleTypeDef* huart;
+    int      Fd;				//<0 表示接在进程内模拟器上
+    TJC_Emu_t* Emu;				//Fd<0 时使用
+    uint8_t* RxPtr;				//HAL_UART_Receive_IT 给的接收地址,为空表示未开启接收
+    uint8_t  TxPending;			//发送完成回调待分发
+    uint8_t  Pace;				//1:按波特率模拟发送时间
+    uint32_t FailLeft;			//接下来这么多次启动发送返回HAL_BUSY
+    uint8_t  Stall;				//1:扣住发送完成回调,模拟发送卡死
+    uint64_t TxDoneAt;			//发送完成时刻,us
+    uint8_t  Rx[TJC_HOST_RX_LEN];	//已到达但还没分发的接收数据
+    uint32_t RxHead;
+    uint32_t RxTail;
+    TJC_HostUartStats_t Stats;
+}TJC_HostPort_t;
+
+volatile uint32_t tjcHostPrimask = 0;
+volatile uint32_t tjcHostIpsr = 0;		//正在分发回调(相当于在中断里)
+
+static TJC_HostPort_t ports[TJC_HOST_PORT_MAX];
+static uint8_t portCount = 0;
+
+
+
+uint64_t tjc_host_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+
+
+static TJC_HostPort_t* tjc_host_port_new(UART_HandleTypeDef* huart, void* instance)
+{
+	TJC_HostPort_t* port;
+
+	if(portCount >= TJC_HOST_PORT_MAX)
+	{
+		return NULL;
+	}
+	port = &ports[portCount++];
+	memset(port, 0, sizeof(TJC_HostPort_t));
+	port->huart = huart;
+	port->Fd = -1;
+	memset(huart, 0, sizeof(UART_HandleTypeDef));
+	huart->Instance = instance;
+	huart->Init.BaudRate = 9600;
+	huart->gState = HAL_UART_STATE_READY;
+	huart->RxState = HAL_UART_STATE_READY;
+	huart->Port = port;
+	return port;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_host_uart_fd
+日期：    	2026.10.19
+功能：    	把串口句柄接到已打开的文件描述符上(伪终端、/dev/ttyUSBx)
+输入参数：		串口句柄,区分串口用的任意非空指针,文件描述符(需已设为原始模式)
+返回值： 		0:成功 1:串口数量超过上限
+修改记录：
+**********************************************************/
+uint8_t tjc_host_uart_fd(UART_HandleTypeDef* huart, void* instance, int fd)
+{
+	TJC_HostPort_t* port = tjc_host_port_new(huart, instance);
+
+	if(port == NULL)
+	{
+		return 1;
+	}
+	port->Fd = fd;
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+	return 0;
+}
+
+
+
+//接收数据入队,模拟器的应答和从文件描述符读到的数据都经这里
+static void tjc_host_emu_write(void* ctx, const uint8_t* data, uint16_t len)
+{
+	TJC_HostPort_t* port = (TJC_HostPort_t*)ctx;
+
+	for(uint16_t i = 0; i < len; i++)
+	{
+		if(port->RxTail - port->RxHead >= TJC_HOST_RX_LEN)
+		{
+			return;		//与真实串口一样,来不及接收的数据丢失
+		}
+		port->Rx[port->RxTail++ % TJC_HOST_RX_LEN] = data[i];
+	}
+}
+
+
+
+/********************************************************
+函数名：  		tjc_host_uart_emu
+日期：    	2026.10.19
+功能：    	把串口句柄直接接到进程内的模拟器上,模拟器由本函数初始化
+输入参数：		串口句柄,区分串口用的任意非空指针,模拟器(TJC_Emu_t*)
+返回值： 		0:成功 1:串口数量超过上限
+修改记录：
+**********************************************************/
+uint8_t tjc_host_uart_emu(UART_HandleTypeDef* huart, void* instance, void* emu)
+{
+	TJC_HostPort_t* port = tjc_host_port_new(huart, instance);
+
+	if(port == NULL)
+	{
+		return 1;
+	}
+	port->Emu = (TJC_Emu_t*)emu;
+	tjc_emu_init(port->Emu, tjc_host_emu_write, port);
+	return 0;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_host_fd_drain
+日期：    	2026.10.19
+功能：    	把文件描述符上已到达的数据读进接收队列
+			发送被阻塞时也要调用,否则对端写满后不再读取,双方互相等待
+输入参数：		串口
+返回值： 		无
+修改记录：
+**********************************************************/
+static void tjc_host_fd_drain(TJC_HostPort_t* port)
+{
+	uint8_t buf[256];
+	ssize_t n;
+
+	if(port->Fd < 0)
+	{
+		return;
+	}
+	while((n = read(port->Fd, buf, sizeof(buf))) > 0)
+	{
+		tjc_host_emu_write(port, buf, (uint16_t)n);
+	}
+}
+
+
+
+/********************************************************
+函数名：  		tjc_host_poll
+日期：    	2026.10.19
+功能：    	分发接收完成、发送完成"中断"
+			每个接收到的字节调用一次 HAL_UART_RxCpltCallback,和单片机上逐字节中断接收一致
+输入参数：
+返回值： 		无
+修改记录：
+**********************************************************/
+void tjc_host_poll(void)
+{
+	TJC_HostPort_t* port;
+
+	//回调里再调用 HAL_GetTick 时不重入
+	if(tjcHostPrimask || tjcHostIpsr)
+	{
+		return;
+	}
+	tjcHostIpsr = 1;
+	for(uint8_t i = 0; i < portCount; i++)
+	{
+		port = &ports[i];
+		if(port->TxPending && !port->Stall && tjc_host_us() >= port->TxDoneAt)
+		{
+			port->TxPending = 0;
+			port->huart->gState = HAL_UART_STATE_READY;
+			HAL_UART_TxCpltCallback(port->huart);
+		}
+		tjc_host_fd_drain(port);
+		while(port->RxPtr != NULL && port->RxHead != port->RxTail)
+		{
+			port->Stats.RxBytes++;
+			*port->RxPtr = port->Rx[port->RxHead++ % TJC_HOST_RX_LEN];
+			port->RxPtr = NULL;
+			port->huart->RxState = HAL_UART_STATE_READY;
+			HAL_UART_RxCpltCallback(port->huart);
+		}
+	}
+	tjcHostIpsr = 0;
+}
+
+
+
+void tjc_host_set_primask(uint32_t primask)
+{
+	tjcHostPrimask = primask;
+	if(!primask)
+	{
+		tjc_host_poll();
+	}
+}
+
+
+
+/********************************************************
+函数名：  		tjc_host_uart_pace
+日期：    	2026.10.19
+功能：    	按当前波特率模拟发送耗时,发送完成回调推迟到数据"发完"之后
+			接伪终端或进程内模拟器时发送是瞬间完成的,测试发送队列排队效果时打开
+输入参数：		串口句柄,1:打开 0:关闭
+返回值： 		无
+修改记录：
+**********************************************************/
+void tjc_host_uart_pace(UART_HandleTypeDef* huart, uint8_t enable)
+{
+	huart->Port->Pace = enable;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_host_uart_fail
+日期：    	2026.10.19
+功能：    	让接下来的几次 HAL_UART_Transmit_xx 返回HAL_BUSY,测试驱动的重发
+输入参数：		串口句柄,失败次数
+返回值： 		无
+修改记录：
+**********************************************************/
+void tjc_host_uart_fail(UART_HandleTypeDef* huart, uint32_t count)
+{
+	huart->Port->FailLeft = count;
+}
+
+
+
+/********************************************************
+函数名：  		tjc_host_uart_stall
+日期：    	2026.10.19
+功能：    	扣住发送完成回调,串口一直处于发送中,测试发送卡死时驱动不会无限等待;关闭后补发回调
+输入参数：		串口句柄,1:打开 0:关闭
+返回值： 		无
+修改记录：
+**********************************************************/
+void tjc_host_uart_stall(UART_HandleTypeDef* huart, uint8_t enable)
+{
+	huart->Port->Stall = enable;
+}
+
+
+
+void tjc_host_get_stats(UART_HandleTypeDef* huart, TJC_HostUartStats_t* stats)
+{
+	*stats = huart->Port->Stats;
+}
+
+
+
+uint32_t HAL_GetTick(void)
+{
+	tjc_host_poll();
+	return (uint32_t)(tjc_host_us() / 1000u);
+}
+
+
+
+void HAL_Delay(uint32_t delay)
+{
+	uint32_t tick = HAL_GetTick();
+
+	while(HAL_GetTick() - tick < delay)
+	{
+		usleep(100);
+	}
+}
+
+
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef* huart)
+{
+	huart->gState = HAL_UART_STATE_READY;
+	huart->RxState = HAL_UART_STATE_READY;
+	return HAL_OK;
+}
+
+
+
+/********************************************************
+函数名：  		HAL_UART_Transmit_IT
+日期：    	2026.10.19
+功能：    	发送数据,写完后串口立即空闲,发送完成回调在下一次分发时调用
+输入参数：
+返回值：
+修改记录：
+**********************************************************/
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef* huart, uint8_t* data, uint16_t len)
+{
+	TJC_HostPort_t* port = huart->Port;
+	ssize_t n;
+
+	if(huart->gState != HAL_UART_STATE_READY)
+	{
+		return HAL_BUSY;
+	}
+	if(port->FailLeft)
+	{
+		port->FailLeft--;
+		return HAL_BUSY;
+	}
+	port->Stats.TxCalls++;
+	port->Stats.TxBytes += len;
+	//每字节10位(1起始位+8数据位+1停止位)
+	port->TxDoneAt = port->Pace ? tjc_host_us() + (uint64_t)len * 10000000u / huart->Init.BaudRate : 0;
+	if(port->Fd >= 0)
+	{
+		while(len)
+		{
+			n = write(port->Fd, data, len);
+			if(n < 0 && errno != EAGAIN)
+			{
+				return HAL_ERROR;
+			}
+			if(n < 0)
+			{
+				tjc_host_fd_drain(port);
+				usleep(10);
+			}
+			if(n > 0)
+			{
+				data += n;
+				len -= (uint16_t)n;
+			}
+		}
+	}
+	else
+	{
+		tjc_emu_feed(port->Emu, data, len, tjc_host_us());
+	}
+	port->TxPending = 1;
+	huart->gState = HAL_UART_STATE_BUSY_TX;
+	return HAL_OK;
+}
+
+
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, uint8_t* data, uint16_t len)
+{
+	return HAL_UART_Transmit_IT(huart, data, len);
+}
+
+
+
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef* huart, uint8_t* data, uint16_t len)
+{
+	(void)len;	//驱动总是逐字节接收
+	huart->Port->RxPtr = data;
+	huart->RxState = HAL_UART_STATE_BUSY_RX;
+	return HAL_OK;
+}
+
+
+
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef* huart)
+{
+	huart->Port->RxPtr = NULL;
+	huart->RxState = HAL_UART_STATE_READY;
+	return HAL_OK;
+}
+
+
+
+__weak void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart)
+{
+	(void)huart;
+}
@@ -0,0 +1,93 @@
+#ifndef __TJC_HOST_HAL_H__
+#define __TJC_HOST_HAL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+	在Linux主机上编译 tjc_usart_hmi.c 用的最小HAL(编译驱动时定义 TJC_HOST)
+	串口可以接到文件描述符(伪终端/真实串口)上,也可以直接接到进程内的模拟器上
+	没有真正的中断:接收完成、发送完成回调在 HAL_GetTick()/HAL_Delay()/tjc_host_poll() 中分发,
+	驱动的等待循环都会调用 HAL_GetTick(),效果与中断相同;关中断期间不分发
+*/
+
+
+
+typedef enum
+{
+    HAL_OK = 0,
+    HAL_ERROR,
+    HAL_BUSY,
+    HAL_TIMEOUT,
+}HAL_StatusTypeDef;
+
+typedef enum
+{
+    HAL_UART_STATE_RESET = 0,
+    HAL_UART_STATE_READY,
+    HAL_UART_STATE_BUSY_TX,
+    HAL_UART_STATE_BUSY_RX,
+}HAL_UART_StateTypeDef;
+
+typedef struct
+{
+    uint32_t BaudRate;
+}UART_InitTypeDef;
+
+struct TJC_HostPort_s;
+
+typedef struct
+{
+    void*    Instance;						//只用来区分不同串口
+    UART_InitTypeDef Init;
+    void*    hdmatx;						//主机上总是为空,驱动走中断发送分支
+    void*    hdmarx;
+    volatile HAL_UART_StateTypeDef gState;
+    volatile HAL_UART_StateTypeDef RxState;
+    struct TJC_HostPort_s* Port;			//tjc_host_uart_xxx() 绑定的传输方式
+}UART_HandleTypeDef;
+
+#define __weak	__attribute__((weak))
+
+//关中断期间到达的"中断"在重新开中断时分发,和单片机上挂起的中断一样
+extern volatile uint32_t tjcHostPrimask;
+void tjc_host_set_primask(uint32_t primask);
+#define __get_PRIMASK()		(tjcHostPrimask)
+#define __set_PRIMASK(x)	tjc_host_set_primask(x)
+#define __disable_irq()		tjc_host_set_primask(1)
+#define __enable_irq()		tjc_host_set_primask(0)
+
+//分发回调期间非0,驱动用来判断是否在中断里
+extern volatile uint32_t tjcHostIpsr;
+#define __get_IPSR()		(tjcHostIpsr)
+
+
+
+typedef struct
+{
+    uint64_t TxBytes;
+    uint64_t RxBytes;
+    uint32_t TxCalls;		//HAL_UART_Transmit_xx 调用次数
+}TJC_HostUartStats_t;
+
+uint8_t tjc_host_uart_fd(UART_HandleTypeDef* huart, void* instance, int fd);
+uint8_t tjc_host_uart_emu(UART_HandleTypeDef* huart, void* instance, void* emu);
+void tjc_host_uart_pace(UART_HandleTypeDef* huart, uint8_t enable);
+void tjc_host_uart_fail(UART_HandleTypeDef* huart, uint32_t count);
+void tjc_host_uart_stall(UART_HandleTypeDef* huart, uint8_t enable);
+void tjc_host_poll(void);
+void tjc_host_get_stats(UART_HandleTypeDef* huart, TJC_HostUartStats_t* stats);
+uint64_t tjc_host_us(void);
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t delay);
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef* huart, uint8_t* data, uint16_t len);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, uint8_t* data, uint16_t len);
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef* huart, uint8_t* data, uint16_t len);
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef* huart);
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart);
+
+
+#endif